@@ -1,8 +1,50 @@
 {
   "variables": {
-    "platform": "<(OS)"
+    "platform": "<(OS)",
+    "openvr_mock%": 0
   },
   "conditions": [
+    [
+      "openvr_mock == 1",
+      {
+        "targets": [
+          {
+            "target_name": "openvr_mock",
+            "type": "static_library",
+            "sources": [
+              "mock/openvr_mock.cpp"
+            ],
+            "include_dirs": [
+              "<(module_root_dir)/openvr/",
+              "<(module_root_dir)/mock/"
+            ],
+            "defines": [
+              "OPENVR_BUILD_STATIC"
+            ],
+            "cflags_cc": [
+              "-fPIC"
+            ],
+            "msvs_settings": {
+              "VCCLCompilerTool": {
+                "AdditionalOptions": [
+                  "/EHsc",
+                  "/MT"
+                ]
+              }
+            },
+            "direct_dependent_settings": {
+              "include_dirs": [
+                "<(module_root_dir)/mock/"
+              ],
+              "defines": [
+                "OPENVR_BUILD_STATIC",
+                "OPENVR_JS_MOCK"
+              ]
+            }
+          }
+        ]
+      }
+    ],
     [
       "platform == 'win'",
       {
@@ -30,7 +72,23 @@
         "src/ivrdebug.cpp",
         "src/bindings.cpp",
         "src/util.cpp",
-        "src/openvr.cpp"
+        "src/openvr.cpp",
+        "src/posesampler.cpp",
+        "src/eventpump.cpp",
+        "src/eventfilter.cpp",
+        "src/eventcoalescer.cpp",
+        "src/propertycache.cpp",
+        "src/overlayupload.cpp",
+        "src/overlayfingerprint.cpp",
+        "src/cpufeatures.cpp",
+        "src/pixelconvert.cpp",
+        "src/imagecache.cpp",
+        "src/overlayproperties.cpp",
+        "src/overlaymirror.cpp",
+        "src/overlaytransformcache.cpp",
+        "src/overlayregistry.cpp",
+        "src/hmdmath.cpp",
+        "src/overlayanimator.cpp"
       ],
       "include_dirs": [
         "<!(node -e \"require('nan')\")",
@@ -40,12 +98,6 @@
         [
           "OS=='win'",
           {
-            "library_dirs": [
-              "<(module_root_dir)/openvr/lib/"
-            ],
-            "libraries": [
-              "openvr_api.lib"
-            ],
             "defines": [
               "WIN32_LEAN_AND_MEAN",
               "VC_EXTRALEAN",
@@ -74,7 +126,18 @@
                   "/LTCG"
                 ]
               }
-            },
+            }
+          }
+        ],
+        [
+          "OS=='win' and openvr_mock != 1",
+          {
+            "library_dirs": [
+              "<(module_root_dir)/openvr/lib/"
+            ],
+            "libraries": [
+              "openvr_api.lib"
+            ],
             "actions": [
               {
                 "action_name": "copy_openvr_libs",
@@ -95,12 +158,28 @@
         ],
         [
           "OS=='linux'",
+          {
+            "defines": [
+              "LINUX"
+            ]
+          }
+        ],
+        [
+          "OS=='linux' and openvr_mock != 1",
           {
             "libraries": [
               "<(module_root_dir)/openvr/lib/libopenvr_api.so"
+            ]
+          }
+        ],
+        [
+          "openvr_mock == 1",
+          {
+            "sources": [
+              "src/vrmock.cpp"
             ],
-            "defines": [
-              "LINUX"
+            "dependencies": [
+              "openvr_mock"
             ]
           }
         ]
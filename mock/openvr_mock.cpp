@@ -0,0 +1,2135 @@
+#include "openvr_mock.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t k_unMockProcessId = 1000;
+    constexpr uint32_t k_unForeignProcessId = 2000;
+
+    // This SDK has SetOverlayTransformOverlayRelative but no enum value for it.
+    constexpr vr::VROverlayTransformType k_eOverlayRelativeTransform = static_cast<vr::VROverlayTransformType>(-2);
+
+    const vr::HmdMatrix34_t k_mIdentity = {{{1.0f, 0.0f, 0.0f, 0.0f},
+                                            {0.0f, 1.0f, 0.0f, 0.0f},
+                                            {0.0f, 0.0f, 1.0f, 0.0f}}};
+
+    struct PropertyValue
+    {
+        vr::PropertyTypeTag_t tag;
+        std::vector<uint8_t> data;
+    };
+
+    struct Device
+    {
+        vr::ETrackedDeviceClass deviceClass = vr::TrackedDeviceClass_Invalid;
+        vr::ETrackedControllerRole role = vr::TrackedControllerRole_Invalid;
+        bool connected = false;
+        vr::TrackedDevicePose_t pose = {};
+        Clock::time_point poseTime;
+        vr::VRControllerState_t controllerState = {};
+        std::map<vr::ETrackedDeviceProperty, PropertyValue> properties;
+    };
+
+    struct Overlay
+    {
+        std::string key;
+        std::string name;
+        uint32_t ownerPid = k_unMockProcessId;
+        uint32_t renderingPid = 0;
+        uint32_t flags = 0;
+        float red = 1.0f, green = 1.0f, blue = 1.0f;
+        float alpha = 1.0f;
+        float texelAspect = 1.0f;
+        uint32_t sortOrder = 0;
+        float widthInMeters = 1.0f;
+        float curvature = 0.0f;
+        vr::EColorSpace colorSpace = vr::ColorSpace_Auto;
+        vr::VRTextureBounds_t textureBounds = {0.0f, 0.0f, 1.0f, 1.0f};
+        vr::VROverlayTransformType transformType = vr::VROverlayTransform_Absolute;
+        vr::ETrackingUniverseOrigin trackingOrigin = vr::TrackingUniverseStanding;
+        vr::HmdMatrix34_t transform = k_mIdentity;
+        vr::TrackedDeviceIndex_t trackedDevice = vr::k_unTrackedDeviceIndexInvalid;
+        std::string componentName;
+        vr::VROverlayHandle_t parent = vr::k_ulOverlayHandleInvalid;
+        vr::HmdVector2_t cursorHotspot = {{0.0f, 0.0f}};
+        bool visible = false;
+        vr::VROverlayInputMethod inputMethod = vr::VROverlayInputMethod_None;
+        vr::HmdVector2_t mouseScale = {{1.0f, 1.0f}};
+        uint32_t textureWidth = 0;
+        uint32_t textureHeight = 0;
+        uint32_t sceneProcess = 0;
+        vr::VROverlayHandle_t thumbnail = vr::k_ulOverlayHandleInvalid;
+        bool isThumbnail = false;
+        std::deque<vr::VREvent_t> events;
+    };
+
+    struct Runtime
+    {
+        std::mutex mutex;
+        std::atomic<uint32_t> latencyUs{0};
+        std::atomic<uint64_t> calls{0};
+
+        bool initialized = false;
+        uint32_t initToken = 0;
+        vr::EVRInitError initError = vr::VRInitError_None;
+        bool hmdPresent = true;
+        float displayFrequency = 90.0f;
+        Clock::time_point epoch = Clock::now();
+
+        Device devices[vr::k_unMaxTrackedDeviceCount];
+        std::deque<vr::VREvent_t> events;
+
+        std::map<vr::VROverlayHandle_t, Overlay> overlays;
+        vr::VROverlayHandle_t nextOverlayHandle = 0;
+        uint64_t overlayUploads = 0;
+        uint64_t overlayUploadBytes = 0;
+        uint64_t overlayFileLoads = 0;
+
+        bool keyboardVisible = false;
+        std::string keyboardText;
+
+        std::vector<std::string> manifests;
+        uint64_t nextProfilerEvent = 1;
+    };
+
+    Runtime &State()
+    {
+        static Runtime runtime;
+        return runtime;
+    }
+
+    // Every interface entry point goes through here. The sleep happens before the
+    // lock is taken so concurrent callers overlap, like real IPC does.
+    std::unique_lock<std::mutex> Call()
+    {
+        Runtime &runtime = State();
+        runtime.calls.fetch_add(1, std::memory_order_relaxed);
+        const uint32_t latencyUs = runtime.latencyUs.load(std::memory_order_relaxed);
+        if (latencyUs != 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(latencyUs));
+        return std::unique_lock<std::mutex>(runtime.mutex);
+    }
+
+    //=========================================================
+    vr::HmdMatrix34_t Multiply(const vr::HmdMatrix34_t &a, const vr::HmdMatrix34_t &b)
+    {
+        vr::HmdMatrix34_t result;
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int col = 0; col < 4; ++col)
+            {
+                float sum = col == 3 ? a.m[row][3] : 0.0f;
+                for (int k = 0; k < 3; ++k)
+                    sum += a.m[row][k] * b.m[k][col];
+                result.m[row][col] = sum;
+            }
+        }
+        return result;
+    }
+
+    vr::HmdVector3_t Rotate(const vr::HmdMatrix34_t &m, const vr::HmdVector3_t &v)
+    {
+        vr::HmdVector3_t result;
+        for (int row = 0; row < 3; ++row)
+            result.v[row] = m.m[row][0] * v.v[0] + m.m[row][1] * v.v[1] + m.m[row][2] * v.v[2];
+        return result;
+    }
+
+    // Rotation of `angle` radians about the unit vector (x, y, z).
+    vr::HmdMatrix34_t AxisAngle(float x, float y, float z, float angle)
+    {
+        const float c = std::cos(angle), s = std::sin(angle), t = 1.0f - c;
+        vr::HmdMatrix34_t result = {{{t * x * x + c, t * x * y - s * z, t * x * z + s * y, 0.0f},
+                                     {t * x * y + s * z, t * y * y + c, t * y * z - s * x, 0.0f},
+                                     {t * x * z - s * y, t * y * z + s * x, t * z * z + c, 0.0f}}};
+        return result;
+    }
+
+    vr::HmdMatrix34_t Translation(float x, float y, float z)
+    {
+        vr::HmdMatrix34_t result = k_mIdentity;
+        result.m[0][3] = x;
+        result.m[1][3] = y;
+        result.m[2][3] = z;
+        return result;
+    }
+
+    // Seated zero pose sits at standing eye height.
+    const vr::HmdMatrix34_t k_mSeatedZeroToStanding = Translation(0.0f, 1.6f, 0.0f);
+
+    //=========================================================
+    // Integrates a device's scripted velocity up to `time`.
+    vr::TrackedDevicePose_t PoseAt(const Device &device, Clock::time_point time, vr::ETrackingUniverseOrigin eOrigin)
+    {
+        if (!device.connected)
+        {
+            vr::TrackedDevicePose_t pose = {};
+            pose.eTrackingResult = vr::TrackingResult_Uninitialized;
+            return pose;
+        }
+
+        vr::TrackedDevicePose_t pose = device.pose;
+        const float dt = std::chrono::duration<float>(time - device.poseTime).count();
+
+        const vr::HmdVector3_t &w = pose.vAngularVelocity;
+        const float speed = std::sqrt(w.v[0] * w.v[0] + w.v[1] * w.v[1] + w.v[2] * w.v[2]);
+        vr::HmdMatrix34_t motion = k_mIdentity;
+        if (speed > 0.0f)
+            motion = AxisAngle(w.v[0] / speed, w.v[1] / speed, w.v[2] / speed, speed * dt);
+
+        const vr::HmdMatrix34_t &start = device.pose.mDeviceToAbsoluteTracking;
+        vr::HmdMatrix34_t rotated = Multiply(motion, start);
+        for (int row = 0; row < 3; ++row)
+            rotated.m[row][3] = start.m[row][3] + pose.vVelocity.v[row] * dt;
+        pose.mDeviceToAbsoluteTracking = rotated;
+
+        if (eOrigin == vr::TrackingUniverseSeated)
+        {
+            const vr::HmdMatrix34_t standingToSeated = Translation(
+                -k_mSeatedZeroToStanding.m[0][3], -k_mSeatedZeroToStanding.m[1][3], -k_mSeatedZeroToStanding.m[2][3]);
+            pose.mDeviceToAbsoluteTracking = Multiply(standingToSeated, pose.mDeviceToAbsoluteTracking);
+        }
+
+        return pose;
+    }
+
+    Clock::time_point PredictedTime(float fSecondsFromNow)
+    {
+        return Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(fSecondsFromNow));
+    }
+
+    //=========================================================
+    void StoreProperty(Device &device, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t tag, const void *pvData, uint32_t unSize)
+    {
+        PropertyValue &value = device.properties[prop];
+        value.tag = tag;
+        value.data.assign(static_cast<const uint8_t *>(pvData), static_cast<const uint8_t *>(pvData) + unSize);
+    }
+
+    template <typename T>
+    void StoreProperty(Device &device, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t tag, const T &value)
+    {
+        StoreProperty(device, prop, tag, &value, sizeof(T));
+    }
+
+    void StoreProperty(Device &device, vr::ETrackedDeviceProperty prop, const char *value)
+    {
+        StoreProperty(device, prop, vr::k_unStringPropertyTag, value, static_cast<uint32_t>(std::strlen(value) + 1));
+    }
+
+    const PropertyValue *FindProperty(const Runtime &runtime, vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *pError)
+    {
+        vr::ETrackedPropertyError error = vr::TrackedProp_Success;
+        const PropertyValue *value = nullptr;
+
+        if (unDeviceIndex >= vr::k_unMaxTrackedDeviceCount || !runtime.devices[unDeviceIndex].connected)
+        {
+            error = vr::TrackedProp_InvalidDevice;
+        }
+        else
+        {
+            const auto &properties = runtime.devices[unDeviceIndex].properties;
+            const auto it = properties.find(prop);
+            if (it == properties.end())
+                error = vr::TrackedProp_UnknownProperty;
+            else
+                value = &it->second;
+        }
+
+        if (pError)
+            *pError = error;
+        return value;
+    }
+
+    template <typename T>
+    T ReadProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t tag, vr::ETrackedPropertyError *pError)
+    {
+        auto lock = Call();
+        T result = {};
+
+        vr::ETrackedPropertyError error;
+        const PropertyValue *value = FindProperty(State(), unDeviceIndex, prop, &error);
+        if (value && (value->tag != tag || value->data.size() != sizeof(T)))
+            error = vr::TrackedProp_WrongDataType;
+        else if (value)
+            std::memcpy(&result, value->data.data(), sizeof(T));
+
+        if (pError)
+            *pError = error;
+        return result;
+    }
+
+    void PushEvent(Runtime &runtime, vr::EVREventType eType, vr::TrackedDeviceIndex_t unDeviceIndex, const vr::VREvent_Data_t &data)
+    {
+        vr::VREvent_t event = {};
+        event.eventType = eType;
+        event.trackedDeviceIndex = unDeviceIndex;
+        event.data = data;
+        runtime.events.push_back(event);
+    }
+
+    void InstallDevice(Runtime &runtime, vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceClass eClass, vr::ETrackedControllerRole eRole, float fHeight)
+    {
+        Device &device = runtime.devices[unDeviceIndex];
+        device = Device();
+        device.deviceClass = eClass;
+        device.role = eRole;
+        device.connected = true;
+        device.poseTime = Clock::now();
+        device.pose.mDeviceToAbsoluteTracking = Translation(
+            eRole == vr::TrackedControllerRole_LeftHand ? -0.2f : eRole == vr::TrackedControllerRole_RightHand ? 0.2f : 0.0f,
+            fHeight, eClass == vr::TrackedDeviceClass_HMD ? 0.0f : -0.3f);
+        device.pose.eTrackingResult = vr::TrackingResult_Running_OK;
+        device.pose.bPoseIsValid = true;
+        device.pose.bDeviceIsConnected = true;
+
+        const std::string serial = "MOCK-" + std::to_string(unDeviceIndex);
+        StoreProperty(device, vr::Prop_TrackingSystemName_String, "mock");
+        StoreProperty(device, vr::Prop_ManufacturerName_String, "OpenVR.js");
+        StoreProperty(device, vr::Prop_SerialNumber_String, serial.c_str());
+        StoreProperty(device, vr::Prop_DeviceClass_Int32, vr::k_unInt32PropertyTag, static_cast<int32_t>(eClass));
+        StoreProperty(device, vr::Prop_HardwareRevision_Uint64, vr::k_unUint64PropertyTag, static_cast<uint64_t>(1));
+        StoreProperty(device, vr::Prop_StatusDisplayTransform_Matrix34, vr::k_unHmdMatrix34PropertyTag, k_mIdentity);
+
+        if (eClass == vr::TrackedDeviceClass_HMD)
+        {
+            const float frameRates[] = {90.0f, 120.0f, 144.0f};
+            const vr::HmdMatrix34_t cameraToHead[] = {Translation(-0.035f, 0.0f, -0.08f), Translation(0.035f, 0.0f, -0.08f)};
+
+            StoreProperty(device, vr::Prop_ModelNumber_String, "Mock HMD");
+            StoreProperty(device, vr::Prop_DisplayFrequency_Float, vr::k_unFloatPropertyTag, runtime.displayFrequency);
+            StoreProperty(device, vr::Prop_UserIpdMeters_Float, vr::k_unFloatPropertyTag, 0.063f);
+            StoreProperty(device, vr::Prop_CurrentUniverseId_Uint64, vr::k_unUint64PropertyTag, static_cast<uint64_t>(1));
+            StoreProperty(device, vr::Prop_DeviceProvidesBatteryStatus_Bool, vr::k_unBoolPropertyTag, false);
+            StoreProperty(device, vr::Prop_NumCameras_Int32, vr::k_unInt32PropertyTag, static_cast<int32_t>(2));
+            StoreProperty(device, vr::Prop_DisplayAvailableFrameRates_Float_Array, vr::k_unFloatPropertyTag, frameRates, sizeof(frameRates));
+            StoreProperty(device, vr::Prop_CameraToHeadTransforms_Matrix34_Array, vr::k_unHmdMatrix34PropertyTag, cameraToHead, sizeof(cameraToHead));
+        }
+        else
+        {
+            StoreProperty(device, vr::Prop_ModelNumber_String, "Mock Controller");
+            StoreProperty(device, vr::Prop_ControllerRoleHint_Int32, vr::k_unInt32PropertyTag, static_cast<int32_t>(eRole));
+            StoreProperty(device, vr::Prop_DeviceProvidesBatteryStatus_Bool, vr::k_unBoolPropertyTag, true);
+            StoreProperty(device, vr::Prop_DeviceIsWireless_Bool, vr::k_unBoolPropertyTag, true);
+            StoreProperty(device, vr::Prop_DeviceIsCharging_Bool, vr::k_unBoolPropertyTag, false);
+            StoreProperty(device, vr::Prop_DeviceBatteryPercentage_Float, vr::k_unFloatPropertyTag, 0.75f);
+        }
+    }
+
+    void ResetLocked(Runtime &runtime)
+    {
+        runtime.latencyUs = 0;
+        runtime.initError = vr::VRInitError_None;
+        runtime.hmdPresent = true;
+        runtime.displayFrequency = 90.0f;
+        runtime.epoch = Clock::now();
+
+        for (auto &device : runtime.devices)
+            device = Device();
+        InstallDevice(runtime, 0, vr::TrackedDeviceClass_HMD, vr::TrackedControllerRole_Invalid, 1.7f);
+        InstallDevice(runtime, 1, vr::TrackedDeviceClass_Controller, vr::TrackedControllerRole_LeftHand, 1.2f);
+        InstallDevice(runtime, 2, vr::TrackedDeviceClass_Controller, vr::TrackedControllerRole_RightHand, 1.2f);
+        runtime.events.clear();
+
+        runtime.overlays.clear();
+        runtime.nextOverlayHandle = (static_cast<uint64_t>(1) << 32) + 1;
+        runtime.overlayUploads = 0;
+        runtime.overlayUploadBytes = 0;
+        runtime.overlayFileLoads = 0;
+
+        runtime.keyboardVisible = false;
+        runtime.keyboardText.clear();
+        runtime.manifests.clear();
+    }
+
+    struct ResetOnLoad
+    {
+        ResetOnLoad() { ResetLocked(State()); }
+    } resetOnLoad;
+
+    //=========================================================
+    // Writes `value` as a NUL-terminated string and returns the size it needs.
+    uint32_t CopyString(const std::string &value, char *pchBuffer, uint32_t unBufferSize)
+    {
+        const uint32_t required = static_cast<uint32_t>(value.size() + 1);
+        if (pchBuffer && unBufferSize >= required)
+            std::memcpy(pchBuffer, value.c_str(), required);
+        else if (pchBuffer && unBufferSize > 0)
+            pchBuffer[0] = '\0';
+        return required;
+    }
+
+    Overlay *FindOverlay(Runtime &runtime, vr::VROverlayHandle_t ulOverlayHandle)
+    {
+        const auto it = runtime.overlays.find(ulOverlayHandle);
+        return it == runtime.overlays.end() ? nullptr : &it->second;
+    }
+
+    vr::VROverlayHandle_t AddOverlay(Runtime &runtime, const char *pchOverlayKey, const char *pchOverlayName, uint32_t unOwnerPid)
+    {
+        const vr::VROverlayHandle_t handle = runtime.nextOverlayHandle++;
+        Overlay &overlay = runtime.overlays[handle];
+        overlay.key = pchOverlayKey;
+        overlay.name = pchOverlayName;
+        overlay.ownerPid = unOwnerPid;
+        return handle;
+    }
+
+    vr::EVROverlayError ValidateNewOverlay(Runtime &runtime, const char *pchOverlayKey, const char *pchOverlayName)
+    {
+        if (!pchOverlayKey || !pchOverlayName)
+            return vr::VROverlayError_InvalidParameter;
+        if (std::strlen(pchOverlayKey) >= vr::k_unVROverlayMaxKeyLength)
+            return vr::VROverlayError_KeyTooLong;
+        if (std::strlen(pchOverlayName) >= vr::k_unVROverlayMaxNameLength)
+            return vr::VROverlayError_NameTooLong;
+        for (const auto &entry : runtime.overlays)
+        {
+            if (!entry.second.isThumbnail && entry.second.key == pchOverlayKey)
+                return vr::VROverlayError_KeyInUse;
+        }
+        return vr::VROverlayError_None;
+    }
+
+    // Looks up an overlay this process may modify.
+    vr::EVROverlayError Writable(Runtime &runtime, vr::VROverlayHandle_t ulOverlayHandle, Overlay **ppOverlay)
+    {
+        *ppOverlay = FindOverlay(runtime, ulOverlayHandle);
+        if (!*ppOverlay)
+            return vr::VROverlayError_UnknownOverlay;
+        if ((*ppOverlay)->ownerPid != k_unMockProcessId)
+            return vr::VROverlayError_PermissionDenied;
+        return vr::VROverlayError_None;
+    }
+
+    // Reads the dimensions out of a PNG header so file-backed overlays report a size.
+    bool ReadPngSize(const char *pchFilePath, uint32_t *pWidth, uint32_t *pHeight)
+    {
+        std::ifstream file(pchFilePath, std::ios::binary);
+        if (!file)
+            return false;
+
+        unsigned char header[24] = {};
+        file.read(reinterpret_cast<char *>(header), sizeof(header));
+        static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        if (file.gcount() == sizeof(header) && std::memcmp(header, signature, sizeof(signature)) == 0)
+        {
+            *pWidth = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+            *pHeight = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+        }
+        return true;
+    }
+
+#define MOCK_ENUM_NAME(name) \
+    case vr::name:           \
+        return #name;
+
+    //=========================================================
+    class MockSystem : public vr::IVRSystem
+    {
+    public:
+        void GetRecommendedRenderTargetSize(uint32_t *pnWidth, uint32_t *pnHeight) override
+        {
+            auto lock = Call();
+            *pnWidth = 2016;
+            *pnHeight = 2240;
+        }
+
+        vr::HmdMatrix44_t GetProjectionMatrix(vr::EVREye eEye, float fNearZ, float fFarZ) override
+        {
+            float left, right, top, bottom;
+            GetProjectionRaw(eEye, &left, &right, &top, &bottom);
+
+            const float idx = 1.0f / (right - left);
+            const float idy = 1.0f / (bottom - top);
+            const float idz = 1.0f / (fFarZ - fNearZ);
+            vr::HmdMatrix44_t result = {{{2.0f * idx, 0.0f, (right + left) * idx, 0.0f},
+                                         {0.0f, 2.0f * idy, (bottom + top) * idy, 0.0f},
+                                         {0.0f, 0.0f, -fFarZ * idz, -fFarZ * fNearZ * idz},
+                                         {0.0f, 0.0f, -1.0f, 0.0f}}};
+            return result;
+        }
+
+        void GetProjectionRaw(vr::EVREye eEye, float *pfLeft, float *pfRight, float *pfTop, float *pfBottom) override
+        {
+            auto lock = Call();
+            *pfLeft = eEye == vr::Eye_Left ? -1.39f : -1.24f;
+            *pfRight = eEye == vr::Eye_Left ? 1.24f : 1.39f;
+            *pfTop = -1.47f;
+            *pfBottom = 1.45f;
+        }
+
+        bool ComputeDistortion(vr::EVREye eEye, float fU, float fV, vr::DistortionCoordinates_t *pDistortionCoordinates) override
+        {
+            auto lock = Call();
+            pDistortionCoordinates->rfRed[0] = pDistortionCoordinates->rfGreen[0] = pDistortionCoordinates->rfBlue[0] = fU;
+            pDistortionCoordinates->rfRed[1] = pDistortionCoordinates->rfGreen[1] = pDistortionCoordinates->rfBlue[1] = fV;
+            return true;
+        }
+
+        vr::HmdMatrix34_t GetEyeToHeadTransform(vr::EVREye eEye) override
+        {
+            auto lock = Call();
+            return Translation(eEye == vr::Eye_Left ? -0.0315f : 0.0315f, 0.0f, 0.0f);
+        }
+
+        bool GetTimeSinceLastVsync(float *pfSecondsSinceLastVsync, uint64_t *pulFrameCounter) override
+        {
+            auto lock = Call();
+            Runtime &runtime = State();
+            const double elapsed = std::chrono::duration<double>(Clock::now() - runtime.epoch).count();
+            const double period = 1.0 / runtime.displayFrequency;
+            const uint64_t frame = static_cast<uint64_t>(elapsed / period);
+            if (pfSecondsSinceLastVsync)
+                *pfSecondsSinceLastVsync = static_cast<float>(elapsed - frame * period);
+            if (pulFrameCounter)
+                *pulFrameCounter = frame;
+            return runtime.hmdPresent;
+        }
+
+        int32_t GetD3D9AdapterIndex() override
+        {
+            auto lock = Call();
+            return 0;
+        }
+
+        void GetDXGIOutputInfo(int32_t *pnAdapterIndex) override
+        {
+            auto lock = Call();
+            *pnAdapterIndex = 0;
+        }
+
+        void GetOutputDevice(uint64_t *pnDevice, vr::ETextureType textureType, VkInstance_T *pInstance) override
+        {
+            auto lock = Call();
+            *pnDevice = 0;
+        }
+
+        bool IsDisplayOnDesktop() override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        bool SetDisplayVisibility(bool bIsVisibleOnDesktop) override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        void GetDeviceToAbsoluteTrackingPose(vr::ETrackingUniverseOrigin eOrigin, float fPredictedSecondsToPhotonsFromNow, vr::TrackedDevicePose_t *pTrackedDevicePoseArray, uint32_t unTrackedDevicePoseArrayCount) override
+        {
+            auto lock = Call();
+            Runtime &runtime = State();
+            const Clock::time_point time = PredictedTime(fPredictedSecondsToPhotonsFromNow);
+            const uint32_t count = std::min(unTrackedDevicePoseArrayCount, vr::k_unMaxTrackedDeviceCount);
+            for (uint32_t idx = 0; idx < count; ++idx)
+                pTrackedDevicePoseArray[idx] = PoseAt(runtime.devices[idx], time, eOrigin);
+        }
+
+        vr::HmdMatrix34_t GetSeatedZeroPoseToStandingAbsoluteTrackingPose() override
+        {
+            auto lock = Call();
+            return k_mSeatedZeroToStanding;
+        }
+
+        vr::HmdMatrix34_t GetRawZeroPoseToStandingAbsoluteTrackingPose() override
+        {
+            auto lock = Call();
+            return k_mIdentity;
+        }
+
+        uint32_t GetSortedTrackedDeviceIndicesOfClass(vr::ETrackedDeviceClass eTrackedDeviceClass, vr::TrackedDeviceIndex_t *punTrackedDeviceIndexArray, uint32_t unTrackedDeviceIndexArrayCount, vr::TrackedDeviceIndex_t unRelativeToTrackedDeviceIndex) override
+        {
+            auto lock = Call();
+            Runtime &runtime = State();
+            uint32_t count = 0;
+            for (vr::TrackedDeviceIndex_t idx = 0; idx < vr::k_unMaxTrackedDeviceCount; ++idx)
+            {
+                const Device &device = runtime.devices[idx];
+                if (!device.connected)
+                    continue;
+                if (eTrackedDeviceClass != vr::TrackedDeviceClass_Invalid && device.deviceClass != eTrackedDeviceClass)
+                    continue;
+                if (punTrackedDeviceIndexArray && count < unTrackedDeviceIndexArrayCount)
+                    punTrackedDeviceIndexArray[count] = idx;
+                ++count;
+            }
+            return count;
+        }
+
+        vr::EDeviceActivityLevel GetTrackedDeviceActivityLevel(vr::TrackedDeviceIndex_t unDeviceId) override
+        {
+            auto lock = Call();
+            if (unDeviceId >= vr::k_unMaxTrackedDeviceCount || !State().devices[unDeviceId].connected)
+                return vr::k_EDeviceActivityLevel_Unknown;
+            return vr::k_EDeviceActivityLevel_UserInteraction;
+        }
+
+        void ApplyTransform(vr::TrackedDevicePose_t *pOutputPose, const vr::TrackedDevicePose_t *pTrackedDevicePose, const vr::HmdMatrix34_t *pTransform) override
+        {
+            auto lock = Call();
+            vr::TrackedDevicePose_t result = *pTrackedDevicePose;
+            result.mDeviceToAbsoluteTracking = Multiply(*pTransform, pTrackedDevicePose->mDeviceToAbsoluteTracking);
+            result.vVelocity = Rotate(*pTransform, pTrackedDevicePose->vVelocity);
+            result.vAngularVelocity = Rotate(*pTransform, pTrackedDevicePose->vAngularVelocity);
+            *pOutputPose = result;
+        }
+
+        vr::TrackedDeviceIndex_t GetTrackedDeviceIndexForControllerRole(vr::ETrackedControllerRole unDeviceType) override
+        {
+            auto lock = Call();
+            Runtime &runtime = State();
+            for (vr::TrackedDeviceIndex_t idx = 0; idx < vr::k_unMaxTrackedDeviceCount; ++idx)
+            {
+                if (runtime.devices[idx].connected && runtime.devices[idx].role == unDeviceType)
+                    return idx;
+            }
+            return vr::k_unTrackedDeviceIndexInvalid;
+        }
+
+        vr::ETrackedControllerRole GetControllerRoleForTrackedDeviceIndex(vr::TrackedDeviceIndex_t unDeviceIndex) override
+        {
+            auto lock = Call();
+            if (unDeviceIndex >= vr::k_unMaxTrackedDeviceCount)
+                return vr::TrackedControllerRole_Invalid;
+            return State().devices[unDeviceIndex].role;
+        }
+
+        vr::ETrackedDeviceClass GetTrackedDeviceClass(vr::TrackedDeviceIndex_t unDeviceIndex) override
+        {
+            auto lock = Call();
+            if (unDeviceIndex >= vr::k_unMaxTrackedDeviceCount)
+                return vr::TrackedDeviceClass_Invalid;
+            return State().devices[unDeviceIndex].deviceClass;
+        }
+
+        bool IsTrackedDeviceConnected(vr::TrackedDeviceIndex_t unDeviceIndex) override
+        {
+            auto lock = Call();
+            return unDeviceIndex < vr::k_unMaxTrackedDeviceCount && State().devices[unDeviceIndex].connected;
+        }
+
+        bool GetBoolTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *pError) override
+        {
+            return ReadProperty<bool>(unDeviceIndex, prop, vr::k_unBoolPropertyTag, pError);
+        }
+
+        float GetFloatTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *pError) override
+        {
+            return ReadProperty<float>(unDeviceIndex, prop, vr::k_unFloatPropertyTag, pError);
+        }
+
+        int32_t GetInt32TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *pError) override
+        {
+            return ReadProperty<int32_t>(unDeviceIndex, prop, vr::k_unInt32PropertyTag, pError);
+        }
+
+        uint64_t GetUint64TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *pError) override
+        {
+            return ReadProperty<uint64_t>(unDeviceIndex, prop, vr::k_unUint64PropertyTag, pError);
+        }
+
+        vr::HmdMatrix34_t GetMatrix34TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *pError) override
+        {
+            return ReadProperty<vr::HmdMatrix34_t>(unDeviceIndex, prop, vr::k_unHmdMatrix34PropertyTag, pError);
+        }
+
+        uint32_t GetArrayTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t propType, void *pBuffer, uint32_t unBufferSize, vr::ETrackedPropertyError *pError) override
+        {
+            auto lock = Call();
+            vr::ETrackedPropertyError error;
+            uint32_t size = 0;
+            const PropertyValue *value = FindProperty(State(), unDeviceIndex, prop, &error);
+            if (value && value->tag != propType)
+            {
+                error = vr::TrackedProp_WrongDataType;
+            }
+            else if (value)
+            {
+                size = static_cast<uint32_t>(value->data.size());
+                if (!pBuffer || unBufferSize < size)
+                    error = vr::TrackedProp_BufferTooSmall;
+                else
+                    std::memcpy(pBuffer, value->data.data(), size);
+            }
+
+            if (pError)
+                *pError = error;
+            return size;
+        }
+
+        uint32_t GetStringTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, char *pchValue, uint32_t unBufferSize, vr::ETrackedPropertyError *pError) override
+        {
+            auto lock = Call();
+            vr::ETrackedPropertyError error;
+            uint32_t size = 0;
+            const PropertyValue *value = FindProperty(State(), unDeviceIndex, prop, &error);
+            if (value && value->tag != vr::k_unStringPropertyTag)
+            {
+                error = vr::TrackedProp_WrongDataType;
+            }
+            else if (value)
+            {
+                size = static_cast<uint32_t>(value->data.size());
+                if (!pchValue || unBufferSize < size)
+                    error = vr::TrackedProp_BufferTooSmall;
+                else
+                    std::memcpy(pchValue, value->data.data(), size);
+            }
+
+            if (error != vr::TrackedProp_Success && pchValue && unBufferSize > 0)
+                pchValue[0] = '\0';
+            if (pError)
+                *pError = error;
+            return size;
+        }
+
+        const char *GetPropErrorNameFromEnum(vr::ETrackedPropertyError error) override
+        {
+            auto lock = Call();
+            switch (error)
+            {
+                MOCK_ENUM_NAME(TrackedProp_Success)
+                MOCK_ENUM_NAME(TrackedProp_WrongDataType)
+                MOCK_ENUM_NAME(TrackedProp_WrongDeviceClass)
+                MOCK_ENUM_NAME(TrackedProp_BufferTooSmall)
+                MOCK_ENUM_NAME(TrackedProp_UnknownProperty)
+                MOCK_ENUM_NAME(TrackedProp_InvalidDevice)
+                MOCK_ENUM_NAME(TrackedProp_CouldNotContactServer)
+                MOCK_ENUM_NAME(TrackedProp_ValueNotProvidedByDevice)
+                MOCK_ENUM_NAME(TrackedProp_StringExceedsMaximumLength)
+                MOCK_ENUM_NAME(TrackedProp_NotYetAvailable)
+                MOCK_ENUM_NAME(TrackedProp_PermissionDenied)
+                MOCK_ENUM_NAME(TrackedProp_InvalidOperation)
+                MOCK_ENUM_NAME(TrackedProp_CannotWriteToWildcards)
+                MOCK_ENUM_NAME(TrackedProp_IPCReadFailure)
+                MOCK_ENUM_NAME(TrackedProp_OutOfMemory)
+                MOCK_ENUM_NAME(TrackedProp_InvalidContainer)
+            default:
+                return "Unknown";
+            }
+        }
+
+        bool PollNextEvent(vr::VREvent_t *pEvent, uint32_t uncbVREvent) override
+        {
+            auto lock = Call();
+            Runtime &runtime = State();
+            if (runtime.events.empty())
+                return false;
+
+            std::memcpy(pEvent, &runtime.events.front(), std::min<size_t>(uncbVREvent, sizeof(vr::VREvent_t)));
+            runtime.events.pop_front();
+            return true;
+        }
+
+        bool PollNextEventWithPose(vr::ETrackingUniverseOrigin eOrigin, vr::VREvent_t *pEvent, uint32_t uncbVREvent, vr::TrackedDevicePose_t *pTrackedDevicePose) override
+        {
+            auto lock = Call();
+            Runtime &runtime = State();
+            if (runtime.events.empty())
+                return false;
+
+            const vr::VREvent_t &event = runtime.events.front();
+            std::memcpy(pEvent, &event, std::min<size_t>(uncbVREvent, sizeof(vr::VREvent_t)));
+            if (pTrackedDevicePose && event.trackedDeviceIndex < vr::k_unMaxTrackedDeviceCount)
+                *pTrackedDevicePose = PoseAt(runtime.devices[event.trackedDeviceIndex], Clock::now(), eOrigin);
+            runtime.events.pop_front();
+            return true;
+        }
+
+        const char *GetEventTypeNameFromEnum(vr::EVREventType eType) override
+        {
+            auto lock = Call();
+            switch (eType)
+            {
+                MOCK_ENUM_NAME(VREvent_None)
+                MOCK_ENUM_NAME(VREvent_TrackedDeviceActivated)
+                MOCK_ENUM_NAME(VREvent_TrackedDeviceDeactivated)
+                MOCK_ENUM_NAME(VREvent_TrackedDeviceUpdated)
+                MOCK_ENUM_NAME(VREvent_PropertyChanged)
+                MOCK_ENUM_NAME(VREvent_ButtonPress)
+                MOCK_ENUM_NAME(VREvent_ButtonUnpress)
+                MOCK_ENUM_NAME(VREvent_ButtonTouch)
+                MOCK_ENUM_NAME(VREvent_ButtonUntouch)
+                MOCK_ENUM_NAME(VREvent_MouseMove)
+                MOCK_ENUM_NAME(VREvent_MouseButtonDown)
+                MOCK_ENUM_NAME(VREvent_MouseButtonUp)
+                MOCK_ENUM_NAME(VREvent_ScrollDiscrete)
+                MOCK_ENUM_NAME(VREvent_ScrollSmooth)
+                MOCK_ENUM_NAME(VREvent_Quit)
+            default:
+                return "Unknown";
+            }
+        }
+
+        vr::HiddenAreaMesh_t GetHiddenAreaMesh(vr::EVREye eEye, vr::EHiddenAreaMeshType type) override
+        {
+            auto lock = Call();
+            vr::HiddenAreaMesh_t mesh = {nullptr, 0};
+            return mesh;
+        }
+
+        bool GetControllerState(vr::TrackedDeviceIndex_t unControllerDeviceIndex, vr::VRControllerState_t *pControllerState, uint32_t unControllerStateSize) override
+        {
+            auto lock = Call();
+            Runtime &runtime = State();
+            if (unControllerDeviceIndex >= vr::k_unMaxTrackedDeviceCount || !runtime.devices[unControllerDeviceIndex].connected)
+                return false;
+
+            std::memcpy(pControllerState, &runtime.devices[unControllerDeviceIndex].controllerState,
+                        std::min<size_t>(unControllerStateSize, sizeof(vr::VRControllerState_t)));
+            return true;
+        }
+
+        bool GetControllerStateWithPose(vr::ETrackingUniverseOrigin eOrigin, vr::TrackedDeviceIndex_t unControllerDeviceIndex, vr::VRControllerState_t *pControllerState, uint32_t unControllerStateSize, vr::TrackedDevicePose_t *pTrackedDevicePose) override
+        {
+            if (!GetControllerState(unControllerDeviceIndex, pControllerState, unControllerStateSize))
+                return false;
+
+            std::lock_guard<std::mutex> lock(State().mutex);
+            if (pTrackedDevicePose)
+                *pTrackedDevicePose = PoseAt(State().devices[unControllerDeviceIndex], Clock::now(), eOrigin);
+            return true;
+        }
+
+        void TriggerHapticPulse(vr::TrackedDeviceIndex_t unControllerDeviceIndex, uint32_t unAxisId, unsigned short usDurationMicroSec) override
+        {
+            auto lock = Call();
+        }
+
+        const char *GetButtonIdNameFromEnum(vr::EVRButtonId eButtonId) override
+        {
+            auto lock = Call();
+            switch (eButtonId)
+            {
+                MOCK_ENUM_NAME(k_EButton_System)
+                MOCK_ENUM_NAME(k_EButton_ApplicationMenu)
+                MOCK_ENUM_NAME(k_EButton_Grip)
+                MOCK_ENUM_NAME(k_EButton_A)
+                MOCK_ENUM_NAME(k_EButton_Axis0)
+                MOCK_ENUM_NAME(k_EButton_Axis1)
+            default:
+                return "Unknown";
+            }
+        }
+
+        const char *GetControllerAxisTypeNameFromEnum(vr::EVRControllerAxisType eAxisType) override
+        {
+            auto lock = Call();
+            switch (eAxisType)
+            {
+                MOCK_ENUM_NAME(k_eControllerAxis_None)
+                MOCK_ENUM_NAME(k_eControllerAxis_TrackPad)
+                MOCK_ENUM_NAME(k_eControllerAxis_Joystick)
+                MOCK_ENUM_NAME(k_eControllerAxis_Trigger)
+            default:
+                return "Unknown";
+            }
+        }
+
+        bool IsInputAvailable() override
+        {
+            auto lock = Call();
+            return true;
+        }
+
+        bool IsSteamVRDrawingControllers() override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        bool ShouldApplicationPause() override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        bool ShouldApplicationReduceRenderingWork() override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        vr::EVRFirmwareError PerformFirmwareUpdate(vr::TrackedDeviceIndex_t unDeviceIndex) override
+        {
+            auto lock = Call();
+            return vr::VRFirmwareError_None;
+        }
+
+        void AcknowledgeQuit_Exiting() override
+        {
+            auto lock = Call();
+        }
+
+        uint32_t GetAppContainerFilePaths(char *pchBuffer, uint32_t unBufferSize) override
+        {
+            auto lock = Call();
+            return CopyString("", pchBuffer, unBufferSize);
+        }
+
+        const char *GetRuntimeVersion() override
+        {
+            auto lock = Call();
+            return "mock";
+        }
+    };
+
+    //=========================================================
+    class MockOverlay : public vr::IVROverlay
+    {
+    public:
+        vr::EVROverlayError FindOverlay(const char *pchOverlayKey, vr::VROverlayHandle_t *pOverlayHandle) override
+        {
+            auto lock = Call();
+            *pOverlayHandle = vr::k_ulOverlayHandleInvalid;
+            for (const auto &entry : State().overlays)
+            {
+                if (!entry.second.isThumbnail && entry.second.key == pchOverlayKey)
+                {
+                    *pOverlayHandle = entry.first;
+                    return vr::VROverlayError_None;
+                }
+            }
+            return vr::VROverlayError_UnknownOverlay;
+        }
+
+        vr::EVROverlayError CreateOverlay(const char *pchOverlayKey, const char *pchOverlayName, vr::VROverlayHandle_t *pOverlayHandle) override
+        {
+            auto lock = Call();
+            Runtime &runtime = State();
+            *pOverlayHandle = vr::k_ulOverlayHandleInvalid;
+            const vr::EVROverlayError error = ValidateNewOverlay(runtime, pchOverlayKey, pchOverlayName);
+            if (error == vr::VROverlayError_None)
+                *pOverlayHandle = AddOverlay(runtime, pchOverlayKey, pchOverlayName, k_unMockProcessId);
+            return error;
+        }
+
+        vr::EVROverlayError DestroyOverlay(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            auto lock = Call();
+            Runtime &runtime = State();
+            Overlay *overlay;
+            const vr::EVROverlayError error = Writable(runtime, ulOverlayHandle, &overlay);
+            if (error != vr::VROverlayError_None)
+                return error;
+            if (overlay->isThumbnail)
+                return vr::VROverlayError_ThumbnailCantBeDestroyed;
+
+            runtime.overlays.erase(overlay->thumbnail);
+            runtime.overlays.erase(ulOverlayHandle);
+            return vr::VROverlayError_None;
+        }
+
+        uint32_t GetOverlayKey(vr::VROverlayHandle_t ulOverlayHandle, char *pchValue, uint32_t unBufferSize, vr::EVROverlayError *pError) override
+        {
+            auto lock = Call();
+            const Overlay *overlay = ::FindOverlay(State(), ulOverlayHandle);
+            if (pError)
+                *pError = overlay ? vr::VROverlayError_None : vr::VROverlayError_UnknownOverlay;
+            return CopyString(overlay ? overlay->key : "", pchValue, unBufferSize);
+        }
+
+        uint32_t GetOverlayName(vr::VROverlayHandle_t ulOverlayHandle, char *pchValue, uint32_t unBufferSize, vr::EVROverlayError *pError) override
+        {
+            auto lock = Call();
+            const Overlay *overlay = ::FindOverlay(State(), ulOverlayHandle);
+            if (pError)
+                *pError = overlay ? vr::VROverlayError_None : vr::VROverlayError_UnknownOverlay;
+            return CopyString(overlay ? overlay->name : "", pchValue, unBufferSize);
+        }
+
+        vr::EVROverlayError SetOverlayName(vr::VROverlayHandle_t ulOverlayHandle, const char *pchName) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.name = pchName; });
+        }
+
+        vr::EVROverlayError GetOverlayImageData(vr::VROverlayHandle_t ulOverlayHandle, void *pvBuffer, uint32_t unBufferSize, uint32_t *punWidth, uint32_t *punHeight) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *punWidth = overlay.textureWidth;
+                *punHeight = overlay.textureHeight;
+                return unBufferSize < overlay.textureWidth * overlay.textureHeight * 4 ? vr::VROverlayError_ArrayTooSmall : vr::VROverlayError_None;
+            });
+        }
+
+        const char *GetOverlayErrorNameFromEnum(vr::EVROverlayError error) override
+        {
+            auto lock = Call();
+            switch (error)
+            {
+                MOCK_ENUM_NAME(VROverlayError_None)
+                MOCK_ENUM_NAME(VROverlayError_UnknownOverlay)
+                MOCK_ENUM_NAME(VROverlayError_InvalidHandle)
+                MOCK_ENUM_NAME(VROverlayError_PermissionDenied)
+                MOCK_ENUM_NAME(VROverlayError_OverlayLimitExceeded)
+                MOCK_ENUM_NAME(VROverlayError_WrongVisibilityType)
+                MOCK_ENUM_NAME(VROverlayError_KeyTooLong)
+                MOCK_ENUM_NAME(VROverlayError_NameTooLong)
+                MOCK_ENUM_NAME(VROverlayError_KeyInUse)
+                MOCK_ENUM_NAME(VROverlayError_WrongTransformType)
+                MOCK_ENUM_NAME(VROverlayError_InvalidTrackedDevice)
+                MOCK_ENUM_NAME(VROverlayError_InvalidParameter)
+                MOCK_ENUM_NAME(VROverlayError_ThumbnailCantBeDestroyed)
+                MOCK_ENUM_NAME(VROverlayError_ArrayTooSmall)
+                MOCK_ENUM_NAME(VROverlayError_RequestFailed)
+                MOCK_ENUM_NAME(VROverlayError_InvalidTexture)
+                MOCK_ENUM_NAME(VROverlayError_UnableToLoadFile)
+                MOCK_ENUM_NAME(VROverlayError_KeyboardAlreadyInUse)
+                MOCK_ENUM_NAME(VROverlayError_NoNeighbor)
+                MOCK_ENUM_NAME(VROverlayError_TooManyMaskPrimitives)
+                MOCK_ENUM_NAME(VROverlayError_BadMaskPrimitive)
+                MOCK_ENUM_NAME(VROverlayError_TextureAlreadyLocked)
+                MOCK_ENUM_NAME(VROverlayError_TextureLockCapacityReached)
+                MOCK_ENUM_NAME(VROverlayError_TextureNotLocked)
+            default:
+                return "Unknown";
+            }
+        }
+
+        vr::EVROverlayError SetOverlayRenderingPid(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unPID) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.renderingPid = unPID; });
+        }
+
+        uint32_t GetOverlayRenderingPid(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            uint32_t pid = 0;
+            Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                pid = overlay.renderingPid;
+                return vr::VROverlayError_None;
+            });
+            return pid;
+        }
+
+        vr::EVROverlayError SetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayFlags eOverlayFlag, bool bEnabled) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {
+                if (bEnabled)
+                    overlay.flags |= eOverlayFlag;
+                else
+                    overlay.flags &= ~static_cast<uint32_t>(eOverlayFlag);
+            });
+        }
+
+        vr::EVROverlayError GetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayFlags eOverlayFlag, bool *pbEnabled) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *pbEnabled = (overlay.flags & eOverlayFlag) != 0;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayFlags(vr::VROverlayHandle_t ulOverlayHandle, uint32_t *pFlags) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *pFlags = overlay.flags;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayColor(vr::VROverlayHandle_t ulOverlayHandle, float fRed, float fGreen, float fBlue) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {
+                overlay.red = fRed;
+                overlay.green = fGreen;
+                overlay.blue = fBlue;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayColor(vr::VROverlayHandle_t ulOverlayHandle, float *pfRed, float *pfGreen, float *pfBlue) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *pfRed = overlay.red;
+                *pfGreen = overlay.green;
+                *pfBlue = overlay.blue;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayAlpha(vr::VROverlayHandle_t ulOverlayHandle, float fAlpha) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.alpha = fAlpha; });
+        }
+
+        vr::EVROverlayError GetOverlayAlpha(vr::VROverlayHandle_t ulOverlayHandle, float *pfAlpha) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *pfAlpha = overlay.alpha;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTexelAspect(vr::VROverlayHandle_t ulOverlayHandle, float fTexelAspect) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.texelAspect = fTexelAspect; });
+        }
+
+        vr::EVROverlayError GetOverlayTexelAspect(vr::VROverlayHandle_t ulOverlayHandle, float *pfTexelAspect) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *pfTexelAspect = overlay.texelAspect;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlaySortOrder(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unSortOrder) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.sortOrder = unSortOrder; });
+        }
+
+        vr::EVROverlayError GetOverlaySortOrder(vr::VROverlayHandle_t ulOverlayHandle, uint32_t *punSortOrder) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *punSortOrder = overlay.sortOrder;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayWidthInMeters(vr::VROverlayHandle_t ulOverlayHandle, float fWidthInMeters) override
+        {
+            if (fWidthInMeters < 0.0f)
+            {
+                auto lock = Call();
+                return vr::VROverlayError_InvalidParameter;
+            }
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.widthInMeters = fWidthInMeters; });
+        }
+
+        vr::EVROverlayError GetOverlayWidthInMeters(vr::VROverlayHandle_t ulOverlayHandle, float *pfWidthInMeters) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *pfWidthInMeters = overlay.widthInMeters;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayCurvature(vr::VROverlayHandle_t ulOverlayHandle, float fCurvature) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.curvature = fCurvature; });
+        }
+
+        vr::EVROverlayError GetOverlayCurvature(vr::VROverlayHandle_t ulOverlayHandle, float *pfCurvature) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *pfCurvature = overlay.curvature;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTextureColorSpace(vr::VROverlayHandle_t ulOverlayHandle, vr::EColorSpace eTextureColorSpace) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.colorSpace = eTextureColorSpace; });
+        }
+
+        vr::EVROverlayError GetOverlayTextureColorSpace(vr::VROverlayHandle_t ulOverlayHandle, vr::EColorSpace *peTextureColorSpace) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *peTextureColorSpace = overlay.colorSpace;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTextureBounds(vr::VROverlayHandle_t ulOverlayHandle, const vr::VRTextureBounds_t *pOverlayTextureBounds) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.textureBounds = *pOverlayTextureBounds; });
+        }
+
+        vr::EVROverlayError GetOverlayTextureBounds(vr::VROverlayHandle_t ulOverlayHandle, vr::VRTextureBounds_t *pOverlayTextureBounds) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *pOverlayTextureBounds = overlay.textureBounds;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTransformType(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayTransformType *peTransformType) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *peTransformType = overlay.transformType;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTransformAbsolute(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin, const vr::HmdMatrix34_t *pmatTrackingOriginToOverlayTransform) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {
+                overlay.transformType = vr::VROverlayTransform_Absolute;
+                overlay.trackingOrigin = eTrackingOrigin;
+                overlay.transform = *pmatTrackingOriginToOverlayTransform;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTransformAbsolute(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin *peTrackingOrigin, vr::HmdMatrix34_t *pmatTrackingOriginToOverlayTransform) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                if (overlay.transformType != vr::VROverlayTransform_Absolute)
+                    return vr::VROverlayError_WrongTransformType;
+                *peTrackingOrigin = overlay.trackingOrigin;
+                *pmatTrackingOriginToOverlayTransform = overlay.transform;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t unTrackedDevice, const vr::HmdMatrix34_t *pmatTrackedDeviceToOverlayTransform) override
+        {
+            if (unTrackedDevice >= vr::k_unMaxTrackedDeviceCount)
+            {
+                auto lock = Call();
+                return vr::VROverlayError_InvalidTrackedDevice;
+            }
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {
+                overlay.transformType = vr::VROverlayTransform_TrackedDeviceRelative;
+                overlay.trackedDevice = unTrackedDevice;
+                overlay.transform = *pmatTrackedDeviceToOverlayTransform;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t *punTrackedDevice, vr::HmdMatrix34_t *pmatTrackedDeviceToOverlayTransform) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                if (overlay.transformType != vr::VROverlayTransform_TrackedDeviceRelative)
+                    return vr::VROverlayError_WrongTransformType;
+                *punTrackedDevice = overlay.trackedDevice;
+                *pmatTrackedDeviceToOverlayTransform = overlay.transform;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTransformTrackedDeviceComponent(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t unDeviceIndex, const char *pchComponentName) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {
+                overlay.transformType = vr::VROverlayTransform_TrackedComponent;
+                overlay.trackedDevice = unDeviceIndex;
+                overlay.componentName = pchComponentName;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTransformTrackedDeviceComponent(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t *punDeviceIndex, char *pchComponentName, uint32_t unComponentNameSize) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                if (overlay.transformType != vr::VROverlayTransform_TrackedComponent)
+                    return vr::VROverlayError_WrongTransformType;
+                *punDeviceIndex = overlay.trackedDevice;
+                if (CopyString(overlay.componentName, pchComponentName, unComponentNameSize) > unComponentNameSize)
+                    return vr::VROverlayError_ArrayTooSmall;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTransformOverlayRelative(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayHandle_t *ulOverlayHandleParent, vr::HmdMatrix34_t *pmatParentOverlayToOverlayTransform) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                if (overlay.transformType != k_eOverlayRelativeTransform)
+                    return vr::VROverlayError_WrongTransformType;
+                *ulOverlayHandleParent = overlay.parent;
+                *pmatParentOverlayToOverlayTransform = overlay.transform;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTransformOverlayRelative(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayHandle_t ulOverlayHandleParent, const vr::HmdMatrix34_t *pmatParentOverlayToOverlayTransform) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {
+                overlay.transformType = k_eOverlayRelativeTransform;
+                overlay.parent = ulOverlayHandleParent;
+                overlay.transform = *pmatParentOverlayToOverlayTransform;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTransformCursor(vr::VROverlayHandle_t ulCursorOverlayHandle, const vr::HmdVector2_t *pvHotspot) override
+        {
+            return Set(ulCursorOverlayHandle, [&](Overlay &overlay) {
+                overlay.transformType = vr::VROverlayTransform_Cursor;
+                overlay.cursorHotspot = *pvHotspot;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTransformCursor(vr::VROverlayHandle_t ulOverlayHandle, vr::HmdVector2_t *pvHotspot) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                if (overlay.transformType != vr::VROverlayTransform_Cursor)
+                    return vr::VROverlayError_WrongTransformType;
+                *pvHotspot = overlay.cursorHotspot;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayTransformProjection(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin, const vr::HmdMatrix34_t *pmatTrackingOriginToOverlayTransform, const vr::VROverlayProjection_t *pProjection, vr::EVREye eEye) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {
+                overlay.transformType = vr::VROverlayTransform_Projection;
+                overlay.trackingOrigin = eTrackingOrigin;
+                overlay.transform = *pmatTrackingOriginToOverlayTransform;
+            });
+        }
+
+        vr::EVROverlayError ShowOverlay(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.visible = true; });
+        }
+
+        vr::EVROverlayError HideOverlay(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.visible = false; });
+        }
+
+        bool IsOverlayVisible(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            bool visible = false;
+            Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                visible = overlay.visible;
+                return vr::VROverlayError_None;
+            });
+            return visible;
+        }
+
+        vr::EVROverlayError GetTransformForOverlayCoordinates(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin, vr::HmdVector2_t coordinatesInOverlay, vr::HmdMatrix34_t *pmatTransform) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                const float height = overlay.widthInMeters * AspectOf(overlay);
+                const float x = (coordinatesInOverlay.v[0] / overlay.mouseScale.v[0] - 0.5f) * overlay.widthInMeters;
+                const float y = (coordinatesInOverlay.v[1] / overlay.mouseScale.v[1] - 0.5f) * height;
+                *pmatTransform = Multiply(overlay.transform, Translation(x, y, 0.0f));
+                return vr::VROverlayError_None;
+            });
+        }
+
+        bool PollNextOverlayEvent(vr::VROverlayHandle_t ulOverlayHandle, vr::VREvent_t *pEvent, uint32_t uncbVREvent) override
+        {
+            auto lock = Call();
+            Overlay *overlay = ::FindOverlay(State(), ulOverlayHandle);
+            if (!overlay || overlay->events.empty())
+                return false;
+
+            std::memcpy(pEvent, &overlay->events.front(), std::min<size_t>(uncbVREvent, sizeof(vr::VREvent_t)));
+            overlay->events.pop_front();
+            return true;
+        }
+
+        vr::EVROverlayError GetOverlayInputMethod(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayInputMethod *peInputMethod) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *peInputMethod = overlay.inputMethod;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayInputMethod(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayInputMethod eInputMethod) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.inputMethod = eInputMethod; });
+        }
+
+        vr::EVROverlayError GetOverlayMouseScale(vr::VROverlayHandle_t ulOverlayHandle, vr::HmdVector2_t *pvecMouseScale) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *pvecMouseScale = overlay.mouseScale;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayMouseScale(vr::VROverlayHandle_t ulOverlayHandle, const vr::HmdVector2_t *pvecMouseScale) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.mouseScale = *pvecMouseScale; });
+        }
+
+        // Intersects the ray with the overlay's plane, treating it as a flat quad.
+        bool ComputeOverlayIntersection(vr::VROverlayHandle_t ulOverlayHandle, const vr::VROverlayIntersectionParams_t *pParams, vr::VROverlayIntersectionResults_t *pResults) override
+        {
+            bool hit = false;
+            Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                const vr::HmdMatrix34_t &m = overlay.transform;
+                vr::HmdVector3_t normal = {{m.m[0][2], m.m[1][2], m.m[2][2]}};
+                vr::HmdVector3_t origin = {{m.m[0][3], m.m[1][3], m.m[2][3]}};
+                const vr::HmdVector3_t &dir = pParams->vDirection;
+                const vr::HmdVector3_t &src = pParams->vSource;
+
+                const float denom = normal.v[0] * dir.v[0] + normal.v[1] * dir.v[1] + normal.v[2] * dir.v[2];
+                if (std::fabs(denom) < 1e-6f)
+                    return vr::VROverlayError_None;
+
+                const float t = ((origin.v[0] - src.v[0]) * normal.v[0] + (origin.v[1] - src.v[1]) * normal.v[1] + (origin.v[2] - src.v[2]) * normal.v[2]) / denom;
+                if (t < 0.0f)
+                    return vr::VROverlayError_None;
+
+                vr::HmdVector3_t point = {{src.v[0] + dir.v[0] * t, src.v[1] + dir.v[1] * t, src.v[2] + dir.v[2] * t}};
+                vr::HmdVector3_t local = {{point.v[0] - origin.v[0], point.v[1] - origin.v[1], point.v[2] - origin.v[2]}};
+                const float x = local.v[0] * m.m[0][0] + local.v[1] * m.m[1][0] + local.v[2] * m.m[2][0];
+                const float y = local.v[0] * m.m[0][1] + local.v[1] * m.m[1][1] + local.v[2] * m.m[2][1];
+                const float height = overlay.widthInMeters * AspectOf(overlay);
+
+                pResults->vPoint = point;
+                pResults->vNormal = normal;
+                pResults->vUVs.v[0] = x / overlay.widthInMeters + 0.5f;
+                pResults->vUVs.v[1] = y / height + 0.5f;
+                pResults->fDistance = t;
+                hit = std::fabs(x) <= overlay.widthInMeters * 0.5f && std::fabs(y) <= height * 0.5f;
+                return vr::VROverlayError_None;
+            });
+            return hit;
+        }
+
+        bool IsHoverTargetOverlay(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        vr::EVROverlayError SetOverlayIntersectionMask(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayIntersectionMaskPrimitive_t *pMaskPrimitives, uint32_t unNumMaskPrimitives, uint32_t unPrimitiveSize) override
+        {
+            if (unNumMaskPrimitives > vr::k_unMaxOverlayIntersectionMaskPrimitivesCount)
+            {
+                auto lock = Call();
+                return vr::VROverlayError_TooManyMaskPrimitives;
+            }
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {});
+        }
+
+        vr::EVROverlayError TriggerLaserMouseHapticVibration(vr::VROverlayHandle_t ulOverlayHandle, float fDurationSeconds, float fFrequency, float fAmplitude) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {});
+        }
+
+        vr::EVROverlayError SetOverlayCursor(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayHandle_t ulCursorHandle) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {});
+        }
+
+        vr::EVROverlayError SetOverlayCursorPositionOverride(vr::VROverlayHandle_t ulOverlayHandle, const vr::HmdVector2_t *pvCursor) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {});
+        }
+
+        vr::EVROverlayError ClearOverlayCursorPositionOverride(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {});
+        }
+
+        vr::EVROverlayError SetOverlayTexture(vr::VROverlayHandle_t ulOverlayHandle, const vr::Texture_t *pTexture) override
+        {
+            if (!pTexture || !pTexture->handle)
+            {
+                auto lock = Call();
+                return vr::VROverlayError_InvalidTexture;
+            }
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {});
+        }
+
+        vr::EVROverlayError ClearOverlayTexture(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {
+                overlay.textureWidth = 0;
+                overlay.textureHeight = 0;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayRaw(vr::VROverlayHandle_t ulOverlayHandle, void *pvBuffer, uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel) override
+        {
+            if (!pvBuffer || unWidth == 0 || unHeight == 0 || (unBytesPerPixel != 1 && unBytesPerPixel != 3 && unBytesPerPixel != 4))
+            {
+                auto lock = Call();
+                return vr::VROverlayError_InvalidParameter;
+            }
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {
+                overlay.textureWidth = unWidth;
+                overlay.textureHeight = unHeight;
+                State().overlayUploads += 1;
+                State().overlayUploadBytes += static_cast<uint64_t>(unWidth) * unHeight * unBytesPerPixel;
+            });
+        }
+
+        vr::EVROverlayError SetOverlayFromFile(vr::VROverlayHandle_t ulOverlayHandle, const char *pchFilePath) override
+        {
+            uint32_t width = 0, height = 0;
+            if (!pchFilePath || !ReadPngSize(pchFilePath, &width, &height))
+            {
+                auto lock = Call();
+                return vr::VROverlayError_UnableToLoadFile;
+            }
+            return Set(ulOverlayHandle, [&](Overlay &overlay) {
+                overlay.textureWidth = width;
+                overlay.textureHeight = height;
+                State().overlayFileLoads += 1;
+            });
+        }
+
+        vr::EVROverlayError GetOverlayTexture(vr::VROverlayHandle_t ulOverlayHandle, void **pNativeTextureHandle, void *pNativeTextureRef, uint32_t *pWidth, uint32_t *pHeight, uint32_t *pNativeFormat, vr::ETextureType *pAPIType, vr::EColorSpace *pColorSpace, vr::VRTextureBounds_t *pTextureBounds) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) { return vr::VROverlayError_InvalidTexture; });
+        }
+
+        vr::EVROverlayError ReleaseNativeOverlayHandle(vr::VROverlayHandle_t ulOverlayHandle, void *pNativeTextureHandle) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) { return vr::VROverlayError_None; });
+        }
+
+        vr::EVROverlayError GetOverlayTextureSize(vr::VROverlayHandle_t ulOverlayHandle, uint32_t *pWidth, uint32_t *pHeight) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *pWidth = overlay.textureWidth;
+                *pHeight = overlay.textureHeight;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        vr::EVROverlayError CreateDashboardOverlay(const char *pchOverlayKey, const char *pchOverlayFriendlyName, vr::VROverlayHandle_t *pMainHandle, vr::VROverlayHandle_t *pThumbnailHandle) override
+        {
+            auto lock = Call();
+            Runtime &runtime = State();
+            *pMainHandle = *pThumbnailHandle = vr::k_ulOverlayHandleInvalid;
+            const vr::EVROverlayError error = ValidateNewOverlay(runtime, pchOverlayKey, pchOverlayFriendlyName);
+            if (error != vr::VROverlayError_None)
+                return error;
+
+            *pMainHandle = AddOverlay(runtime, pchOverlayKey, pchOverlayFriendlyName, k_unMockProcessId);
+            *pThumbnailHandle = AddOverlay(runtime, pchOverlayKey, pchOverlayFriendlyName, k_unMockProcessId);
+            runtime.overlays[*pMainHandle].thumbnail = *pThumbnailHandle;
+            runtime.overlays[*pThumbnailHandle].isThumbnail = true;
+            return vr::VROverlayError_None;
+        }
+
+        bool IsDashboardVisible() override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        bool IsActiveDashboardOverlay(vr::VROverlayHandle_t ulOverlayHandle) override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        vr::EVROverlayError SetDashboardOverlaySceneProcess(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unProcessId) override
+        {
+            return Set(ulOverlayHandle, [&](Overlay &overlay) { overlay.sceneProcess = unProcessId; });
+        }
+
+        vr::EVROverlayError GetDashboardOverlaySceneProcess(vr::VROverlayHandle_t ulOverlayHandle, uint32_t *punProcessId) override
+        {
+            return Get(ulOverlayHandle, [&](const Overlay &overlay) {
+                *punProcessId = overlay.sceneProcess;
+                return vr::VROverlayError_None;
+            });
+        }
+
+        void ShowDashboard(const char *pchOverlayToShow) override
+        {
+            auto lock = Call();
+        }
+
+        vr::TrackedDeviceIndex_t GetPrimaryDashboardDevice() override
+        {
+            auto lock = Call();
+            return vr::k_unTrackedDeviceIndex_Hmd;
+        }
+
+        vr::EVROverlayError ShowKeyboard(vr::EGamepadTextInputMode eInputMode, vr::EGamepadTextInputLineMode eLineInputMode, uint32_t unFlags, const char *pchDescription, uint32_t unCharMax, const char *pchExistingText, uint64_t uUserValue) override
+        {
+            auto lock = Call();
+            Runtime &runtime = State();
+            if (runtime.keyboardVisible)
+                return vr::VROverlayError_KeyboardAlreadyInUse;
+
+            runtime.keyboardVisible = true;
+            runtime.keyboardText = pchExistingText ? pchExistingText : "";
+            return vr::VROverlayError_None;
+        }
+
+        vr::EVROverlayError ShowKeyboardForOverlay(vr::VROverlayHandle_t ulOverlayHandle, vr::EGamepadTextInputMode eInputMode, vr::EGamepadTextInputLineMode eLineInputMode, uint32_t unFlags, const char *pchDescription, uint32_t unCharMax, const char *pchExistingText, uint64_t uUserValue) override
+        {
+            {
+                auto lock = Call();
+                if (!::FindOverlay(State(), ulOverlayHandle))
+                    return vr::VROverlayError_UnknownOverlay;
+            }
+            return ShowKeyboard(eInputMode, eLineInputMode, unFlags, pchDescription, unCharMax, pchExistingText, uUserValue);
+        }
+
+        uint32_t GetKeyboardText(char *pchText, uint32_t cchText) override
+        {
+            auto lock = Call();
+            return CopyString(State().keyboardText, pchText, cchText);
+        }
+
+        void HideKeyboard() override
+        {
+            auto lock = Call();
+            State().keyboardVisible = false;
+        }
+
+        void SetKeyboardTransformAbsolute(vr::ETrackingUniverseOrigin eTrackingOrigin, const vr::HmdMatrix34_t *pmatTrackingOriginToKeyboardTransform) override
+        {
+            auto lock = Call();
+        }
+
+        void SetKeyboardPositionForOverlay(vr::VROverlayHandle_t ulOverlayHandle, vr::HmdRect2_t avoidRect) override
+        {
+            auto lock = Call();
+        }
+
+        vr::VRMessageOverlayResponse ShowMessageOverlay(const char *pchText, const char *pchCaption, const char *pchButton0Text, const char *pchButton1Text, const char *pchButton2Text, const char *pchButton3Text) override
+        {
+            auto lock = Call();
+            return vr::VRMessageOverlayResponse_ButtonPress_0;
+        }
+
+        void CloseMessageOverlay() override
+        {
+            auto lock = Call();
+        }
+
+    private:
+        static float AspectOf(const Overlay &overlay)
+        {
+            if (overlay.textureWidth == 0 || overlay.textureHeight == 0)
+                return 1.0f;
+            return overlay.texelAspect * overlay.textureHeight / overlay.textureWidth;
+        }
+
+        template <typename Fn>
+        static vr::EVROverlayError Set(vr::VROverlayHandle_t ulOverlayHandle, Fn apply)
+        {
+            auto lock = Call();
+            Overlay *overlay;
+            const vr::EVROverlayError error = Writable(State(), ulOverlayHandle, &overlay);
+            if (error == vr::VROverlayError_None)
+                apply(*overlay);
+            return error;
+        }
+
+        template <typename Fn>
+        static vr::EVROverlayError Get(vr::VROverlayHandle_t ulOverlayHandle, Fn read)
+        {
+            auto lock = Call();
+            const Overlay *overlay = ::FindOverlay(State(), ulOverlayHandle);
+            if (!overlay)
+                return vr::VROverlayError_UnknownOverlay;
+            return read(*overlay);
+        }
+    };
+
+    //=========================================================
+    class MockApplications : public vr::IVRApplications
+    {
+    public:
+        vr::EVRApplicationError AddApplicationManifest(const char *pchApplicationManifestFullPath, bool bTemporary) override
+        {
+            auto lock = Call();
+            std::ifstream file(pchApplicationManifestFullPath);
+            if (!file)
+                return vr::VRApplicationError_InvalidManifest;
+
+            State().manifests.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            return vr::VRApplicationError_None;
+        }
+
+        vr::EVRApplicationError RemoveApplicationManifest(const char *pchApplicationManifestFullPath) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_None;
+        }
+
+        // A manifest "installs" every app key that appears in it as a quoted string.
+        bool IsApplicationInstalled(const char *pchAppKey) override
+        {
+            auto lock = Call();
+            const std::string quoted = std::string("\"") + pchAppKey + "\"";
+            for (const auto &manifest : State().manifests)
+            {
+                if (manifest.find(quoted) != std::string::npos)
+                    return true;
+            }
+            return false;
+        }
+
+        uint32_t GetApplicationCount() override
+        {
+            auto lock = Call();
+            return static_cast<uint32_t>(State().manifests.size());
+        }
+
+        vr::EVRApplicationError GetApplicationKeyByIndex(uint32_t unApplicationIndex, char *pchAppKeyBuffer, uint32_t unAppKeyBufferLen) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_InvalidIndex;
+        }
+
+        vr::EVRApplicationError GetApplicationKeyByProcessId(uint32_t unProcessId, char *pchAppKeyBuffer, uint32_t unAppKeyBufferLen) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_UnknownApplication;
+        }
+
+        vr::EVRApplicationError LaunchApplication(const char *pchAppKey) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_UnknownApplication;
+        }
+
+        vr::EVRApplicationError LaunchTemplateApplication(const char *pchTemplateAppKey, const char *pchNewAppKey, const vr::AppOverrideKeys_t *pKeys, uint32_t unKeys) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_UnknownApplication;
+        }
+
+        vr::EVRApplicationError LaunchApplicationFromMimeType(const char *pchMimeType, const char *pchArgs) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_UnknownApplication;
+        }
+
+        vr::EVRApplicationError LaunchDashboardOverlay(const char *pchAppKey) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_UnknownApplication;
+        }
+
+        bool CancelApplicationLaunch(const char *pchAppKey) override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        vr::EVRApplicationError IdentifyApplication(uint32_t unProcessId, const char *pchAppKey) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_None;
+        }
+
+        uint32_t GetApplicationProcessId(const char *pchAppKey) override
+        {
+            auto lock = Call();
+            return 0;
+        }
+
+        const char *GetApplicationsErrorNameFromEnum(vr::EVRApplicationError error) override
+        {
+            auto lock = Call();
+            switch (error)
+            {
+                MOCK_ENUM_NAME(VRApplicationError_None)
+                MOCK_ENUM_NAME(VRApplicationError_AppKeyAlreadyExists)
+                MOCK_ENUM_NAME(VRApplicationError_NoManifest)
+                MOCK_ENUM_NAME(VRApplicationError_NoApplication)
+                MOCK_ENUM_NAME(VRApplicationError_InvalidIndex)
+                MOCK_ENUM_NAME(VRApplicationError_UnknownApplication)
+                MOCK_ENUM_NAME(VRApplicationError_InvalidManifest)
+            default:
+                return "Unknown";
+            }
+        }
+
+        uint32_t GetApplicationPropertyString(const char *pchAppKey, vr::EVRApplicationProperty eProperty, char *pchPropertyValueBuffer, uint32_t unPropertyValueBufferLen, vr::EVRApplicationError *peError) override
+        {
+            auto lock = Call();
+            if (peError)
+                *peError = vr::VRApplicationError_UnknownApplication;
+            return CopyString("", pchPropertyValueBuffer, unPropertyValueBufferLen);
+        }
+
+        bool GetApplicationPropertyBool(const char *pchAppKey, vr::EVRApplicationProperty eProperty, vr::EVRApplicationError *peError) override
+        {
+            auto lock = Call();
+            if (peError)
+                *peError = vr::VRApplicationError_UnknownApplication;
+            return false;
+        }
+
+        uint64_t GetApplicationPropertyUint64(const char *pchAppKey, vr::EVRApplicationProperty eProperty, vr::EVRApplicationError *peError) override
+        {
+            auto lock = Call();
+            if (peError)
+                *peError = vr::VRApplicationError_UnknownApplication;
+            return 0;
+        }
+
+        vr::EVRApplicationError SetApplicationAutoLaunch(const char *pchAppKey, bool bAutoLaunch) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_UnknownApplication;
+        }
+
+        bool GetApplicationAutoLaunch(const char *pchAppKey) override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        vr::EVRApplicationError SetDefaultApplicationForMimeType(const char *pchAppKey, const char *pchMimeType) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_UnknownApplication;
+        }
+
+        bool GetDefaultApplicationForMimeType(const char *pchMimeType, char *pchAppKeyBuffer, uint32_t unAppKeyBufferLen) override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        bool GetApplicationSupportedMimeTypes(const char *pchAppKey, char *pchMimeTypesBuffer, uint32_t unMimeTypesBuffer) override
+        {
+            auto lock = Call();
+            return false;
+        }
+
+        uint32_t GetApplicationsThatSupportMimeType(const char *pchMimeType, char *pchAppKeysThatSupportBuffer, uint32_t unAppKeysThatSupportBuffer) override
+        {
+            auto lock = Call();
+            return CopyString("", pchAppKeysThatSupportBuffer, unAppKeysThatSupportBuffer);
+        }
+
+        uint32_t GetApplicationLaunchArguments(uint32_t unHandle, char *pchArgs, uint32_t unArgs) override
+        {
+            auto lock = Call();
+            return CopyString("", pchArgs, unArgs);
+        }
+
+        vr::EVRApplicationError GetStartingApplication(char *pchAppKeyBuffer, uint32_t unAppKeyBufferLen) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_NoApplication;
+        }
+
+        vr::EVRSceneApplicationState GetSceneApplicationState() override
+        {
+            auto lock = Call();
+            return vr::EVRSceneApplicationState_None;
+        }
+
+        vr::EVRApplicationError PerformApplicationPrelaunchCheck(const char *pchAppKey) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_None;
+        }
+
+        const char *GetSceneApplicationStateNameFromEnum(vr::EVRSceneApplicationState state) override
+        {
+            auto lock = Call();
+            return state == vr::EVRSceneApplicationState_None ? "EVRSceneApplicationState_None" : "Unknown";
+        }
+
+        vr::EVRApplicationError LaunchInternalProcess(const char *pchBinaryPath, const char *pchArguments, const char *pchWorkingDirectory) override
+        {
+            auto lock = Call();
+            return vr::VRApplicationError_LaunchFailed;
+        }
+
+        uint32_t GetCurrentSceneProcessId() override
+        {
+            auto lock = Call();
+            return 0;
+        }
+    };
+
+    //=========================================================
+    class MockDebug : public vr::IVRDebug
+    {
+    public:
+        vr::EVRDebugError EmitVrProfilerEvent(const char *pchMessage) override
+        {
+            auto lock = Call();
+            return vr::VRDebugError_Success;
+        }
+
+        vr::EVRDebugError BeginVrProfilerEvent(vr::VrProfilerEventHandle_t *pHandleOut) override
+        {
+            auto lock = Call();
+            *pHandleOut = State().nextProfilerEvent++;
+            return vr::VRDebugError_Success;
+        }
+
+        vr::EVRDebugError FinishVrProfilerEvent(vr::VrProfilerEventHandle_t hHandle, const char *pchMessage) override
+        {
+            auto lock = Call();
+            return hHandle != 0 && hHandle < State().nextProfilerEvent ? vr::VRDebugError_Success : vr::VRDebugError_BadParameter;
+        }
+
+        uint32_t DriverDebugRequest(vr::TrackedDeviceIndex_t unDeviceIndex, const char *pchRequest, char *pchResponseBuffer, uint32_t unResponseBufferSize) override
+        {
+            auto lock = Call();
+            return CopyString("{}", pchResponseBuffer, unResponseBufferSize);
+        }
+    };
+
+#undef MOCK_ENUM_NAME
+
+    MockSystem g_system;
+    MockOverlay g_overlay;
+    MockApplications g_applications;
+    MockDebug g_debug;
+}
+
+//=========================================================
+// Control API
+//=========================================================
+
+namespace vrmock
+{
+    void Reset()
+    {
+        Runtime &runtime = State();
+        std::lock_guard<std::mutex> lock(runtime.mutex);
+        ResetLocked(runtime);
+    }
+
+    void SetCallLatency(uint32_t unMicroseconds)
+    {
+        State().latencyUs = unMicroseconds;
+    }
+
+    void SetInitError(vr::EVRInitError eError)
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        State().initError = eError;
+    }
+
+    void SetHmdPresent(bool bPresent)
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        State().hmdPresent = bPresent;
+    }
+
+    void SetDisplayFrequency(float fHz)
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        Runtime &runtime = State();
+        runtime.displayFrequency = fHz > 0.0f ? fHz : 90.0f;
+        StoreProperty(runtime.devices[vr::k_unTrackedDeviceIndex_Hmd], vr::Prop_DisplayFrequency_Float, vr::k_unFloatPropertyTag, runtime.displayFrequency);
+    }
+
+    void SetDevice(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceClass eClass, vr::ETrackedControllerRole eRole, bool bConnected)
+    {
+        if (unDeviceIndex >= vr::k_unMaxTrackedDeviceCount)
+            return;
+
+        std::lock_guard<std::mutex> lock(State().mutex);
+        Runtime &runtime = State();
+        Device &device = runtime.devices[unDeviceIndex];
+        const bool wasConnected = device.connected;
+
+        if (bConnected && (!wasConnected || device.deviceClass != eClass))
+            InstallDevice(runtime, unDeviceIndex, eClass, eRole, 1.0f);
+        device.deviceClass = eClass;
+        device.role = eRole;
+        device.connected = bConnected;
+        device.pose.bDeviceIsConnected = bConnected;
+
+        if (wasConnected != bConnected)
+            PushEvent(runtime, bConnected ? vr::VREvent_TrackedDeviceActivated : vr::VREvent_TrackedDeviceDeactivated, unDeviceIndex, vr::VREvent_Data_t());
+    }
+
+    void SetDevicePose(vr::TrackedDeviceIndex_t unDeviceIndex, const vr::TrackedDevicePose_t &pose)
+    {
+        if (unDeviceIndex >= vr::k_unMaxTrackedDeviceCount)
+            return;
+
+        std::lock_guard<std::mutex> lock(State().mutex);
+        Device &device = State().devices[unDeviceIndex];
+        device.pose = pose;
+        device.pose.bDeviceIsConnected = device.connected;
+        device.poseTime = Clock::now();
+    }
+
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, const void *pvData, uint32_t unSize)
+    {
+        if (unDeviceIndex >= vr::k_unMaxTrackedDeviceCount)
+            return;
+
+        std::lock_guard<std::mutex> lock(State().mutex);
+        Runtime &runtime = State();
+        StoreProperty(runtime.devices[unDeviceIndex], prop, unTag, pvData, unSize);
+
+        vr::VREvent_Data_t data = {};
+        data.property.container = static_cast<vr::PropertyContainerHandle_t>(unDeviceIndex) + 1;
+        data.property.prop = prop;
+        PushEvent(runtime, vr::VREvent_PropertyChanged, unDeviceIndex, data);
+    }
+
+    void SetControllerState(vr::TrackedDeviceIndex_t unDeviceIndex, const vr::VRControllerState_t &state)
+    {
+        if (unDeviceIndex >= vr::k_unMaxTrackedDeviceCount)
+            return;
+
+        std::lock_guard<std::mutex> lock(State().mutex);
+        State().devices[unDeviceIndex].controllerState = state;
+    }
+
+    void QueueEvent(const vr::VREvent_t &event)
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        State().events.push_back(event);
+    }
+
+    bool QueueOverlayEvent(vr::VROverlayHandle_t ulOverlayHandle, const vr::VREvent_t &event)
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        Overlay *overlay = FindOverlay(State(), ulOverlayHandle);
+        if (!overlay)
+            return false;
+
+        overlay->events.push_back(event);
+        return true;
+    }
+
+    vr::VROverlayHandle_t CreateForeignOverlay(const char *pchOverlayKey, const char *pchOverlayName)
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        Runtime &runtime = State();
+        if (ValidateNewOverlay(runtime, pchOverlayKey, pchOverlayName) != vr::VROverlayError_None)
+            return vr::k_ulOverlayHandleInvalid;
+        return AddOverlay(runtime, pchOverlayKey, pchOverlayName, k_unForeignProcessId);
+    }
+
+    Stats GetStats()
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        const Runtime &runtime = State();
+        Stats stats;
+        stats.calls = runtime.calls.load(std::memory_order_relaxed);
+        stats.overlayUploads = runtime.overlayUploads;
+        stats.overlayUploadBytes = runtime.overlayUploadBytes;
+        stats.overlayFileLoads = runtime.overlayFileLoads;
+        stats.overlays = static_cast<uint32_t>(runtime.overlays.size());
+        return stats;
+    }
+}
+
+//=========================================================
+// libopenvr_api exports
+//=========================================================
+
+namespace vr
+{
+    VR_INTERFACE uint32_t VR_CALLTYPE VR_InitInternal2(EVRInitError *peError, EVRApplicationType eApplicationType, const char *pStartupInfo)
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        Runtime &runtime = State();
+
+        EVRInitError error = runtime.initError;
+        if (error == VRInitError_None && !runtime.hmdPresent && eApplicationType != VRApplication_Utility)
+            error = VRInitError_Init_HmdNotFound;
+
+        if (error == VRInitError_None)
+        {
+            runtime.initialized = true;
+            runtime.initToken += 1;
+        }
+        if (peError)
+            *peError = error;
+        return runtime.initToken;
+    }
+
+    VR_INTERFACE void VR_CALLTYPE VR_ShutdownInternal()
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        State().initialized = false;
+    }
+
+    VR_INTERFACE bool VR_CALLTYPE VR_IsHmdPresent()
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        return State().hmdPresent;
+    }
+
+    VR_INTERFACE bool VR_CALLTYPE VR_IsRuntimeInstalled()
+    {
+        return true;
+    }
+
+    VR_INTERFACE bool VR_CALLTYPE VR_GetRuntimePath(char *pchPathBuffer, uint32_t unBufferSize, uint32_t *punRequiredBufferSize)
+    {
+        const uint32_t required = CopyString("openvr-mock", pchPathBuffer, unBufferSize);
+        if (punRequiredBufferSize)
+            *punRequiredBufferSize = required;
+        return unBufferSize >= required;
+    }
+
+    VR_INTERFACE const char *VR_CALLTYPE VR_GetVRInitErrorAsSymbol(EVRInitError error)
+    {
+        switch (error)
+        {
+        case VRInitError_None:
+            return "VRInitError_None";
+        case VRInitError_Init_NotInitialized:
+            return "VRInitError_Init_NotInitialized";
+        case VRInitError_Init_InterfaceNotFound:
+            return "VRInitError_Init_InterfaceNotFound";
+        case VRInitError_Init_HmdNotFound:
+            return "VRInitError_Init_HmdNotFound";
+        default:
+            return "VRInitError_Unknown";
+        }
+    }
+
+    VR_INTERFACE const char *VR_CALLTYPE VR_GetVRInitErrorAsEnglishDescription(EVRInitError error)
+    {
+        switch (error)
+        {
+        case VRInitError_None:
+            return "No Error (0)";
+        case VRInitError_Init_NotInitialized:
+            return "Not initialized (119)";
+        case VRInitError_Init_InterfaceNotFound:
+            return "Interface not found (105)";
+        case VRInitError_Init_HmdNotFound:
+            return "Hmd Not Found (108)";
+        default:
+            return "Unknown error (mock runtime)";
+        }
+    }
+
+    VR_INTERFACE bool VR_CALLTYPE VR_IsInterfaceVersionValid(const char *pchInterfaceVersion)
+    {
+        return std::strcmp(pchInterfaceVersion, IVRSystem_Version) == 0 ||
+               std::strcmp(pchInterfaceVersion, IVROverlay_Version) == 0 ||
+               std::strcmp(pchInterfaceVersion, IVRApplications_Version) == 0 ||
+               std::strcmp(pchInterfaceVersion, IVRDebug_Version) == 0;
+    }
+
+    VR_INTERFACE void *VR_CALLTYPE VR_GetGenericInterface(const char *pchInterfaceVersion, EVRInitError *peError)
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        void *result = nullptr;
+        EVRInitError error = VRInitError_None;
+
+        if (!State().initialized)
+            error = VRInitError_Init_NotInitialized;
+        else if (std::strcmp(pchInterfaceVersion, IVRSystem_Version) == 0)
+            result = static_cast<IVRSystem *>(&g_system);
+        else if (std::strcmp(pchInterfaceVersion, IVROverlay_Version) == 0)
+            result = static_cast<IVROverlay *>(&g_overlay);
+        else if (std::strcmp(pchInterfaceVersion, IVRApplications_Version) == 0)
+            result = static_cast<IVRApplications *>(&g_applications);
+        else if (std::strcmp(pchInterfaceVersion, IVRDebug_Version) == 0)
+            result = static_cast<IVRDebug *>(&g_debug);
+        else
+            error = VRInitError_Init_InterfaceNotFound;
+
+        if (peError)
+            *peError = error;
+        return result;
+    }
+
+    VR_INTERFACE uint32_t VR_CALLTYPE VR_GetInitToken()
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        return State().initToken;
+    }
+}
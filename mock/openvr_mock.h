@@ -0,0 +1,66 @@
+#ifndef OPENVR_MOCK_H_JS
+#define OPENVR_MOCK_H_JS
+
+#include <openvr.h>
+
+#include <cstdint>
+
+/// In-process stand-in for libopenvr_api.
+///
+/// Building with `--openvr_mock=1` links this library instead of the real
+/// runtime. It exports the same `VR_*` entry points and hands out
+/// deterministic implementations of IVRSystem, IVROverlay, IVRApplications
+/// and IVRDebug. The functions below script that runtime from tests and
+/// benchmarks. They are thread-safe.
+namespace vrmock
+{
+    struct Stats
+    {
+        uint64_t calls;              // interface calls made through any mock interface
+        uint64_t overlayUploads;     // successful SetOverlayRaw calls
+        uint64_t overlayUploadBytes; // bytes passed to successful SetOverlayRaw calls
+        uint64_t overlayFileLoads;   // successful SetOverlayFromFile calls
+        uint32_t overlays;           // overlays currently alive
+    };
+
+    /// Restores the default scene: HMD at index 0, left and right controllers at
+    /// 1 and 2, no queued events, no overlays, zero latency, 90 Hz display.
+    void Reset();
+
+    /// Every interface call sleeps this long before it returns, simulating the
+    /// IPC round trip to vrserver.
+    void SetCallLatency(uint32_t unMicroseconds);
+
+    /// Result that the next VR_Init reports. Anything other than
+    /// VRInitError_None makes initialization fail.
+    void SetInitError(vr::EVRInitError eError);
+    void SetHmdPresent(bool bPresent);
+    void SetDisplayFrequency(float fHz);
+
+    /// Connects or disconnects a device. A change in connection state queues
+    /// VREvent_TrackedDeviceActivated or VREvent_TrackedDeviceDeactivated.
+    void SetDevice(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceClass eClass, vr::ETrackedControllerRole eRole, bool bConnected);
+
+    /// Sets the pose a device reports now. The device keeps moving at the pose's
+    /// velocity and angular velocity, so later and predicted reads differ.
+    void SetDevicePose(vr::TrackedDeviceIndex_t unDeviceIndex, const vr::TrackedDevicePose_t &pose);
+
+    /// Stores a raw property value with the given type tag and queues
+    /// VREvent_PropertyChanged for the device.
+    void SetDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, const void *pvData, uint32_t unSize);
+
+    void SetControllerState(vr::TrackedDeviceIndex_t unDeviceIndex, const vr::VRControllerState_t &state);
+
+    /// Appends to the queue drained by IVRSystem::PollNextEvent.
+    void QueueEvent(const vr::VREvent_t &event);
+
+    /// Appends to the queue drained by IVROverlay::PollNextOverlayEvent.
+    bool QueueOverlayEvent(vr::VROverlayHandle_t ulOverlayHandle, const vr::VREvent_t &event);
+
+    /// Creates an overlay as though another process owned it.
+    vr::VROverlayHandle_t CreateForeignOverlay(const char *pchOverlayKey, const char *pchOverlayName);
+
+    Stats GetStats();
+}
+
+#endif
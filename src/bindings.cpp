@@ -2,6 +2,13 @@
 #include "ivroverlay.h"
 #include "ivrapplications.h"
 #include "openvr.h"
+#include "posesampler.h"
+#include "eventpump.h"
+#include "overlayanimator.h"
+
+#ifdef OPENVR_JS_MOCK
+#include "vrmock.h"
+#endif
 
 #include <nan.h>
 
@@ -39,10 +46,23 @@ void Initialize(v8::Local<v8::Object> exports)
     exports->Set(context,
                  Nan::New("IVRApplications_Init").ToLocalChecked(),
                  Nan::New<v8::FunctionTemplate>(IVRApplications_Init)->GetFunction(context).ToLocalChecked());
+    exports->Set(context,
+                 Nan::New("ConvertPixels").ToLocalChecked(),
+                 Nan::New<v8::FunctionTemplate>(ConvertPixels)->GetFunction(context).ToLocalChecked());
+    exports->Set(context,
+                 Nan::New("GetPixelConversionInstructionSet").ToLocalChecked(),
+                 Nan::New<v8::FunctionTemplate>(GetPixelConversionInstructionSet)->GetFunction(context).ToLocalChecked());
 
     IVRSystem::Init(exports);
     IVROverlay::Init(exports);
     IVRApplications::Init(exports);
+    PoseSampler::Init(exports);
+    EventPump::Init(exports);
+    OverlayAnimator::Init(exports);
+
+#ifdef OPENVR_JS_MOCK
+    VRMock::Init(exports);
+#endif
 }
 
 NODE_MODULE(openvr, Initialize);
@@ -0,0 +1,44 @@
+#include "cpufeatures.h"
+
+namespace CpuFeatures
+{
+#if defined(CPUFEATURES_X86)
+    bool HasSse2()
+    {
+#if defined(_M_X64) || defined(__x86_64__)
+        return true;
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#else
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+
+    bool HasSsse3()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 9)) != 0;
+#else
+        return __builtin_cpu_supports("ssse3");
+#endif
+    }
+
+    bool HasAvx2()
+    {
+#if defined(_MSC_VER)
+        // AVX2 also needs the OS to save the upper halves of the registers.
+        int info[4];
+        __cpuid(info, 1);
+        const bool bOsSavesAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return bOsSavesAvx && (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+}
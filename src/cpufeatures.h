@@ -0,0 +1,34 @@
+#ifndef CPUFEATURES_H_JS
+#define CPUFEATURES_H_JS
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CPUFEATURES_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CPUFEATURES_NEON 1
+#include <arm_neon.h>
+#endif
+
+// MSVC compiles any intrinsic without flags; GCC and Clang need each SIMD
+// function marked with the instruction set it may use.
+#if defined(CPUFEATURES_X86) && !defined(_MSC_VER)
+#define CPUFEATURES_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CPUFEATURES_TARGET(isa)
+#endif
+
+/// Runtime checks for the x86 instruction sets the SIMD kernels use. NEON is
+/// part of every ARM64 CPU, so it needs no check.
+namespace CpuFeatures
+{
+#if defined(CPUFEATURES_X86)
+    bool HasSse2();
+    bool HasSsse3();
+    bool HasAvx2();
+#endif
+}
+
+#endif
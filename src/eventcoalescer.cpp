@@ -0,0 +1,85 @@
+#include "eventcoalescer.h"
+#include "overlaymirror.h"
+
+namespace
+{
+    bool IsMove(uint32_t unEventType)
+    {
+        return unEventType == vr::VREvent_MouseMove || unEventType == vr::VREvent_TouchPadMove;
+    }
+
+    bool IsScroll(uint32_t unEventType)
+    {
+        return unEventType == vr::VREvent_ScrollDiscrete || unEventType == vr::VREvent_ScrollSmooth;
+    }
+
+    bool PollFiltered(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle, const EventFilter &filter, vr::VREvent_t *pEvent)
+    {
+        while (overlay->PollNextOverlayEvent(ulOverlayHandle, pEvent, sizeof(vr::VREvent_t)))
+        {
+            // Seen even when filtered out, so mirrored visibility stays current.
+            OverlayMirror::Observe(ulOverlayHandle, *pEvent);
+            if (filter.Accepts(pEvent->eventType))
+                return true;
+        }
+        return false;
+    }
+}
+
+bool CoalesceEvent(vr::VREvent_t &last, const vr::VREvent_t &next)
+{
+    if (last.eventType != next.eventType || last.trackedDeviceIndex != next.trackedDeviceIndex)
+        return false;
+
+    if (IsMove(next.eventType))
+    {
+        last = next;
+        return true;
+    }
+
+    if (IsScroll(next.eventType))
+    {
+        last.eventAgeSeconds = next.eventAgeSeconds;
+        last.data.scroll.xdelta += next.data.scroll.xdelta;
+        last.data.scroll.ydelta += next.data.scroll.ydelta;
+        last.data.scroll.viewportscale = next.data.scroll.viewportscale;
+        return true;
+    }
+
+    return false;
+}
+
+bool EventCoalescer::Poll(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle, const EventFilter &filter, vr::VREvent_t *pEvent)
+{
+    // The held event passed the filter when it was read, but the filter may
+    // have changed since.
+    bool bHeld = false;
+    auto lookahead = lookahead_.find(ulOverlayHandle);
+    if (lookahead != lookahead_.end())
+    {
+        *pEvent = lookahead->second;
+        lookahead_.erase(lookahead);
+        bHeld = filter.Accepts(pEvent->eventType);
+    }
+    if (!bHeld && !PollFiltered(overlay, ulOverlayHandle, filter, pEvent))
+        return false;
+
+    if (!enabled_ || !(IsMove(pEvent->eventType) || IsScroll(pEvent->eventType)))
+        return true;
+
+    vr::VREvent_t next;
+    while (PollFiltered(overlay, ulOverlayHandle, filter, &next))
+    {
+        if (!CoalesceEvent(*pEvent, next))
+        {
+            lookahead_.emplace(ulOverlayHandle, next);
+            break;
+        }
+    }
+    return true;
+}
+
+void EventCoalescer::Forget(vr::VROverlayHandle_t ulOverlayHandle)
+{
+    lookahead_.erase(ulOverlayHandle);
+}
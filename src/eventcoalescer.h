@@ -0,0 +1,37 @@
+#ifndef EVENTCOALESCER_H_JS
+#define EVENTCOALESCER_H_JS
+
+#include "eventfilter.h"
+
+#include <openvr.h>
+
+#include <unordered_map>
+
+/// Folds `next` into `last` when both are part of one run of pointer motion:
+/// mouse or touchpad moves keep the latest position, scrolls of the same kind
+/// sum their deltas. Returns false, leaving `last` untouched, for anything else.
+bool CoalesceEvent(vr::VREvent_t &last, const vr::VREvent_t &next);
+
+/// Overlay event reader that optionally merges runs of motion events.
+///
+/// Merging needs one event of lookahead. The event that ended a run is kept
+/// per overlay and returned by the next Poll, so nothing is lost or reordered.
+class EventCoalescer
+{
+public:
+    bool Enabled() const { return enabled_; }
+    void SetEnabled(bool bEnabled) { enabled_ = bEnabled; }
+
+    /// Next event for the overlay that passes the filter, with runs merged when
+    /// enabled. Returns false when the overlay has nothing pending.
+    bool Poll(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle, const EventFilter &filter, vr::VREvent_t *pEvent);
+
+    /// Drops the event held for a destroyed overlay.
+    void Forget(vr::VROverlayHandle_t ulOverlayHandle);
+
+private:
+    bool enabled_ = false;
+    std::unordered_map<vr::VROverlayHandle_t, vr::VREvent_t> lookahead_;
+};
+
+#endif
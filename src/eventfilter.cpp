@@ -0,0 +1,65 @@
+#include "eventfilter.h"
+
+bool EventFilter::Accepts(uint32_t unEventType) const
+{
+    if (!filtering_.load(std::memory_order_acquire))
+        return true;
+
+    if (unEventType >= k_unEventTypeCount)
+        return false;
+
+    return (mask_[unEventType / 64].load(std::memory_order_relaxed) >> (unEventType % 64)) & 1;
+}
+
+bool EventFilter::Set(v8::Local<v8::Value> value, v8::Isolate *isolate)
+{
+    if (value->IsNullOrUndefined())
+    {
+        filtering_.store(false, std::memory_order_release);
+        return true;
+    }
+
+    if (!value->IsArray())
+        return false;
+
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Array> eventTypes = value.As<v8::Array>();
+
+    std::array<uint64_t, k_unWordCount> mask{};
+    for (uint32_t i = 0; i < eventTypes->Length(); ++i)
+    {
+        v8::Local<v8::Value> eventType = Nan::Get(eventTypes, i).ToLocalChecked();
+        if (!eventType->IsUint32())
+            return false;
+
+        const uint32_t unEventType = eventType->Uint32Value(context).FromJust();
+        if (unEventType >= k_unEventTypeCount)
+            return false;
+
+        mask[unEventType / 64] |= uint64_t(1) << (unEventType % 64);
+    }
+
+    // A reader racing with this sees each word either before or after the
+    // change, which only matters for events polled during the call.
+    for (uint32_t i = 0; i < k_unWordCount; ++i)
+        mask_[i].store(mask[i], std::memory_order_relaxed);
+    filtering_.store(true, std::memory_order_release);
+    return true;
+}
+
+v8::Local<v8::Value> EventFilter::Get() const
+{
+    Nan::EscapableHandleScope scope;
+
+    if (!filtering_.load(std::memory_order_acquire))
+        return scope.Escape(Nan::Undefined());
+
+    v8::Local<v8::Array> result = Nan::New<v8::Array>();
+    uint32_t unCount = 0;
+    for (uint32_t unEventType = 0; unEventType < k_unEventTypeCount; ++unEventType)
+    {
+        if ((mask_[unEventType / 64].load(std::memory_order_relaxed) >> (unEventType % 64)) & 1)
+            Nan::Set(result, unCount++, Nan::New<v8::Number>(unEventType));
+    }
+    return scope.Escape(result);
+}
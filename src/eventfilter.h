@@ -0,0 +1,38 @@
+#ifndef EVENTFILTER_H_JS
+#define EVENTFILTER_H_JS
+
+#include <nan.h>
+#include <v8.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/// Set of event types a wrapper delivers to JS. Events outside the set are
+/// dropped in C++ before anything is encoded. An empty filter (the default)
+/// delivers everything.
+///
+/// Reads are lock-free and may run on another thread than the one that
+/// changes the filter.
+class EventFilter
+{
+public:
+    bool Accepts(uint32_t unEventType) const;
+
+    /// Takes an array of event types, or undefined/null to deliver everything.
+    /// Returns false and leaves the filter unchanged if the value is neither.
+    bool Set(v8::Local<v8::Value> value, v8::Isolate *isolate);
+
+    /// Array of the subscribed event types, or undefined when not filtering.
+    v8::Local<v8::Value> Get() const;
+
+private:
+    // Every EVREventType up to and including the vendor-specific range.
+    static constexpr uint32_t k_unEventTypeCount = 20000;
+    static constexpr uint32_t k_unWordCount = (k_unEventTypeCount + 63) / 64;
+
+    std::atomic<bool> filtering_{false};
+    std::array<std::atomic<uint64_t>, k_unWordCount> mask_{};
+};
+
+#endif
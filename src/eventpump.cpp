@@ -0,0 +1,339 @@
+#include "eventpump.h"
+#include "eventcoalescer.h"
+#include "overlaymirror.h"
+#include "propertycache.h"
+#include "util.h"
+
+#include <algorithm>
+#include <set>
+
+using namespace v8;
+
+namespace
+{
+    constexpr uint32_t k_unQueueCapacity = 1024;
+    constexpr uint32_t k_unDefaultPollIntervalUs = 1000;
+    constexpr uint32_t k_unMinPollIntervalUs = 100;
+    constexpr uint32_t k_unMaxPollIntervalUs = 1000000;
+
+    std::mutex g_pumpsMutex;
+    std::set<EventPump *> g_pumps;
+}
+
+Nan::Persistent<Function> EventPump::constructor;
+
+void EventPump::Init(Local<Object> exports)
+{
+    Local<Context> context = exports->CreationContext();
+    Nan::HandleScope scope;
+
+    Local<FunctionTemplate> tpl = Nan::New<FunctionTemplate>(New);
+    tpl->SetClassName(Nan::New("EventPump").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    Nan::SetPrototypeMethod(tpl, "Start", Start);
+    Nan::SetPrototypeMethod(tpl, "Stop", Stop);
+    Nan::SetPrototypeMethod(tpl, "IsRunning", IsRunning);
+    Nan::SetPrototypeMethod(tpl, "WatchOverlay", WatchOverlay);
+    Nan::SetPrototypeMethod(tpl, "UnwatchOverlay", UnwatchOverlay);
+    Nan::SetPrototypeMethod(tpl, "SetEventFilter", SetEventFilter);
+    Nan::SetPrototypeMethod(tpl, "GetEventFilter", GetEventFilter);
+    Nan::SetPrototypeMethod(tpl, "SetEventCoalescing", SetEventCoalescing);
+
+    constructor.Reset(tpl->GetFunction(context).ToLocalChecked());
+    exports->Set(
+               context,
+               Nan::New("EventPump").ToLocalChecked(),
+               tpl->GetFunction(context).ToLocalChecked())
+        .FromJust();
+}
+
+void EventPump::StopAll()
+{
+    std::set<EventPump *> pumps;
+    {
+        std::lock_guard<std::mutex> lock(g_pumpsMutex);
+        pumps = g_pumps;
+    }
+
+    for (EventPump *pump : pumps)
+        pump->Stop();
+}
+
+EventPump::EventPump(Local<Function> callback, uint32_t unPollIntervalUs)
+    : callback_(callback), resource_("openvr:EventPump"), pollInterval_(unPollIntervalUs), queue_(new QueuedEvent[k_unQueueCapacity])
+{
+    std::lock_guard<std::mutex> lock(g_pumpsMutex);
+    g_pumps.insert(this);
+}
+
+EventPump::~EventPump()
+{
+    // A running pump holds a reference to itself, so it is always stopped here.
+    std::lock_guard<std::mutex> lock(g_pumpsMutex);
+    g_pumps.erase(this);
+}
+
+void EventPump::Start()
+{
+    if (running_)
+        return;
+
+    async_ = new uv_async_t;
+    uv_async_init(Nan::GetCurrentEventLoop(), async_, OnAsync);
+    async_->data = this;
+
+    // Events left in the ring by the last Stop would otherwise wait for the next new one.
+    if (head_.load(std::memory_order_acquire) != tail_.load(std::memory_order_acquire))
+        uv_async_send(async_);
+
+    running_ = true;
+    Ref();
+    thread_ = std::thread(&EventPump::Run, this, vr::VRSystem(), vr::VROverlay());
+}
+
+void EventPump::Stop()
+{
+    if (!running_.exchange(false))
+        return;
+
+    thread_.join();
+
+    // Events still in the ring are delivered after the next Start.
+    uv_close(reinterpret_cast<uv_handle_t *>(async_), [](uv_handle_t *handle)
+             { delete reinterpret_cast<uv_async_t *>(handle); });
+    async_ = nullptr;
+    Unref();
+}
+
+void EventPump::Run(vr::IVRSystem *system, vr::IVROverlay *overlay)
+{
+    std::vector<vr::VROverlayHandle_t> overlays;
+    vr::VREvent_t event;
+
+    while (running_.load(std::memory_order_relaxed))
+    {
+        const uint32_t unTail = tail_.load(std::memory_order_relaxed);
+
+        while (Room() > 0 && system->PollNextEvent(&event, sizeof(vr::VREvent_t)))
+        {
+            PropertyCache::Observe(event);
+            if (eventFilter_.Accepts(event.eventType))
+                Push(vr::k_ulOverlayHandleInvalid, event);
+        }
+
+        if (overlay)
+        {
+            {
+                std::lock_guard<std::mutex> lock(overlaysMutex_);
+                overlays.assign(overlays_.begin(), overlays_.end());
+            }
+
+            const bool bCoalesce = coalescing_.load(std::memory_order_relaxed);
+            for (vr::VROverlayHandle_t ulOverlayHandle : overlays)
+            {
+                // Runs are only merged within one poll, before anything reaches the ring.
+                bool bHeld = false;
+                vr::VREvent_t held;
+                while (Room() > (bHeld ? 1u : 0u) && overlay->PollNextOverlayEvent(ulOverlayHandle, &event, sizeof(vr::VREvent_t)))
+                {
+                    OverlayMirror::Observe(ulOverlayHandle, event);
+                    if (!eventFilter_.Accepts(event.eventType))
+                        continue;
+
+                    if (bHeld && bCoalesce && CoalesceEvent(held, event))
+                        continue;
+
+                    if (bHeld)
+                        Push(ulOverlayHandle, held);
+                    held = event;
+                    bHeld = true;
+                }
+
+                if (bHeld)
+                    Push(ulOverlayHandle, held);
+            }
+        }
+
+        if (tail_.load(std::memory_order_relaxed) != unTail)
+            uv_async_send(async_);
+
+        std::this_thread::sleep_for(pollInterval_);
+    }
+}
+
+uint32_t EventPump::Room() const
+{
+    return k_unQueueCapacity - (tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire));
+}
+
+void EventPump::Push(vr::VROverlayHandle_t ulOverlayHandle, const vr::VREvent_t &event)
+{
+    const uint32_t unTail = tail_.load(std::memory_order_relaxed);
+    queue_[unTail % k_unQueueCapacity] = {ulOverlayHandle, event};
+    tail_.store(unTail + 1, std::memory_order_release);
+}
+
+void EventPump::Deliver()
+{
+    Nan::HandleScope scope;
+
+    // The callback may stop the pump and drop the last reference to it.
+    Ref();
+
+    uint32_t unHead = head_.load(std::memory_order_relaxed);
+    const uint32_t unTail = tail_.load(std::memory_order_acquire);
+
+    // One callback per run of events from the same source.
+    while (unHead != unTail)
+    {
+        const vr::VROverlayHandle_t ulOverlayHandle = queue_[unHead % k_unQueueCapacity].ulOverlayHandle;
+        Local<Array> events = Nan::New<Array>();
+        uint32_t unCount = 0;
+
+        while (unHead != unTail && queue_[unHead % k_unQueueCapacity].ulOverlayHandle == ulOverlayHandle)
+        {
+            Nan::Set(events, unCount++, encode(queue_[unHead % k_unQueueCapacity].event));
+            ++unHead;
+        }
+        head_.store(unHead, std::memory_order_release);
+
+        Local<Value> argv[] = {
+            ulOverlayHandle == vr::k_ulOverlayHandleInvalid ? Nan::Undefined().As<Value>() : encode(ulOverlayHandle),
+            events,
+        };
+        callback_.Call(2, argv, &resource_);
+    }
+
+    Unref();
+}
+
+void EventPump::OnAsync(uv_async_t *handle)
+{
+    static_cast<EventPump *>(handle->data)->Deliver();
+}
+
+// new EventPump( callback, unPollIntervalUs? )
+void EventPump::New(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+
+    if (!info.IsConstructCall())
+    {
+        Nan::ThrowError("Use the `new` keyword when creating a new instance.");
+        return;
+    }
+
+    if (!info[0]->IsFunction())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a function.");
+        return;
+    }
+
+    uint32_t unPollIntervalUs = k_unDefaultPollIntervalUs;
+    if (!info[1]->IsUndefined())
+    {
+        if (!info[1]->IsUint32() || info[1]->Uint32Value(context).FromJust() < k_unMinPollIntervalUs || info[1]->Uint32Value(context).FromJust() > k_unMaxPollIntervalUs)
+        {
+            Nan::ThrowRangeError("Poll interval must be between 100 and 1000000 microseconds.");
+            return;
+        }
+        unPollIntervalUs = info[1]->Uint32Value(context).FromJust();
+    }
+
+    EventPump *obj = new EventPump(info[0].As<Function>(), unPollIntervalUs);
+    obj->Wrap(info.This());
+    info.GetReturnValue().Set(info.This());
+}
+
+void EventPump::Start(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    EventPump *obj = Nan::ObjectWrap::Unwrap<EventPump>(info.Holder());
+
+    if (!vr::VRSystem())
+    {
+        Nan::ThrowError("VR_Init must be called before starting an EventPump.");
+        return;
+    }
+
+    obj->Start();
+}
+
+void EventPump::Stop(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    EventPump *obj = Nan::ObjectWrap::Unwrap<EventPump>(info.Holder());
+    obj->Stop();
+}
+
+void EventPump::IsRunning(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    EventPump *obj = Nan::ObjectWrap::Unwrap<EventPump>(info.Holder());
+    info.GetReturnValue().Set(Nan::New<Boolean>(obj->running_.load()));
+}
+
+void EventPump::WatchOverlay(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    EventPump *obj = Nan::ObjectWrap::Unwrap<EventPump>(info.Holder());
+
+    if (info.Length() != 1)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+
+    std::lock_guard<std::mutex> lock(obj->overlaysMutex_);
+    if (std::find(obj->overlays_.begin(), obj->overlays_.end(), ulOverlayHandle) == obj->overlays_.end())
+        obj->overlays_.push_back(ulOverlayHandle);
+}
+
+void EventPump::UnwatchOverlay(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    EventPump *obj = Nan::ObjectWrap::Unwrap<EventPump>(info.Holder());
+
+    if (info.Length() != 1)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+
+    std::lock_guard<std::mutex> lock(obj->overlaysMutex_);
+    obj->overlays_.erase(std::remove(obj->overlays_.begin(), obj->overlays_.end(), ulOverlayHandle), obj->overlays_.end());
+}
+
+void EventPump::SetEventFilter(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    EventPump *obj = Nan::ObjectWrap::Unwrap<EventPump>(info.Holder());
+
+    if (!obj->eventFilter_.Set(info[0], info.GetIsolate()))
+    {
+        Nan::ThrowTypeError("Argument[0] must be an array of event types or undefined.");
+        return;
+    }
+}
+
+void EventPump::GetEventFilter(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    EventPump *obj = Nan::ObjectWrap::Unwrap<EventPump>(info.Holder());
+    info.GetReturnValue().Set(obj->eventFilter_.Get());
+}
+
+void EventPump::SetEventCoalescing(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    EventPump *obj = Nan::ObjectWrap::Unwrap<EventPump>(info.Holder());
+
+    if (!info[0]->IsBoolean())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a boolean.");
+        return;
+    }
+
+    obj->coalescing_.store(info[0]->BooleanValue(info.GetIsolate()));
+}
@@ -0,0 +1,93 @@
+#ifndef EVENTPUMP_H_JS
+#define EVENTPUMP_H_JS
+
+#include "eventfilter.h"
+
+#include <nan.h>
+#include <openvr.h>
+#include <uv.h>
+#include <v8.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace v8;
+
+/// Polls IVRSystem and a set of watched overlays on a native thread and hands
+/// the events to a JS callback on the main loop.
+///
+/// The poll thread is the only producer and the main loop the only consumer of
+/// a fixed-size ring, so neither side takes a lock per event. When the ring is
+/// full the thread stops polling and leaves the rest in the runtime's queue.
+class EventPump : public Nan::ObjectWrap
+{
+public:
+    static void Init(Local<Object> exports);
+
+    /// Stops every running pump. Called before the runtime is shut down.
+    static void StopAll();
+
+private:
+    struct QueuedEvent
+    {
+        vr::VROverlayHandle_t ulOverlayHandle;
+        vr::VREvent_t event;
+    };
+
+    EventPump(Local<Function> callback, uint32_t unPollIntervalUs);
+    ~EventPump();
+
+    void Start();
+    void Stop();
+    void Run(vr::IVRSystem *system, vr::IVROverlay *overlay);
+    uint32_t Room() const;
+    void Push(vr::VROverlayHandle_t ulOverlayHandle, const vr::VREvent_t &event);
+    void Deliver();
+
+    static void OnAsync(uv_async_t *handle);
+
+    static void New(const Nan::FunctionCallbackInfo<Value> &info);
+
+    // Start(): void
+    static void Start(const Nan::FunctionCallbackInfo<Value> &info);
+    // Stop(): void
+    static void Stop(const Nan::FunctionCallbackInfo<Value> &info);
+    // IsRunning(): boolean
+    static void IsRunning(const Nan::FunctionCallbackInfo<Value> &info);
+    // WatchOverlay( ulOverlayHandle ): void
+    static void WatchOverlay(const Nan::FunctionCallbackInfo<Value> &info);
+    // UnwatchOverlay( ulOverlayHandle ): void
+    static void UnwatchOverlay(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetEventFilter( eventTypes?: EVREventType[] ): void
+    static void SetEventFilter(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetEventFilter(): EVREventType[] | undefined
+    static void GetEventFilter(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetEventCoalescing( bEnabled: boolean ): void
+    static void SetEventCoalescing(const Nan::FunctionCallbackInfo<Value> &info);
+
+    static Nan::Persistent<v8::Function> constructor;
+
+    Nan::Callback callback_;
+    Nan::AsyncResource resource_;
+    const std::chrono::microseconds pollInterval_;
+
+    std::unique_ptr<QueuedEvent[]> queue_;
+    std::atomic<uint32_t> head_{0}; // next slot the main loop reads
+    std::atomic<uint32_t> tail_{0}; // next slot the poll thread writes
+
+    EventFilter eventFilter_;
+    std::atomic<bool> coalescing_{false};
+
+    std::mutex overlaysMutex_;
+    std::vector<vr::VROverlayHandle_t> overlays_;
+
+    uv_async_t *async_ = nullptr;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+#endif
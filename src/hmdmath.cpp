@@ -0,0 +1,170 @@
+#include "hmdmath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace HmdMath
+{
+    Quaternion ToQuaternion(const vr::HmdMatrix34_t &m)
+    {
+        Quaternion q;
+        const double trace = m.m[0][0] + m.m[1][1] + m.m[2][2];
+        if (trace > 0.0)
+        {
+            const double s = 0.5 / std::sqrt(trace + 1.0);
+            q.w = 0.25 / s;
+            q.x = (m.m[2][1] - m.m[1][2]) * s;
+            q.y = (m.m[0][2] - m.m[2][0]) * s;
+            q.z = (m.m[1][0] - m.m[0][1]) * s;
+        }
+        else if (m.m[0][0] > m.m[1][1] && m.m[0][0] > m.m[2][2])
+        {
+            const double s = 2.0 * std::sqrt(1.0 + m.m[0][0] - m.m[1][1] - m.m[2][2]);
+            q.w = (m.m[2][1] - m.m[1][2]) / s;
+            q.x = 0.25 * s;
+            q.y = (m.m[0][1] + m.m[1][0]) / s;
+            q.z = (m.m[0][2] + m.m[2][0]) / s;
+        }
+        else if (m.m[1][1] > m.m[2][2])
+        {
+            const double s = 2.0 * std::sqrt(1.0 + m.m[1][1] - m.m[0][0] - m.m[2][2]);
+            q.w = (m.m[0][2] - m.m[2][0]) / s;
+            q.x = (m.m[0][1] + m.m[1][0]) / s;
+            q.y = 0.25 * s;
+            q.z = (m.m[1][2] + m.m[2][1]) / s;
+        }
+        else
+        {
+            const double s = 2.0 * std::sqrt(1.0 + m.m[2][2] - m.m[0][0] - m.m[1][1]);
+            q.w = (m.m[1][0] - m.m[0][1]) / s;
+            q.x = (m.m[0][2] + m.m[2][0]) / s;
+            q.y = (m.m[1][2] + m.m[2][1]) / s;
+            q.z = 0.25 * s;
+        }
+        return q;
+    }
+
+    Quaternion Slerp(Quaternion a, Quaternion b, double t)
+    {
+        double cosTheta = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+        if (cosTheta < 0.0)
+        {
+            b = {-b.w, -b.x, -b.y, -b.z};
+            cosTheta = -cosTheta;
+        }
+
+        double wa = 1.0 - t, wb = t;
+        if (cosTheta < 0.9995)
+        {
+            const double theta = std::acos(cosTheta);
+            const double sinTheta = std::sin(theta);
+            wa = std::sin((1.0 - t) * theta) / sinTheta;
+            wb = std::sin(t * theta) / sinTheta;
+        }
+
+        Quaternion q = {wa * a.w + wb * b.w, wa * a.x + wb * b.x, wa * a.y + wb * b.y, wa * a.z + wb * b.z};
+        const double length = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+        return {q.w / length, q.x / length, q.y / length, q.z / length};
+    }
+
+    void SetRotation(vr::HmdMatrix34_t &m, const Quaternion &q)
+    {
+        m.m[0][0] = static_cast<float>(1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+        m.m[0][1] = static_cast<float>(2.0 * (q.x * q.y - q.z * q.w));
+        m.m[0][2] = static_cast<float>(2.0 * (q.x * q.z + q.y * q.w));
+        m.m[1][0] = static_cast<float>(2.0 * (q.x * q.y + q.z * q.w));
+        m.m[1][1] = static_cast<float>(1.0 - 2.0 * (q.x * q.x + q.z * q.z));
+        m.m[1][2] = static_cast<float>(2.0 * (q.y * q.z - q.x * q.w));
+        m.m[2][0] = static_cast<float>(2.0 * (q.x * q.z - q.y * q.w));
+        m.m[2][1] = static_cast<float>(2.0 * (q.y * q.z + q.x * q.w));
+        m.m[2][2] = static_cast<float>(1.0 - 2.0 * (q.x * q.x + q.y * q.y));
+    }
+
+    float Lerp(float a, float b, double t)
+    {
+        return static_cast<float>(a + (b - a) * t);
+    }
+
+    vr::HmdMatrix34_t Multiply(const vr::HmdMatrix34_t &a, const vr::HmdMatrix34_t &b)
+    {
+        vr::HmdMatrix34_t result;
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 4; ++column)
+            {
+                result.m[row][column] = a.m[row][0] * b.m[0][column] + a.m[row][1] * b.m[1][column] + a.m[row][2] * b.m[2][column];
+                if (column == 3)
+                    result.m[row][column] += a.m[row][3];
+            }
+        }
+        return result;
+    }
+
+    void Decompose(const vr::HmdMatrix34_t &m, Quaternion *pRotation, vr::HmdVector3d_t *pTranslation, vr::HmdVector3d_t *pScale)
+    {
+        vr::HmdMatrix34_t rotation = m;
+        for (int column = 0; column < 3; ++column)
+        {
+            const double scale = std::sqrt(m.m[0][column] * m.m[0][column] + m.m[1][column] * m.m[1][column] + m.m[2][column] * m.m[2][column]);
+            pScale->v[column] = scale;
+            if (scale > 0.0)
+            {
+                for (int row = 0; row < 3; ++row)
+                    rotation.m[row][column] = static_cast<float>(m.m[row][column] / scale);
+            }
+        }
+
+        *pRotation = ToQuaternion(rotation);
+        for (int row = 0; row < 3; ++row)
+            pTranslation->v[row] = m.m[row][3];
+    }
+
+    vr::HmdMatrix34_t Compose(const Quaternion &rotation, const vr::HmdVector3d_t &translation, const vr::HmdVector3d_t &scale)
+    {
+        vr::HmdMatrix34_t result;
+        SetRotation(result, rotation);
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column)
+                result.m[row][column] = static_cast<float>(result.m[row][column] * scale.v[column]);
+            result.m[row][3] = static_cast<float>(translation.v[row]);
+        }
+        return result;
+    }
+
+    double Yaw(const vr::HmdMatrix34_t &m)
+    {
+        // The Z axis projected onto the floor, or the X axis when Z points
+        // straight up or down.
+        if (std::fabs(m.m[0][2]) + std::fabs(m.m[2][2]) > 1e-6f)
+            return std::atan2(m.m[0][2], m.m[2][2]);
+        return std::atan2(-m.m[2][0], m.m[0][0]);
+    }
+
+    Quaternion YawRotation(double yaw)
+    {
+        return {std::cos(0.5 * yaw), 0.0, std::sin(0.5 * yaw), 0.0};
+    }
+
+    double Angle(const Quaternion &a, const Quaternion &b)
+    {
+        const double dot = std::fabs(a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z);
+        return 2.0 * std::acos(std::min(dot, 1.0));
+    }
+
+    vr::HmdMatrix34_t Interpolate(const vr::HmdMatrix34_t &a, const vr::HmdMatrix34_t &b, double t)
+    {
+        Quaternion rotationA, rotationB;
+        vr::HmdVector3d_t translationA, translationB, scaleA, scaleB;
+        Decompose(a, &rotationA, &translationA, &scaleA);
+        Decompose(b, &rotationB, &translationB, &scaleB);
+
+        vr::HmdVector3d_t translation, scale;
+        for (int i = 0; i < 3; ++i)
+        {
+            translation.v[i] = translationA.v[i] + (translationB.v[i] - translationA.v[i]) * t;
+            scale.v[i] = scaleA.v[i] + (scaleB.v[i] - scaleA.v[i]) * t;
+        }
+        return Compose(Slerp(rotationA, rotationB, t), translation, scale);
+    }
+}
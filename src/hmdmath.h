@@ -0,0 +1,46 @@
+#ifndef HMDMATH_H_JS
+#define HMDMATH_H_JS
+
+#include <openvr.h>
+
+/// Rotation and interpolation helpers for HmdMatrix34_t, shared by the pose
+/// sampler and the overlay animator. Y is up, and an overlay faces along +Z.
+namespace HmdMath
+{
+    struct Quaternion
+    {
+        double w, x, y, z;
+    };
+
+    /// The rotation part of m, which must be orthonormal.
+    Quaternion ToQuaternion(const vr::HmdMatrix34_t &m);
+
+    /// Shortest-path spherical interpolation, normalized.
+    Quaternion Slerp(Quaternion a, Quaternion b, double t);
+
+    /// Overwrites the rotation part of m, leaving the translation column.
+    void SetRotation(vr::HmdMatrix34_t &m, const Quaternion &q);
+
+    float Lerp(float a, float b, double t);
+
+    vr::HmdMatrix34_t Multiply(const vr::HmdMatrix34_t &a, const vr::HmdMatrix34_t &b);
+
+    /// Splits an affine transform into rotation, translation and per-axis scale.
+    void Decompose(const vr::HmdMatrix34_t &m, Quaternion *pRotation, vr::HmdVector3d_t *pTranslation, vr::HmdVector3d_t *pScale);
+
+    vr::HmdMatrix34_t Compose(const Quaternion &rotation, const vr::HmdVector3d_t &translation, const vr::HmdVector3d_t &scale);
+
+    /// Heading of m's rotation about +Y, in radians.
+    double Yaw(const vr::HmdMatrix34_t &m);
+
+    Quaternion YawRotation(double yaw);
+
+    /// Angle of the rotation from a to b, in radians.
+    double Angle(const Quaternion &a, const Quaternion &b);
+
+    /// Interpolates two affine transforms: translation and per-axis scale
+    /// linearly, rotation spherically.
+    vr::HmdMatrix34_t Interpolate(const vr::HmdMatrix34_t &a, const vr::HmdMatrix34_t &b, double t);
+}
+
+#endif
@@ -0,0 +1,356 @@
+#include "imagecache.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    // Larger images would not fit an overlay texture anyway.
+    constexpr uint32_t k_unMaxDimension = 16384;
+    constexpr uint64_t k_unMaxPixels = 1ull << 26;
+
+    struct Entry
+    {
+        std::filesystem::file_time_type::rep mtime;
+        uintmax_t unFileSize;
+        std::shared_ptr<const ImageCache::Image> image;
+        std::list<std::string>::iterator lru;
+    };
+
+    std::mutex g_mutex;
+    std::list<std::string> g_lru; // most recently used first
+    std::unordered_map<std::string, Entry> g_entries;
+    uint64_t g_bytes = 0;
+    uint64_t g_budget = ImageCache::k_unDefaultBudget;
+    uint64_t g_hits = 0;
+    uint64_t g_misses = 0;
+    uint64_t g_evictions = 0;
+
+    void EraseLocked(std::unordered_map<std::string, Entry>::iterator entry)
+    {
+        g_bytes -= entry->second.image->pixels.size();
+        g_lru.erase(entry->second.lru);
+        g_entries.erase(entry);
+    }
+
+    void EvictLocked()
+    {
+        while (g_bytes > g_budget && !g_lru.empty())
+        {
+            EraseLocked(g_entries.find(g_lru.back()));
+            ++g_evictions;
+        }
+    }
+
+    uint32_t ReadBigEndian32(const uint8_t *p)
+    {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    }
+
+    uint8_t Paeth(uint8_t a, uint8_t b, uint8_t c)
+    {
+        const int p = int(a) + int(b) - int(c);
+        const int pa = std::abs(p - int(a));
+        const int pb = std::abs(p - int(b));
+        const int pc = std::abs(p - int(c));
+        if (pa <= pb && pa <= pc)
+            return a;
+        return pb <= pc ? b : c;
+    }
+
+    // Reverses the per-row filters in place. Rows are a filter byte followed
+    // by unStride bytes.
+    bool Unfilter(uint8_t *pData, uint32_t unHeight, size_t unStride, size_t unFilterBytes)
+    {
+        const uint8_t *pPrevious = nullptr;
+        for (uint32_t y = 0; y < unHeight; ++y)
+        {
+            const uint8_t uFilter = pData[0];
+            uint8_t *pRow = pData + 1;
+            for (size_t i = 0; i < unStride; ++i)
+            {
+                const uint8_t a = i >= unFilterBytes ? pRow[i - unFilterBytes] : 0;
+                const uint8_t b = pPrevious ? pPrevious[i] : 0;
+                const uint8_t c = pPrevious && i >= unFilterBytes ? pPrevious[i - unFilterBytes] : 0;
+                switch (uFilter)
+                {
+                case 0:
+                    break;
+                case 1:
+                    pRow[i] += a;
+                    break;
+                case 2:
+                    pRow[i] += b;
+                    break;
+                case 3:
+                    pRow[i] += static_cast<uint8_t>((unsigned(a) + unsigned(b)) / 2);
+                    break;
+                case 4:
+                    pRow[i] += Paeth(a, b, c);
+                    break;
+                default:
+                    return false;
+                }
+            }
+            pPrevious = pRow;
+            pData += unStride + 1;
+        }
+        return true;
+    }
+
+    std::shared_ptr<ImageCache::Image> DecodePng(const std::vector<uint8_t> &file)
+    {
+        static const uint8_t k_signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+        if (file.size() < 8 || !std::equal(std::begin(k_signature), std::end(k_signature), file.begin()))
+            return nullptr;
+
+        uint32_t unWidth = 0, unHeight = 0;
+        uint8_t uDepth = 0, uColorType = 0;
+        std::array<std::array<uint8_t, 4>, 256> palette{};
+        uint32_t unPaletteSize = 0;
+        bool bHasColorKey = false;
+        std::array<uint16_t, 3> colorKey{};
+        std::vector<uint8_t> compressed;
+
+        size_t unOffset = 8;
+        bool bEnded = false;
+        while (!bEnded && unOffset + 12 <= file.size())
+        {
+            const uint32_t unLength = ReadBigEndian32(&file[unOffset]);
+            const uint8_t *pType = &file[unOffset + 4];
+            const uint8_t *pChunk = &file[unOffset + 8];
+            if (unLength > file.size() - unOffset - 12)
+                return nullptr;
+            unOffset += 12 + size_t(unLength);
+
+            if (std::equal(pType, pType + 4, "IHDR"))
+            {
+                // Only the non-interlaced layout is handled.
+                if (unLength != 13 || pChunk[10] != 0 || pChunk[11] != 0 || pChunk[12] != 0)
+                    return nullptr;
+                unWidth = ReadBigEndian32(pChunk);
+                unHeight = ReadBigEndian32(pChunk + 4);
+                uDepth = pChunk[8];
+                uColorType = pChunk[9];
+            }
+            else if (std::equal(pType, pType + 4, "PLTE"))
+            {
+                unPaletteSize = std::min<uint32_t>(unLength / 3, 256);
+                for (uint32_t i = 0; i < unPaletteSize; ++i)
+                    palette[i] = {pChunk[i * 3], pChunk[i * 3 + 1], pChunk[i * 3 + 2], 255};
+            }
+            else if (std::equal(pType, pType + 4, "tRNS"))
+            {
+                if (uColorType == 3)
+                {
+                    for (uint32_t i = 0; i < std::min<uint32_t>(unLength, 256); ++i)
+                        palette[i][3] = pChunk[i];
+                }
+                else if ((uColorType == 0 && unLength >= 2) || (uColorType == 2 && unLength >= 6))
+                {
+                    bHasColorKey = true;
+                    for (uint32_t i = 0; i < unLength / 2 && i < 3; ++i)
+                        colorKey[i] = uint16_t((pChunk[i * 2] << 8) | pChunk[i * 2 + 1]);
+                }
+            }
+            else if (std::equal(pType, pType + 4, "IDAT"))
+            {
+                compressed.insert(compressed.end(), pChunk, pChunk + unLength);
+            }
+            else if (std::equal(pType, pType + 4, "IEND"))
+            {
+                bEnded = true;
+            }
+        }
+
+        uint32_t unChannels;
+        switch (uColorType)
+        {
+        case 0: unChannels = 1; break;
+        case 2: unChannels = 3; break;
+        case 3: unChannels = 1; break;
+        case 4: unChannels = 2; break;
+        case 6: unChannels = 4; break;
+        default: return nullptr;
+        }
+        const bool bValidDepth = uColorType == 0 ? (uDepth == 1 || uDepth == 2 || uDepth == 4 || uDepth == 8 || uDepth == 16)
+                               : uColorType == 3 ? (uDepth == 1 || uDepth == 2 || uDepth == 4 || uDepth == 8)
+                                                 : (uDepth == 8 || uDepth == 16);
+        if (!bValidDepth || unWidth == 0 || unHeight == 0 || unWidth > k_unMaxDimension || unHeight > k_unMaxDimension ||
+            uint64_t(unWidth) * unHeight > k_unMaxPixels || (uColorType == 3 && unPaletteSize == 0))
+        {
+            return nullptr;
+        }
+
+        const size_t unStride = (size_t(unWidth) * unChannels * uDepth + 7) / 8;
+        const size_t unFilterBytes = std::max<size_t>(1, unChannels * uDepth / 8);
+        std::vector<uint8_t> filtered((unStride + 1) * unHeight);
+        uLongf unFilteredSize = static_cast<uLongf>(filtered.size());
+        if (uncompress(filtered.data(), &unFilteredSize, compressed.data(), static_cast<uLong>(compressed.size())) != Z_OK ||
+            unFilteredSize != filtered.size() || !Unfilter(filtered.data(), unHeight, unStride, unFilterBytes))
+        {
+            return nullptr;
+        }
+
+        auto image = std::make_shared<ImageCache::Image>();
+        image->unWidth = unWidth;
+        image->unHeight = unHeight;
+        image->pixels.resize(size_t(unWidth) * unHeight * 4);
+
+        const uint32_t unMaxSample = (1u << std::min<uint8_t>(uDepth, 16)) - 1;
+        for (uint32_t y = 0; y < unHeight; ++y)
+        {
+            const uint8_t *pRow = &filtered[y * (unStride + 1) + 1];
+            uint8_t *pOut = &image->pixels[size_t(y) * unWidth * 4];
+
+            auto sample = [&](size_t unIndex) -> uint32_t {
+                if (uDepth == 8)
+                    return pRow[unIndex];
+                if (uDepth == 16)
+                    return (uint32_t(pRow[unIndex * 2]) << 8) | pRow[unIndex * 2 + 1];
+                const size_t unBit = unIndex * uDepth;
+                return (pRow[unBit / 8] >> (8 - uDepth - unBit % 8)) & unMaxSample;
+            };
+            auto to8 = [&](uint32_t unSample) -> uint8_t {
+                return static_cast<uint8_t>(uDepth == 16 ? unSample >> 8 : unSample * 255 / unMaxSample);
+            };
+
+            for (uint32_t x = 0; x < unWidth; ++x, pOut += 4)
+            {
+                switch (uColorType)
+                {
+                case 0:
+                {
+                    const uint32_t g = sample(x);
+                    pOut[0] = pOut[1] = pOut[2] = to8(g);
+                    pOut[3] = bHasColorKey && g == colorKey[0] ? 0 : 255;
+                    break;
+                }
+                case 2:
+                {
+                    const uint32_t r = sample(x * 3), g = sample(x * 3 + 1), b = sample(x * 3 + 2);
+                    pOut[0] = to8(r);
+                    pOut[1] = to8(g);
+                    pOut[2] = to8(b);
+                    pOut[3] = bHasColorKey && r == colorKey[0] && g == colorKey[1] && b == colorKey[2] ? 0 : 255;
+                    break;
+                }
+                case 3:
+                {
+                    const uint32_t unIndex = sample(x);
+                    if (unIndex >= unPaletteSize)
+                        return nullptr;
+                    std::copy(palette[unIndex].begin(), palette[unIndex].end(), pOut);
+                    break;
+                }
+                case 4:
+                    pOut[0] = pOut[1] = pOut[2] = to8(sample(x * 2));
+                    pOut[3] = to8(sample(x * 2 + 1));
+                    break;
+                case 6:
+                    for (uint32_t c = 0; c < 4; ++c)
+                        pOut[c] = to8(sample(x * 4 + c));
+                    break;
+                }
+            }
+        }
+        return image;
+    }
+
+    std::shared_ptr<ImageCache::Image> DecodeFile(const std::string &path)
+    {
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream)
+            return nullptr;
+        const std::vector<uint8_t> file((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        return DecodePng(file);
+    }
+}
+
+namespace ImageCache
+{
+    std::shared_ptr<const Image> Load(const std::string &path, bool *pbCached)
+    {
+        *pbCached = false;
+
+        std::error_code error;
+        const auto mtime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+        const uintmax_t unFileSize = error ? 0 : std::filesystem::file_size(path, error);
+        if (error)
+            return nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            auto entry = g_entries.find(path);
+            if (entry != g_entries.end())
+            {
+                if (entry->second.mtime == mtime && entry->second.unFileSize == unFileSize)
+                {
+                    g_lru.splice(g_lru.begin(), g_lru, entry->second.lru);
+                    ++g_hits;
+                    *pbCached = true;
+                    return entry->second.image;
+                }
+                EraseLocked(entry);
+            }
+            ++g_misses;
+        }
+
+        // Decoded without the lock, so other paths keep hitting meanwhile.
+        std::shared_ptr<const Image> image = DecodeFile(path);
+        if (!image)
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (image->pixels.size() > g_budget)
+            return image;
+
+        // Another load of the same file may have finished first.
+        auto entry = g_entries.find(path);
+        if (entry != g_entries.end())
+            EraseLocked(entry);
+
+        g_lru.push_front(path);
+        g_entries.emplace(path, Entry{mtime, unFileSize, image, g_lru.begin()});
+        g_bytes += image->pixels.size();
+        EvictLocked();
+        return image;
+    }
+
+    void SetBudget(uint64_t unBytes)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_budget = unBytes;
+        EvictLocked();
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_lru.clear();
+        g_entries.clear();
+        g_bytes = 0;
+    }
+
+    Stats GetStats()
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        Stats stats;
+        stats.hits = g_hits;
+        stats.misses = g_misses;
+        stats.evictions = g_evictions;
+        stats.bytes = g_bytes;
+        stats.budget = g_budget;
+        stats.entries = static_cast<uint32_t>(g_entries.size());
+        return stats;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef IMAGECACHE_H_JS
+#define IMAGECACHE_H_JS
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Images decoded from disk to RGBA, kept so that switching an overlay
+/// between a set of image files costs a raw upload instead of the runtime
+/// reading and decoding the file again.
+///
+/// Entries are keyed by path and checked against the file's modification
+/// time and size on every load. Decoded bytes are held under a budget, least
+/// recently used first out.
+///
+/// Only PNG is decoded here, through the zlib that Node itself exports.
+/// Interlaced PNGs and other formats load as null, and callers hand those
+/// to the runtime instead. All functions are thread-safe.
+namespace ImageCache
+{
+    constexpr uint64_t k_unDefaultBudget = 64ull << 20;
+
+    struct Image
+    {
+        uint32_t unWidth;
+        uint32_t unHeight;
+        std::vector<uint8_t> pixels; // RGBA, straight alpha
+    };
+
+    struct Stats
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        uint64_t bytes;
+        uint64_t budget;
+        uint32_t entries;
+    };
+
+    /// The image at path as it is on disk now. pbCached tells whether it came
+    /// from the cache. Blocks on file IO, so call it off the JS thread.
+    std::shared_ptr<const Image> Load(const std::string &path, bool *pbCached);
+
+    /// A budget of 0 turns caching off; every load then decodes.
+    void SetBudget(uint64_t unBytes);
+
+    void Clear();
+
+    Stats GetStats();
+}
+
+#endif
@@ -1,14 +1,68 @@
 #include "ivroverlay.h"
+#include "imagecache.h"
+#include "overlayfingerprint.h"
+#include "overlaymirror.h"
+#include "overlayproperties.h"
+#include "overlayregistry.h"
+#include "overlaytransformcache.h"
+#include "overlayupload.h"
+#include "pixelconvert.h"
 #include "util.h"
 
 #include <array>
+#include <cmath>
+#include <cstring>
 #include <node.h>
 #include <openvr.h>
+#include <string>
+#include <vector>
 
 using namespace v8;
 
 Nan::Persistent<Function> IVROverlay::constructor;
 
+namespace
+{
+    // Overlay handles from a BigUint64Array or an array of anything the
+    // handle decoder takes.
+    bool DecodeOverlayHandleList(Local<Value> value, Isolate *isolate, std::vector<vr::VROverlayHandle_t> *pList)
+    {
+        if (value->IsBigUint64Array())
+        {
+            Local<BigUint64Array> array = value.As<BigUint64Array>();
+            pList->resize(array->Length());
+            array->CopyContents(pList->data(), pList->size() * sizeof(vr::VROverlayHandle_t));
+            return true;
+        }
+
+        if (!value->IsArray())
+            return false;
+
+        Local<Array> array = value.As<Array>();
+        pList->resize(array->Length());
+        for (uint32_t i = 0; i < array->Length(); ++i)
+        {
+            Local<Value> element = Nan::Get(array, i).ToLocalChecked();
+            if (!IsOverlayHandle(element))
+                return false;
+            (*pList)[i] = decode<vr::VROverlayHandle_t>(element, isolate);
+        }
+        return true;
+    }
+
+    // Where the JS code creating an overlay lives, for leak accounting.
+    std::string CreationSite(Isolate *isolate)
+    {
+        Local<StackTrace> stackTrace = StackTrace::CurrentStackTrace(isolate, 1);
+        if (stackTrace->GetFrameCount() == 0)
+            return "<native>";
+
+        Local<StackFrame> frame = stackTrace->GetFrame(isolate, 0);
+        return std::string(*Nan::Utf8String(frame->GetScriptName())) + ":" + std::to_string(frame->GetLineNumber()) + ":" +
+               std::to_string(frame->GetColumn());
+    }
+}
+
 void IVROverlay::Init(Local<Object> exports)
 {
     Local<Context> context = exports->CreationContext();
@@ -66,9 +120,17 @@ void IVROverlay::Init(Local<Object> exports)
     Nan::SetPrototypeMethod(tpl, "ShowOverlay", ShowOverlay);
     Nan::SetPrototypeMethod(tpl, "HideOverlay", HideOverlay);
     Nan::SetPrototypeMethod(tpl, "IsOverlayVisible", IsOverlayVisible);
+    Nan::SetPrototypeMethod(tpl, "SetOverlayProperties", SetOverlayProperties);
+    Nan::SetPrototypeMethod(tpl, "SetOverlayPropertiesBatch", SetOverlayPropertiesBatch);
+    Nan::SetPrototypeMethod(tpl, "SetOverlayTransformsAbsolute", SetOverlayTransformsAbsolute);
     Nan::SetPrototypeMethod(tpl, "GetTransformForOverlayCoordinates", GetTransformForOverlayCoordinates);
 
     Nan::SetPrototypeMethod(tpl, "PollNextOverlayEvent", PollNextOverlayEvent);
+    Nan::SetPrototypeMethod(tpl, "PollNextOverlayEvents", PollNextOverlayEvents);
+    Nan::SetPrototypeMethod(tpl, "SetEventFilter", SetEventFilter);
+    Nan::SetPrototypeMethod(tpl, "GetEventFilter", GetEventFilter);
+    Nan::SetPrototypeMethod(tpl, "SetEventCoalescing", SetEventCoalescing);
+    Nan::SetPrototypeMethod(tpl, "GetEventCoalescing", GetEventCoalescing);
     Nan::SetPrototypeMethod(tpl, "GetOverlayInputMethod", GetOverlayInputMethod);
     Nan::SetPrototypeMethod(tpl, "SetOverlayInputMethod", SetOverlayInputMethod);
     Nan::SetPrototypeMethod(tpl, "GetOverlayMouseScale", GetOverlayMouseScale);
@@ -84,7 +146,17 @@ void IVROverlay::Init(Local<Object> exports)
     Nan::SetPrototypeMethod(tpl, "SetOverlayTexture", SetOverlayTexture);
     Nan::SetPrototypeMethod(tpl, "ClearOverlayTexture", ClearOverlayTexture);
     Nan::SetPrototypeMethod(tpl, "SetOverlayRaw", SetOverlayRaw);
+    Nan::SetPrototypeMethod(tpl, "SetOverlayRawAsync", SetOverlayRawAsync);
+    Nan::SetPrototypeMethod(tpl, "SetSkipUnchangedUploads", SetSkipUnchangedUploads);
+    Nan::SetPrototypeMethod(tpl, "GetOverlayUploadStats", GetOverlayUploadStats);
     Nan::SetPrototypeMethod(tpl, "SetOverlayFromFile", SetOverlayFromFile);
+    Nan::SetPrototypeMethod(tpl, "SetOverlayFromFileAsync", SetOverlayFromFileAsync);
+    Nan::SetPrototypeMethod(tpl, "SetOverlayImageCacheBudget", SetOverlayImageCacheBudget);
+    Nan::SetPrototypeMethod(tpl, "ClearOverlayImageCache", ClearOverlayImageCache);
+    Nan::SetPrototypeMethod(tpl, "GetOverlayImageCacheStats", GetOverlayImageCacheStats);
+    Nan::SetPrototypeMethod(tpl, "SetOverlayStateMirrorEnabled", SetOverlayStateMirrorEnabled);
+    Nan::SetPrototypeMethod(tpl, "GetOverlayStateMirrorStats", GetOverlayStateMirrorStats);
+    Nan::SetPrototypeMethod(tpl, "GetOverlayRegistryStats", GetOverlayRegistryStats);
     // Nan::SetPrototypeMethod(tpl, "GetOverlayTexture", GetOverlayTexture);
     Nan::SetPrototypeMethod(tpl, "ReleaseNativeOverlayHandle", ReleaseNativeOverlayHandle);
     Nan::SetPrototypeMethod(tpl, "GetOverlayTextureSize", GetOverlayTextureSize);
@@ -127,6 +199,11 @@ IVROverlay::IVROverlay(vr::IVROverlay *self)
 {
 }
 
+IVROverlay::~IVROverlay()
+{
+    OverlayRegistry::DestroyOwned(this, self_);
+}
+
 void IVROverlay::New(const Nan::FunctionCallbackInfo<Value> &info)
 {
     if (!info.IsConstructCall())
@@ -152,9 +229,10 @@ void IVROverlay::FindOverlay(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    const char *pchOverlayKey = *Nan::Utf8String(info[0]);
+    const std::string overlayKey = *Nan::Utf8String(info[0]);
     vr::VROverlayHandle_t OverlayHandle;
-    obj->self_->FindOverlay(pchOverlayKey, &OverlayHandle);
+    if (!OverlayRegistry::Find(overlayKey, &OverlayHandle))
+        obj->self_->FindOverlay(overlayKey.c_str(), &OverlayHandle);
     info.GetReturnValue().Set(encode(OverlayHandle));
 }
 // virtual EVROverlayError CreateOverlay( const char *pchOverlayKey, const char *pchOverlayName, VROverlayHandle_t * pOverlayHandle ) = 0;
@@ -163,10 +241,14 @@ void IVROverlay::CreateOverlay(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    const char *pchOverlayKey = *Nan::Utf8String(info[0]);
-    const char *pchOverlayName = *Nan::Utf8String(info[1]);
+    const std::string overlayKey = *Nan::Utf8String(info[0]);
+    const std::string overlayName = *Nan::Utf8String(info[1]);
     vr::VROverlayHandle_t OverlayHandle;
-    obj->self_->CreateOverlay(pchOverlayKey, pchOverlayName, &OverlayHandle);
+    if (obj->self_->CreateOverlay(overlayKey.c_str(), overlayName.c_str(), &OverlayHandle) == vr::VROverlayError_None)
+    {
+        OverlayRegistry::Add(obj, OverlayHandle, vr::k_ulOverlayHandleInvalid, overlayKey, CreationSite(info.GetIsolate()));
+        OverlayMirror::Track(OverlayHandle, false);
+    }
     info.GetReturnValue().Set(encode(OverlayHandle));
 }
 // virtual EVROverlayError DestroyOverlay( VROverlayHandle_t ulOverlayHandle ) = 0;
@@ -175,8 +257,17 @@ void IVROverlay::DestroyOverlay(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+    OverlayFingerprint::Forget(ulOverlayHandle);
+    OverlayMirror::Forget(ulOverlayHandle);
+    OverlayTransformCache::Forget(ulOverlayHandle);
+    OverlayRawUpload::Forget(ulOverlayHandle);
+    obj->eventCoalescer_.Forget(ulOverlayHandle);
     vr::EVROverlayError overlayError = obj->self_->DestroyOverlay(ulOverlayHandle);
+    if (overlayError == vr::VROverlayError_None)
+        OverlayRegistry::Remove(ulOverlayHandle);
     info.GetReturnValue().Set(Nan::New<Number>(static_cast<uint32_t>(overlayError)));
 }
 // virtual uint32_t GetOverlayKey( VROverlayHandle_t ulOverlayHandle, VR_OUT_STRING() char *pchValue, uint32_t unBufferSize, EVROverlayError *pError = 0L ) = 0;
@@ -185,7 +276,9 @@ void IVROverlay::GetOverlayKey(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     char *pchValue;
     obj->self_->GetOverlayKey(ulOverlayHandle, pchValue, vr::k_unVROverlayMaxKeyLength);
     info.GetReturnValue().Set(Nan::New<String>(pchValue).ToLocalChecked());
@@ -196,7 +289,9 @@ void IVROverlay::GetOverlayName(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     char *pchValue;
     obj->self_->GetOverlayKey(ulOverlayHandle, pchValue, vr::k_unVROverlayMaxNameLength);
     info.GetReturnValue().Set(Nan::New<String>(pchValue).ToLocalChecked());
@@ -207,7 +302,9 @@ void IVROverlay::SetOverlayName(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     const char *pchName = *Nan::Utf8String(info[1]);
     vr::EVROverlayError error = obj->self_->SetOverlayName(ulOverlayHandle, pchName);
 
@@ -240,7 +337,9 @@ void IVROverlay::SetOverlayRenderingPid(const Nan::FunctionCallbackInfo<Value> &
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     uint32_t unPID = info[1]->Uint32Value(context).FromJust();
     vr::EVROverlayError error = obj->self_->SetOverlayRenderingPid(ulOverlayHandle, unPID);
 
@@ -256,7 +355,9 @@ void IVROverlay::GetOverlayRenderingPid(const Nan::FunctionCallbackInfo<Value> &
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     uint32_t unPID = obj->self_->SetOverlayRenderingPid(ulOverlayHandle, unPID);
     info.GetReturnValue().Set(Nan::New<Number>(unPID));
 }
@@ -266,7 +367,9 @@ void IVROverlay::SetOverlayFlag(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::VROverlayFlags eOverlayFlag = static_cast<vr::VROverlayFlags>(info[1]->Uint32Value(context).FromJust());
     bool bEnabled = info[2]->BooleanValue(info.GetIsolate());
     vr::EVROverlayError error = obj->self_->SetOverlayFlag(ulOverlayHandle, eOverlayFlag, bEnabled);
@@ -283,7 +386,9 @@ void IVROverlay::GetOverlayFlag(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::VROverlayFlags eOverlayFlag = static_cast<vr::VROverlayFlags>(info[1]->Uint32Value(context).FromJust());
     bool bEnabled;
     vr::EVROverlayError error = obj->self_->GetOverlayFlag(ulOverlayHandle, eOverlayFlag, &bEnabled);
@@ -302,7 +407,9 @@ void IVROverlay::GetOverlayFlags(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     uint32_t flags;
     vr::EVROverlayError error = obj->self_->GetOverlayFlags(ulOverlayHandle, &flags);
 
@@ -320,7 +427,9 @@ void IVROverlay::SetOverlayColor(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     float fRed = info[1]->NumberValue(context).FromJust();
     float fGreen = info[2]->NumberValue(context).FromJust();
     float fBlue = info[3]->NumberValue(context).FromJust();
@@ -331,6 +440,12 @@ void IVROverlay::SetOverlayColor(const Nan::FunctionCallbackInfo<Value> &info)
         Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
         return;
     }
+
+    OverlayProperties mirrored;
+    mirrored.fRed = fRed;
+    mirrored.fGreen = fGreen;
+    mirrored.fBlue = fBlue;
+    OverlayMirror::Record(ulOverlayHandle, mirrored, OverlayProperties::Field_Color);
 }
 // virtual EVROverlayError GetOverlayColor( VROverlayHandle_t ulOverlayHandle, float *pfRed, float *pfGreen, float *pfBlue ) = 0;
 void IVROverlay::GetOverlayColor(const Nan::FunctionCallbackInfo<Value> &info)
@@ -338,26 +453,33 @@ void IVROverlay::GetOverlayColor(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
-    float fRed, fGreen, fBlue;
-    vr::EVROverlayError error = obj->self_->GetOverlayColor(ulOverlayHandle, &fRed, &fGreen, &fBlue);
-
-    if (error != vr::VROverlayError_None)
-    {
-        Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
         return;
+    OverlayProperties mirrored;
+    if (!OverlayMirror::Lookup(ulOverlayHandle, OverlayProperties::Field_Color, &mirrored))
+    {
+        vr::EVROverlayError error = obj->self_->GetOverlayColor(ulOverlayHandle, &mirrored.fRed, &mirrored.fGreen, &mirrored.fBlue);
+
+        if (error != vr::VROverlayError_None)
+        {
+            Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
+            return;
+        }
+
+        OverlayMirror::Record(ulOverlayHandle, mirrored, OverlayProperties::Field_Color);
     }
 
     Local<Object> result = Nan::New<Object>();
     {
         Local<String> left_prop = Nan::New<String>("Red").ToLocalChecked();
-        Nan::Set(result, left_prop, Nan::New<Number>(fRed));
+        Nan::Set(result, left_prop, Nan::New<Number>(mirrored.fRed));
 
         Local<String> right_prop = Nan::New<String>("Green").ToLocalChecked();
-        Nan::Set(result, right_prop, Nan::New<Number>(fGreen));
+        Nan::Set(result, right_prop, Nan::New<Number>(mirrored.fGreen));
 
         Local<String> top_prop = Nan::New<String>("Blue").ToLocalChecked();
-        Nan::Set(result, top_prop, Nan::New<Number>(fBlue));
+        Nan::Set(result, top_prop, Nan::New<Number>(mirrored.fBlue));
     }
 
     info.GetReturnValue().Set(result);
@@ -368,7 +490,9 @@ void IVROverlay::SetOverlayAlpha(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     float fAlpha = info[1]->NumberValue(context).FromJust();
     vr::EVROverlayError error = obj->self_->SetOverlayAlpha(ulOverlayHandle, fAlpha);
 
@@ -377,6 +501,10 @@ void IVROverlay::SetOverlayAlpha(const Nan::FunctionCallbackInfo<Value> &info)
         Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
         return;
     }
+
+    OverlayProperties mirrored;
+    mirrored.fAlpha = fAlpha;
+    OverlayMirror::Record(ulOverlayHandle, mirrored, OverlayProperties::Field_Alpha);
 }
 // virtual EVROverlayError GetOverlayAlpha( VROverlayHandle_t ulOverlayHandle, float *pfAlpha ) = 0;
 void IVROverlay::GetOverlayAlpha(const Nan::FunctionCallbackInfo<Value> &info)
@@ -384,17 +512,24 @@ void IVROverlay::GetOverlayAlpha(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
-    float fAlpha;
-    vr::EVROverlayError error = obj->self_->GetOverlayAlpha(ulOverlayHandle, &fAlpha);
-
-    if (error != vr::VROverlayError_None)
-    {
-        Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
         return;
+    OverlayProperties mirrored;
+    if (!OverlayMirror::Lookup(ulOverlayHandle, OverlayProperties::Field_Alpha, &mirrored))
+    {
+        vr::EVROverlayError error = obj->self_->GetOverlayAlpha(ulOverlayHandle, &mirrored.fAlpha);
+
+        if (error != vr::VROverlayError_None)
+        {
+            Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
+            return;
+        }
+
+        OverlayMirror::Record(ulOverlayHandle, mirrored, OverlayProperties::Field_Alpha);
     }
 
-    info.GetReturnValue().Set(Nan::New<Number>(fAlpha));
+    info.GetReturnValue().Set(Nan::New<Number>(mirrored.fAlpha));
 }
 // virtual EVROverlayError SetOverlayTexelAspect( VROverlayHandle_t ulOverlayHandle, float fTexelAspect ) = 0;
 void IVROverlay::SetOverlayTexelAspect(const Nan::FunctionCallbackInfo<Value> &info)
@@ -402,7 +537,9 @@ void IVROverlay::SetOverlayTexelAspect(const Nan::FunctionCallbackInfo<Value> &i
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     float fTexelAspect = info[1]->NumberValue(context).FromJust();
     vr::EVROverlayError error = obj->self_->SetOverlayTexelAspect(ulOverlayHandle, fTexelAspect);
 
@@ -418,7 +555,9 @@ void IVROverlay::GetOverlayTexelAspect(const Nan::FunctionCallbackInfo<Value> &i
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     float pfTexelAspect;
     vr::EVROverlayError error = obj->self_->GetOverlayTexelAspect(ulOverlayHandle, &pfTexelAspect);
 
@@ -436,7 +575,9 @@ void IVROverlay::SetOverlaySortOrder(const Nan::FunctionCallbackInfo<Value> &inf
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     uint32_t unSortOrder = info[1]->NumberValue(context).FromJust();
     vr::EVROverlayError error = obj->self_->SetOverlaySortOrder(ulOverlayHandle, unSortOrder);
 
@@ -452,7 +593,9 @@ void IVROverlay::GetOverlaySortOrder(const Nan::FunctionCallbackInfo<Value> &inf
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     uint32_t punSortOrder;
     vr::EVROverlayError error = obj->self_->GetOverlaySortOrder(ulOverlayHandle, &punSortOrder);
 
@@ -470,7 +613,9 @@ void IVROverlay::SetOverlayWidthInMeters(const Nan::FunctionCallbackInfo<Value>
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     float fWidthInMeters = info[1]->NumberValue(context).FromJust();
     vr::EVROverlayError error = obj->self_->SetOverlayWidthInMeters(ulOverlayHandle, fWidthInMeters);
 
@@ -479,6 +624,10 @@ void IVROverlay::SetOverlayWidthInMeters(const Nan::FunctionCallbackInfo<Value>
         Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
         return;
     }
+
+    OverlayProperties mirrored;
+    mirrored.fWidthInMeters = fWidthInMeters;
+    OverlayMirror::Record(ulOverlayHandle, mirrored, OverlayProperties::Field_WidthInMeters);
 }
 // virtual EVROverlayError GetOverlayWidthInMeters( VROverlayHandle_t ulOverlayHandle, float *pfWidthInMeters ) = 0;
 void IVROverlay::GetOverlayWidthInMeters(const Nan::FunctionCallbackInfo<Value> &info)
@@ -486,17 +635,24 @@ void IVROverlay::GetOverlayWidthInMeters(const Nan::FunctionCallbackInfo<Value>
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
-    float fWidthInMeters;
-    vr::EVROverlayError error = obj->self_->GetOverlayWidthInMeters(ulOverlayHandle, &fWidthInMeters);
-
-    if (error != vr::VROverlayError_None)
-    {
-        Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
         return;
+    OverlayProperties mirrored;
+    if (!OverlayMirror::Lookup(ulOverlayHandle, OverlayProperties::Field_WidthInMeters, &mirrored))
+    {
+        vr::EVROverlayError error = obj->self_->GetOverlayWidthInMeters(ulOverlayHandle, &mirrored.fWidthInMeters);
+
+        if (error != vr::VROverlayError_None)
+        {
+            Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
+            return;
+        }
+
+        OverlayMirror::Record(ulOverlayHandle, mirrored, OverlayProperties::Field_WidthInMeters);
     }
 
-    info.GetReturnValue().Set(Nan::New<Number>(fWidthInMeters));
+    info.GetReturnValue().Set(Nan::New<Number>(mirrored.fWidthInMeters));
 }
 // virtual EVROverlayError SetOverlayCurvature( VROverlayHandle_t ulOverlayHandle, float fCurvature ) = 0;
 void IVROverlay::SetOverlayCurvature(const Nan::FunctionCallbackInfo<Value> &info)
@@ -504,7 +660,9 @@ void IVROverlay::SetOverlayCurvature(const Nan::FunctionCallbackInfo<Value> &inf
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     float fCurvature = info[1]->NumberValue(context).FromJust();
     vr::EVROverlayError error = obj->self_->SetOverlayCurvature(ulOverlayHandle, fCurvature);
 
@@ -520,7 +678,9 @@ void IVROverlay::GetOverlayCurvature(const Nan::FunctionCallbackInfo<Value> &inf
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     float pfCurvature;
     vr::EVROverlayError error = obj->self_->GetOverlayCurvature(ulOverlayHandle, &pfCurvature);
 
@@ -538,7 +698,9 @@ void IVROverlay::SetOverlayTextureColorSpace(const Nan::FunctionCallbackInfo<Val
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::EColorSpace eTextureColorSpace = static_cast<vr::EColorSpace>(info[1]->Uint32Value(context).FromJust());
     vr::EVROverlayError error = obj->self_->SetOverlayTextureColorSpace(ulOverlayHandle, eTextureColorSpace);
 
@@ -554,7 +716,9 @@ void IVROverlay::GetOverlayTextureColorSpace(const Nan::FunctionCallbackInfo<Val
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::EColorSpace eTextureColorSpace;
     vr::EVROverlayError error = obj->self_->GetOverlayTextureColorSpace(ulOverlayHandle, &eTextureColorSpace);
 
@@ -572,7 +736,9 @@ void IVROverlay::SetOverlayTextureBounds(const Nan::FunctionCallbackInfo<Value>
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::VRTextureBounds_t OverlayTextureBounds = decode<vr::VRTextureBounds_t>(info[1], info.GetIsolate());
     vr::EVROverlayError error = obj->self_->SetOverlayTextureBounds(ulOverlayHandle, &OverlayTextureBounds);
 
@@ -588,7 +754,9 @@ void IVROverlay::GetOverlayTextureBounds(const Nan::FunctionCallbackInfo<Value>
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::VRTextureBounds_t OverlayTextureBounds;
     vr::EVROverlayError error = obj->self_->GetOverlayTextureBounds(ulOverlayHandle, &OverlayTextureBounds);
 
@@ -606,7 +774,9 @@ void IVROverlay::GetOverlayTransformType(const Nan::FunctionCallbackInfo<Value>
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::VROverlayTransformType OverlayTransformType;
     vr::EVROverlayError error = obj->self_->GetOverlayTransformType(ulOverlayHandle, &OverlayTransformType);
 
@@ -624,7 +794,9 @@ void IVROverlay::SetOverlayTransformAbsolute(const Nan::FunctionCallbackInfo<Val
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::ETrackingUniverseOrigin eTrackingOrigin = static_cast<vr::ETrackingUniverseOrigin>(info[1]->Uint32Value(context).FromJust());
     vr::HmdMatrix34_t matTrackingOriginToOverlayTransform = decode<vr::HmdMatrix34_t>(info[2], info.GetIsolate());
     vr::EVROverlayError error = obj->self_->SetOverlayTransformAbsolute(ulOverlayHandle, eTrackingOrigin, &matTrackingOriginToOverlayTransform);
@@ -634,6 +806,12 @@ void IVROverlay::SetOverlayTransformAbsolute(const Nan::FunctionCallbackInfo<Val
         Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
         return;
     }
+
+    OverlayProperties mirrored;
+    mirrored.eTrackingOrigin = eTrackingOrigin;
+    mirrored.transform = matTrackingOriginToOverlayTransform;
+    OverlayMirror::Record(ulOverlayHandle, mirrored, OverlayProperties::Field_Transform);
+    OverlayTransformCache::Store(ulOverlayHandle, eTrackingOrigin, matTrackingOriginToOverlayTransform);
 }
 // virtual EVROverlayError GetOverlayTransformAbsolute( VROverlayHandle_t ulOverlayHandle, ETrackingUniverseOrigin *peTrackingOrigin, HmdMatrix34_t *pmatTrackingOriginToOverlayTransform ) = 0;
 void IVROverlay::GetOverlayTransformAbsolute(const Nan::FunctionCallbackInfo<Value> &info)
@@ -641,24 +819,30 @@ void IVROverlay::GetOverlayTransformAbsolute(const Nan::FunctionCallbackInfo<Val
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
-    vr::ETrackingUniverseOrigin eTrackingOrigin;
-    vr::HmdMatrix34_t matTrackingOriginToOverlayTransform;
-    vr::EVROverlayError error = obj->self_->GetOverlayTransformAbsolute(ulOverlayHandle, &eTrackingOrigin, &matTrackingOriginToOverlayTransform);
-
-    if (error != vr::VROverlayError_None)
-    {
-        Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
         return;
+    OverlayProperties mirrored;
+    if (!OverlayMirror::Lookup(ulOverlayHandle, OverlayProperties::Field_Transform, &mirrored))
+    {
+        vr::EVROverlayError error = obj->self_->GetOverlayTransformAbsolute(ulOverlayHandle, &mirrored.eTrackingOrigin, &mirrored.transform);
+
+        if (error != vr::VROverlayError_None)
+        {
+            Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
+            return;
+        }
+
+        OverlayMirror::Record(ulOverlayHandle, mirrored, OverlayProperties::Field_Transform);
     }
 
     Local<Object> result = Nan::New<Object>();
     {
         Local<String> TrackingOrigin_prop = Nan::New<String>("TrackingOrigin").ToLocalChecked();
-        Nan::Set(result, TrackingOrigin_prop, Nan::New<Number>(static_cast<uint32_t>(eTrackingOrigin)));
+        Nan::Set(result, TrackingOrigin_prop, Nan::New<Number>(static_cast<uint32_t>(mirrored.eTrackingOrigin)));
 
         Local<String> TrackingOriginToOverlayTransform_prop = Nan::New("TrackingOriginToOverlayTransform").ToLocalChecked();
-        Nan::Set(result, TrackingOriginToOverlayTransform_prop, encode(matTrackingOriginToOverlayTransform));
+        Nan::Set(result, TrackingOriginToOverlayTransform_prop, encode(mirrored.transform));
     }
 
     info.GetReturnValue().Set(result);
@@ -669,9 +853,13 @@ void IVROverlay::SetOverlayTransformTrackedDeviceRelative(const Nan::FunctionCal
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::TrackedDeviceIndex_t unTrackedDevice = static_cast<vr::TrackedDeviceIndex_t>(info[1]->Uint32Value(context).FromJust());
     vr::HmdMatrix34_t matTrackedDeviceToOverlayTransform = decode<vr::HmdMatrix34_t>(info[2], info.GetIsolate());
+    OverlayMirror::Invalidate(ulOverlayHandle, OverlayProperties::Field_Transform);
+    OverlayTransformCache::Forget(ulOverlayHandle);
     vr::EVROverlayError error = obj->self_->SetOverlayTransformTrackedDeviceRelative(ulOverlayHandle, unTrackedDevice, &matTrackedDeviceToOverlayTransform);
 
     if (error != vr::VROverlayError_None)
@@ -686,7 +874,9 @@ void IVROverlay::GetOverlayTransformTrackedDeviceRelative(const Nan::FunctionCal
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::TrackedDeviceIndex_t unTrackedDevice;
     vr::HmdMatrix34_t matTrackedDeviceToOverlayTransform;
     vr::EVROverlayError error = obj->self_->GetOverlayTransformTrackedDeviceRelative(ulOverlayHandle, &unTrackedDevice, &matTrackedDeviceToOverlayTransform);
@@ -714,9 +904,13 @@ void IVROverlay::SetOverlayTransformTrackedDeviceComponent(const Nan::FunctionCa
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::TrackedDeviceIndex_t unDeviceIndex = static_cast<vr::TrackedDeviceIndex_t>(info[1]->Uint32Value(context).FromJust());
     const char *pchComponentName = *Nan::Utf8String(info[2]);
+    OverlayMirror::Invalidate(ulOverlayHandle, OverlayProperties::Field_Transform);
+    OverlayTransformCache::Forget(ulOverlayHandle);
     vr::EVROverlayError error = obj->self_->SetOverlayTransformTrackedDeviceComponent(ulOverlayHandle, unDeviceIndex, pchComponentName);
 
     if (error != vr::VROverlayError_None)
@@ -731,7 +925,9 @@ void IVROverlay::GetOverlayTransformTrackedDeviceComponent(const Nan::FunctionCa
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::TrackedDeviceIndex_t unDeviceIndex;
     char *chComponentName;
     vr::EVROverlayError error = obj->self_->GetOverlayTransformTrackedDeviceComponent(ulOverlayHandle, &unDeviceIndex, chComponentName, vr::k_unVROverlayMaxNameLength);
@@ -759,7 +955,9 @@ void IVROverlay::GetOverlayTransformOverlayRelative(const Nan::FunctionCallbackI
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::VROverlayHandle_t ulOverlayHandleParent;
     vr::HmdMatrix34_t matParentOverlayToOverlayTransform;
     vr::EVROverlayError error = obj->self_->GetOverlayTransformOverlayRelative(ulOverlayHandle, &ulOverlayHandleParent, &matParentOverlayToOverlayTransform);
@@ -773,7 +971,7 @@ void IVROverlay::GetOverlayTransformOverlayRelative(const Nan::FunctionCallbackI
     Local<Object> result = Nan::New<Object>();
     {
         Local<String> OverlayHandleParent_prop = Nan::New<String>("OverlayHandleParent").ToLocalChecked();
-        Nan::Set(result, OverlayHandleParent_prop, Nan::New<Number>(static_cast<uint32_t>(ulOverlayHandleParent)));
+        Nan::Set(result, OverlayHandleParent_prop, encode(ulOverlayHandleParent));
 
         Local<String> ParentOverlayToOverlayTransform_prop = Nan::New("ParentOverlayToOverlayTransform").ToLocalChecked();
         Nan::Set(result, ParentOverlayToOverlayTransform_prop, encode(matParentOverlayToOverlayTransform));
@@ -784,13 +982,18 @@ void IVROverlay::GetOverlayTransformOverlayRelative(const Nan::FunctionCallbackI
 // virtual vr::EVROverlayError SetOverlayTransformOverlayRelative( VROverlayHandle_t ulOverlayHandle, VROverlayHandle_t ulOverlayHandleParent, const HmdMatrix34_t *pmatParentOverlayToOverlayTransform ) = 0;
 void IVROverlay::SetOverlayTransformOverlayRelative(const Nan::FunctionCallbackInfo<Value> &info)
 {
-    Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
-    vr::VROverlayHandle_t ulOverlayHandleParent = static_cast<vr::VROverlayHandle_t>(info[1]->Uint32Value(context).FromJust());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+    vr::VROverlayHandle_t ulOverlayHandleParent;
+    if (!DecodeOverlayHandle(info[1], info.GetIsolate(), &ulOverlayHandleParent))
+        return;
     vr::HmdMatrix34_t matParentOverlayToOverlayTransform = decode<vr::HmdMatrix34_t>(info[2], info.GetIsolate());
-    vr::EVROverlayError error = obj->self_->GetOverlayTransformOverlayRelative(ulOverlayHandle, &ulOverlayHandleParent, &matParentOverlayToOverlayTransform);
+    OverlayMirror::Invalidate(ulOverlayHandle, OverlayProperties::Field_Transform);
+    OverlayTransformCache::Forget(ulOverlayHandle);
+    vr::EVROverlayError error = obj->self_->SetOverlayTransformOverlayRelative(ulOverlayHandle, ulOverlayHandleParent, &matParentOverlayToOverlayTransform);
 
     if (error != vr::VROverlayError_None)
     {
@@ -804,9 +1007,13 @@ void IVROverlay::SetOverlayTransformCursor(const Nan::FunctionCallbackInfo<Value
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulCursorOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulCursorOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulCursorOverlayHandle))
+        return;
     vr::HmdVector2_t vHotSpot = decode<vr::HmdVector2_t>(info[1], info.GetIsolate());
 
+    OverlayMirror::Invalidate(ulCursorOverlayHandle, OverlayProperties::Field_Transform);
+    OverlayTransformCache::Forget(ulCursorOverlayHandle);
     vr::EVROverlayError error = obj->self_->SetOverlayTransformCursor(ulCursorOverlayHandle, &vHotSpot);
 
     if (error != vr::VROverlayError_None)
@@ -821,7 +1028,9 @@ void IVROverlay::GetOverlayTransformCursor(const Nan::FunctionCallbackInfo<Value
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulCursorOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulCursorOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulCursorOverlayHandle))
+        return;
     vr::HmdVector2_t vHotSpot;
 
     vr::EVROverlayError error = obj->self_->SetOverlayTransformCursor(ulCursorOverlayHandle, &vHotSpot);
@@ -842,12 +1051,16 @@ void IVROverlay::SetOverlayTransformProjection(const Nan::FunctionCallbackInfo<V
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::ETrackingUniverseOrigin eTrackingOrigin = static_cast<vr::ETrackingUniverseOrigin>(info[1]->Uint32Value(context).FromJust());
     vr::HmdMatrix34_t matTrackingOriginToOverlayTransform = decode<vr::HmdMatrix34_t>(info[2], info.GetIsolate());
     vr::VROverlayProjection_t Projection = decode<vr::VROverlayProjection_t>(info[3], info.GetIsolate());
     vr::EVREye eEye = static_cast<vr::EVREye>(info[4]->Uint32Value(context).FromJust());
 
+    OverlayMirror::Invalidate(ulOverlayHandle, OverlayProperties::Field_Transform);
+    OverlayTransformCache::Forget(ulOverlayHandle);
     vr::EVROverlayError error = obj->self_->SetOverlayTransformProjection(ulOverlayHandle, eTrackingOrigin, &matTrackingOriginToOverlayTransform, &Projection, eEye);
 
     if (error != vr::VROverlayError_None)
@@ -862,7 +1075,9 @@ void IVROverlay::ShowOverlay(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::EVROverlayError error = obj->self_->ShowOverlay(ulOverlayHandle);
 
     if (error != vr::VROverlayError_None)
@@ -870,6 +1085,10 @@ void IVROverlay::ShowOverlay(const Nan::FunctionCallbackInfo<Value> &info)
         Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
         return;
     }
+
+    OverlayProperties mirrored;
+    mirrored.bVisible = true;
+    OverlayMirror::Record(ulOverlayHandle, mirrored, OverlayProperties::Field_Visible);
 }
 // virtual EVROverlayError HideOverlay( VROverlayHandle_t ulOverlayHandle ) = 0;
 void IVROverlay::HideOverlay(const Nan::FunctionCallbackInfo<Value> &info)
@@ -877,7 +1096,9 @@ void IVROverlay::HideOverlay(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::EVROverlayError error = obj->self_->HideOverlay(ulOverlayHandle);
 
     if (error != vr::VROverlayError_None)
@@ -885,6 +1106,10 @@ void IVROverlay::HideOverlay(const Nan::FunctionCallbackInfo<Value> &info)
         Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
         return;
     }
+
+    OverlayProperties mirrored;
+    mirrored.bVisible = false;
+    OverlayMirror::Record(ulOverlayHandle, mirrored, OverlayProperties::Field_Visible);
 }
 // virtual bool IsOverlayVisible( VROverlayHandle_t ulOverlayHandle ) = 0;
 void IVROverlay::IsOverlayVisible(const Nan::FunctionCallbackInfo<Value> &info)
@@ -892,9 +1117,171 @@ void IVROverlay::IsOverlayVisible(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
-    bool isOverlayVisible = obj->self_->IsOverlayVisible(ulOverlayHandle);
-    info.GetReturnValue().Set(Nan::New<Boolean>(isOverlayVisible));
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+    OverlayProperties mirrored;
+    if (!OverlayMirror::Lookup(ulOverlayHandle, OverlayProperties::Field_Visible, &mirrored))
+    {
+        mirrored.bVisible = obj->self_->IsOverlayVisible(ulOverlayHandle);
+        OverlayMirror::Record(ulOverlayHandle, mirrored, OverlayProperties::Field_Visible);
+    }
+    info.GetReturnValue().Set(Nan::New<Boolean>(mirrored.bVisible));
+}
+// SetOverlayProperties( ulOverlayHandle, properties: OverlayProperties ): void
+void IVROverlay::SetOverlayProperties(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
+
+    if (info.Length() != 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+    OverlayProperties properties;
+    if (!OverlayProperties::Decode(info[1], "Argument[1]", &properties))
+        return;
+
+    vr::EVROverlayError error = properties.Apply(obj->self_, ulOverlayHandle);
+    if (error != vr::VROverlayError_None)
+    {
+        Nan::ThrowError(obj->self_->GetOverlayErrorNameFromEnum(error));
+        return;
+    }
+}
+// SetOverlayPropertiesBatch( overlayHandles, properties: OverlayProperties | OverlayProperties[] ): Int32Array
+// One descriptor applies to every overlay; an array pairs descriptors with
+// overlays by index. Returns each overlay's first EVROverlayError instead of
+// throwing, so one bad handle does not stop the rest.
+void IVROverlay::SetOverlayPropertiesBatch(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
+
+    if (info.Length() != 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    std::vector<vr::VROverlayHandle_t> overlayHandles;
+    if (!DecodeOverlayHandleList(info[0], info.GetIsolate(), &overlayHandles))
+    {
+        Nan::ThrowTypeError("Argument[0] must be an array of overlay handles or a BigUint64Array.");
+        return;
+    }
+
+    // Everything is decoded before anything is applied, so a malformed
+    // descriptor leaves every overlay untouched.
+    std::vector<OverlayProperties> properties;
+    if (info[1]->IsArray())
+    {
+        Local<Array> descriptors = info[1].As<Array>();
+        if (descriptors->Length() != overlayHandles.size())
+        {
+            Nan::ThrowRangeError("Argument[1] must have one descriptor per overlay handle.");
+            return;
+        }
+
+        properties.resize(overlayHandles.size());
+        for (uint32_t i = 0; i < descriptors->Length(); ++i)
+        {
+            if (!OverlayProperties::Decode(Nan::Get(descriptors, i).ToLocalChecked(), "Argument[1][" + std::to_string(i) + "]", &properties[i]))
+                return;
+        }
+    }
+    else
+    {
+        properties.resize(1);
+        if (!OverlayProperties::Decode(info[1], "Argument[1]", &properties[0]))
+            return;
+    }
+
+    Local<Int32Array> errors = Int32Array::New(ArrayBuffer::New(info.GetIsolate(), overlayHandles.size() * sizeof(int32_t)), 0, overlayHandles.size());
+    int32_t *pErrors = reinterpret_cast<int32_t *>(static_cast<uint8_t *>(errors->Buffer()->Data()) + errors->ByteOffset());
+    for (size_t i = 0; i < overlayHandles.size(); ++i)
+        pErrors[i] = properties[properties.size() == 1 ? 0 : i].Apply(obj->self_, overlayHandles[i]);
+
+    info.GetReturnValue().Set(errors);
+}
+// SetOverlayTransformsAbsolute( overlayHandles, eTrackingOrigin, transforms: Float32Array ): Int32Array
+// transforms holds one row-major 3x4 matrix per overlay. Transforms equal to
+// the one this process last sent the overlay, or to the mirrored one, are not sent.
+// Returns each overlay's EVROverlayError instead of throwing.
+void IVROverlay::SetOverlayTransformsAbsolute(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
+
+    if (info.Length() != 3)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    std::vector<vr::VROverlayHandle_t> overlayHandles;
+    if (!DecodeOverlayHandleList(info[0], info.GetIsolate(), &overlayHandles))
+    {
+        Nan::ThrowTypeError("Argument[0] must be an array of overlay handles or a BigUint64Array.");
+        return;
+    }
+
+    if (!info[1]->IsUint32() || info[1].As<Uint32>()->Value() > vr::TrackingUniverseRawAndUncalibrated)
+    {
+        Nan::ThrowTypeError("Argument[1] must be an ETrackingUniverseOrigin.");
+        return;
+    }
+
+    if (!info[2]->IsFloat32Array())
+    {
+        Nan::ThrowTypeError("Argument[2] must be a Float32Array.");
+        return;
+    }
+
+    constexpr size_t k_unFloatsPerTransform = sizeof(vr::HmdMatrix34_t) / sizeof(float);
+    Local<Float32Array> transforms = info[2].As<Float32Array>();
+    if (transforms->Length() != overlayHandles.size() * k_unFloatsPerTransform)
+    {
+        Nan::ThrowRangeError("Argument[2] must hold 12 floats per overlay handle.");
+        return;
+    }
+
+    OverlayProperties sent;
+    sent.eTrackingOrigin = static_cast<vr::ETrackingUniverseOrigin>(info[1].As<Uint32>()->Value());
+    const uint8_t *pTransforms = static_cast<const uint8_t *>(transforms->Buffer()->Data()) + transforms->ByteOffset();
+
+    Local<Int32Array> errors = Int32Array::New(ArrayBuffer::New(info.GetIsolate(), overlayHandles.size() * sizeof(int32_t)), 0, overlayHandles.size());
+    int32_t *pErrors = reinterpret_cast<int32_t *>(static_cast<uint8_t *>(errors->Buffer()->Data()) + errors->ByteOffset());
+    for (size_t i = 0; i < overlayHandles.size(); ++i)
+    {
+        // Copied out, since a Float32Array over a shared buffer need not be aligned.
+        std::memcpy(&sent.transform, pTransforms + i * sizeof(vr::HmdMatrix34_t), sizeof(vr::HmdMatrix34_t));
+
+        OverlayProperties current;
+        if (OverlayTransformCache::Matches(overlayHandles[i], sent.eTrackingOrigin, sent.transform) ||
+            (OverlayMirror::Lookup(overlayHandles[i], OverlayProperties::Field_Transform, &current) &&
+             current.eTrackingOrigin == sent.eTrackingOrigin &&
+             std::memcmp(&current.transform, &sent.transform, sizeof(vr::HmdMatrix34_t)) == 0))
+        {
+            pErrors[i] = vr::VROverlayError_None;
+            continue;
+        }
+
+        pErrors[i] = obj->self_->SetOverlayTransformAbsolute(overlayHandles[i], sent.eTrackingOrigin, &sent.transform);
+        if (pErrors[i] == vr::VROverlayError_None)
+        {
+            OverlayMirror::Record(overlayHandles[i], sent, OverlayProperties::Field_Transform);
+            OverlayTransformCache::Store(overlayHandles[i], sent.eTrackingOrigin, sent.transform);
+        }
+        else
+        {
+            OverlayTransformCache::Forget(overlayHandles[i]);
+        }
+    }
+
+    info.GetReturnValue().Set(errors);
 }
 // virtual EVROverlayError GetTransformForOverlayCoordinates( VROverlayHandle_t ulOverlayHandle, ETrackingUniverseOrigin eTrackingOrigin, HmdVector2_t coordinatesInOverlay, HmdMatrix34_t *pmatTransform ) = 0;
 void IVROverlay::GetTransformForOverlayCoordinates(const Nan::FunctionCallbackInfo<Value> &info)
@@ -902,7 +1289,9 @@ void IVROverlay::GetTransformForOverlayCoordinates(const Nan::FunctionCallbackIn
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::ETrackingUniverseOrigin eTrackingOrigin = static_cast<vr::ETrackingUniverseOrigin>(info[1]->Uint32Value(context).FromJust());
     vr::HmdVector2_t coordinatesInOverlay = decode<vr::HmdVector2_t>(info[2], info.GetIsolate());
     vr::HmdMatrix34_t matTransform;
@@ -928,11 +1317,79 @@ void IVROverlay::PollNextOverlayEvent(const Nan::FunctionCallbackInfo<Value> &in
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::VREvent_t event;
-    bool success = obj->self_->PollNextOverlayEvent(ulOverlayHandle, &event, sizeof(vr::VREvent_t));
+    if (obj->eventCoalescer_.Poll(obj->self_, ulOverlayHandle, obj->eventFilter_, &event))
+        info.GetReturnValue().Set(encode(event));
+}
+// PollNextOverlayEvents( ulOverlayHandle, buffer: ArrayBuffer | ArrayBufferView ): number
+void IVROverlay::PollNextOverlayEvents(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
+
+    if (info.Length() != 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+    uint8_t *pBuffer;
+    size_t unBufferSize;
+    if (!GetBufferContents(info[1], &pBuffer, &unBufferSize))
+    {
+        Nan::ThrowTypeError("Argument[1] must be an ArrayBuffer or ArrayBufferView.");
+        return;
+    }
 
-    info.GetReturnValue().Set(encode(event));
+    // Events that do not fit stay queued for the next call.
+    const size_t unCapacity = unBufferSize / k_unVREventRecordSize;
+    uint32_t unCount = 0;
+    vr::VREvent_t event;
+    while (unCount < unCapacity && obj->eventCoalescer_.Poll(obj->self_, ulOverlayHandle, obj->eventFilter_, &event))
+        encode(event, pBuffer + k_unVREventRecordSize * unCount++);
+
+    info.GetReturnValue().Set(unCount);
+}
+// SetEventFilter( eventTypes?: EVREventType[] ): void
+void IVROverlay::SetEventFilter(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
+
+    if (!obj->eventFilter_.Set(info[0], info.GetIsolate()))
+    {
+        Nan::ThrowTypeError("Argument[0] must be an array of event types or undefined.");
+        return;
+    }
+}
+// GetEventFilter(): EVREventType[] | undefined
+void IVROverlay::GetEventFilter(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
+    info.GetReturnValue().Set(obj->eventFilter_.Get());
+}
+// SetEventCoalescing( bEnabled: boolean ): void
+void IVROverlay::SetEventCoalescing(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
+
+    if (!info[0]->IsBoolean())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a boolean.");
+        return;
+    }
+
+    obj->eventCoalescer_.SetEnabled(info[0]->BooleanValue(info.GetIsolate()));
+}
+// GetEventCoalescing(): boolean
+void IVROverlay::GetEventCoalescing(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
+    info.GetReturnValue().Set(Nan::New<Boolean>(obj->eventCoalescer_.Enabled()));
 }
 // virtual EVROverlayError GetOverlayInputMethod( VROverlayHandle_t ulOverlayHandle, VROverlayInputMethod *peInputMethod ) = 0;
 void IVROverlay::GetOverlayInputMethod(const Nan::FunctionCallbackInfo<Value> &info)
@@ -940,7 +1397,9 @@ void IVROverlay::GetOverlayInputMethod(const Nan::FunctionCallbackInfo<Value> &i
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::VROverlayInputMethod eInputMethod;
 
     vr::EVROverlayError error = obj->self_->GetOverlayInputMethod(ulOverlayHandle, &eInputMethod);
@@ -959,7 +1418,9 @@ void IVROverlay::SetOverlayInputMethod(const Nan::FunctionCallbackInfo<Value> &i
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::VROverlayInputMethod eInputMethod = static_cast<vr::VROverlayInputMethod>(info[1]->Uint32Value(context).FromJust());
 
     vr::EVROverlayError error = obj->self_->SetOverlayInputMethod(ulOverlayHandle, eInputMethod);
@@ -976,7 +1437,9 @@ void IVROverlay::GetOverlayMouseScale(const Nan::FunctionCallbackInfo<Value> &in
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::HmdVector2_t vecMouseScale;
 
     vr::EVROverlayError error = obj->self_->GetOverlayMouseScale(ulOverlayHandle, &vecMouseScale);
@@ -995,7 +1458,9 @@ void IVROverlay::SetOverlayMouseScale(const Nan::FunctionCallbackInfo<Value> &in
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::HmdVector2_t vecMouseScale = decode<vr::HmdVector2_t>(info[1], info.GetIsolate());
 
     vr::EVROverlayError error = obj->self_->GetOverlayMouseScale(ulOverlayHandle, &vecMouseScale);
@@ -1012,7 +1477,9 @@ void IVROverlay::ComputeOverlayIntersection(const Nan::FunctionCallbackInfo<Valu
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::VROverlayIntersectionParams_t Params = decode<vr::VROverlayIntersectionParams_t>(info[1], info.GetIsolate());
     vr::VROverlayIntersectionResults_t Results = decode<vr::VROverlayIntersectionResults_t>(info[2], info.GetIsolate());
 
@@ -1026,7 +1493,9 @@ void IVROverlay::IsHoverTargetOverlay(const Nan::FunctionCallbackInfo<Value> &in
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     bool isHoverTargetOverlay = obj->self_->IsHoverTargetOverlay(ulOverlayHandle);
 
     info.GetReturnValue().Set(Nan::New<Boolean>(isHoverTargetOverlay));
@@ -1039,7 +1508,9 @@ void IVROverlay::TriggerLaserMouseHapticVibration(const Nan::FunctionCallbackInf
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     float fDurationSeconds = info[1]->NumberValue(context).FromJust();
     float fFrequency = info[2]->NumberValue(context).FromJust();
     float fAmplitude = info[3]->NumberValue(context).FromJust();
@@ -1055,11 +1526,14 @@ void IVROverlay::TriggerLaserMouseHapticVibration(const Nan::FunctionCallbackInf
 // virtual EVROverlayError SetOverlayCursor( VROverlayHandle_t ulOverlayHandle, VROverlayHandle_t ulCursorHandle ) = 0;
 void IVROverlay::SetOverlayCursor(const Nan::FunctionCallbackInfo<Value> &info)
 {
-    Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
-    vr::VROverlayHandle_t ulCursorHandle = static_cast<vr::VROverlayHandle_t>(info[1]->Uint32Value(context).FromJust());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+    vr::VROverlayHandle_t ulCursorHandle;
+    if (!DecodeOverlayHandle(info[1], info.GetIsolate(), &ulCursorHandle))
+        return;
 
     vr::EVROverlayError error = obj->self_->SetOverlayCursor(ulOverlayHandle, ulCursorHandle);
 
@@ -1075,7 +1549,9 @@ void IVROverlay::SetOverlayCursorPositionOverride(const Nan::FunctionCallbackInf
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::HmdVector2_t vCursor = decode<vr::HmdVector2_t>(info[1], info.GetIsolate());
 
     vr::EVROverlayError error = obj->self_->SetOverlayCursorPositionOverride(ulOverlayHandle, &vCursor);
@@ -1092,7 +1568,9 @@ void IVROverlay::ClearOverlayCursorPositionOverride(const Nan::FunctionCallbackI
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
 
     vr::EVROverlayError error = obj->self_->ClearOverlayCursorPositionOverride(ulOverlayHandle);
 
@@ -1113,9 +1591,12 @@ void IVROverlay::SetOverlayTexture(const Nan::FunctionCallbackInfo<Value> &info)
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::Texture_t Texture = decode<vr::Texture_t>(info[1], info.GetIsolate());
 
+    OverlayFingerprint::Forget(ulOverlayHandle);
     vr::EVROverlayError error = obj->self_->SetOverlayTexture(ulOverlayHandle, &Texture);
 
     if (error != vr::VROverlayError_None)
@@ -1130,7 +1611,10 @@ void IVROverlay::ClearOverlayTexture(const Nan::FunctionCallbackInfo<Value> &inf
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+    OverlayFingerprint::Forget(ulOverlayHandle);
     vr::EVROverlayError error = obj->self_->ClearOverlayTexture(ulOverlayHandle);
 
     if (error != vr::VROverlayError_None)
@@ -1140,18 +1624,69 @@ void IVROverlay::ClearOverlayTexture(const Nan::FunctionCallbackInfo<Value> &inf
     }
 }
 // virtual EVROverlayError SetOverlayRaw( VROverlayHandle_t ulOverlayHandle, void *pvBuffer, uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel ) = 0;
+// Takes an optional EPixelConversion as a sixth argument, applied before the upload.
 void IVROverlay::SetOverlayRaw(const Nan::FunctionCallbackInfo<Value> &info)
 {
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     void *pvBuffer = node::Buffer::Data(info[1]->ToObject(context).ToLocalChecked());
     uint32_t unWidth = info[2]->Uint32Value(context).FromJust();
     uint32_t unHeight = info[3]->Uint32Value(context).FromJust();
     uint32_t unBytesPerPixel = info[4]->Uint32Value(context).FromJust();
 
-    vr::EVROverlayError error = obj->self_->SetOverlayRaw(ulOverlayHandle, pvBuffer, unWidth, unHeight, unBytesPerPixel);
+    uint32_t unConversion = PixelConvert::Conversion_None;
+    if (info.Length() > 5 && !info[5]->IsUndefined())
+    {
+        if (!info[5]->IsUint32())
+        {
+            Nan::ThrowTypeError("Argument[5] must be an EPixelConversion.");
+            return;
+        }
+        unConversion = info[5].As<Uint32>()->Value();
+        if (const char *pchError = PixelConvert::Validate(unConversion, unBytesPerPixel))
+        {
+            Nan::ThrowRangeError(pchError);
+            return;
+        }
+    }
+
+    // Fingerprinting reads the whole frame, so it is only done when the
+    // buffer is known to hold one; anything else goes to the runtime as is.
+    vr::EVROverlayError error;
+    uint8_t *pData;
+    size_t unBufferSize;
+    bool bSkipped;
+    const bool bWholeFrame = GetBufferContents(info[1], &pData, &unBufferSize) && static_cast<uint64_t>(unWidth) * unHeight * unBytesPerPixel <= unBufferSize;
+    if (unConversion != PixelConvert::Conversion_None)
+    {
+        if (!bWholeFrame)
+        {
+            Nan::ThrowRangeError("Argument[1] is smaller than width * height * bytes per pixel.");
+            return;
+        }
+
+        // Converted frames go through one scratch buffer, reused so that
+        // steady uploads do not allocate. Only the JS thread uses it.
+        static std::vector<uint8_t> converted;
+        const size_t unPixels = static_cast<size_t>(unWidth) * unHeight;
+        converted.resize(unPixels * PixelConvert::TargetBytesPerPixel(unConversion));
+        PixelConvert::Convert(unConversion, pData, converted.data(), unPixels);
+        error = OverlayFingerprint::UploadRaw(obj->self_, ulOverlayHandle, converted.data(), unWidth, unHeight,
+                                              PixelConvert::TargetBytesPerPixel(unConversion), &bSkipped);
+    }
+    else if (bWholeFrame)
+    {
+        error = OverlayFingerprint::UploadRaw(obj->self_, ulOverlayHandle, pData, unWidth, unHeight, unBytesPerPixel, &bSkipped);
+    }
+    else
+    {
+        OverlayFingerprint::Forget(ulOverlayHandle);
+        error = obj->self_->SetOverlayRaw(ulOverlayHandle, pvBuffer, unWidth, unHeight, unBytesPerPixel);
+    }
 
     if (error != vr::VROverlayError_None)
     {
@@ -1159,15 +1694,123 @@ void IVROverlay::SetOverlayRaw(const Nan::FunctionCallbackInfo<Value> &info)
         return;
     }
 }
+// SetOverlayRawAsync( ulOverlayHandle, buffer, unWidth, unHeight, unBytesPerPixel, eConversion? ): Promise<{ uploadMs, skipped }>
+void IVROverlay::SetOverlayRawAsync(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+    IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
+
+    if (info.Length() < 5 || info.Length() > 6)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+
+    std::shared_ptr<BackingStore> backingStore;
+    size_t unByteOffset = 0;
+    size_t unByteLength = 0;
+    if (info[1]->IsArrayBufferView())
+    {
+        Local<ArrayBufferView> view = info[1].As<ArrayBufferView>();
+        backingStore = view->Buffer()->GetBackingStore();
+        unByteOffset = view->ByteOffset();
+        unByteLength = view->ByteLength();
+    }
+    else if (info[1]->IsArrayBuffer())
+    {
+        backingStore = info[1].As<ArrayBuffer>()->GetBackingStore();
+        unByteLength = backingStore->ByteLength();
+    }
+    else
+    {
+        Nan::ThrowTypeError("Argument[1] must be a Buffer, ArrayBuffer or ArrayBufferView.");
+        return;
+    }
+
+    if (!info[2]->IsUint32() || !info[3]->IsUint32() || !info[4]->IsUint32())
+    {
+        Nan::ThrowTypeError("Width, height and bytes per pixel must be unsigned integers.");
+        return;
+    }
+    uint32_t unWidth = info[2]->Uint32Value(context).FromJust();
+    uint32_t unHeight = info[3]->Uint32Value(context).FromJust();
+    uint32_t unBytesPerPixel = info[4]->Uint32Value(context).FromJust();
+
+    uint32_t unConversion = PixelConvert::Conversion_None;
+    if (info.Length() == 6 && !info[5]->IsUndefined())
+    {
+        if (!info[5]->IsUint32())
+        {
+            Nan::ThrowTypeError("Argument[5] must be an EPixelConversion.");
+            return;
+        }
+        unConversion = info[5].As<Uint32>()->Value();
+        if (const char *pchError = PixelConvert::Validate(unConversion, unBytesPerPixel))
+        {
+            Nan::ThrowRangeError(pchError);
+            return;
+        }
+    }
+
+    // The worker reads the buffer without the JS thread watching, so a short
+    // buffer is refused here rather than read past its end.
+    if (static_cast<uint64_t>(unWidth) * unHeight * unBytesPerPixel > unByteLength)
+    {
+        Nan::ThrowRangeError("Argument[1] is smaller than width * height * bytes per pixel.");
+        return;
+    }
+
+    uint8_t *pData = static_cast<uint8_t *>(backingStore->Data()) + unByteOffset;
+    info.GetReturnValue().Set(OverlayRawUpload::Queue(obj->self_, ulOverlayHandle, info[1], std::move(backingStore), pData, unWidth, unHeight, unBytesPerPixel, unConversion));
+}
+// SetSkipUnchangedUploads( bEnabled: boolean ): void
+void IVROverlay::SetSkipUnchangedUploads(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (info.Length() != 1)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsBoolean())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a boolean.");
+        return;
+    }
+
+    OverlayFingerprint::SetEnabled(info[0]->BooleanValue(info.GetIsolate()));
+}
+// GetOverlayUploadStats(): OverlayUploadStats
+void IVROverlay::GetOverlayUploadStats(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    const OverlayFingerprint::Stats stats = OverlayFingerprint::GetStats();
+
+    Local<Object> result = Nan::New<Object>();
+    Nan::Set(result, Nan::New("enabled").ToLocalChecked(), Nan::New<Boolean>(OverlayFingerprint::Enabled()));
+    Nan::Set(result, Nan::New("uploadedFrames").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.uploadedFrames)));
+    Nan::Set(result, Nan::New("uploadedBytes").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.uploadedBytes)));
+    Nan::Set(result, Nan::New("skippedFrames").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.skippedFrames)));
+    Nan::Set(result, Nan::New("skippedBytes").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.skippedBytes)));
+    Nan::Set(result, Nan::New("dirtyTiles").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.dirtyTiles)));
+    Nan::Set(result, Nan::New("totalTiles").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.totalTiles)));
+    info.GetReturnValue().Set(result);
+}
 // virtual EVROverlayError SetOverlayFromFile( VROverlayHandle_t ulOverlayHandle, const char *pchFilePath ) = 0;
 void IVROverlay::SetOverlayFromFile(const Nan::FunctionCallbackInfo<Value> &info)
 {
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     const char *pchFilePath = *(Nan::Utf8String(info[1]));
 
+    OverlayFingerprint::Forget(ulOverlayHandle);
     vr::EVROverlayError error = obj->self_->SetOverlayFromFile(ulOverlayHandle, pchFilePath);
 
     if (error != vr::VROverlayError_None)
@@ -1176,6 +1819,119 @@ void IVROverlay::SetOverlayFromFile(const Nan::FunctionCallbackInfo<Value> &info
         return;
     }
 }
+// SetOverlayFromFileAsync( ulOverlayHandle, pchFilePath ): Promise<{ uploadMs, skipped, cached }>
+void IVROverlay::SetOverlayFromFileAsync(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
+
+    if (info.Length() != 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[1]->IsString())
+    {
+        Nan::ThrowTypeError("Argument[1] must be a string.");
+        return;
+    }
+
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+    info.GetReturnValue().Set(OverlayRawUpload::QueueFile(obj->self_, ulOverlayHandle, *Nan::Utf8String(info[1])));
+}
+// SetOverlayImageCacheBudget( unBytes: number ): void
+void IVROverlay::SetOverlayImageCacheBudget(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (info.Length() != 1)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    // NaN, Infinity and anything past 2^64 have no uint64_t value to cast to.
+    const double fBytes = info[0]->IsNumber() ? info[0].As<Number>()->Value() : -1.0;
+    if (!std::isfinite(fBytes) || fBytes < 0 || fBytes > 9007199254740991.0)
+    {
+        Nan::ThrowTypeError("Argument[0] must be a non-negative number no greater than Number.MAX_SAFE_INTEGER.");
+        return;
+    }
+
+    ImageCache::SetBudget(static_cast<uint64_t>(fBytes));
+}
+// ClearOverlayImageCache(): void
+void IVROverlay::ClearOverlayImageCache(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    ImageCache::Clear();
+}
+// GetOverlayImageCacheStats(): OverlayImageCacheStats
+void IVROverlay::GetOverlayImageCacheStats(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    const ImageCache::Stats stats = ImageCache::GetStats();
+
+    Local<Object> result = Nan::New<Object>();
+    Nan::Set(result, Nan::New("entries").ToLocalChecked(), Nan::New<Number>(stats.entries));
+    Nan::Set(result, Nan::New("bytes").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.bytes)));
+    Nan::Set(result, Nan::New("budget").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.budget)));
+    Nan::Set(result, Nan::New("hits").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.hits)));
+    Nan::Set(result, Nan::New("misses").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.misses)));
+    Nan::Set(result, Nan::New("evictions").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.evictions)));
+    info.GetReturnValue().Set(result);
+}
+// SetOverlayStateMirrorEnabled( bEnabled: boolean ): void
+void IVROverlay::SetOverlayStateMirrorEnabled(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (info.Length() != 1)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsBoolean())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a boolean.");
+        return;
+    }
+
+    OverlayMirror::SetEnabled(info[0]->BooleanValue(info.GetIsolate()));
+}
+// GetOverlayStateMirrorStats(): OverlayStateMirrorStats
+void IVROverlay::GetOverlayStateMirrorStats(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    const OverlayMirror::Stats stats = OverlayMirror::GetStats();
+
+    Local<Object> result = Nan::New<Object>();
+    Nan::Set(result, Nan::New("enabled").ToLocalChecked(), Nan::New<Boolean>(OverlayMirror::Enabled()));
+    Nan::Set(result, Nan::New("overlays").ToLocalChecked(), Nan::New<Number>(stats.overlays));
+    Nan::Set(result, Nan::New("hits").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.hits)));
+    Nan::Set(result, Nan::New("misses").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.misses)));
+    info.GetReturnValue().Set(result);
+}
+// GetOverlayRegistryStats(): OverlayRegistryStats
+void IVROverlay::GetOverlayRegistryStats(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    const OverlayRegistry::Stats stats = OverlayRegistry::GetStats();
+
+    Local<Array> sites = Nan::New<Array>(static_cast<int>(stats.sites.size()));
+    for (uint32_t i = 0; i < stats.sites.size(); ++i)
+    {
+        Local<Object> site = Nan::New<Object>();
+        Nan::Set(site, Nan::New("location").ToLocalChecked(), Nan::New(stats.sites[i].location).ToLocalChecked());
+        Nan::Set(site, Nan::New("created").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.sites[i].created)));
+        Nan::Set(site, Nan::New("live").ToLocalChecked(), Nan::New<Number>(stats.sites[i].live));
+        Nan::Set(sites, i, site);
+    }
+
+    Local<Object> result = Nan::New<Object>();
+    Nan::Set(result, Nan::New("live").ToLocalChecked(), Nan::New<Number>(stats.live));
+    Nan::Set(result, Nan::New("created").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.created)));
+    Nan::Set(result, Nan::New("destroyed").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.destroyed)));
+    Nan::Set(result, Nan::New("reclaimed").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.reclaimed)));
+    Nan::Set(result, Nan::New("findHits").ToLocalChecked(), Nan::New<Number>(static_cast<double>(stats.findHits)));
+    Nan::Set(result, Nan::New("sites").ToLocalChecked(), sites);
+    info.GetReturnValue().Set(result);
+}
 // virtual EVROverlayError GetOverlayTexture( VROverlayHandle_t ulOverlayHandle, void **pNativeTextureHandle, void *pNativeTextureRef, uint32_t *pWidth, uint32_t *pHeight, uint32_t *pNativeFormat, ETextureType *pAPIType, EColorSpace *pColorSpace, VRTextureBounds_t *pTextureBounds ) = 0;
 // void IVROverlay::GetOverlayTexture(const Nan::FunctionCallbackInfo<Value> &info);
 // virtual EVROverlayError ReleaseNativeOverlayHandle( VROverlayHandle_t ulOverlayHandle, void *pNativeTextureHandle ) = 0;
@@ -1184,7 +1940,9 @@ void IVROverlay::ReleaseNativeOverlayHandle(const Nan::FunctionCallbackInfo<Valu
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     void *pNativeTextureHandle = (void *)(uintptr_t)(info[1]->Uint32Value(context).FromJust());
 
     vr::EVROverlayError error = obj->self_->ReleaseNativeOverlayHandle(ulOverlayHandle, pNativeTextureHandle);
@@ -1201,7 +1959,9 @@ void IVROverlay::GetOverlayTextureSize(const Nan::FunctionCallbackInfo<Value> &i
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     uint32_t Width, Height;
 
     vr::EVROverlayError error = obj->self_->GetOverlayTextureSize(ulOverlayHandle, &Width, &Height);
@@ -1234,11 +1994,11 @@ void IVROverlay::CreateDashboardOverlay(const Nan::FunctionCallbackInfo<Value> &
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    const char *pchOverlayKey = *(Nan::Utf8String(info[0]));
-    const char *pchOverlayFriendlyName = *(Nan::Utf8String(info[1]));
+    const std::string overlayKey = *Nan::Utf8String(info[0]);
+    const std::string overlayFriendlyName = *Nan::Utf8String(info[1]);
     vr::VROverlayHandle_t MainHandle, ThumbnailHandle;
 
-    vr::EVROverlayError error = obj->self_->CreateDashboardOverlay(pchOverlayKey, pchOverlayFriendlyName, &MainHandle, &ThumbnailHandle);
+    vr::EVROverlayError error = obj->self_->CreateDashboardOverlay(overlayKey.c_str(), overlayFriendlyName.c_str(), &MainHandle, &ThumbnailHandle);
 
     if (error != vr::VROverlayError_None)
     {
@@ -1246,6 +2006,10 @@ void IVROverlay::CreateDashboardOverlay(const Nan::FunctionCallbackInfo<Value> &
         return;
     }
 
+    OverlayRegistry::Add(obj, MainHandle, ThumbnailHandle, overlayKey, CreationSite(info.GetIsolate()));
+    OverlayMirror::Track(MainHandle, true);
+    OverlayMirror::Track(ThumbnailHandle, true);
+
     Local<Object> result = Nan::New<Object>();
     {
         Local<String> MainHandle_prop = Nan::New<String>("MainHandle").ToLocalChecked();
@@ -1272,7 +2036,9 @@ void IVROverlay::IsActiveDashboardOverlay(const Nan::FunctionCallbackInfo<Value>
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     bool isActiveDashboardOverlay = obj->self_->IsActiveDashboardOverlay(ulOverlayHandle);
     info.GetReturnValue().Set(Nan::New<Boolean>(isActiveDashboardOverlay));
 }
@@ -1282,7 +2048,9 @@ void IVROverlay::SetDashboardOverlaySceneProcess(const Nan::FunctionCallbackInfo
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     uint32_t unProcessId = info[1]->Uint32Value(context).FromJust();
 
     vr::EVROverlayError error = obj->self_->SetDashboardOverlaySceneProcess(ulOverlayHandle, unProcessId);
@@ -1299,7 +2067,9 @@ void IVROverlay::GetDashboardOverlaySceneProcess(const Nan::FunctionCallbackInfo
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     uint32_t unProcessId;
 
     vr::EVROverlayError error = obj->self_->GetDashboardOverlaySceneProcess(ulOverlayHandle, &unProcessId);
@@ -1365,7 +2135,9 @@ void IVROverlay::ShowKeyboardForOverlay(const Nan::FunctionCallbackInfo<Value> &
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::EGamepadTextInputMode eInputMode = static_cast<vr::EGamepadTextInputMode>(info[1]->Uint32Value(context).FromJust());
     vr::EGamepadTextInputLineMode eLineInputMode = static_cast<vr::EGamepadTextInputLineMode>(info[2]->Uint32Value(context).FromJust());
     uint32_t unFlags = info[3]->Uint32Value(context).FromJust();
@@ -1415,7 +2187,9 @@ void IVROverlay::SetKeyboardPositionForOverlay(const Nan::FunctionCallbackInfo<V
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
     IVROverlay *obj = Nan::ObjectWrap::Unwrap<IVROverlay>(info.Holder());
 
-    vr::VROverlayHandle_t ulOverlayHandle = decode<vr::VROverlayHandle_t>(info[0], info.GetIsolate());
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
     vr::HmdRect2_t avoidRect = decode<vr::HmdRect2_t>(info[1], info.GetIsolate());
 }
 
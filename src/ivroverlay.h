@@ -1,6 +1,9 @@
 #ifndef IVRSETTINGS_H_JS
 #define IVRSETTINGS_H_JS
 
+#include "eventcoalescer.h"
+#include "eventfilter.h"
+
 #include <nan.h>
 #include <v8.h>
 
@@ -19,7 +22,8 @@ public:
 
 private:
     explicit IVROverlay(vr::IVROverlay *self);
-    ~IVROverlay() = default;
+    // Destroys the overlays this wrapper created and still owns.
+    ~IVROverlay();
 
     static void New(const Nan::FunctionCallbackInfo<Value> &info);
 
@@ -123,6 +127,12 @@ private:
     static void HideOverlay(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual bool IsOverlayVisible( VROverlayHandle_t ulOverlayHandle ) = 0;
     static void IsOverlayVisible(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetOverlayProperties( ulOverlayHandle, properties: OverlayProperties ): void
+    static void SetOverlayProperties(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetOverlayPropertiesBatch( overlayHandles, properties: OverlayProperties | OverlayProperties[] ): Int32Array
+    static void SetOverlayPropertiesBatch(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetOverlayTransformsAbsolute( overlayHandles, eTrackingOrigin, transforms: Float32Array ): Int32Array
+    static void SetOverlayTransformsAbsolute(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual EVROverlayError GetTransformForOverlayCoordinates( VROverlayHandle_t ulOverlayHandle, ETrackingUniverseOrigin eTrackingOrigin, HmdVector2_t coordinatesInOverlay, HmdMatrix34_t *pmatTransform ) = 0;
     static void GetTransformForOverlayCoordinates(const Nan::FunctionCallbackInfo<Value> &info);
 
@@ -132,6 +142,19 @@ private:
 
     // virtual bool PollNextOverlayEvent( VROverlayHandle_t ulOverlayHandle, VREvent_t *pEvent, uint32_t uncbVREvent ) = 0;
     static void PollNextOverlayEvent(const Nan::FunctionCallbackInfo<Value> &info);
+    // PollNextOverlayEvents( ulOverlayHandle, buffer: ArrayBuffer | ArrayBufferView ): number
+    // Drains pending events into fixed-size records, see k_unVREventRecordSize.
+    static void PollNextOverlayEvents(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetEventFilter( eventTypes?: EVREventType[] ): void
+    // Applies to the events of every overlay polled through this wrapper.
+    static void SetEventFilter(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetEventFilter(): EVREventType[] | undefined
+    static void GetEventFilter(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetEventCoalescing( bEnabled: boolean ): void
+    // Merges runs of mouse-move and scroll events per overlay while polling.
+    static void SetEventCoalescing(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetEventCoalescing(): boolean
+    static void GetEventCoalescing(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual EVROverlayError GetOverlayInputMethod( VROverlayHandle_t ulOverlayHandle, VROverlayInputMethod *peInputMethod ) = 0;
     static void GetOverlayInputMethod(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual EVROverlayError SetOverlayInputMethod( VROverlayHandle_t ulOverlayHandle, VROverlayInputMethod eInputMethod ) = 0;
@@ -165,8 +188,30 @@ private:
     static void ClearOverlayTexture(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual EVROverlayError SetOverlayRaw( VROverlayHandle_t ulOverlayHandle, void *pvBuffer, uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel ) = 0;
     static void SetOverlayRaw(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetOverlayRawAsync( ulOverlayHandle, buffer, unWidth, unHeight, unBytesPerPixel, eConversion? ): Promise<{ uploadMs, skipped }>
+    // SetOverlayRaw on a libuv worker; see OverlayRawUpload.
+    static void SetOverlayRawAsync(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetSkipUnchangedUploads( bEnabled: boolean ): void
+    // Raw uploads identical to the overlay's last one are skipped; see OverlayFingerprint.
+    static void SetSkipUnchangedUploads(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetOverlayUploadStats(): OverlayUploadStats
+    static void GetOverlayUploadStats(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual EVROverlayError SetOverlayFromFile( VROverlayHandle_t ulOverlayHandle, const char *pchFilePath ) = 0;
     static void SetOverlayFromFile(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetOverlayFromFileAsync( ulOverlayHandle, pchFilePath ): Promise<{ uploadMs, skipped, cached }>
+    static void SetOverlayFromFileAsync(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetOverlayImageCacheBudget( unBytes: number ): void
+    static void SetOverlayImageCacheBudget(const Nan::FunctionCallbackInfo<Value> &info);
+    // ClearOverlayImageCache(): void
+    static void ClearOverlayImageCache(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetOverlayImageCacheStats(): OverlayImageCacheStats
+    static void GetOverlayImageCacheStats(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetOverlayStateMirrorEnabled( bEnabled: boolean ): void
+    static void SetOverlayStateMirrorEnabled(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetOverlayStateMirrorStats(): OverlayStateMirrorStats
+    static void GetOverlayStateMirrorStats(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetOverlayRegistryStats(): OverlayRegistryStats
+    static void GetOverlayRegistryStats(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual EVROverlayError GetOverlayTexture( VROverlayHandle_t ulOverlayHandle, void **pNativeTextureHandle, void *pNativeTextureRef, uint32_t *pWidth, uint32_t *pHeight, uint32_t *pNativeFormat, ETextureType *pAPIType, EColorSpace *pColorSpace, VRTextureBounds_t *pTextureBounds ) = 0;
     // static void GetOverlayTexture(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual EVROverlayError ReleaseNativeOverlayHandle( VROverlayHandle_t ulOverlayHandle, void *pNativeTextureHandle ) = 0;
@@ -224,6 +269,8 @@ private:
 
     static Nan::Persistent<v8::Function> constructor;
     vr::IVROverlay *const self_;
+    EventFilter eventFilter_;
+    EventCoalescer eventCoalescer_;
 };
 
 #endif
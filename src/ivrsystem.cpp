@@ -1,7 +1,14 @@
 #include "ivrsystem.h"
+#include "propertycache.h"
+#include "propertytypes.h"
 #include "util.h"
 
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
 #include <node.h>
 #include <openvr.h>
 
@@ -12,6 +19,157 @@ using TrackedDeviceIndexArray = std::array<vr::TrackedDeviceIndex_t, vr::k_unMax
 
 using VREventArray = std::array<vr::VREvent_t, vr::k_unMaxTrackedDeviceCount>;
 
+namespace
+{
+    // Accepts an array of non-negative integers or a Uint32Array.
+    bool DecodeUint32List(Local<Value> value, Local<Context> context, std::vector<uint32_t> *pList)
+    {
+        if (value->IsUint32Array())
+        {
+            Local<Uint32Array> array = value.As<Uint32Array>();
+            pList->resize(array->Length());
+            array->CopyContents(pList->data(), pList->size() * sizeof(uint32_t));
+            return true;
+        }
+
+        if (!value->IsArray())
+            return false;
+
+        Local<Array> array = value.As<Array>();
+        pList->resize(array->Length());
+        for (uint32_t i = 0; i < array->Length(); ++i)
+        {
+            Local<Value> element = Nan::Get(array, i).ToLocalChecked();
+            if (!element->IsUint32())
+                return false;
+            (*pList)[i] = element->Uint32Value(context).FromJust();
+        }
+        return true;
+    }
+
+    double ReadScalarProperty(vr::IVRSystem *system, vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, vr::ETrackedPropertyError *pError)
+    {
+        switch (unTag)
+        {
+        case vr::k_unBoolPropertyTag:
+            return PropertyCache::Read(system, unDeviceIndex, prop, unTag, &vr::IVRSystem::GetBoolTrackedDeviceProperty, pError) ? 1.0 : 0.0;
+        case vr::k_unFloatPropertyTag:
+            return PropertyCache::Read(system, unDeviceIndex, prop, unTag, &vr::IVRSystem::GetFloatTrackedDeviceProperty, pError);
+        case vr::k_unInt32PropertyTag:
+            return PropertyCache::Read(system, unDeviceIndex, prop, unTag, &vr::IVRSystem::GetInt32TrackedDeviceProperty, pError);
+        default:
+            *pError = vr::TrackedProp_WrongDataType;
+            return 0.0;
+        }
+    }
+
+    bool IsScalarPropertyTag(vr::PropertyTypeTag_t unTag)
+    {
+        return unTag == vr::k_unBoolPropertyTag || unTag == vr::k_unFloatPropertyTag || unTag == vr::k_unInt32PropertyTag || unTag == vr::k_unUint64PropertyTag;
+    }
+
+    uint32_t FetchPropertyBytes(vr::IVRSystem *system, vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, std::string *pData, vr::ETrackedPropertyError *pError)
+    {
+        if (unTag == vr::k_unStringPropertyTag)
+            return system->GetStringTrackedDeviceProperty(unDeviceIndex, prop, &(*pData)[0], static_cast<uint32_t>(pData->size()), pError);
+        return system->GetArrayTrackedDeviceProperty(unDeviceIndex, prop, unTag, &(*pData)[0], static_cast<uint32_t>(pData->size()), pError);
+    }
+
+    // Raw bytes of a string or array property. Most values fit the first
+    // buffer; larger ones are fetched again at the size the runtime reports.
+    std::string ReadPropertyBytes(vr::IVRSystem *system, vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, vr::ETrackedPropertyError *pError)
+    {
+        std::string data;
+        if (PropertyCache::Lookup(unDeviceIndex, prop, unTag, &data))
+        {
+            *pError = vr::TrackedProp_Success;
+            return data;
+        }
+
+        const uint64_t unGeneration = PropertyCache::Generation();
+        data.resize(256);
+        uint32_t unSize = FetchPropertyBytes(system, unDeviceIndex, prop, unTag, &data, pError);
+        if (*pError == vr::TrackedProp_BufferTooSmall && unSize > data.size())
+        {
+            data.resize(unSize);
+            unSize = FetchPropertyBytes(system, unDeviceIndex, prop, unTag, &data, pError);
+        }
+
+        if (*pError != vr::TrackedProp_Success)
+            return std::string();
+
+        data.resize(unSize);
+        PropertyCache::Store(unGeneration, unDeviceIndex, prop, unTag, data.data(), unSize);
+        return data;
+    }
+
+    // Element view for an array property's bytes. Matrices and vectors are
+    // flattened into floats.
+    Local<Value> NewArrayPropertyView(Local<ArrayBuffer> buffer, size_t unSize, vr::PropertyTypeTag_t unTag)
+    {
+        switch (unTag)
+        {
+        case vr::k_unFloatPropertyTag:
+        case vr::k_unHmdMatrix34PropertyTag:
+        case vr::k_unHmdMatrix44PropertyTag:
+        case vr::k_unHmdVector2PropertyTag:
+        case vr::k_unHmdVector3PropertyTag:
+        case vr::k_unHmdVector4PropertyTag:
+        case vr::k_unHmdQuadPropertyTag:
+            return Float32Array::New(buffer, 0, unSize / sizeof(float));
+        case vr::k_unDoublePropertyTag:
+            return Float64Array::New(buffer, 0, unSize / sizeof(double));
+        case vr::k_unInt32PropertyTag:
+            return Int32Array::New(buffer, 0, unSize / sizeof(int32_t));
+        case vr::k_unUint64PropertyTag:
+            return BigUint64Array::New(buffer, 0, unSize / sizeof(uint64_t));
+        default:
+            return Uint8Array::New(buffer, 0, unSize);
+        }
+    }
+
+    // Reads an array property straight into a new ArrayBuffer: one call with
+    // no buffer for the size, then one into the buffer's own storage. A value
+    // that grows in between is probed again.
+    Local<Value> ReadArrayProperty(Isolate *isolate, vr::IVRSystem *system, vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, vr::ETrackedPropertyError *pError)
+    {
+        std::string cached;
+        if (PropertyCache::Lookup(unDeviceIndex, prop, unTag, &cached))
+        {
+            *pError = vr::TrackedProp_Success;
+            Local<ArrayBuffer> buffer = ArrayBuffer::New(isolate, cached.size());
+            if (!cached.empty())
+                std::memcpy(buffer->GetBackingStore()->Data(), cached.data(), cached.size());
+            return NewArrayPropertyView(buffer, cached.size(), unTag);
+        }
+
+        const uint64_t unGeneration = PropertyCache::Generation();
+        uint32_t unSize = system->GetArrayTrackedDeviceProperty(unDeviceIndex, prop, unTag, nullptr, 0, pError);
+        for (uint32_t unAttempt = 0; unAttempt < 4; ++unAttempt)
+        {
+            if (*pError != vr::TrackedProp_Success && *pError != vr::TrackedProp_BufferTooSmall)
+                return Nan::Undefined();
+
+            Local<ArrayBuffer> buffer = ArrayBuffer::New(isolate, unSize);
+            void *pBuffer = buffer->GetBackingStore()->Data();
+            const uint32_t unFilled = unSize > 0 ? system->GetArrayTrackedDeviceProperty(unDeviceIndex, prop, unTag, pBuffer, unSize, pError) : 0;
+            if (*pError == vr::TrackedProp_Success)
+            {
+                PropertyCache::Store(unGeneration, unDeviceIndex, prop, unTag, pBuffer, unFilled);
+                return NewArrayPropertyView(buffer, unFilled, unTag);
+            }
+            unSize = unFilled;
+        }
+        return Nan::Undefined();
+    }
+
+    Local<Value> EncodeStringProperty(const std::string &data)
+    {
+        // The runtime counts the terminating null.
+        return Nan::New<String>(data.c_str(), static_cast<int>(strnlen(data.c_str(), data.size()))).ToLocalChecked();
+    }
+}
+
 Nan::Persistent<Function> IVRSystem::constructor;
 
 void IVRSystem::Init(Local<Object> exports)
@@ -52,11 +210,19 @@ void IVRSystem::Init(Local<Object> exports)
     Nan::SetPrototypeMethod(tpl, "GetInt32TrackedDeviceProperty", GetInt32TrackedDeviceProperty);
     Nan::SetPrototypeMethod(tpl, "GetUint64TrackedDeviceProperty", GetUint64TrackedDeviceProperty);
     Nan::SetPrototypeMethod(tpl, "GetMatrix34TrackedDeviceProperty", GetMatrix34TrackedDeviceProperty);
-    // Nan::SetPrototypeMethod(tpl, "GetArrayTrackedDeviceProperty", GetArrayTrackedDeviceProperty);
-    // Nan::SetPrototypeMethod(tpl, "GetStringTrackedDeviceProperty", GetStringTrackedDeviceProperty);
+    Nan::SetPrototypeMethod(tpl, "GetTrackedDeviceProperty", GetTrackedDeviceProperty);
+    Nan::SetPrototypeMethod(tpl, "GetDeviceProperties", GetDeviceProperties);
+    Nan::SetPrototypeMethod(tpl, "SetPropertyCacheEnabled", SetPropertyCacheEnabled);
+    Nan::SetPrototypeMethod(tpl, "GetPropertyCacheStats", GetPropertyCacheStats);
+    Nan::SetPrototypeMethod(tpl, "InvalidatePropertyCache", InvalidatePropertyCache);
+    Nan::SetPrototypeMethod(tpl, "GetArrayTrackedDeviceProperty", GetArrayTrackedDeviceProperty);
+    Nan::SetPrototypeMethod(tpl, "GetStringTrackedDeviceProperty", GetStringTrackedDeviceProperty);
     // Nan::SetPrototypeMethod(tpl, "GetPropErrorNameFromEnum", GetPropErrorNameFromEnum);
 
-    // Nan::SetPrototypeMethod(tpl, "PollNextEvent", PollNextEvent);
+    Nan::SetPrototypeMethod(tpl, "PollNextEvent", PollNextEvent);
+    Nan::SetPrototypeMethod(tpl, "PollNextEvents", PollNextEvents);
+    Nan::SetPrototypeMethod(tpl, "SetEventFilter", SetEventFilter);
+    Nan::SetPrototypeMethod(tpl, "GetEventFilter", GetEventFilter);
     // Nan::SetPrototypeMethod(tpl, "PollNextEventWithPose", PollNextEventWithPose);
     // Nan::SetPrototypeMethod(tpl, "GetEventTypeNameFromEnum", GetEventTypeNameFromEnum);
 
@@ -286,6 +452,55 @@ void IVRSystem::SetDisplayVisibility(const Nan::FunctionCallbackInfo<Value> &inf
 // Tracking Methods
 // ------------------------------------
 
+// Overload: GetDeviceToAbsoluteTrackingPose(eOrigin, fPredicted, poses: Float32Array, states?: Uint8Array)
+// Writes one pose per k_unTrackedDevicePoseFloatStride floats (and k_unTrackedDevicePoseStateStride
+// bytes) for as many devices as the Float32Array holds, up to k_unMaxTrackedDeviceCount, and returns
+// that count. Nothing is allocated on the V8 heap.
+static void GetDeviceToAbsoluteTrackingPoseInto(vr::IVRSystem *system, const Nan::FunctionCallbackInfo<Value> &info, vr::ETrackingUniverseOrigin eOrigin, float fPredictedSecondsToPhotonsFromNow)
+{
+    if (!info[2]->IsFloat32Array())
+    {
+        Nan::ThrowTypeError("Argument[2] must be a Float32Array.");
+        return;
+    }
+
+    if (!info[3]->IsUndefined() && !info[3]->IsUint8Array())
+    {
+        Nan::ThrowTypeError("Argument[3] must be a Uint8Array.");
+        return;
+    }
+
+    Nan::TypedArrayContents<float> poses(info[2]);
+    uint32_t unCount = std::min<uint32_t>(static_cast<uint32_t>(poses.length()) / k_unTrackedDevicePoseFloatStride, vr::k_unMaxTrackedDeviceCount);
+
+    uint8_t *punStates = nullptr;
+    if (info[3]->IsUint8Array())
+    {
+        Nan::TypedArrayContents<uint8_t> states(info[3]);
+        punStates = *states;
+        unCount = std::min<uint32_t>(unCount, static_cast<uint32_t>(states.length()) / k_unTrackedDevicePoseStateStride);
+    }
+
+    if (unCount == 0)
+    {
+        Nan::ThrowRangeError("Pose buffers must hold at least one device.");
+        return;
+    }
+
+    TrackedDevicePoseArray trackedDevicePoseArray;
+    system->GetDeviceToAbsoluteTrackingPose(
+        eOrigin, fPredictedSecondsToPhotonsFromNow, trackedDevicePoseArray.data(), unCount);
+
+    for (uint32_t idx = 0; idx < unCount; ++idx)
+    {
+        encode(trackedDevicePoseArray[idx],
+               *poses + idx * k_unTrackedDevicePoseFloatStride,
+               punStates ? punStates + idx * k_unTrackedDevicePoseStateStride : nullptr);
+    }
+
+    info.GetReturnValue().Set(unCount);
+}
+
 void IVRSystem::GetDeviceToAbsoluteTrackingPose(const Nan::FunctionCallbackInfo<Value> &info)
 {
     Local<Context> context = info.GetIsolate()->GetCurrentContext();
@@ -293,6 +508,13 @@ void IVRSystem::GetDeviceToAbsoluteTrackingPose(const Nan::FunctionCallbackInfo<
 
     vr::ETrackingUniverseOrigin eOrigin = static_cast<vr::ETrackingUniverseOrigin>(info[0]->Uint32Value(context).FromJust());
     float fPredictedSecondsToPhotonsFromNow = static_cast<float>(info[1]->NumberValue(context).FromJust());
+
+    if (!info[2]->IsUndefined())
+    {
+        GetDeviceToAbsoluteTrackingPoseInto(obj->self_, info, eOrigin, fPredictedSecondsToPhotonsFromNow);
+        return;
+    }
+
     TrackedDevicePoseArray trackedDevicePoseArray;
     obj->self_->GetDeviceToAbsoluteTrackingPose(
         eOrigin, fPredictedSecondsToPhotonsFromNow, trackedDevicePoseArray.data(),
@@ -517,7 +739,7 @@ void IVRSystem::GetBoolTrackedDeviceProperty(const Nan::FunctionCallbackInfo<Val
     }
     vr::ETrackedDeviceProperty nDeviceProp = static_cast<vr::ETrackedDeviceProperty>(info[1]->Uint32Value(context).FromJust());
 
-    bool bProp = obj->self_->GetBoolTrackedDeviceProperty(nDeviceIndex, nDeviceProp);
+    bool bProp = PropertyCache::Read(obj->self_, nDeviceIndex, nDeviceProp, vr::k_unBoolPropertyTag, &vr::IVRSystem::GetBoolTrackedDeviceProperty);
     info.GetReturnValue().Set(Nan::New<Boolean>(bProp));
 }
 
@@ -546,7 +768,7 @@ void IVRSystem::GetFloatTrackedDeviceProperty(const Nan::FunctionCallbackInfo<Va
     }
     vr::ETrackedDeviceProperty nDeviceProp = static_cast<vr::ETrackedDeviceProperty>(info[1]->Uint32Value(context).FromJust());
 
-    float fProp = obj->self_->GetFloatTrackedDeviceProperty(nDeviceIndex, nDeviceProp);
+    float fProp = PropertyCache::Read(obj->self_, nDeviceIndex, nDeviceProp, vr::k_unFloatPropertyTag, &vr::IVRSystem::GetFloatTrackedDeviceProperty);
     info.GetReturnValue().Set(Nan::New<Number>(fProp));
 }
 
@@ -575,7 +797,7 @@ void IVRSystem::GetInt32TrackedDeviceProperty(const Nan::FunctionCallbackInfo<Va
     }
     vr::ETrackedDeviceProperty nDeviceProp = static_cast<vr::ETrackedDeviceProperty>(info[1]->Uint32Value(context).FromJust());
 
-    int32_t iProp = obj->self_->GetInt32TrackedDeviceProperty(nDeviceIndex, nDeviceProp);
+    int32_t iProp = PropertyCache::Read(obj->self_, nDeviceIndex, nDeviceProp, vr::k_unInt32PropertyTag, &vr::IVRSystem::GetInt32TrackedDeviceProperty);
     info.GetReturnValue().Set(Nan::New<Number>(iProp));
 }
 
@@ -604,7 +826,7 @@ void IVRSystem::GetUint64TrackedDeviceProperty(const Nan::FunctionCallbackInfo<V
     }
     vr::ETrackedDeviceProperty nDeviceProp = static_cast<vr::ETrackedDeviceProperty>(info[1]->Uint32Value(context).FromJust());
 
-    uint64_t uiProp = obj->self_->GetUint64TrackedDeviceProperty(nDeviceIndex, nDeviceProp);
+    uint64_t uiProp = PropertyCache::Read(obj->self_, nDeviceIndex, nDeviceProp, vr::k_unUint64PropertyTag, &vr::IVRSystem::GetUint64TrackedDeviceProperty);
     info.GetReturnValue().Set(Nan::New<Number>(uiProp));
 }
 
@@ -633,10 +855,418 @@ void IVRSystem::GetMatrix34TrackedDeviceProperty(const Nan::FunctionCallbackInfo
     }
     vr::ETrackedDeviceProperty nDeviceProp = static_cast<vr::ETrackedDeviceProperty>(info[1]->Uint32Value(context).FromJust());
 
-    vr::HmdMatrix34_t matrixProp = obj->self_->GetMatrix34TrackedDeviceProperty(nDeviceIndex, nDeviceProp);
+    vr::HmdMatrix34_t matrixProp = PropertyCache::Read(obj->self_, nDeviceIndex, nDeviceProp, vr::k_unHmdMatrix34PropertyTag, &vr::IVRSystem::GetMatrix34TrackedDeviceProperty);
     info.GetReturnValue().Set(encode(matrixProp));
 }
 
+void IVRSystem::GetArrayTrackedDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+    IVRSystem *obj = Nan::ObjectWrap::Unwrap<IVRSystem>(info.Holder());
+
+    if (info.Length() < 2 || info.Length() > 4)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a tracked device index.");
+        return;
+    }
+    vr::TrackedDeviceIndex_t nDeviceIndex = static_cast<vr::TrackedDeviceIndex_t>(info[0]->Uint32Value(context).FromJust());
+
+    if (!info[1]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[1] must be a tracked device property.");
+        return;
+    }
+    vr::ETrackedDeviceProperty nDeviceProp = static_cast<vr::ETrackedDeviceProperty>(info[1]->Uint32Value(context).FromJust());
+
+    vr::PropertyTypeTag_t unTag = PropertyTypes::Tag(nDeviceProp);
+    if (!info[2]->IsUndefined())
+    {
+        if (!info[2]->IsUint32())
+        {
+            Nan::ThrowTypeError("Argument[2] must be a property type tag.");
+            return;
+        }
+        unTag = info[2]->Uint32Value(context).FromJust();
+    }
+
+    if (unTag == vr::k_unInvalidPropertyTag)
+    {
+        Nan::ThrowRangeError("Argument[1] has no known type; pass its property type tag.");
+        return;
+    }
+
+    vr::ETrackedPropertyError error;
+    if (info[3]->IsUndefined())
+    {
+        Local<Value> result = ReadArrayProperty(info.GetIsolate(), obj->self_, nDeviceIndex, nDeviceProp, unTag, &error);
+        if (error == vr::TrackedProp_Success)
+            info.GetReturnValue().Set(result);
+        return;
+    }
+
+    uint8_t *pBuffer;
+    size_t unBufferSize;
+    if (!GetBufferContents(info[3], &pBuffer, &unBufferSize))
+    {
+        Nan::ThrowTypeError("Argument[3] must be an ArrayBuffer or ArrayBufferView.");
+        return;
+    }
+
+    // Caller-owned storage is filled in place, and the runtime's byte count is
+    // returned whether or not it fit.
+    uint32_t unSize = obj->self_->GetArrayTrackedDeviceProperty(nDeviceIndex, nDeviceProp, unTag, unBufferSize > 0 ? pBuffer : nullptr, static_cast<uint32_t>(unBufferSize), &error);
+    if (error != vr::TrackedProp_Success && error != vr::TrackedProp_BufferTooSmall)
+        unSize = 0;
+    info.GetReturnValue().Set(unSize);
+}
+
+void IVRSystem::GetStringTrackedDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+    IVRSystem *obj = Nan::ObjectWrap::Unwrap<IVRSystem>(info.Holder());
+
+    if (info.Length() != 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a tracked device index.");
+        return;
+    }
+    vr::TrackedDeviceIndex_t nDeviceIndex = static_cast<vr::TrackedDeviceIndex_t>(info[0]->Uint32Value(context).FromJust());
+
+    if (!info[1]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[1] must be a tracked device property.");
+        return;
+    }
+    vr::ETrackedDeviceProperty nDeviceProp = static_cast<vr::ETrackedDeviceProperty>(info[1]->Uint32Value(context).FromJust());
+
+    vr::ETrackedPropertyError error;
+    std::string sProp = ReadPropertyBytes(obj->self_, nDeviceIndex, nDeviceProp, vr::k_unStringPropertyTag, &error);
+    info.GetReturnValue().Set(EncodeStringProperty(sProp));
+}
+
+void IVRSystem::GetTrackedDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+    IVRSystem *obj = Nan::ObjectWrap::Unwrap<IVRSystem>(info.Holder());
+
+    if (info.Length() != 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a tracked device index.");
+        return;
+    }
+    vr::TrackedDeviceIndex_t nDeviceIndex = static_cast<vr::TrackedDeviceIndex_t>(info[0]->Uint32Value(context).FromJust());
+
+    if (!info[1]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[1] must be a tracked device property.");
+        return;
+    }
+    vr::ETrackedDeviceProperty nDeviceProp = static_cast<vr::ETrackedDeviceProperty>(info[1]->Uint32Value(context).FromJust());
+
+    const vr::PropertyTypeTag_t unTag = PropertyTypes::Tag(nDeviceProp);
+    if (unTag == vr::k_unInvalidPropertyTag)
+    {
+        Nan::ThrowRangeError("Argument[1] has no known type; use the getter for its type instead.");
+        return;
+    }
+
+    vr::ETrackedPropertyError error = vr::TrackedProp_Success;
+    Local<Value> result;
+    if (PropertyTypes::IsArray(nDeviceProp))
+    {
+        result = ReadArrayProperty(info.GetIsolate(), obj->self_, nDeviceIndex, nDeviceProp, unTag, &error);
+    }
+    else
+    {
+        switch (unTag)
+        {
+        case vr::k_unBoolPropertyTag:
+            result = Nan::New<Boolean>(PropertyCache::Read(obj->self_, nDeviceIndex, nDeviceProp, unTag, &vr::IVRSystem::GetBoolTrackedDeviceProperty, &error));
+            break;
+        case vr::k_unFloatPropertyTag:
+            result = Nan::New<Number>(PropertyCache::Read(obj->self_, nDeviceIndex, nDeviceProp, unTag, &vr::IVRSystem::GetFloatTrackedDeviceProperty, &error));
+            break;
+        case vr::k_unInt32PropertyTag:
+            result = Nan::New<Number>(PropertyCache::Read(obj->self_, nDeviceIndex, nDeviceProp, unTag, &vr::IVRSystem::GetInt32TrackedDeviceProperty, &error));
+            break;
+        case vr::k_unUint64PropertyTag:
+            // Container handles and LUIDs use all 64 bits, as in the BigUint64Array of array properties.
+            result = BigInt::NewFromUnsigned(info.GetIsolate(), PropertyCache::Read(obj->self_, nDeviceIndex, nDeviceProp, unTag, &vr::IVRSystem::GetUint64TrackedDeviceProperty, &error));
+            break;
+        case vr::k_unHmdMatrix34PropertyTag:
+            result = encode(PropertyCache::Read(obj->self_, nDeviceIndex, nDeviceProp, unTag, &vr::IVRSystem::GetMatrix34TrackedDeviceProperty, &error));
+            break;
+        case vr::k_unHmdVector3PropertyTag:
+        {
+            const std::string data = ReadPropertyBytes(obj->self_, nDeviceIndex, nDeviceProp, unTag, &error);
+            vr::HmdVector3_t vector = {};
+            if (data.size() == sizeof(vector))
+                std::memcpy(&vector, data.data(), sizeof(vector));
+            else if (error == vr::TrackedProp_Success)
+                error = vr::TrackedProp_WrongDataType;
+            result = encode(vector);
+            break;
+        }
+        case vr::k_unStringPropertyTag:
+            result = EncodeStringProperty(ReadPropertyBytes(obj->self_, nDeviceIndex, nDeviceProp, unTag, &error));
+            break;
+        default:
+            error = vr::TrackedProp_WrongDataType;
+            break;
+        }
+    }
+
+    // Unlike the typed getters, a failed read is reported instead of
+    // returning the runtime's default value.
+    if (error == vr::TrackedProp_Success)
+        info.GetReturnValue().Set(result);
+}
+
+void IVRSystem::GetDeviceProperties(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+    IVRSystem *obj = Nan::ObjectWrap::Unwrap<IVRSystem>(info.Holder());
+
+    if (info.Length() < 2 || info.Length() > 3)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    std::vector<uint32_t> deviceIndices;
+    if (!DecodeUint32List(info[0], context, &deviceIndices))
+    {
+        Nan::ThrowTypeError("Argument[0] must be an array of tracked device indices.");
+        return;
+    }
+
+    std::vector<uint32_t> props;
+    if (!DecodeUint32List(info[1], context, &props))
+    {
+        Nan::ThrowTypeError("Argument[1] must be an array of tracked device properties.");
+        return;
+    }
+
+    // Without tags, each property's type comes from the property type table.
+    std::vector<uint32_t> tags;
+    if (info[2]->IsUndefined())
+    {
+        for (uint32_t prop : props)
+            tags.push_back(PropertyTypes::IsArray(prop) ? vr::k_unInvalidPropertyTag : PropertyTypes::Tag(prop));
+    }
+    else if (!DecodeUint32List(info[2], context, &tags) || tags.size() != props.size())
+    {
+        Nan::ThrowTypeError("Argument[2] must be an array with one property type tag per property.");
+        return;
+    }
+
+    for (vr::PropertyTypeTag_t unTag : tags)
+    {
+        if (!IsScalarPropertyTag(unTag))
+        {
+            Nan::ThrowRangeError("Only bool, float, int32 and uint64 properties can be fetched in bulk.");
+            return;
+        }
+    }
+
+    // Row-major, one row per device and one column per property.
+    const size_t unCellCount = deviceIndices.size() * props.size();
+    Local<Float64Array> values = Float64Array::New(ArrayBuffer::New(info.GetIsolate(), unCellCount * sizeof(double)), 0, unCellCount);
+    Local<Int32Array> errors = Int32Array::New(ArrayBuffer::New(info.GetIsolate(), unCellCount * sizeof(int32_t)), 0, unCellCount);
+
+    uint8_t *pValues;
+    uint8_t *pErrors;
+    size_t unSize;
+    GetBufferContents(values, &pValues, &unSize);
+    GetBufferContents(errors, &pErrors, &unSize);
+    double *pfValues = reinterpret_cast<double *>(pValues);
+    int32_t *pnErrors = reinterpret_cast<int32_t *>(pErrors);
+
+    // A double cannot hold every uint64, so those cells live in a parallel
+    // BigUint64Array, made only when some column needs it.
+    Local<BigUint64Array> uint64Values;
+    uint64_t *pulValues = nullptr;
+    if (std::find(tags.begin(), tags.end(), vr::k_unUint64PropertyTag) != tags.end())
+    {
+        uint8_t *pUint64Values;
+        uint64Values = BigUint64Array::New(ArrayBuffer::New(info.GetIsolate(), unCellCount * sizeof(uint64_t)), 0, unCellCount);
+        GetBufferContents(uint64Values, &pUint64Values, &unSize);
+        pulValues = reinterpret_cast<uint64_t *>(pUint64Values);
+    }
+
+    for (size_t unRow = 0; unRow < deviceIndices.size(); ++unRow)
+    {
+        for (size_t unColumn = 0; unColumn < props.size(); ++unColumn)
+        {
+            const size_t unCell = unRow * props.size() + unColumn;
+            const vr::ETrackedDeviceProperty prop = static_cast<vr::ETrackedDeviceProperty>(props[unColumn]);
+            vr::ETrackedPropertyError error = vr::TrackedProp_Success;
+            if (tags[unColumn] == vr::k_unUint64PropertyTag)
+            {
+                pulValues[unCell] = PropertyCache::Read(obj->self_, deviceIndices[unRow], prop, tags[unColumn], &vr::IVRSystem::GetUint64TrackedDeviceProperty, &error);
+                pfValues[unCell] = std::numeric_limits<double>::quiet_NaN();
+            }
+            else
+            {
+                pfValues[unCell] = ReadScalarProperty(obj->self_, deviceIndices[unRow], prop, tags[unColumn], &error);
+            }
+            pnErrors[unCell] = error;
+        }
+    }
+
+    Local<Object> result = Nan::New<Object>();
+    Nan::Set(result, Nan::New("values").ToLocalChecked(), values);
+    Nan::Set(result, Nan::New("errors").ToLocalChecked(), errors);
+    if (pulValues)
+        Nan::Set(result, Nan::New("uint64Values").ToLocalChecked(), uint64Values);
+    info.GetReturnValue().Set(result);
+}
+
+void IVRSystem::SetPropertyCacheEnabled(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (info.Length() != 1)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsBoolean())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a boolean.");
+        return;
+    }
+
+    PropertyCache::SetEnabled(info[0]->BooleanValue(info.GetIsolate()));
+}
+
+void IVRSystem::GetPropertyCacheStats(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (info.Length() != 0)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    Local<Object> result = Nan::New<Object>();
+    Nan::Set(result, Nan::New("enabled").ToLocalChecked(), Nan::New<Boolean>(PropertyCache::Enabled()));
+    Nan::Set(result, Nan::New("hits").ToLocalChecked(), Nan::New<Number>(static_cast<double>(PropertyCache::Hits())));
+    Nan::Set(result, Nan::New("misses").ToLocalChecked(), Nan::New<Number>(static_cast<double>(PropertyCache::Misses())));
+    info.GetReturnValue().Set(result);
+}
+
+void IVRSystem::InvalidatePropertyCache(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+
+    if (info.Length() > 1)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    vr::TrackedDeviceIndex_t nDeviceIndex = vr::k_unTrackedDeviceIndexInvalid;
+    if (!info[0]->IsUndefined())
+    {
+        if (!info[0]->IsUint32())
+        {
+            Nan::ThrowTypeError("Argument[0] must be a tracked device index.");
+            return;
+        }
+        nDeviceIndex = static_cast<vr::TrackedDeviceIndex_t>(info[0]->Uint32Value(context).FromJust());
+    }
+
+    PropertyCache::Invalidate(nDeviceIndex);
+}
+
+void IVRSystem::PollNextEvent(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVRSystem *obj = Nan::ObjectWrap::Unwrap<IVRSystem>(info.Holder());
+
+    if (info.Length() != 0)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    vr::VREvent_t event;
+    while (obj->self_->PollNextEvent(&event, sizeof(vr::VREvent_t)))
+    {
+        PropertyCache::Observe(event);
+        if (obj->eventFilter_.Accepts(event.eventType))
+        {
+            info.GetReturnValue().Set(encode(event));
+            return;
+        }
+    }
+}
+
+void IVRSystem::PollNextEvents(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVRSystem *obj = Nan::ObjectWrap::Unwrap<IVRSystem>(info.Holder());
+
+    if (info.Length() != 1)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    uint8_t *pBuffer;
+    size_t unBufferSize;
+    if (!GetBufferContents(info[0], &pBuffer, &unBufferSize))
+    {
+        Nan::ThrowTypeError("Argument[0] must be an ArrayBuffer or ArrayBufferView.");
+        return;
+    }
+
+    // Events that do not fit stay queued for the next call.
+    const size_t unCapacity = unBufferSize / k_unVREventRecordSize;
+    uint32_t unCount = 0;
+    vr::VREvent_t event;
+    while (unCount < unCapacity && obj->self_->PollNextEvent(&event, sizeof(vr::VREvent_t)))
+    {
+        PropertyCache::Observe(event);
+        if (obj->eventFilter_.Accepts(event.eventType))
+            encode(event, pBuffer + k_unVREventRecordSize * unCount++);
+    }
+
+    info.GetReturnValue().Set(unCount);
+}
+
+void IVRSystem::SetEventFilter(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVRSystem *obj = Nan::ObjectWrap::Unwrap<IVRSystem>(info.Holder());
+
+    if (!obj->eventFilter_.Set(info[0], info.GetIsolate()))
+    {
+        Nan::ThrowTypeError("Argument[0] must be an array of event types or undefined.");
+        return;
+    }
+}
+
+void IVRSystem::GetEventFilter(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    IVRSystem *obj = Nan::ObjectWrap::Unwrap<IVRSystem>(info.Holder());
+    info.GetReturnValue().Set(obj->eventFilter_.Get());
+}
+
 void IVRSystem::IsInputAvailable(const Nan::FunctionCallbackInfo<Value> &info)
 {
     IVRSystem *obj = Nan::ObjectWrap::Unwrap<IVRSystem>(info.Holder());
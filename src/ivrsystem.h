@@ -1,6 +1,8 @@
 #ifndef IVRSYSTEM_H_JS
 #define IVRSYSTEM_H_JS
 
+#include "eventfilter.h"
+
 #include <nan.h>
 #include <v8.h>
 
@@ -94,10 +96,23 @@ private:
     static void GetUint64TrackedDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual HmdMatrix34_t GetMatrix34TrackedDeviceProperty( vr::TrackedDeviceIndex_t unDeviceIndex, ETrackedDeviceProperty prop, ETrackedPropertyError *pError = 0L )
     static void GetMatrix34TrackedDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetDeviceProperties( unDeviceIndices: TrackedDeviceIndex_t[], props: ETrackedDeviceProperty[], tags?: PropertyTypeTag_t[] ): { values: Float64Array, errors: Int32Array, uint64Values?: BigUint64Array }
+    // Reads every scalar property of every device in one call. Results are row-major by device.
+    static void GetDeviceProperties(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetPropertyCacheEnabled( bEnabled: boolean ): void
+    static void SetPropertyCacheEnabled(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetPropertyCacheStats(): { enabled: boolean, hits: number, misses: number }
+    static void GetPropertyCacheStats(const Nan::FunctionCallbackInfo<Value> &info);
+    // InvalidatePropertyCache( unDeviceIndex?: TrackedDeviceIndex_t ): void
+    static void InvalidatePropertyCache(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual uint32_t GetArrayTrackedDeviceProperty( vr::TrackedDeviceIndex_t unDeviceIndex, ETrackedDeviceProperty prop, PropertyTypeTag_t propType, void *pBuffer, uint32_t unBufferSize, ETrackedPropertyError *pError = 0L )
-    // static void GetArrayTrackedDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetArrayTrackedDeviceProperty( unDeviceIndex, prop, propType?, buffer? ): TypedArray | undefined, or the byte count when given a buffer
+    static void GetArrayTrackedDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual uint32_t GetStringTrackedDeviceProperty( vr::TrackedDeviceIndex_t unDeviceIndex, ETrackedDeviceProperty prop, VR_OUT_STRING() char *pchValue, uint32_t unBufferSize, ETrackedPropertyError *pError = 0L )
-    // static void GetStringTrackedDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info);
+    static void GetStringTrackedDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetTrackedDeviceProperty( unDeviceIndex: TrackedDeviceIndex_t, prop: ETrackedDeviceProperty ): value | undefined
+    // Picks the getter from the property type table in propertytypes.h.
+    static void GetTrackedDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual const char *GetPropErrorNameFromEnum( ETrackedPropertyError error )
     // static void GetPropErrorNameFromEnum(const Nan::FunctionCallbackInfo<Value> &info);
 
@@ -106,7 +121,14 @@ private:
     // ------------------------------------
 
     // virtual bool PollNextEvent( VREvent_t *pEvent, uint32_t uncbVREvent )
-    // static void PollNextEvent(const Nan::FunctionCallbackInfo<Value> &info);
+    static void PollNextEvent(const Nan::FunctionCallbackInfo<Value> &info);
+    // PollNextEvents( buffer: ArrayBuffer | ArrayBufferView ): number
+    // Drains pending events into fixed-size records, see k_unVREventRecordSize.
+    static void PollNextEvents(const Nan::FunctionCallbackInfo<Value> &info);
+    // SetEventFilter( eventTypes?: EVREventType[] ): void
+    static void SetEventFilter(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetEventFilter(): EVREventType[] | undefined
+    static void GetEventFilter(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual bool PollNextEventWithPose( ETrackingUniverseOrigin eOrigin, VREvent_t *pEvent, uint32_t uncbVREvent, vr::TrackedDevicePose_t *pTrackedDevicePose )
     // static void PollNextEventWithPose(const Nan::FunctionCallbackInfo<Value> &info);
     // virtual const char *GetEventTypeNameFromEnum( EVREventType eType )
@@ -172,6 +194,7 @@ private:
 
     static Nan::Persistent<v8::Function> constructor;
     vr::IVRSystem *const self_;
+    EventFilter eventFilter_;
 };
 
 #endif
\ No newline at end of file
@@ -2,6 +2,17 @@
 #include "ivrsystem.h"
 #include "ivroverlay.h"
 #include "ivrapplications.h"
+#include "posesampler.h"
+#include "eventpump.h"
+#include "overlayanimator.h"
+#include "overlayfingerprint.h"
+#include "overlaymirror.h"
+#include "overlayregistry.h"
+#include "overlaytransformcache.h"
+#include "overlayupload.h"
+#include "pixelconvert.h"
+#include "propertycache.h"
+#include "util.h"
 
 #include <node.h>
 #include <openvr.h>
@@ -31,6 +42,15 @@ void VR_Init(const Nan::FunctionCallbackInfo<Value> &info)
 
 void VR_Shutdown(const Nan::FunctionCallbackInfo<Value> &info)
 {
+    PoseSampler::StopAll();
+    EventPump::StopAll();
+    OverlayAnimator::StopAll();
+    OverlayRawUpload::CancelAll();
+    OverlayRegistry::DestroyOwned(nullptr, vr::VROverlay());
+    OverlayFingerprint::Forget(vr::k_ulOverlayHandleInvalid);
+    OverlayMirror::Forget(vr::k_ulOverlayHandleInvalid);
+    OverlayTransformCache::Forget(vr::k_ulOverlayHandleInvalid);
+    PropertyCache::Invalidate(vr::k_unTrackedDeviceIndexInvalid);
     vr::VR_Shutdown();
 }
 
@@ -99,3 +119,82 @@ void IVRApplications_Init(const Nan::FunctionCallbackInfo<Value>& info)
     auto result = IVRApplications::NewInstance(vr::VRApplications());
     info.GetReturnValue().Set(result);
 }
+
+void ConvertPixels(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (info.Length() < 2 || info.Length() > 3)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be an EPixelConversion.");
+        return;
+    }
+    const uint32_t unConversion = info[0].As<Uint32>()->Value();
+    const uint32_t unSourceBytesPerPixel = PixelConvert::SourceBytesPerPixel(unConversion);
+    if (const char *pchError = PixelConvert::Validate(unConversion, unSourceBytesPerPixel))
+    {
+        Nan::ThrowRangeError(pchError);
+        return;
+    }
+
+    uint8_t *pSource;
+    size_t unSourceSize;
+    if (!GetBufferContents(info[1], &pSource, &unSourceSize))
+    {
+        Nan::ThrowTypeError("Argument[1] must be a Buffer, ArrayBuffer or ArrayBufferView.");
+        return;
+    }
+    if (unSourceSize % unSourceBytesPerPixel != 0)
+    {
+        Nan::ThrowRangeError("Argument[1] must hold a whole number of pixels.");
+        return;
+    }
+
+    const size_t unPixels = unSourceSize / unSourceBytesPerPixel;
+    const size_t unTargetSize = unPixels * PixelConvert::TargetBytesPerPixel(unConversion);
+
+    Local<Value> target;
+    uint8_t *pTarget;
+    if (info.Length() == 3 && !info[2]->IsUndefined())
+    {
+        size_t unTargetCapacity;
+        if (!GetBufferContents(info[2], &pTarget, &unTargetCapacity))
+        {
+            Nan::ThrowTypeError("Argument[2] must be a Buffer, ArrayBuffer or ArrayBufferView.");
+            return;
+        }
+        if (unTargetCapacity < unTargetSize)
+        {
+            Nan::ThrowRangeError("Argument[2] is too small for the converted pixels.");
+            return;
+        }
+
+        // In place works pixel by pixel; any other overlap would read pixels
+        // that were already overwritten.
+        const bool bOverlaps = pTarget < pSource + unSourceSize && pSource < pTarget + unTargetSize;
+        if (bOverlaps && (pTarget != pSource || unSourceBytesPerPixel != 4))
+        {
+            Nan::ThrowRangeError("Argument[2] must either be Argument[1] itself or not overlap it.");
+            return;
+        }
+        target = info[2];
+    }
+    else
+    {
+        Local<Object> buffer = node::Buffer::New(info.GetIsolate(), unTargetSize).ToLocalChecked();
+        pTarget = reinterpret_cast<uint8_t *>(node::Buffer::Data(buffer));
+        target = buffer;
+    }
+
+    PixelConvert::Convert(unConversion, pSource, pTarget, unPixels);
+    info.GetReturnValue().Set(target);
+}
+
+void GetPixelConversionInstructionSet(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    info.GetReturnValue().Set(Nan::New(PixelConvert::InstructionSet()).ToLocalChecked());
+}
@@ -40,4 +40,11 @@ void IVROverlay_Init(const Nan::FunctionCallbackInfo<Value>& info);
 
 void IVRApplications_Init(const Nan::FunctionCallbackInfo<Value>& info);
 
+/// ConvertPixels( eConversion, source, target? ): target, or a new Buffer when none is given
+/// Runs the PixelConvert kernels over a whole buffer.
+void ConvertPixels(const Nan::FunctionCallbackInfo<Value>& info);
+
+/// GetPixelConversionInstructionSet(): string
+void GetPixelConversionInstructionSet(const Nan::FunctionCallbackInfo<Value>& info);
+
 #endif
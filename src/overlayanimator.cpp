@@ -0,0 +1,714 @@
+#include "overlayanimator.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <set>
+
+using namespace v8;
+
+namespace
+{
+    constexpr float k_fDefaultDisplayHz = 90.0f;
+
+    // How long after vsync the thread wakes, so GetTimeSinceLastVsync
+    // already reports the new frame.
+    constexpr double k_fWakeDelaySeconds = 0.0005;
+
+    constexpr double k_fDefaultSmoothTime = 0.15;
+    constexpr double k_fDefaultDeadZoneDistance = 0.3;
+    constexpr double k_fDefaultDeadZoneAngle = 25.0;
+    constexpr double k_fDegreesToRadians = 3.14159265358979323846 / 180.0;
+
+    constexpr vr::HmdVector3d_t k_vUnitScale = {{1.0, 1.0, 1.0}};
+
+    vr::HmdVector3d_t GetTranslation(const vr::HmdMatrix34_t &m)
+    {
+        return {{m.m[0][3], m.m[1][3], m.m[2][3]}};
+    }
+
+    // Reads an optional non-negative number, throwing a RangeError naming it.
+    bool DecodeNonNegative(Local<Object> object, Local<String> key, const char *szUnit, double fDefault, double *pValue)
+    {
+        Local<Value> value = Nan::Get(object, key).ToLocalChecked();
+        if (value->IsUndefined())
+        {
+            *pValue = fDefault;
+            return true;
+        }
+
+        *pValue = value->IsNumber() ? value.As<Number>()->Value() : -1.0;
+        if (!(*pValue >= 0.0) || !std::isfinite(*pValue))
+        {
+            Nan::Utf8String name(key);
+            Nan::ThrowRangeError((std::string("Argument[1].") + *name + " must be a non-negative number of " + szUnit + ".").c_str());
+            return false;
+        }
+        return true;
+    }
+
+    std::mutex g_animatorsMutex;
+    std::set<OverlayAnimator *> g_animators;
+}
+
+Nan::Persistent<Function> OverlayAnimator::constructor;
+
+void OverlayAnimator::Init(Local<Object> exports)
+{
+    Local<Context> context = exports->CreationContext();
+    Nan::HandleScope scope;
+
+    Local<FunctionTemplate> tpl = Nan::New<FunctionTemplate>(New);
+    tpl->SetClassName(Nan::New("OverlayAnimator").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    Nan::SetPrototypeMethod(tpl, "Start", Start);
+    Nan::SetPrototypeMethod(tpl, "Stop", Stop);
+    Nan::SetPrototypeMethod(tpl, "IsRunning", IsRunning);
+    Nan::SetPrototypeMethod(tpl, "Animate", Animate);
+    Nan::SetPrototypeMethod(tpl, "Follow", Follow);
+    Nan::SetPrototypeMethod(tpl, "Cancel", Cancel);
+    Nan::SetPrototypeMethod(tpl, "CancelOverlay", CancelOverlay);
+    Nan::SetPrototypeMethod(tpl, "GetActiveCount", GetActiveCount);
+    Nan::SetPrototypeMethod(tpl, "GetFrameCount", GetFrameCount);
+
+    constructor.Reset(tpl->GetFunction(context).ToLocalChecked());
+    exports->Set(
+               context,
+               Nan::New("OverlayAnimator").ToLocalChecked(),
+               tpl->GetFunction(context).ToLocalChecked())
+        .FromJust();
+}
+
+void OverlayAnimator::StopAll()
+{
+    std::set<OverlayAnimator *> animators;
+    {
+        std::lock_guard<std::mutex> lock(g_animatorsMutex);
+        animators = g_animators;
+    }
+
+    for (OverlayAnimator *animator : animators)
+        animator->Stop();
+}
+
+OverlayAnimator::OverlayAnimator(Local<Value> callback)
+    : resource_("openvr:OverlayAnimator")
+{
+    if (callback->IsFunction())
+        callback_.Reset(callback.As<Function>());
+
+    std::lock_guard<std::mutex> lock(g_animatorsMutex);
+    g_animators.insert(this);
+}
+
+OverlayAnimator::~OverlayAnimator()
+{
+    // A running animator holds a reference to itself, so it is always stopped here.
+    std::lock_guard<std::mutex> lock(g_animatorsMutex);
+    g_animators.erase(this);
+}
+
+void OverlayAnimator::Start()
+{
+    if (running_)
+        return;
+
+    if (!callback_.IsEmpty())
+    {
+        async_ = new uv_async_t;
+        uv_async_init(Nan::GetCurrentEventLoop(), async_, OnAsync);
+        async_->data = this;
+    }
+
+    running_ = true;
+    Ref();
+    thread_ = std::thread(&OverlayAnimator::Run, this, vr::VRSystem(), vr::VROverlay());
+}
+
+void OverlayAnimator::Stop()
+{
+    if (!running_.exchange(false))
+        return;
+
+    thread_.join();
+
+    // Tweens keep their progress and resume on the next Start. Results the
+    // thread queued but the closing handle will not deliver are reported now.
+    if (async_)
+    {
+        uv_close(reinterpret_cast<uv_handle_t *>(async_), [](uv_handle_t *handle)
+                 { delete reinterpret_cast<uv_async_t *>(handle); });
+        async_ = nullptr;
+        Deliver();
+    }
+    Unref();
+}
+
+void OverlayAnimator::Run(vr::IVRSystem *system, vr::IVROverlay *overlay)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto epoch = Clock::now();
+    auto now = [&epoch]()
+    { return std::chrono::duration<double>(Clock::now() - epoch).count(); };
+
+    float fDisplayHz = system->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DisplayFrequency_Float);
+    if (!(fDisplayHz > 0.0f))
+        fDisplayHz = k_fDefaultDisplayHz;
+    const double period = 1.0 / fDisplayHz;
+
+    float fVsyncToPhotons = system->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_SecondsFromVsyncToPhotons_Float);
+    if (!(fVsyncToPhotons > 0.0f))
+        fVsyncToPhotons = 0.0f;
+
+    uint64_t ulLastFrame = 0;
+    double lastVsync = -1.0;
+    while (running_.load(std::memory_order_relaxed))
+    {
+        float fSecondsSinceLastVsync;
+        uint64_t ulFrame;
+        double vsync = now();
+        if (system->GetTimeSinceLastVsync(&fSecondsSinceLastVsync, &ulFrame))
+            vsync -= fSecondsSinceLastVsync;
+        else
+            ulFrame = ulLastFrame + 1; // no compositor: tick on our own clock
+
+        // One tick per frame; a wakeup before the frame counter moved does nothing.
+        if (lastVsync < 0.0 || ulFrame != ulLastFrame)
+        {
+            // Followers place their overlays where the device will be when this frame is shown.
+            const double predicted = std::max(0.0, vsync + period - now()) + fVsyncToPhotons;
+            Tick(system, overlay, lastVsync < 0.0 ? 0.0 : vsync - lastVsync, static_cast<float>(predicted));
+            ulLastFrame = ulFrame;
+            lastVsync = vsync;
+        }
+
+        const double wake = vsync + period + k_fWakeDelaySeconds;
+        std::this_thread::sleep_until(epoch + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(wake)));
+    }
+}
+
+void OverlayAnimator::Tick(vr::IVRSystem *system, vr::IVROverlay *overlay, double delta, float fPredictedSeconds)
+{
+    for (Tween &tween : active_)
+        tween.elapsed += delta;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::move(pending_.begin(), pending_.end(), std::back_inserter(active_));
+        pending_.clear();
+        std::move(pendingFollowers_.begin(), pendingFollowers_.end(), std::back_inserter(followers_));
+        pendingFollowers_.clear();
+
+        if (!cancelled_.empty())
+        {
+            auto isCancelled = [this](uint32_t unId)
+            { return std::find(cancelled_.begin(), cancelled_.end(), unId) != cancelled_.end(); };
+            active_.erase(std::remove_if(active_.begin(), active_.end(), [&isCancelled](const Tween &tween)
+                                         { return isCancelled(tween.unId); }),
+                          active_.end());
+            followers_.erase(std::remove_if(followers_.begin(), followers_.end(), [&isCancelled](const Follower &follower)
+                                            { return isCancelled(follower.unId); }),
+                             followers_.end());
+            cancelled_.clear();
+        }
+    }
+
+    std::vector<std::pair<uint32_t, vr::EVROverlayError>> finished;
+    for (auto tween = active_.begin(); tween != active_.end();)
+    {
+        const vr::EVROverlayError error = Evaluate(*tween).Apply(overlay, tween->ulOverlayHandle);
+        if (error != vr::VROverlayError_None || (!tween->bLoop && tween->elapsed >= tween->keyframes.back().time))
+        {
+            finished.emplace_back(tween->unId, error);
+            tween = active_.erase(tween);
+        }
+        else
+        {
+            ++tween;
+        }
+    }
+
+    if (!followers_.empty())
+        UpdateFollowers(system, overlay, delta, fPredictedSeconds, &finished);
+
+    if (!finished.empty())
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &result : finished)
+        {
+            // A tween cancelled since this tick started is not reported.
+            if (live_.erase(result.first) && async_)
+                finished_.push_back(result);
+        }
+        if (!finished_.empty())
+            uv_async_send(async_);
+    }
+
+    frames_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OverlayAnimator::UpdateFollowers(vr::IVRSystem *system, vr::IVROverlay *overlay, double delta, float fPredictedSeconds,
+                                      std::vector<std::pair<uint32_t, vr::EVROverlayError>> *pFinished)
+{
+    bool bFetched[vr::TrackingUniverseRawAndUncalibrated + 1] = {};
+    for (auto follower = followers_.begin(); follower != followers_.end();)
+    {
+        const vr::ETrackingUniverseOrigin eOrigin = follower->eTrackingOrigin;
+        if (!bFetched[eOrigin])
+        {
+            system->GetDeviceToAbsoluteTrackingPose(eOrigin, fPredictedSeconds, poses_[eOrigin], vr::k_unMaxTrackedDeviceCount);
+            bFetched[eOrigin] = true;
+        }
+
+        // Without a pose the overlay holds still until tracking comes back.
+        const vr::TrackedDevicePose_t &pose = poses_[eOrigin][follower->unDeviceIndex];
+        if (!pose.bPoseIsValid)
+        {
+            ++follower;
+            continue;
+        }
+
+        const vr::HmdMatrix34_t target = Target(*follower, pose.mDeviceToAbsoluteTracking);
+        const vr::EVROverlayError error = Step(*follower, target, delta).Apply(overlay, follower->ulOverlayHandle);
+        if (error != vr::VROverlayError_None)
+        {
+            pFinished->emplace_back(follower->unId, error);
+            follower = followers_.erase(follower);
+        }
+        else
+        {
+            ++follower;
+        }
+    }
+}
+
+void OverlayAnimator::Deliver()
+{
+    Nan::HandleScope scope;
+
+    std::vector<std::pair<uint32_t, vr::EVROverlayError>> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished.swap(finished_);
+    }
+
+    // The callback may stop the animator and drop the last reference to it.
+    Ref();
+    for (const auto &result : finished)
+    {
+        Local<Value> argv[] = {
+            Nan::New<Number>(result.first),
+            Nan::New<Number>(static_cast<uint32_t>(result.second)),
+        };
+        callback_.Call(2, argv, &resource_);
+    }
+    Unref();
+}
+
+void OverlayAnimator::OnAsync(uv_async_t *handle)
+{
+    static_cast<OverlayAnimator *>(handle->data)->Deliver();
+}
+
+double OverlayAnimator::Ease(EEasing eEasing, double t)
+{
+    switch (eEasing)
+    {
+    case Easing_QuadIn:
+        return t * t;
+    case Easing_QuadOut:
+        return t * (2.0 - t);
+    case Easing_QuadInOut:
+        return t < 0.5 ? 2.0 * t * t : 1.0 - 2.0 * (1.0 - t) * (1.0 - t);
+    case Easing_CubicIn:
+        return t * t * t;
+    case Easing_CubicOut:
+        return 1.0 - (1.0 - t) * (1.0 - t) * (1.0 - t);
+    case Easing_CubicInOut:
+        return t < 0.5 ? 4.0 * t * t * t : 1.0 - 4.0 * (1.0 - t) * (1.0 - t) * (1.0 - t);
+    case Easing_Step:
+        return t < 1.0 ? 0.0 : 1.0;
+    default:
+        return t;
+    }
+}
+
+OverlayProperties OverlayAnimator::Evaluate(const Tween &tween)
+{
+    const std::vector<Keyframe> &keyframes = tween.keyframes;
+    const double duration = keyframes.back().time;
+    const double time = tween.bLoop && duration > 0.0 ? std::fmod(tween.elapsed, duration) : tween.elapsed;
+
+    if (time <= keyframes.front().time)
+        return keyframes.front().properties;
+
+    for (size_t i = 1; i < keyframes.size(); ++i)
+    {
+        if (time < keyframes[i].time)
+        {
+            const Keyframe &from = keyframes[i - 1];
+            const double t = (time - from.time) / (keyframes[i].time - from.time);
+            return OverlayProperties::Interpolate(from.properties, keyframes[i].properties, Ease(from.eEasing, t));
+        }
+    }
+    return keyframes.back().properties;
+}
+
+// Where the follower's overlay should be for this device pose.
+vr::HmdMatrix34_t OverlayAnimator::Target(Follower &follower, const vr::HmdMatrix34_t &device)
+{
+    if (follower.eMode == FollowMode_Billboard)
+    {
+        const vr::HmdVector3d_t position = GetTranslation(follower.offset);
+        vr::HmdMatrix34_t local = follower.offset;
+        for (int row = 0; row < 3; ++row)
+            local.m[row][3] = 0.0f;
+
+        const double yaw = std::atan2(device.m[0][3] - position.v[0], device.m[2][3] - position.v[2]);
+        return HmdMath::Multiply(HmdMath::Compose(HmdMath::YawRotation(yaw), position, k_vUnitScale), local);
+    }
+
+    vr::HmdMatrix34_t base = device;
+    if (follower.bYawOnly)
+        base = HmdMath::Compose(HmdMath::YawRotation(HmdMath::Yaw(device)), GetTranslation(device), k_vUnitScale);
+
+    if (follower.eMode == FollowMode_DeadZone)
+    {
+        bool bRecenter = !follower.bAnchored;
+        if (!bRecenter)
+        {
+            const vr::HmdVector3d_t from = GetTranslation(follower.anchor);
+            const vr::HmdVector3d_t to = GetTranslation(base);
+            const double dx = to.v[0] - from.v[0], dy = to.v[1] - from.v[1], dz = to.v[2] - from.v[2];
+            bRecenter = std::sqrt(dx * dx + dy * dy + dz * dz) > follower.deadZoneDistance ||
+                        HmdMath::Angle(HmdMath::ToQuaternion(follower.anchor), HmdMath::ToQuaternion(base)) > follower.deadZoneAngle;
+        }
+        if (bRecenter)
+        {
+            follower.anchor = base;
+            follower.bAnchored = true;
+        }
+        base = follower.anchor;
+    }
+
+    return HmdMath::Multiply(base, follower.offset);
+}
+
+// Moves the follower's overlay toward target: position as a critically
+// damped spring, rotation by exponential slerp, both settling in about
+// smoothTime. Scale is taken from target.
+OverlayProperties OverlayAnimator::Step(Follower &follower, const vr::HmdMatrix34_t &target, double delta)
+{
+    HmdMath::Quaternion rotation;
+    vr::HmdVector3d_t position, scale;
+    HmdMath::Decompose(target, &rotation, &position, &scale);
+
+    if (!follower.bPlaced || follower.smoothTime <= 0.0)
+    {
+        follower.rotation = rotation;
+        follower.position = position;
+        follower.velocity = {};
+        follower.bPlaced = true;
+    }
+    else
+    {
+        const double omega = 2.0 / follower.smoothTime;
+        const double x = omega * delta;
+        const double decay = 1.0 / (1.0 + x + 0.48 * x * x + 0.235 * x * x * x);
+        for (int i = 0; i < 3; ++i)
+        {
+            const double change = follower.position.v[i] - position.v[i];
+            const double impulse = (follower.velocity.v[i] + omega * change) * delta;
+            follower.velocity.v[i] = (follower.velocity.v[i] - omega * impulse) * decay;
+            follower.position.v[i] = position.v[i] + (change + impulse) * decay;
+        }
+        follower.rotation = HmdMath::Slerp(follower.rotation, rotation, 1.0 - std::exp(-x));
+    }
+
+    OverlayProperties properties;
+    properties.unFields = OverlayProperties::Field_Transform;
+    properties.eTrackingOrigin = follower.eTrackingOrigin;
+    properties.transform = HmdMath::Compose(follower.rotation, follower.position, scale);
+    return properties;
+}
+
+// Decodes { keyframes: [{ time, easing?, ...OverlayProperties }], loop? }.
+bool OverlayAnimator::DecodeTween(Local<Value> value, Tween *pTween)
+{
+    const CodecKeys &keys = CodecKeys::Get(Isolate::GetCurrent());
+    if (!value->IsObject())
+    {
+        Nan::ThrowTypeError("Argument[1] must be an object.");
+        return false;
+    }
+
+    Local<Object> object = value.As<Object>();
+    Local<Value> keyframes = Nan::Get(object, keys.keyframes()).ToLocalChecked();
+    if (!keyframes->IsArray() || keyframes.As<Array>()->Length() == 0)
+    {
+        Nan::ThrowTypeError("Argument[1].keyframes must be a non-empty array.");
+        return false;
+    }
+
+    Local<Value> loop = Nan::Get(object, keys.loop()).ToLocalChecked();
+    if (!loop->IsUndefined() && !loop->IsBoolean())
+    {
+        Nan::ThrowTypeError("Argument[1].loop must be a boolean.");
+        return false;
+    }
+    pTween->bLoop = loop->IsTrue();
+
+    Local<Array> array = keyframes.As<Array>();
+    pTween->keyframes.resize(array->Length());
+    for (uint32_t i = 0; i < array->Length(); ++i)
+    {
+        const std::string name = "Argument[1].keyframes[" + std::to_string(i) + "]";
+        Keyframe &keyframe = pTween->keyframes[i];
+        Local<Value> element = Nan::Get(array, i).ToLocalChecked();
+        if (!OverlayProperties::Decode(element, name, &keyframe.properties))
+            return false;
+
+        Local<Value> time = Nan::Get(element.As<Object>(), keys.time()).ToLocalChecked();
+        keyframe.time = time->IsNumber() ? time.As<Number>()->Value() : -1.0;
+        if (!(keyframe.time >= (i == 0 ? 0.0 : pTween->keyframes[i - 1].time)) || !std::isfinite(keyframe.time))
+        {
+            Nan::ThrowRangeError((name + ".time must be a finite number of seconds, no earlier than the keyframe before it.").c_str());
+            return false;
+        }
+
+        Local<Value> easing = Nan::Get(element.As<Object>(), keys.easing()).ToLocalChecked();
+        if (!easing->IsUndefined() && (!easing->IsUint32() || easing.As<Uint32>()->Value() >= Easing_Count))
+        {
+            Nan::ThrowTypeError((name + ".easing must be an EOverlayEasing.").c_str());
+            return false;
+        }
+        keyframe.eEasing = easing->IsUndefined() ? Easing_Linear : static_cast<EEasing>(easing.As<Uint32>()->Value());
+
+        const uint32_t unFields = keyframe.properties.unFields;
+        if (unFields == 0 || (unFields & ~OverlayProperties::k_unAnimatableFields) != 0)
+        {
+            Nan::ThrowTypeError((name + " must set some of alpha, color, widthInMeters, curvature and transform, and nothing else.").c_str());
+            return false;
+        }
+        if (unFields != pTween->keyframes[0].properties.unFields)
+        {
+            Nan::ThrowTypeError((name + " must set the same properties as the first keyframe.").c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// Decodes { mode, transform, trackingOrigin?, device?, yawOnly?, smoothTime?,
+// deadZoneDistance?, deadZoneAngle? }.
+bool OverlayAnimator::DecodeFollow(Local<Value> value, Follower *pFollower)
+{
+    const CodecKeys &keys = CodecKeys::Get(Isolate::GetCurrent());
+    OverlayProperties properties;
+    if (!OverlayProperties::Decode(value, "Argument[1]", &properties))
+        return false;
+
+    if (properties.unFields != OverlayProperties::Field_Transform)
+    {
+        Nan::ThrowTypeError("Argument[1] must set transform, and no other overlay property.");
+        return false;
+    }
+    pFollower->offset = properties.transform;
+    pFollower->eTrackingOrigin = properties.eTrackingOrigin;
+
+    Local<Object> object = value.As<Object>();
+    Local<Value> mode = Nan::Get(object, keys.mode()).ToLocalChecked();
+    if (!mode->IsUint32() || mode.As<Uint32>()->Value() >= FollowMode_Count)
+    {
+        Nan::ThrowTypeError("Argument[1].mode must be an EOverlayFollowMode.");
+        return false;
+    }
+    pFollower->eMode = static_cast<EFollowMode>(mode.As<Uint32>()->Value());
+
+    Local<Value> device = Nan::Get(object, keys.device()).ToLocalChecked();
+    if (!device->IsUndefined() && (!device->IsUint32() || device.As<Uint32>()->Value() >= vr::k_unMaxTrackedDeviceCount))
+    {
+        Nan::ThrowTypeError("Argument[1].device must be a tracked device index.");
+        return false;
+    }
+    pFollower->unDeviceIndex = device->IsUndefined() ? vr::k_unTrackedDeviceIndex_Hmd : device.As<Uint32>()->Value();
+
+    Local<Value> yawOnly = Nan::Get(object, keys.yawOnly()).ToLocalChecked();
+    if (!yawOnly->IsUndefined() && !yawOnly->IsBoolean())
+    {
+        Nan::ThrowTypeError("Argument[1].yawOnly must be a boolean.");
+        return false;
+    }
+    pFollower->bYawOnly = yawOnly->IsTrue();
+
+    double deadZoneAngle;
+    if (!DecodeNonNegative(object, keys.smoothTime(), "seconds", k_fDefaultSmoothTime, &pFollower->smoothTime) ||
+        !DecodeNonNegative(object, keys.deadZoneDistance(), "meters", k_fDefaultDeadZoneDistance, &pFollower->deadZoneDistance) ||
+        !DecodeNonNegative(object, keys.deadZoneAngle(), "degrees", k_fDefaultDeadZoneAngle, &deadZoneAngle))
+        return false;
+    pFollower->deadZoneAngle = deadZoneAngle * k_fDegreesToRadians;
+
+    pFollower->bPlaced = false;
+    pFollower->bAnchored = false;
+    return true;
+}
+
+// new OverlayAnimator( onFinished? )
+void OverlayAnimator::New(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (!info.IsConstructCall())
+    {
+        Nan::ThrowError("Use the `new` keyword when creating a new instance.");
+        return;
+    }
+
+    if (!info[0]->IsUndefined() && !info[0]->IsFunction())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a function.");
+        return;
+    }
+
+    OverlayAnimator *obj = new OverlayAnimator(info[0]);
+    obj->Wrap(info.This());
+    info.GetReturnValue().Set(info.This());
+}
+
+void OverlayAnimator::Start(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    OverlayAnimator *obj = Nan::ObjectWrap::Unwrap<OverlayAnimator>(info.Holder());
+
+    if (!vr::VRSystem() || !vr::VROverlay())
+    {
+        Nan::ThrowError("VR_Init must be called before starting an OverlayAnimator.");
+        return;
+    }
+
+    obj->Start();
+}
+
+void OverlayAnimator::Stop(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    OverlayAnimator *obj = Nan::ObjectWrap::Unwrap<OverlayAnimator>(info.Holder());
+    obj->Stop();
+}
+
+void OverlayAnimator::IsRunning(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    OverlayAnimator *obj = Nan::ObjectWrap::Unwrap<OverlayAnimator>(info.Holder());
+    info.GetReturnValue().Set(Nan::New<Boolean>(obj->running_.load()));
+}
+
+void OverlayAnimator::Animate(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    OverlayAnimator *obj = Nan::ObjectWrap::Unwrap<OverlayAnimator>(info.Holder());
+
+    if (info.Length() != 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    Tween tween;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &tween.ulOverlayHandle))
+        return;
+    tween.elapsed = 0.0;
+    if (!DecodeTween(info[1], &tween))
+        return;
+
+    std::lock_guard<std::mutex> lock(obj->mutex_);
+    const uint32_t unId = obj->nextId_++;
+    tween.unId = unId;
+    obj->live_.emplace(unId, tween.ulOverlayHandle);
+    obj->pending_.push_back(std::move(tween));
+    info.GetReturnValue().Set(unId);
+}
+
+void OverlayAnimator::Follow(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    OverlayAnimator *obj = Nan::ObjectWrap::Unwrap<OverlayAnimator>(info.Holder());
+
+    if (info.Length() != 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    Follower follower;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &follower.ulOverlayHandle))
+        return;
+    if (!DecodeFollow(info[1], &follower))
+        return;
+
+    std::lock_guard<std::mutex> lock(obj->mutex_);
+    const uint32_t unId = obj->nextId_++;
+    follower.unId = unId;
+    obj->live_.emplace(unId, follower.ulOverlayHandle);
+    obj->pendingFollowers_.push_back(follower);
+    info.GetReturnValue().Set(unId);
+}
+
+void OverlayAnimator::Cancel(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    OverlayAnimator *obj = Nan::ObjectWrap::Unwrap<OverlayAnimator>(info.Holder());
+
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a tween or follower id.");
+        return;
+    }
+
+    const uint32_t unId = info[0].As<Uint32>()->Value();
+    std::lock_guard<std::mutex> lock(obj->mutex_);
+    const bool bLive = obj->live_.erase(unId) != 0;
+    if (bLive)
+        obj->cancelled_.push_back(unId);
+    info.GetReturnValue().Set(Nan::New<Boolean>(bLive));
+}
+
+void OverlayAnimator::CancelOverlay(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    OverlayAnimator *obj = Nan::ObjectWrap::Unwrap<OverlayAnimator>(info.Holder());
+
+    if (info.Length() != 1)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+    std::lock_guard<std::mutex> lock(obj->mutex_);
+    uint32_t unCancelled = 0;
+    for (auto tween = obj->live_.begin(); tween != obj->live_.end();)
+    {
+        if (tween->second == ulOverlayHandle)
+        {
+            obj->cancelled_.push_back(tween->first);
+            tween = obj->live_.erase(tween);
+            ++unCancelled;
+        }
+        else
+        {
+            ++tween;
+        }
+    }
+    info.GetReturnValue().Set(unCancelled);
+}
+
+void OverlayAnimator::GetActiveCount(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    OverlayAnimator *obj = Nan::ObjectWrap::Unwrap<OverlayAnimator>(info.Holder());
+
+    std::lock_guard<std::mutex> lock(obj->mutex_);
+    info.GetReturnValue().Set(static_cast<uint32_t>(obj->live_.size()));
+}
+
+void OverlayAnimator::GetFrameCount(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    OverlayAnimator *obj = Nan::ObjectWrap::Unwrap<OverlayAnimator>(info.Holder());
+    info.GetReturnValue().Set(Nan::New<Number>(static_cast<double>(obj->frames_.load())));
+}
@@ -0,0 +1,169 @@
+#ifndef OVERLAYANIMATOR_H_JS
+#define OVERLAYANIMATOR_H_JS
+
+#include "hmdmath.h"
+#include "overlayproperties.h"
+
+#include <nan.h>
+#include <openvr.h>
+#include <uv.h>
+#include <v8.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace v8;
+
+/// Runs keyframed overlay tweens on a native thread that wakes once per
+/// display frame, just after vsync, so fades and slides stay smooth however
+/// busy the main loop is.
+///
+/// A tween is a list of keyframes, each an OverlayProperties descriptor of
+/// the animatable fields plus a time in seconds. Every keyframe of a tween
+/// sets the same fields. A keyframe's easing shapes the segment that starts
+/// at it. Tweens added from JS are handed to the thread through a queue; the
+/// thread alone owns the running ones.
+///
+/// The same thread runs followers, which keep an overlay placed relative to
+/// a tracked device: a spring that trails the device, a dead zone that only
+/// recenters once the device has moved or turned far enough, or a billboard
+/// that stays put and turns about +Y to face the device. Poses are predicted
+/// for when the coming frame reaches the display, and fetched once per tick
+/// for every follower of a tracking origin. A follower runs until cancelled.
+class OverlayAnimator : public Nan::ObjectWrap
+{
+public:
+    static void Init(Local<Object> exports);
+
+    /// Stops every running animator. Called before the runtime is shut down.
+    static void StopAll();
+
+private:
+    enum EEasing : uint32_t
+    {
+        Easing_Linear,
+        Easing_QuadIn,
+        Easing_QuadOut,
+        Easing_QuadInOut,
+        Easing_CubicIn,
+        Easing_CubicOut,
+        Easing_CubicInOut,
+        Easing_Step,
+        Easing_Count,
+    };
+
+    enum EFollowMode : uint32_t
+    {
+        FollowMode_Spring,
+        FollowMode_DeadZone,
+        FollowMode_Billboard,
+        FollowMode_Count,
+    };
+
+    struct Keyframe
+    {
+        double time;
+        EEasing eEasing;
+        OverlayProperties properties;
+    };
+
+    struct Tween
+    {
+        uint32_t unId;
+        vr::VROverlayHandle_t ulOverlayHandle;
+        std::vector<Keyframe> keyframes;
+        bool bLoop;
+        double elapsed;
+    };
+
+    struct Follower
+    {
+        uint32_t unId;
+        vr::VROverlayHandle_t ulOverlayHandle;
+        EFollowMode eMode;
+        vr::TrackedDeviceIndex_t unDeviceIndex;
+        vr::ETrackingUniverseOrigin eTrackingOrigin;
+        vr::HmdMatrix34_t offset; // device to overlay; the overlay's own transform for billboards
+        bool bYawOnly;
+        double smoothTime;       // seconds; 0 is rigid
+        double deadZoneDistance; // meters
+        double deadZoneAngle;    // radians
+
+        // Thread state.
+        bool bPlaced;
+        HmdMath::Quaternion rotation;
+        vr::HmdVector3d_t position;
+        vr::HmdVector3d_t velocity;
+        bool bAnchored;
+        vr::HmdMatrix34_t anchor;
+    };
+
+    explicit OverlayAnimator(Local<Value> callback);
+    ~OverlayAnimator();
+
+    void Start();
+    void Stop();
+    void Run(vr::IVRSystem *system, vr::IVROverlay *overlay);
+    void Tick(vr::IVRSystem *system, vr::IVROverlay *overlay, double delta, float fPredictedSeconds);
+    void UpdateFollowers(vr::IVRSystem *system, vr::IVROverlay *overlay, double delta, float fPredictedSeconds,
+                         std::vector<std::pair<uint32_t, vr::EVROverlayError>> *pFinished);
+    void Deliver();
+
+    static double Ease(EEasing eEasing, double t);
+    static OverlayProperties Evaluate(const Tween &tween);
+    static bool DecodeTween(Local<Value> value, Tween *pTween);
+    static vr::HmdMatrix34_t Target(Follower &follower, const vr::HmdMatrix34_t &device);
+    static OverlayProperties Step(Follower &follower, const vr::HmdMatrix34_t &target, double delta);
+    static bool DecodeFollow(Local<Value> value, Follower *pFollower);
+
+    static void OnAsync(uv_async_t *handle);
+
+    static void New(const Nan::FunctionCallbackInfo<Value> &info);
+
+    // Start(): void
+    static void Start(const Nan::FunctionCallbackInfo<Value> &info);
+    // Stop(): void
+    static void Stop(const Nan::FunctionCallbackInfo<Value> &info);
+    // IsRunning(): boolean
+    static void IsRunning(const Nan::FunctionCallbackInfo<Value> &info);
+    // Animate( ulOverlayHandle, tween: OverlayTween ): number
+    static void Animate(const Nan::FunctionCallbackInfo<Value> &info);
+    // Follow( ulOverlayHandle, follow: OverlayFollow ): number
+    static void Follow(const Nan::FunctionCallbackInfo<Value> &info);
+    // Cancel( unId ): boolean
+    static void Cancel(const Nan::FunctionCallbackInfo<Value> &info);
+    // CancelOverlay( ulOverlayHandle ): number
+    static void CancelOverlay(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetActiveCount(): number
+    static void GetActiveCount(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetFrameCount(): number
+    static void GetFrameCount(const Nan::FunctionCallbackInfo<Value> &info);
+
+    static Nan::Persistent<v8::Function> constructor;
+
+    Nan::Callback callback_; // empty when finished tweens are not reported
+    Nan::AsyncResource resource_;
+
+    std::vector<Tween> active_; // the animator thread's, or anyone's while stopped
+    std::vector<Follower> followers_;
+    vr::TrackedDevicePose_t poses_[vr::TrackingUniverseRawAndUncalibrated + 1][vr::k_unMaxTrackedDeviceCount];
+
+    std::mutex mutex_;
+    std::vector<Tween> pending_;
+    std::vector<Follower> pendingFollowers_;
+    std::vector<uint32_t> cancelled_;
+    std::unordered_map<uint32_t, vr::VROverlayHandle_t> live_; // every tween and follower not yet finished or cancelled
+    std::vector<std::pair<uint32_t, vr::EVROverlayError>> finished_;
+    uint32_t nextId_ = 1;
+
+    std::atomic<uint64_t> frames_{0};
+    uv_async_t *async_ = nullptr;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+#endif
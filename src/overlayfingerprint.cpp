@@ -0,0 +1,388 @@
+#include "overlayfingerprint.h"
+#include "cpufeatures.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    constexpr uint64_t k_ulPrime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t k_ulPrime2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t k_ulPrime3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t k_ulPrime4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64_t k_ulPrime5 = 0x27D4EB2F165667C5ull;
+    constexpr uint32_t k_unPrime32_1 = 0x9E3779B1u;
+    constexpr uint32_t k_unPrime32_2 = 0x85EBCA77u;
+    constexpr uint32_t k_unPrime32_3 = 0xC2B2AE3Du;
+
+    // A stripe is 64 bytes, one 64-bit word for each of the eight lanes.
+    constexpr size_t k_unLanes = 8;
+    constexpr size_t k_unStripeSize = k_unLanes * sizeof(uint64_t);
+
+    // Key words, splitmix64 of a counter. Stripe s of a row is keyed with
+    // words (s & 3) to (s & 3) + 7, so the stripes of a row hash differently;
+    // the scramble after each row uses words 8 to 15.
+    constexpr std::array<uint64_t, 16> MakeSecret()
+    {
+        std::array<uint64_t, 16> secret = {};
+        uint64_t ulState = k_ulPrime3;
+        for (size_t i = 0; i < secret.size(); ++i)
+        {
+            ulState += 0x9E3779B97F4A7C15ull;
+            uint64_t z = ulState;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            secret[i] = z ^ (z >> 31);
+        }
+        return secret;
+    }
+
+    constexpr std::array<uint64_t, 16> k_secret = MakeSecret();
+
+    std::atomic<bool> g_enabled{false};
+
+    std::atomic<uint64_t> g_uploadedFrames{0};
+    std::atomic<uint64_t> g_uploadedBytes{0};
+    std::atomic<uint64_t> g_skippedFrames{0};
+    std::atomic<uint64_t> g_skippedBytes{0};
+    std::atomic<uint64_t> g_dirtyTiles{0};
+    std::atomic<uint64_t> g_totalTiles{0};
+
+    std::mutex g_mutex;
+    std::unordered_map<vr::VROverlayHandle_t, OverlayFingerprint::Frame> g_frames;
+
+    uint64_t RotateLeft(uint64_t ulValue, int nBits)
+    {
+        return (ulValue << nBits) | (ulValue >> (64 - nBits));
+    }
+
+    uint64_t Load64(const uint8_t *pData)
+    {
+        uint64_t ulValue;
+        std::memcpy(&ulValue, pData, sizeof(ulValue));
+        return ulValue;
+    }
+
+    //=========================================================
+    // Stripe kernels, XXH3's accumulate step: for each lane, the keyed word's
+    // halves multiplied 32x32->64 into the lane, and the plain word added to
+    // its neighbour. Every kernel gives the same accumulators.
+
+    void AccumulateScalar(uint64_t *pAcc, const uint8_t *pData, size_t unFirstStripe, size_t unStripes)
+    {
+        for (size_t s = 0; s < unStripes; ++s)
+        {
+            const uint64_t *pKey = k_secret.data() + ((unFirstStripe + s) & 3);
+            for (size_t nLane = 0; nLane < k_unLanes; ++nLane)
+            {
+                const uint64_t ulData = Load64(pData + s * k_unStripeSize + nLane * 8);
+                const uint64_t ulKeyed = ulData ^ pKey[nLane];
+                pAcc[nLane ^ 1] += ulData;
+                pAcc[nLane] += (ulKeyed & 0xFFFFFFFFull) * (ulKeyed >> 32);
+            }
+        }
+    }
+
+#if defined(CPUFEATURES_X86)
+    CPUFEATURES_TARGET("sse2")
+    void AccumulateSse2(uint64_t *pAcc, const uint8_t *pData, size_t unFirstStripe, size_t unStripes)
+    {
+        __m128i acc[4];
+        for (int i = 0; i < 4; ++i)
+            acc[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pAcc + i * 2));
+
+        for (size_t s = 0; s < unStripes; ++s)
+        {
+            const uint64_t *pKey = k_secret.data() + ((unFirstStripe + s) & 3);
+            for (int i = 0; i < 4; ++i)
+            {
+                const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + s * k_unStripeSize + i * 16));
+                const __m128i keyed = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i *>(pKey + i * 2)));
+                const __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+                acc[i] = _mm_add_epi64(acc[i], _mm_add_epi64(product, _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2))));
+            }
+        }
+
+        for (int i = 0; i < 4; ++i)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(pAcc + i * 2), acc[i]);
+    }
+
+    CPUFEATURES_TARGET("avx2")
+    void AccumulateAvx2(uint64_t *pAcc, const uint8_t *pData, size_t unFirstStripe, size_t unStripes)
+    {
+        // The shuffles work within 128-bit halves, which is where each lane's neighbour is.
+        __m256i acc[2];
+        for (int i = 0; i < 2; ++i)
+            acc[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pAcc + i * 4));
+
+        for (size_t s = 0; s < unStripes; ++s)
+        {
+            const uint64_t *pKey = k_secret.data() + ((unFirstStripe + s) & 3);
+            for (int i = 0; i < 2; ++i)
+            {
+                const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pData + s * k_unStripeSize + i * 32));
+                const __m256i keyed = _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pKey + i * 4)));
+                const __m256i product = _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+                acc[i] = _mm256_add_epi64(acc[i], _mm256_add_epi64(product, _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2))));
+            }
+        }
+
+        for (int i = 0; i < 2; ++i)
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(pAcc + i * 4), acc[i]);
+    }
+#elif defined(CPUFEATURES_NEON)
+    void AccumulateNeon(uint64_t *pAcc, const uint8_t *pData, size_t unFirstStripe, size_t unStripes)
+    {
+        uint64x2_t acc[4];
+        for (int i = 0; i < 4; ++i)
+            acc[i] = vld1q_u64(pAcc + i * 2);
+
+        for (size_t s = 0; s < unStripes; ++s)
+        {
+            const uint64_t *pKey = k_secret.data() + ((unFirstStripe + s) & 3);
+            for (int i = 0; i < 4; ++i)
+            {
+                const uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(pData + s * k_unStripeSize + i * 16));
+                const uint64x2_t keyed = veorq_u64(data, vld1q_u64(pKey + i * 2));
+                const uint64x2_t product = vmull_u32(vmovn_u64(keyed), vshrn_n_u64(keyed, 32));
+                acc[i] = vaddq_u64(acc[i], vaddq_u64(product, vextq_u64(data, data, 1)));
+            }
+        }
+
+        for (int i = 0; i < 4; ++i)
+            vst1q_u64(pAcc + i * 2, acc[i]);
+    }
+#endif
+
+    //=========================================================
+    struct Kernel
+    {
+        const char *pchName;
+        void (*pfnAccumulate)(uint64_t *, const uint8_t *, size_t, size_t);
+    };
+
+    // Best first.
+    std::vector<Kernel> AvailableKernels()
+    {
+        std::vector<Kernel> kernels;
+#if defined(CPUFEATURES_X86)
+        if (CpuFeatures::HasAvx2())
+            kernels.push_back({"avx2", AccumulateAvx2});
+        if (CpuFeatures::HasSse2())
+            kernels.push_back({"sse2", AccumulateSse2});
+#elif defined(CPUFEATURES_NEON)
+        kernels.push_back({"neon", AccumulateNeon});
+#endif
+        kernels.push_back({"scalar", AccumulateScalar});
+        return kernels;
+    }
+
+    const Kernel &GetKernel()
+    {
+        static const Kernel kernel = AvailableKernels().front();
+        return kernel;
+    }
+
+    // XXH3-style state with eight independent lanes. Each row of a tile is
+    // accumulated a stripe at a time and then scrambled, so moving pixels
+    // between rows or stripes changes the hash.
+    struct TileHash
+    {
+        std::array<uint64_t, k_unLanes> lanes = {k_unPrime32_3, k_ulPrime1, k_ulPrime2, k_ulPrime3,
+                                                 k_ulPrime4, k_unPrime32_2, k_ulPrime5, k_unPrime32_1};
+
+        void Update(const Kernel &kernel, const uint8_t *pData, size_t unSize)
+        {
+            const size_t unStripes = unSize / k_unStripeSize;
+            kernel.pfnAccumulate(lanes.data(), pData, 0, unStripes);
+
+            // Partial tiles at the right edge end in a zero-padded stripe.
+            const size_t unTail = unSize % k_unStripeSize;
+            if (unTail != 0)
+            {
+                uint8_t stripe[k_unStripeSize] = {};
+                std::memcpy(stripe, pData + unStripes * k_unStripeSize, unTail);
+                kernel.pfnAccumulate(lanes.data(), stripe, unStripes, 1);
+            }
+
+            for (size_t nLane = 0; nLane < k_unLanes; ++nLane)
+                lanes[nLane] = (lanes[nLane] ^ (lanes[nLane] >> 47) ^ k_secret[8 + nLane]) * k_unPrime32_1;
+        }
+
+        uint64_t Finish() const
+        {
+            uint64_t ulHash = k_ulPrime5;
+            for (uint64_t ulLane : lanes)
+                ulHash = RotateLeft(ulHash ^ (ulLane * k_ulPrime2), 31) * k_ulPrime1;
+            ulHash ^= ulHash >> 33;
+            ulHash *= k_ulPrime2;
+            ulHash ^= ulHash >> 29;
+            ulHash *= k_ulPrime3;
+            ulHash ^= ulHash >> 32;
+            return ulHash;
+        }
+    };
+
+    void ComputeWith(const Kernel &kernel, const uint8_t *pData, uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel,
+                     OverlayFingerprint::Frame *pFrame)
+    {
+        using OverlayFingerprint::k_unTileSize;
+        const uint32_t unTileColumns = (unWidth + k_unTileSize - 1) / k_unTileSize;
+        const uint32_t unTileRows = (unHeight + k_unTileSize - 1) / k_unTileSize;
+        const size_t unRowBytes = static_cast<size_t>(unWidth) * unBytesPerPixel;
+
+        pFrame->unWidth = unWidth;
+        pFrame->unHeight = unHeight;
+        pFrame->unBytesPerPixel = unBytesPerPixel;
+        pFrame->tiles.resize(static_cast<size_t>(unTileColumns) * unTileRows);
+
+        // Rows are read in memory order, each feeding the tiles it crosses.
+        std::vector<TileHash> hashes(unTileColumns);
+        for (uint32_t unTileRow = 0; unTileRow < unTileRows; ++unTileRow)
+        {
+            std::fill(hashes.begin(), hashes.end(), TileHash());
+
+            const uint32_t unFirstRow = unTileRow * k_unTileSize;
+            const uint32_t unLastRow = std::min(unFirstRow + k_unTileSize, unHeight);
+            for (uint32_t unRow = unFirstRow; unRow < unLastRow; ++unRow)
+            {
+                const uint8_t *pRow = pData + unRow * unRowBytes;
+                for (uint32_t unTileColumn = 0; unTileColumn < unTileColumns; ++unTileColumn)
+                {
+                    const size_t unStart = static_cast<size_t>(unTileColumn) * k_unTileSize * unBytesPerPixel;
+                    const size_t unEnd = std::min(unStart + static_cast<size_t>(k_unTileSize) * unBytesPerPixel, unRowBytes);
+                    hashes[unTileColumn].Update(kernel, pRow + unStart, unEnd - unStart);
+                }
+            }
+
+            for (uint32_t unTileColumn = 0; unTileColumn < unTileColumns; ++unTileColumn)
+                pFrame->tiles[unTileRow * unTileColumns + unTileColumn] = hashes[unTileColumn].Finish();
+        }
+    }
+}
+
+namespace OverlayFingerprint
+{
+    bool Enabled()
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool bEnabled)
+    {
+        g_enabled.store(bEnabled, std::memory_order_relaxed);
+        if (!bEnabled)
+            Forget(vr::k_ulOverlayHandleInvalid);
+    }
+
+    void Compute(const uint8_t *pData, uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel, Frame *pFrame)
+    {
+        ComputeWith(GetKernel(), pData, unWidth, unHeight, unBytesPerPixel, pFrame);
+    }
+
+    std::vector<std::string> InstructionSets()
+    {
+        std::vector<std::string> names;
+        for (const Kernel &kernel : AvailableKernels())
+            names.push_back(kernel.pchName);
+        return names;
+    }
+
+    bool Compute(const std::string &instructionSet, const uint8_t *pData, uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel,
+                 Frame *pFrame)
+    {
+        for (const Kernel &kernel : AvailableKernels())
+        {
+            if (instructionSet == kernel.pchName)
+            {
+                ComputeWith(kernel, pData, unWidth, unHeight, unBytesPerPixel, pFrame);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t DirtyTiles(vr::VROverlayHandle_t ulOverlayHandle, const Frame &frame)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto last = g_frames.find(ulOverlayHandle);
+        if (last == g_frames.end() || last->second.unWidth != frame.unWidth || last->second.unHeight != frame.unHeight ||
+            last->second.unBytesPerPixel != frame.unBytesPerPixel)
+        {
+            return static_cast<uint32_t>(frame.tiles.size());
+        }
+
+        uint32_t unDirty = 0;
+        for (size_t i = 0; i < frame.tiles.size(); ++i)
+            unDirty += frame.tiles[i] != last->second.tiles[i];
+        return unDirty;
+    }
+
+    void Commit(vr::VROverlayHandle_t ulOverlayHandle, Frame &&frame, uint32_t unDirtyTiles)
+    {
+        g_uploadedFrames.fetch_add(1, std::memory_order_relaxed);
+        g_uploadedBytes.fetch_add(static_cast<uint64_t>(frame.unWidth) * frame.unHeight * frame.unBytesPerPixel, std::memory_order_relaxed);
+        g_dirtyTiles.fetch_add(unDirtyTiles, std::memory_order_relaxed);
+        g_totalTiles.fetch_add(frame.tiles.size(), std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_frames[ulOverlayHandle] = std::move(frame);
+    }
+
+    void Skip(const Frame &frame)
+    {
+        g_skippedFrames.fetch_add(1, std::memory_order_relaxed);
+        g_skippedBytes.fetch_add(static_cast<uint64_t>(frame.unWidth) * frame.unHeight * frame.unBytesPerPixel, std::memory_order_relaxed);
+    }
+
+    void Forget(vr::VROverlayHandle_t ulOverlayHandle)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (ulOverlayHandle == vr::k_ulOverlayHandleInvalid)
+            g_frames.clear();
+        else
+            g_frames.erase(ulOverlayHandle);
+    }
+
+    vr::EVROverlayError UploadRaw(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle, const uint8_t *pData,
+                                  uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel, bool *pbSkipped)
+    {
+        *pbSkipped = false;
+        void *pvData = const_cast<uint8_t *>(pData);
+        if (!Enabled())
+            return overlay->SetOverlayRaw(ulOverlayHandle, pvData, unWidth, unHeight, unBytesPerPixel);
+
+        Frame frame;
+        Compute(pData, unWidth, unHeight, unBytesPerPixel, &frame);
+        const uint32_t unDirtyTiles = DirtyTiles(ulOverlayHandle, frame);
+        if (unDirtyTiles == 0)
+        {
+            Skip(frame);
+            *pbSkipped = true;
+            return vr::VROverlayError_None;
+        }
+
+        const vr::EVROverlayError error = overlay->SetOverlayRaw(ulOverlayHandle, pvData, unWidth, unHeight, unBytesPerPixel);
+        if (error == vr::VROverlayError_None)
+            Commit(ulOverlayHandle, std::move(frame), unDirtyTiles);
+        else
+            Forget(ulOverlayHandle);
+        return error;
+    }
+
+    Stats GetStats()
+    {
+        Stats stats;
+        stats.uploadedFrames = g_uploadedFrames.load(std::memory_order_relaxed);
+        stats.uploadedBytes = g_uploadedBytes.load(std::memory_order_relaxed);
+        stats.skippedFrames = g_skippedFrames.load(std::memory_order_relaxed);
+        stats.skippedBytes = g_skippedBytes.load(std::memory_order_relaxed);
+        stats.dirtyTiles = g_dirtyTiles.load(std::memory_order_relaxed);
+        stats.totalTiles = g_totalTiles.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
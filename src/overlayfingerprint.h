@@ -0,0 +1,82 @@
+#ifndef OVERLAYFINGERPRINT_H_JS
+#define OVERLAYFINGERPRINT_H_JS
+
+#include <openvr.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Fingerprints of the last raw frame uploaded to each overlay, so that
+/// SetOverlayRaw can skip frames identical to what the runtime already has.
+///
+/// A frame is hashed in 64x64 pixel tiles. SetOverlayRaw always replaces the
+/// whole texture, so one changed tile means an upload; the tiles are counted
+/// so callers can see how much of each uploaded frame actually changed.
+///
+/// Tiles are hashed with an XXH3-style accumulator built on 32x32->64
+/// multiplies, with AVX2 and SSE2 versions picked at runtime on x86, a NEON
+/// version on ARM64, and a scalar version everywhere. All give the same hashes.
+///
+/// Off until enabled. All functions are thread-safe.
+namespace OverlayFingerprint
+{
+    constexpr uint32_t k_unTileSize = 64;
+
+    struct Frame
+    {
+        uint32_t unWidth = 0;
+        uint32_t unHeight = 0;
+        uint32_t unBytesPerPixel = 0;
+        std::vector<uint64_t> tiles;
+    };
+
+    struct Stats
+    {
+        uint64_t uploadedFrames;
+        uint64_t uploadedBytes;
+        uint64_t skippedFrames;
+        uint64_t skippedBytes;
+        uint64_t dirtyTiles; // tiles that differed in uploaded frames
+        uint64_t totalTiles; // tiles in uploaded frames
+    };
+
+    bool Enabled();
+
+    /// Disabling also forgets every fingerprint.
+    void SetEnabled(bool bEnabled);
+
+    void Compute(const uint8_t *pData, uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel, Frame *pFrame);
+
+    /// Instruction sets the tile hash can use on this CPU, the one Compute uses first.
+    std::vector<std::string> InstructionSets();
+
+    /// Compute with one of InstructionSets(), for checking they agree. Returns
+    /// false for an instruction set this CPU cannot use.
+    bool Compute(const std::string &instructionSet, const uint8_t *pData, uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel,
+                 Frame *pFrame);
+
+    /// Number of tiles in frame that differ from the overlay's last committed
+    /// frame. Every tile counts as dirty when there is nothing to compare to or
+    /// the size changed.
+    uint32_t DirtyTiles(vr::VROverlayHandle_t ulOverlayHandle, const Frame &frame);
+
+    /// Records frame as what the overlay now shows, after a successful upload.
+    void Commit(vr::VROverlayHandle_t ulOverlayHandle, Frame &&frame, uint32_t unDirtyTiles);
+
+    /// Counts a frame that was not uploaded because nothing changed.
+    void Skip(const Frame &frame);
+
+    /// Forgets one overlay, or every overlay when given k_ulOverlayHandleInvalid.
+    /// Needed whenever the texture changes by any other path.
+    void Forget(vr::VROverlayHandle_t ulOverlayHandle);
+
+    /// SetOverlayRaw that skips the call when enabled and the frame matches
+    /// the overlay's last upload. pData must hold the whole frame.
+    vr::EVROverlayError UploadRaw(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle, const uint8_t *pData,
+                                  uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel, bool *pbSkipped);
+
+    Stats GetStats();
+}
+
+#endif
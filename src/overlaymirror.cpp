@@ -0,0 +1,154 @@
+#include "overlaymirror.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    struct MirroredOverlay
+    {
+        bool bDashboard = false;
+        OverlayProperties properties; // unFields says which values are known
+    };
+
+    std::atomic<bool> g_enabled{false};
+    std::atomic<uint64_t> g_hits{0};
+    std::atomic<uint64_t> g_misses{0};
+
+    std::mutex g_mutex;
+    std::unordered_map<vr::VROverlayHandle_t, MirroredOverlay> g_overlays;
+
+    void CopyFields(const OverlayProperties &from, uint32_t unFields, OverlayProperties *pTo)
+    {
+        if (unFields & OverlayProperties::Field_Alpha)
+            pTo->fAlpha = from.fAlpha;
+        if (unFields & OverlayProperties::Field_Color)
+        {
+            pTo->fRed = from.fRed;
+            pTo->fGreen = from.fGreen;
+            pTo->fBlue = from.fBlue;
+        }
+        if (unFields & OverlayProperties::Field_WidthInMeters)
+            pTo->fWidthInMeters = from.fWidthInMeters;
+        if (unFields & OverlayProperties::Field_Curvature)
+            pTo->fCurvature = from.fCurvature;
+        if (unFields & OverlayProperties::Field_SortOrder)
+            pTo->unSortOrder = from.unSortOrder;
+        if (unFields & OverlayProperties::Field_TexelAspect)
+            pTo->fTexelAspect = from.fTexelAspect;
+        if (unFields & OverlayProperties::Field_TextureBounds)
+            pTo->textureBounds = from.textureBounds;
+        if (unFields & OverlayProperties::Field_Transform)
+        {
+            pTo->eTrackingOrigin = from.eTrackingOrigin;
+            pTo->transform = from.transform;
+        }
+        if (unFields & OverlayProperties::Field_Visible)
+            pTo->bVisible = from.bVisible;
+        pTo->unFields |= unFields;
+    }
+}
+
+namespace OverlayMirror
+{
+    bool Enabled()
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool bEnabled)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_enabled.store(bEnabled, std::memory_order_relaxed);
+        if (!bEnabled)
+        {
+            for (auto &overlay : g_overlays)
+                overlay.second.properties.unFields = 0;
+        }
+    }
+
+    void Track(vr::VROverlayHandle_t ulOverlayHandle, bool bDashboard)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        MirroredOverlay &overlay = g_overlays[ulOverlayHandle];
+        overlay = MirroredOverlay();
+        overlay.bDashboard = bDashboard;
+    }
+
+    void Forget(vr::VROverlayHandle_t ulOverlayHandle)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (ulOverlayHandle == vr::k_ulOverlayHandleInvalid)
+            g_overlays.clear();
+        else
+            g_overlays.erase(ulOverlayHandle);
+    }
+
+    void Record(vr::VROverlayHandle_t ulOverlayHandle, const OverlayProperties &properties, uint32_t unFields)
+    {
+        if (!Enabled() || unFields == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto overlay = g_overlays.find(ulOverlayHandle);
+        if (overlay == g_overlays.end())
+            return;
+
+        if (overlay->second.bDashboard)
+            unFields &= ~OverlayProperties::Field_Visible;
+        CopyFields(properties, unFields, &overlay->second.properties);
+    }
+
+    void Invalidate(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unFields)
+    {
+        if (!Enabled())
+            return;
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto overlay = g_overlays.find(ulOverlayHandle);
+        if (overlay != g_overlays.end())
+            overlay->second.properties.unFields &= ~unFields;
+    }
+
+    void Observe(vr::VROverlayHandle_t ulOverlayHandle, const vr::VREvent_t &event)
+    {
+        if (event.eventType != vr::VREvent_OverlayShown && event.eventType != vr::VREvent_OverlayHidden)
+            return;
+
+        OverlayProperties properties;
+        properties.bVisible = event.eventType == vr::VREvent_OverlayShown;
+        Record(ulOverlayHandle, properties, OverlayProperties::Field_Visible);
+    }
+
+    bool Lookup(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unFields, OverlayProperties *pProperties)
+    {
+        if (!Enabled())
+            return false;
+
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            auto overlay = g_overlays.find(ulOverlayHandle);
+            if (overlay != g_overlays.end() && (overlay->second.properties.unFields & unFields) == unFields)
+            {
+                CopyFields(overlay->second.properties, unFields, pProperties);
+                g_hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        g_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Stats GetStats()
+    {
+        Stats stats;
+        stats.hits = g_hits.load(std::memory_order_relaxed);
+        stats.misses = g_misses.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        stats.overlays = static_cast<uint32_t>(g_overlays.size());
+        return stats;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef OVERLAYMIRROR_H_JS
+#define OVERLAYMIRROR_H_JS
+
+#include "overlayproperties.h"
+
+#include <openvr.h>
+
+#include <cstdint>
+
+/// Properties this process set on its own overlays, so that getters can
+/// answer from memory instead of a round trip to vrserver.
+///
+/// Only overlays created through this binding are mirrored. Values are
+/// recorded after the runtime accepted them, and a getter that still has to
+/// ask the runtime fills in what it learns. Overlays of other processes
+/// always go to the runtime. The dashboard decides when dashboard overlays
+/// are visible, so their visibility is never mirrored.
+///
+/// Off until enabled. All functions are thread-safe.
+namespace OverlayMirror
+{
+    bool Enabled();
+
+    /// Disabling drops every recorded value; which overlays are ours is kept.
+    void SetEnabled(bool bEnabled);
+
+    /// Marks an overlay as created by this process.
+    void Track(vr::VROverlayHandle_t ulOverlayHandle, bool bDashboard);
+
+    /// Forgets one overlay, or every overlay when given k_ulOverlayHandleInvalid.
+    void Forget(vr::VROverlayHandle_t ulOverlayHandle);
+
+    /// Records the unFields fields of properties as the overlay's current values.
+    void Record(vr::VROverlayHandle_t ulOverlayHandle, const OverlayProperties &properties, uint32_t unFields);
+
+    /// Drops recorded fields that changed some other way.
+    void Invalidate(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unFields);
+
+    /// Keeps visibility in step with OverlayShown and OverlayHidden events.
+    void Observe(vr::VROverlayHandle_t ulOverlayHandle, const vr::VREvent_t &event);
+
+    /// Copies the unFields fields into pProperties when all of them are
+    /// mirrored. Returns false, counting a miss, otherwise.
+    bool Lookup(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unFields, OverlayProperties *pProperties);
+
+    struct Stats
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint32_t overlays;
+    };
+
+    Stats GetStats();
+}
+
+#endif
@@ -0,0 +1,185 @@
+#include "overlayproperties.h"
+#include "hmdmath.h"
+#include "overlaymirror.h"
+#include "overlaytransformcache.h"
+#include "util.h"
+
+using namespace v8;
+
+namespace
+{
+    // False when the key is missing or undefined, which descriptors treat alike.
+    bool GetKey(Local<Object> object, Local<String> key, Local<Value> *pValue)
+    {
+        *pValue = Nan::Get(object, key).ToLocalChecked();
+        return !(*pValue)->IsUndefined();
+    }
+
+    bool ThrowKeyError(const std::string &name, Local<String> key, const char *pchExpected)
+    {
+        const std::string message = name + "." + *Nan::Utf8String(key) + " must be " + pchExpected + ".";
+        Nan::ThrowTypeError(message.c_str());
+        return false;
+    }
+
+    bool DecodeFloat(Local<Object> object, Local<String> key, const std::string &name, OverlayProperties::EField eField,
+                     float *pfValue, uint32_t *punFields)
+    {
+        Local<Value> value;
+        if (!GetKey(object, key, &value))
+            return true;
+        if (!value->IsNumber())
+            return ThrowKeyError(name, key, "a number");
+
+        *pfValue = static_cast<float>(value.As<Number>()->Value());
+        *punFields |= eField;
+        return true;
+    }
+
+    bool IsMatrix34(Local<Value> value)
+    {
+        if (!value->IsArray() || value.As<Array>()->Length() != 3)
+            return false;
+
+        for (uint32_t unRow = 0; unRow < 3; ++unRow)
+        {
+            Local<Value> row = Nan::Get(value.As<Object>(), unRow).ToLocalChecked();
+            if (!row->IsArray() || row.As<Array>()->Length() != 4)
+                return false;
+        }
+        return true;
+    }
+}
+
+bool OverlayProperties::Decode(Local<Value> value, const std::string &name, OverlayProperties *pProperties)
+{
+    Isolate *isolate = Isolate::GetCurrent();
+    if (!value->IsObject())
+    {
+        Nan::ThrowTypeError((name + " must be an object.").c_str());
+        return false;
+    }
+
+    const CodecKeys &keys = CodecKeys::Get(isolate);
+    Local<Object> object = value.As<Object>();
+    OverlayProperties &properties = *pProperties;
+
+    if (!DecodeFloat(object, keys.alpha(), name, Field_Alpha, &properties.fAlpha, &properties.unFields) ||
+        !DecodeFloat(object, keys.widthInMeters(), name, Field_WidthInMeters, &properties.fWidthInMeters, &properties.unFields) ||
+        !DecodeFloat(object, keys.curvature(), name, Field_Curvature, &properties.fCurvature, &properties.unFields) ||
+        !DecodeFloat(object, keys.texelAspect(), name, Field_TexelAspect, &properties.fTexelAspect, &properties.unFields))
+    {
+        return false;
+    }
+
+    Local<Value> field;
+    if (GetKey(object, keys.color(), &field))
+    {
+        if (!field->IsObject())
+            return ThrowKeyError(name, keys.color(), "an object");
+        Local<Object> color = field.As<Object>();
+        Local<Value> red = Nan::Get(color, keys.Red()).ToLocalChecked();
+        Local<Value> green = Nan::Get(color, keys.Green()).ToLocalChecked();
+        Local<Value> blue = Nan::Get(color, keys.Blue()).ToLocalChecked();
+        if (!red->IsNumber() || !green->IsNumber() || !blue->IsNumber())
+            return ThrowKeyError(name, keys.color(), "an object of Red, Green and Blue numbers");
+        properties.fRed = static_cast<float>(red.As<Number>()->Value());
+        properties.fGreen = static_cast<float>(green.As<Number>()->Value());
+        properties.fBlue = static_cast<float>(blue.As<Number>()->Value());
+        properties.unFields |= Field_Color;
+    }
+
+    if (GetKey(object, keys.sortOrder(), &field))
+    {
+        if (!field->IsUint32())
+            return ThrowKeyError(name, keys.sortOrder(), "an unsigned integer");
+        properties.unSortOrder = field.As<Uint32>()->Value();
+        properties.unFields |= Field_SortOrder;
+    }
+
+    if (GetKey(object, keys.textureBounds(), &field))
+    {
+        if (!field->IsObject())
+            return ThrowKeyError(name, keys.textureBounds(), "a VRTextureBounds_t");
+        properties.textureBounds = decode<vr::VRTextureBounds_t>(field, isolate);
+        properties.unFields |= Field_TextureBounds;
+    }
+
+    if (GetKey(object, keys.transform(), &field))
+    {
+        if (!IsMatrix34(field))
+            return ThrowKeyError(name, keys.transform(), "an HmdMatrix34_t");
+        properties.transform = decode<vr::HmdMatrix34_t>(field, isolate);
+        properties.unFields |= Field_Transform;
+    }
+
+    if (GetKey(object, keys.trackingOrigin(), &field))
+    {
+        if (!field->IsUint32() || field.As<Uint32>()->Value() > vr::TrackingUniverseRawAndUncalibrated)
+            return ThrowKeyError(name, keys.trackingOrigin(), "an ETrackingUniverseOrigin");
+        properties.eTrackingOrigin = static_cast<vr::ETrackingUniverseOrigin>(field.As<Uint32>()->Value());
+    }
+
+    if (GetKey(object, keys.visible(), &field))
+    {
+        if (!field->IsBoolean())
+            return ThrowKeyError(name, keys.visible(), "a boolean");
+        properties.bVisible = field->BooleanValue(isolate);
+        properties.unFields |= Field_Visible;
+    }
+
+    return true;
+}
+
+vr::EVROverlayError OverlayProperties::Apply(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle) const
+{
+    // Fields that went through are mirrored even when a later one fails.
+    uint32_t unApplied = 0;
+    auto step = [&](EField eField, vr::EVROverlayError error) {
+        if (error == vr::VROverlayError_None)
+            unApplied |= eField;
+        return error == vr::VROverlayError_None;
+    };
+
+    vr::EVROverlayError error = vr::VROverlayError_None;
+    bool bOk = (!Has(Field_Alpha) || step(Field_Alpha, error = overlay->SetOverlayAlpha(ulOverlayHandle, fAlpha))) &&
+               (!Has(Field_Color) || step(Field_Color, error = overlay->SetOverlayColor(ulOverlayHandle, fRed, fGreen, fBlue))) &&
+               (!Has(Field_WidthInMeters) || step(Field_WidthInMeters, error = overlay->SetOverlayWidthInMeters(ulOverlayHandle, fWidthInMeters))) &&
+               (!Has(Field_Curvature) || step(Field_Curvature, error = overlay->SetOverlayCurvature(ulOverlayHandle, fCurvature))) &&
+               (!Has(Field_SortOrder) || step(Field_SortOrder, error = overlay->SetOverlaySortOrder(ulOverlayHandle, unSortOrder))) &&
+               (!Has(Field_TexelAspect) || step(Field_TexelAspect, error = overlay->SetOverlayTexelAspect(ulOverlayHandle, fTexelAspect))) &&
+               (!Has(Field_TextureBounds) || step(Field_TextureBounds, error = overlay->SetOverlayTextureBounds(ulOverlayHandle, &textureBounds))) &&
+               (!Has(Field_Transform) || step(Field_Transform, error = overlay->SetOverlayTransformAbsolute(ulOverlayHandle, eTrackingOrigin, &transform)));
+
+    // Shown last, so the overlay never appears with half its new properties.
+    if (bOk && Has(Field_Visible))
+        step(Field_Visible, error = bVisible ? overlay->ShowOverlay(ulOverlayHandle) : overlay->HideOverlay(ulOverlayHandle));
+
+    OverlayMirror::Record(ulOverlayHandle, *this, unApplied);
+    if (unApplied & Field_Transform)
+        OverlayTransformCache::Store(ulOverlayHandle, eTrackingOrigin, transform);
+    else if (Has(Field_Transform))
+        OverlayTransformCache::Forget(ulOverlayHandle);
+    return error;
+}
+
+OverlayProperties OverlayProperties::Interpolate(const OverlayProperties &a, const OverlayProperties &b, double t)
+{
+    OverlayProperties result = a;
+    const uint32_t unBlended = a.unFields & b.unFields & k_unAnimatableFields;
+    if (unBlended & Field_Alpha)
+        result.fAlpha = HmdMath::Lerp(a.fAlpha, b.fAlpha, t);
+    if (unBlended & Field_Color)
+    {
+        result.fRed = HmdMath::Lerp(a.fRed, b.fRed, t);
+        result.fGreen = HmdMath::Lerp(a.fGreen, b.fGreen, t);
+        result.fBlue = HmdMath::Lerp(a.fBlue, b.fBlue, t);
+    }
+    if (unBlended & Field_WidthInMeters)
+        result.fWidthInMeters = HmdMath::Lerp(a.fWidthInMeters, b.fWidthInMeters, t);
+    if (unBlended & Field_Curvature)
+        result.fCurvature = HmdMath::Lerp(a.fCurvature, b.fCurvature, t);
+    if (unBlended & Field_Transform)
+        result.transform = HmdMath::Interpolate(a.transform, b.transform, t);
+    return result;
+}
@@ -0,0 +1,66 @@
+#ifndef OVERLAYPROPERTIES_H_JS
+#define OVERLAYPROPERTIES_H_JS
+
+#include <nan.h>
+#include <openvr.h>
+#include <v8.h>
+
+#include <string>
+
+/// Any subset of an overlay's scalar properties, transform and visibility,
+/// decoded from a JS descriptor once and applied natively in one go:
+///
+///   { alpha, color: { Red, Green, Blue }, widthInMeters, curvature, sortOrder,
+///     texelAspect, textureBounds, transform, trackingOrigin, visible }
+///
+/// transform is an absolute HmdMatrix34_t, relative to trackingOrigin
+/// (standing unless given). Keys that are missing or undefined are left alone.
+struct OverlayProperties
+{
+    enum EField : uint32_t
+    {
+        Field_Alpha = 1 << 0,
+        Field_Color = 1 << 1,
+        Field_WidthInMeters = 1 << 2,
+        Field_Curvature = 1 << 3,
+        Field_SortOrder = 1 << 4,
+        Field_TexelAspect = 1 << 5,
+        Field_TextureBounds = 1 << 6,
+        Field_Transform = 1 << 7,
+        Field_Visible = 1 << 8,
+    };
+
+    /// Fields an OverlayAnimator tween may change.
+    static constexpr uint32_t k_unAnimatableFields = Field_Alpha | Field_Color | Field_WidthInMeters | Field_Curvature | Field_Transform;
+
+    uint32_t unFields = 0;
+
+    float fAlpha = 1.0f;
+    float fRed = 1.0f;
+    float fGreen = 1.0f;
+    float fBlue = 1.0f;
+    float fWidthInMeters = 1.0f;
+    float fCurvature = 0.0f;
+    uint32_t unSortOrder = 0;
+    float fTexelAspect = 1.0f;
+    vr::VRTextureBounds_t textureBounds = {0.0f, 0.0f, 1.0f, 1.0f};
+    vr::ETrackingUniverseOrigin eTrackingOrigin = vr::TrackingUniverseStanding;
+    vr::HmdMatrix34_t transform = {};
+    bool bVisible = false;
+
+    bool Has(EField eField) const { return (unFields & eField) != 0; }
+
+    /// Reads the keys present on value. On a malformed descriptor, throws a
+    /// TypeError naming the argument and key, and returns false.
+    static bool Decode(v8::Local<v8::Value> value, const std::string &name, OverlayProperties *pProperties);
+
+    /// Applies every field present, visibility last. Stops at the first
+    /// error and returns it.
+    vr::EVROverlayError Apply(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle) const;
+
+    /// Blends the animatable fields a and b both have, t from 0 (a) to 1 (b).
+    /// Everything else is taken from a.
+    static OverlayProperties Interpolate(const OverlayProperties &a, const OverlayProperties &b, double t);
+};
+
+#endif
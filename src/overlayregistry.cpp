@@ -0,0 +1,132 @@
+#include "overlayregistry.h"
+#include "overlayfingerprint.h"
+#include "overlaymirror.h"
+#include "overlaytransformcache.h"
+#include "overlayupload.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    struct Entry
+    {
+        const void *owner;
+        vr::VROverlayHandle_t ulThumbnailHandle;
+        std::string key;
+        std::string site;
+    };
+
+    struct SiteCounts
+    {
+        uint64_t created = 0;
+        uint32_t live = 0;
+    };
+
+    std::mutex g_mutex;
+    std::unordered_map<vr::VROverlayHandle_t, Entry> g_entries;
+    std::unordered_map<std::string, vr::VROverlayHandle_t> g_handlesByKey;
+    std::map<std::string, SiteCounts> g_sites;
+    uint64_t g_created = 0;
+    uint64_t g_destroyed = 0;
+    uint64_t g_reclaimed = 0;
+    uint64_t g_findHits = 0;
+
+    // Caller holds g_mutex.
+    void Erase(std::unordered_map<vr::VROverlayHandle_t, Entry>::iterator entry)
+    {
+        g_handlesByKey.erase(entry->second.key);
+        g_sites[entry->second.site].live--;
+
+        OverlayFingerprint::Forget(entry->first);
+        OverlayMirror::Forget(entry->first);
+        OverlayTransformCache::Forget(entry->first);
+        OverlayRawUpload::Forget(entry->first);
+        if (entry->second.ulThumbnailHandle != vr::k_ulOverlayHandleInvalid)
+            OverlayMirror::Forget(entry->second.ulThumbnailHandle);
+
+        g_entries.erase(entry);
+    }
+}
+
+namespace OverlayRegistry
+{
+    void Add(const void *owner, vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayHandle_t ulThumbnailHandle,
+             const std::string &key, const std::string &site)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto existing = g_entries.find(ulOverlayHandle);
+        if (existing != g_entries.end())
+            Erase(existing);
+
+        g_entries[ulOverlayHandle] = {owner, ulThumbnailHandle, key, site};
+        g_handlesByKey[key] = ulOverlayHandle;
+        SiteCounts &counts = g_sites[site];
+        counts.created++;
+        counts.live++;
+        g_created++;
+    }
+
+    void Remove(vr::VROverlayHandle_t ulOverlayHandle)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto entry = g_entries.find(ulOverlayHandle);
+        if (entry == g_entries.end())
+            return;
+
+        Erase(entry);
+        g_destroyed++;
+    }
+
+    bool Find(const std::string &key, vr::VROverlayHandle_t *pulOverlayHandle)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto handle = g_handlesByKey.find(key);
+        if (handle == g_handlesByKey.end())
+            return false;
+
+        *pulOverlayHandle = handle->second;
+        g_findHits++;
+        return true;
+    }
+
+    uint32_t DestroyOwned(const void *owner, vr::IVROverlay *overlay)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        uint32_t unDestroyed = 0;
+        for (auto entry = g_entries.begin(); entry != g_entries.end();)
+        {
+            auto next = std::next(entry);
+            if (owner == nullptr || entry->second.owner == owner)
+            {
+                if (overlay != nullptr)
+                    overlay->DestroyOverlay(entry->first);
+                Erase(entry);
+                unDestroyed++;
+            }
+            entry = next;
+        }
+
+        g_reclaimed += unDestroyed;
+        return unDestroyed;
+    }
+
+    Stats GetStats()
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        Stats stats;
+        stats.live = static_cast<uint32_t>(g_entries.size());
+        stats.created = g_created;
+        stats.destroyed = g_destroyed;
+        stats.reclaimed = g_reclaimed;
+        stats.findHits = g_findHits;
+        for (const auto &site : g_sites)
+            stats.sites.push_back({site.first, site.second.created, site.second.live});
+
+        // Most live overlays first: the likeliest leaks.
+        std::stable_sort(stats.sites.begin(), stats.sites.end(), [](const Site &a, const Site &b) { return a.live > b.live; });
+        return stats;
+    }
+}
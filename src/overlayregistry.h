@@ -0,0 +1,57 @@
+#ifndef OVERLAYREGISTRY_H_JS
+#define OVERLAYREGISTRY_H_JS
+
+#include <openvr.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Overlays created through this binding, each tied to the IVROverlay
+/// wrapper that created it. When the wrapper is garbage collected, or on
+/// VR_Shutdown, the overlays it still owns are destroyed, so a crashed or
+/// reloaded module cannot leave them composited by vrserver. Overlays
+/// reclaimed that way are counted as leaks, per JS creation site.
+///
+/// Keys map to handles here as well, so FindOverlay on a key this process
+/// created needs no IPC.
+///
+/// All functions are thread-safe.
+namespace OverlayRegistry
+{
+    struct Site
+    {
+        std::string location; // "file:line:column" of the JS caller
+        uint64_t created;
+        uint32_t live;
+    };
+
+    struct Stats
+    {
+        uint32_t live;
+        uint64_t created;
+        uint64_t destroyed; // by DestroyOverlay
+        uint64_t reclaimed; // by wrapper collection or VR_Shutdown
+        uint64_t findHits;
+        std::vector<Site> sites;
+    };
+
+    /// Records an overlay owned by owner. ulThumbnailHandle is the thumbnail
+    /// of a dashboard overlay, destroyed along with it, or invalid.
+    void Add(const void *owner, vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayHandle_t ulThumbnailHandle,
+             const std::string &key, const std::string &site);
+
+    /// Drops an overlay that was destroyed explicitly.
+    void Remove(vr::VROverlayHandle_t ulOverlayHandle);
+
+    bool Find(const std::string &key, vr::VROverlayHandle_t *pulOverlayHandle);
+
+    /// Destroys every overlay owner still has, or every overlay when owner is
+    /// null. Returns how many were destroyed. With a null overlay interface
+    /// the runtime is gone and the overlays are only forgotten.
+    uint32_t DestroyOwned(const void *owner, vr::IVROverlay *overlay);
+
+    Stats GetStats();
+}
+
+#endif
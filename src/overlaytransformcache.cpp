@@ -0,0 +1,43 @@
+#include "overlaytransformcache.h"
+
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    struct SentTransform
+    {
+        vr::ETrackingUniverseOrigin eTrackingOrigin;
+        vr::HmdMatrix34_t transform;
+    };
+
+    std::mutex g_mutex;
+    std::unordered_map<vr::VROverlayHandle_t, SentTransform> g_transforms;
+}
+
+namespace OverlayTransformCache
+{
+    bool Matches(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin, const vr::HmdMatrix34_t &transform)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto sent = g_transforms.find(ulOverlayHandle);
+        return sent != g_transforms.end() && sent->second.eTrackingOrigin == eTrackingOrigin &&
+               std::memcmp(&sent->second.transform, &transform, sizeof(vr::HmdMatrix34_t)) == 0;
+    }
+
+    void Store(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin, const vr::HmdMatrix34_t &transform)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_transforms[ulOverlayHandle] = {eTrackingOrigin, transform};
+    }
+
+    void Forget(vr::VROverlayHandle_t ulOverlayHandle)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (ulOverlayHandle == vr::k_ulOverlayHandleInvalid)
+            g_transforms.clear();
+        else
+            g_transforms.erase(ulOverlayHandle);
+    }
+}
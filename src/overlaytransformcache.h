@@ -0,0 +1,24 @@
+#ifndef OVERLAYTRANSFORMCACHE_H_JS
+#define OVERLAYTRANSFORMCACHE_H_JS
+
+#include <openvr.h>
+
+/// The absolute transform this process last sent to each overlay, so that
+/// SetOverlayTransformsAbsolute can skip overlays that would not move. Unlike
+/// the state mirror it is always on, and holds nothing but transforms.
+///
+/// Every other way of placing an overlay forgets its entry. All functions
+/// are thread-safe.
+namespace OverlayTransformCache
+{
+    /// True when the overlay was last sent exactly this transform and origin.
+    bool Matches(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin, const vr::HmdMatrix34_t &transform);
+
+    /// Records a transform the runtime accepted.
+    void Store(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin, const vr::HmdMatrix34_t &transform);
+
+    /// Forgets one overlay, or every overlay when given k_ulOverlayHandleInvalid.
+    void Forget(vr::VROverlayHandle_t ulOverlayHandle);
+}
+
+#endif
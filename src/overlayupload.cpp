@@ -0,0 +1,233 @@
+#include "overlayupload.h"
+#include "imagecache.h"
+#include "overlayfingerprint.h"
+#include "pixelconvert.h"
+
+#include <node.h>
+
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace v8;
+
+struct OverlayUploadState
+{
+    std::mutex mutex;
+    uint64_t unIssued = 0;   // guarded by g_statesMutex
+    uint32_t unInFlight = 0; // guarded by g_statesMutex
+    bool bForgotten = false; // guarded by g_statesMutex
+    uint64_t unUploaded = 0; // guarded by mutex
+};
+
+namespace
+{
+    std::mutex g_statesMutex;
+    std::unordered_map<vr::VROverlayHandle_t, std::shared_ptr<OverlayUploadState>> g_states;
+
+    // Held shared by every running upload and exclusively by CancelAll, which
+    // also moves the epoch on so uploads queued earlier never start.
+    std::shared_mutex g_runtimeMutex;
+    uint64_t g_epoch = 0;
+}
+
+OverlayRawUpload::OverlayRawUpload(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle, std::shared_ptr<BackingStore> backingStore, const uint8_t *pData,
+                                   uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel, uint32_t unConversion)
+    : Nan::AsyncWorker(nullptr, "openvr:SetOverlayRawAsync"), overlay_(overlay), overlayHandle_(ulOverlayHandle), backingStore_(std::move(backingStore)),
+      data_(pData), width_(unWidth), height_(unHeight), bytesPerPixel_(unBytesPerPixel), conversion_(unConversion)
+{
+}
+
+Local<Promise> OverlayRawUpload::Queue(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle,
+                                       Local<Value> buffer, std::shared_ptr<BackingStore> backingStore, uint8_t *pData,
+                                       uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel, uint32_t unConversion)
+{
+    Nan::EscapableHandleScope scope;
+    Local<Context> context = Nan::GetCurrentContext();
+    Local<Promise::Resolver> resolver = Promise::Resolver::New(context).ToLocalChecked();
+
+    OverlayRawUpload *worker = new OverlayRawUpload(overlay, ulOverlayHandle, std::move(backingStore), pData, unWidth, unHeight, unBytesPerPixel, unConversion);
+    worker->SaveToPersistent("buffer", buffer);
+    worker->SaveToPersistent("resolver", resolver);
+    worker->Start();
+    return scope.Escape(resolver->GetPromise());
+}
+
+Local<Promise> OverlayRawUpload::QueueFile(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle, const std::string &path)
+{
+    Nan::EscapableHandleScope scope;
+    Local<Context> context = Nan::GetCurrentContext();
+    Local<Promise::Resolver> resolver = Promise::Resolver::New(context).ToLocalChecked();
+
+    OverlayRawUpload *worker = new OverlayRawUpload(overlay, ulOverlayHandle, nullptr, nullptr, 0, 0, 0, PixelConvert::Conversion_None);
+    worker->path_ = path;
+    worker->SaveToPersistent("resolver", resolver);
+    worker->Start();
+    return scope.Escape(resolver->GetPromise());
+}
+
+void OverlayRawUpload::Start()
+{
+    {
+        std::lock_guard<std::mutex> lock(g_statesMutex);
+        std::shared_ptr<OverlayUploadState> &state = g_states[overlayHandle_];
+        if (!state)
+            state = std::make_shared<OverlayUploadState>();
+        state_ = state;
+        state->bForgotten = false;
+        state->unInFlight++;
+        ticket_ = ++state->unIssued;
+    }
+    {
+        std::shared_lock<std::shared_mutex> lock(g_runtimeMutex);
+        epoch_ = g_epoch;
+    }
+
+    Nan::AsyncQueueWorker(this);
+}
+
+void OverlayRawUpload::CancelAll()
+{
+    std::unique_lock<std::shared_mutex> lock(g_runtimeMutex);
+    ++g_epoch;
+
+    std::lock_guard<std::mutex> statesLock(g_statesMutex);
+    g_states.clear();
+}
+
+void OverlayRawUpload::Forget(vr::VROverlayHandle_t ulOverlayHandle)
+{
+    std::lock_guard<std::mutex> lock(g_statesMutex);
+    auto state = g_states.find(ulOverlayHandle);
+    if (state == g_states.end())
+        return;
+
+    // Uploads still running keep the ticket order until the last one
+    // settles, which erases the entry then.
+    if (state->second->unInFlight == 0)
+        g_states.erase(state);
+    else
+        state->second->bForgotten = true;
+}
+
+void OverlayRawUpload::Execute()
+{
+    // Decoding needs neither the runtime nor the overlay, so it happens
+    // before taking either lock.
+    std::shared_ptr<const ImageCache::Image> image;
+    if (!path_.empty())
+    {
+        image = ImageCache::Load(path_, &cached_);
+        if (image)
+        {
+            data_ = image->pixels.data();
+            width_ = image->unWidth;
+            height_ = image->unHeight;
+            bytesPerPixel_ = 4;
+        }
+    }
+
+    std::shared_lock<std::shared_mutex> runtimeLock(g_runtimeMutex);
+    if (epoch_ != g_epoch)
+    {
+        cancelled_ = true;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (ticket_ < state_->unUploaded)
+    {
+        skipped_ = true;
+        return;
+    }
+
+    const uint8_t *pData = data_;
+    uint32_t unBytesPerPixel = bytesPerPixel_;
+    std::vector<uint8_t> converted;
+    if (conversion_ != PixelConvert::Conversion_None)
+    {
+        const size_t unPixels = static_cast<size_t>(width_) * height_;
+        unBytesPerPixel = PixelConvert::TargetBytesPerPixel(conversion_);
+        converted.resize(unPixels * unBytesPerPixel);
+        PixelConvert::Convert(conversion_, data_, converted.data(), unPixels);
+        pData = converted.data();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!path_.empty() && !image)
+    {
+        OverlayFingerprint::Forget(overlayHandle_);
+        error_ = overlay_->SetOverlayFromFile(overlayHandle_, path_.c_str());
+    }
+    else
+    {
+        error_ = OverlayFingerprint::UploadRaw(overlay_, overlayHandle_, pData, width_, height_, unBytesPerPixel, &skipped_);
+    }
+    uploadMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (error_ == vr::VROverlayError_None)
+        state_->unUploaded = ticket_;
+    else
+        errorName_ = overlay_->GetOverlayErrorNameFromEnum(error_); // the callback may run after VR_Shutdown
+}
+
+void OverlayRawUpload::HandleOKCallback()
+{
+    Nan::HandleScope scope;
+
+    if (cancelled_)
+    {
+        Settle(false, Nan::Error("VR_Shutdown was called before the upload ran."));
+        return;
+    }
+
+    if (error_ != vr::VROverlayError_None)
+    {
+        // Same message as the synchronous SetOverlayRaw, plus the error code.
+        Local<Value> error = Nan::Error(errorName_.c_str());
+        Nan::Set(error.As<Object>(), Nan::New("overlayError").ToLocalChecked(), Nan::New<Number>(error_));
+        Settle(false, error);
+        return;
+    }
+
+    Local<Object> result = Nan::New<Object>();
+    Nan::Set(result, Nan::New("uploadMs").ToLocalChecked(), Nan::New<Number>(uploadMs_));
+    Nan::Set(result, Nan::New("skipped").ToLocalChecked(), Nan::New<Boolean>(skipped_));
+    if (!path_.empty())
+        Nan::Set(result, Nan::New("cached").ToLocalChecked(), Nan::New<Boolean>(cached_));
+    Settle(true, result);
+}
+
+void OverlayRawUpload::HandleErrorCallback()
+{
+    Nan::HandleScope scope;
+    Settle(false, Nan::Error(ErrorMessage()));
+}
+
+void OverlayRawUpload::Settle(bool bResolve, Local<Value> value)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_statesMutex);
+        if (--state_->unInFlight == 0 && state_->bForgotten)
+        {
+            // CancelAll may have dropped the entry, or a later upload
+            // replaced it, so only erase the one this upload counted on.
+            auto state = g_states.find(overlayHandle_);
+            if (state != g_states.end() && state->second == state_)
+                g_states.erase(state);
+        }
+    }
+
+    Local<Context> context = Nan::GetCurrentContext();
+    Local<Promise::Resolver> resolver = GetFromPersistent("resolver").As<Promise::Resolver>();
+
+    // Runs the microtasks the settlement queues when the scope closes, as
+    // returning from a callback would.
+    node::CallbackScope callbackScope(context->GetIsolate(), Nan::New(persistentHandle), {0, 0});
+    if (bResolve)
+        resolver->Resolve(context, value).FromJust();
+    else
+        resolver->Reject(context, value).FromJust();
+}
@@ -0,0 +1,84 @@
+#ifndef OVERLAYUPLOAD_H_JS
+#define OVERLAYUPLOAD_H_JS
+
+#include <nan.h>
+#include <openvr.h>
+#include <v8.h>
+
+#include <memory>
+#include <string>
+
+struct OverlayUploadState;
+
+/// SetOverlayRaw run on the libuv thread pool, settling a Promise when done.
+///
+/// The pixel memory is pinned for the whole upload: the worker holds the
+/// buffer object and a reference to its backing store, so neither garbage
+/// collection nor detaching the buffer can free it underneath the runtime.
+///
+/// Uploads to one overlay run one at a time. An upload that starts after a
+/// newer upload to the same overlay already finished is skipped, so a slow
+/// thread pool never puts an old frame back on screen.
+///
+/// Unchanged frames are skipped as in SetOverlayRaw; see OverlayFingerprint.
+/// A pixel conversion, if any, also runs on the worker, as does decoding for
+/// file uploads.
+class OverlayRawUpload : public Nan::AsyncWorker
+{
+public:
+    /// Queues the upload and returns its Promise. pData must point into
+    /// backingStore and hold unWidth * unHeight * unBytesPerPixel bytes, and
+    /// unConversion must have passed PixelConvert::Validate.
+    static v8::Local<v8::Promise> Queue(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle,
+                                        v8::Local<v8::Value> buffer, std::shared_ptr<v8::BackingStore> backingStore, uint8_t *pData,
+                                        uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel, uint32_t unConversion);
+
+    /// Queues an upload of the image file at path, decoded through
+    /// ImageCache. Files it cannot decode go to SetOverlayFromFile instead.
+    static v8::Local<v8::Promise> QueueFile(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle, const std::string &path);
+
+    /// Waits for running uploads and makes queued ones reject instead of
+    /// touching the runtime. Called before the runtime is shut down.
+    static void CancelAll();
+
+    /// Drops the upload order kept for a destroyed overlay, once no upload
+    /// to it is still in flight.
+    static void Forget(vr::VROverlayHandle_t ulOverlayHandle);
+
+    void Execute() override;
+
+protected:
+    void HandleOKCallback() override;
+    void HandleErrorCallback() override;
+
+private:
+    OverlayRawUpload(vr::IVROverlay *overlay, vr::VROverlayHandle_t ulOverlayHandle, std::shared_ptr<v8::BackingStore> backingStore, const uint8_t *pData,
+                     uint32_t unWidth, uint32_t unHeight, uint32_t unBytesPerPixel, uint32_t unConversion);
+
+    // Takes the next ticket for the overlay and queues the worker.
+    void Start();
+    void Settle(bool bResolve, v8::Local<v8::Value> value);
+
+    vr::IVROverlay *const overlay_;
+    const vr::VROverlayHandle_t overlayHandle_;
+    const std::shared_ptr<v8::BackingStore> backingStore_;
+    const uint8_t *data_;
+    uint32_t width_;
+    uint32_t height_;
+    uint32_t bytesPerPixel_;
+    const uint32_t conversion_;
+    std::string path_; // set for file uploads, which fill in the fields above in Execute
+
+    std::shared_ptr<OverlayUploadState> state_;
+    uint64_t ticket_ = 0;
+    uint64_t epoch_ = 0;
+
+    vr::EVROverlayError error_ = vr::VROverlayError_None;
+    std::string errorName_;
+    bool cancelled_ = false;
+    bool skipped_ = false;
+    bool cached_ = false;
+    double uploadMs_ = 0.0;
+};
+
+#endif
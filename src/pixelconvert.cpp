@@ -0,0 +1,379 @@
+#include "pixelconvert.h"
+#include "cpufeatures.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Pixels per chunk: 16 KiB of RGBA, small enough to stay in L1 between stages.
+    constexpr size_t k_unChunkPixels = 4096;
+
+    // round(c * a / 255) for c, a in [0, 255], without a division.
+    inline uint8_t MultiplyByAlpha(uint32_t unColor, uint32_t unAlpha)
+    {
+        const uint32_t t = unColor * unAlpha + 128;
+        return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+    }
+
+    struct Tables
+    {
+        // ceil((255 << 24) / a), so that (c * r + 2^23) >> 24 == round(c * 255 / a).
+        std::array<uint64_t, 256> unpremultiply;
+        std::array<uint8_t, 256> srgbToLinear;
+        std::array<uint8_t, 256> linearToSrgb;
+
+        Tables()
+        {
+            unpremultiply[0] = 0;
+            for (uint32_t a = 1; a < 256; ++a)
+                unpremultiply[a] = ((255ull << 24) + a - 1) / a;
+
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                const double v = i / 255.0;
+                const double linear = v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4);
+                const double srgb = v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055;
+                srgbToLinear[i] = static_cast<uint8_t>(std::lround(linear * 255.0));
+                linearToSrgb[i] = static_cast<uint8_t>(std::lround(srgb * 255.0));
+            }
+        }
+    };
+
+    const Tables &GetTables()
+    {
+        static const Tables tables;
+        return tables;
+    }
+
+    //=========================================================
+    // Scalar kernels. These also finish the tails the SIMD kernels leave.
+
+    void SwapRedBlueScalar(const uint8_t *pSource, uint8_t *pTarget, size_t unPixels)
+    {
+        for (size_t i = 0; i < unPixels; ++i)
+        {
+            const uint8_t r = pSource[i * 4 + 0];
+            const uint8_t b = pSource[i * 4 + 2];
+            pTarget[i * 4 + 0] = b;
+            pTarget[i * 4 + 1] = pSource[i * 4 + 1];
+            pTarget[i * 4 + 2] = r;
+            pTarget[i * 4 + 3] = pSource[i * 4 + 3];
+        }
+    }
+
+    void RgbToRgbaScalar(const uint8_t *pSource, uint8_t *pTarget, size_t unPixels, bool bSwapRedBlue)
+    {
+        const int nRed = bSwapRedBlue ? 2 : 0;
+        for (size_t i = 0; i < unPixels; ++i)
+        {
+            pTarget[i * 4 + 0] = pSource[i * 3 + nRed];
+            pTarget[i * 4 + 1] = pSource[i * 3 + 1];
+            pTarget[i * 4 + 2] = pSource[i * 3 + 2 - nRed];
+            pTarget[i * 4 + 3] = 255;
+        }
+    }
+
+    void PremultiplyScalar(uint8_t *pPixels, size_t unPixels)
+    {
+        for (size_t i = 0; i < unPixels; ++i)
+        {
+            uint8_t *p = pPixels + i * 4;
+            p[0] = MultiplyByAlpha(p[0], p[3]);
+            p[1] = MultiplyByAlpha(p[1], p[3]);
+            p[2] = MultiplyByAlpha(p[2], p[3]);
+        }
+    }
+
+    void Unpremultiply(uint8_t *pPixels, size_t unPixels)
+    {
+        const std::array<uint64_t, 256> &reciprocals = GetTables().unpremultiply;
+        for (size_t i = 0; i < unPixels; ++i)
+        {
+            uint8_t *p = pPixels + i * 4;
+            const uint64_t r = reciprocals[p[3]];
+            for (int c = 0; c < 3; ++c)
+                p[c] = static_cast<uint8_t>(std::min<uint64_t>(255, (p[c] * r + (1ull << 23)) >> 24));
+        }
+    }
+
+    void ApplyTransfer(uint8_t *pPixels, size_t unPixels, const std::array<uint8_t, 256> &table)
+    {
+        for (size_t i = 0; i < unPixels; ++i)
+        {
+            uint8_t *p = pPixels + i * 4;
+            p[0] = table[p[0]];
+            p[1] = table[p[1]];
+            p[2] = table[p[2]];
+        }
+    }
+
+    //=========================================================
+    // SIMD kernels. Each handles as many whole vectors as it can and returns
+    // how many pixels that was.
+
+#if defined(CPUFEATURES_X86)
+    CPUFEATURES_TARGET("ssse3")
+    size_t SwapRedBlueSsse3(const uint8_t *pSource, uint8_t *pTarget, size_t unPixels)
+    {
+        const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+        size_t i = 0;
+        for (; i + 4 <= unPixels; i += 4)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget + i * 4), _mm_shuffle_epi8(v, mask));
+        }
+        return i;
+    }
+
+    CPUFEATURES_TARGET("ssse3")
+    size_t RgbToRgbaSsse3(const uint8_t *pSource, uint8_t *pTarget, size_t unPixels, bool bSwapRedBlue)
+    {
+        const __m128i mask = bSwapRedBlue ? _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+                                          : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        size_t i = 0;
+        // Each load reads 16 bytes but uses 12, so stop while 16 are still in bounds.
+        for (; i + 6 <= unPixels; i += 4)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource + i * 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha));
+        }
+        return i;
+    }
+
+    CPUFEATURES_TARGET("ssse3")
+    inline __m128i PremultiplyHalf(__m128i pixels, __m128i alphaLane, __m128i bias)
+    {
+        // Broadcast each pixel's alpha over its four 16-bit lanes, with 255 in
+        // the alpha lane itself so alpha comes out unchanged.
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0xFF), 0xFF);
+        alpha = _mm_or_si128(_mm_andnot_si128(alphaLane, alpha), _mm_and_si128(alphaLane, _mm_set1_epi16(255)));
+        __m128i t = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), bias);
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+
+    CPUFEATURES_TARGET("ssse3")
+    size_t PremultiplySsse3(uint8_t *pPixels, size_t unPixels)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i alphaLane = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+        const __m128i bias = _mm_set1_epi16(128);
+        size_t i = 0;
+        for (; i + 4 <= unPixels; i += 4)
+        {
+            __m128i *p = reinterpret_cast<__m128i *>(pPixels + i * 4);
+            const __m128i v = _mm_loadu_si128(p);
+            const __m128i lo = PremultiplyHalf(_mm_unpacklo_epi8(v, zero), alphaLane, bias);
+            const __m128i hi = PremultiplyHalf(_mm_unpackhi_epi8(v, zero), alphaLane, bias);
+            _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+        }
+        return i;
+    }
+
+    CPUFEATURES_TARGET("avx2")
+    size_t SwapRedBlueAvx2(const uint8_t *pSource, uint8_t *pTarget, size_t unPixels)
+    {
+        const __m256i mask = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                              2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+        size_t i = 0;
+        for (; i + 8 <= unPixels; i += 8)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pSource + i * 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(pTarget + i * 4), _mm256_shuffle_epi8(v, mask));
+        }
+        return i;
+    }
+
+    CPUFEATURES_TARGET("avx2")
+    inline __m256i PremultiplyHalf(__m256i pixels, __m256i alphaLane, __m256i bias)
+    {
+        __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, 0xFF), 0xFF);
+        alpha = _mm256_blendv_epi8(alpha, _mm256_set1_epi16(255), alphaLane);
+        __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(pixels, alpha), bias);
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+
+    CPUFEATURES_TARGET("avx2")
+    size_t PremultiplyAvx2(uint8_t *pPixels, size_t unPixels)
+    {
+        // Unpacking and packing both work within 128-bit lanes, so pixel order
+        // survives the round trip.
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i alphaLane = _mm256_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1);
+        const __m256i bias = _mm256_set1_epi16(128);
+        size_t i = 0;
+        for (; i + 8 <= unPixels; i += 8)
+        {
+            __m256i *p = reinterpret_cast<__m256i *>(pPixels + i * 4);
+            const __m256i v = _mm256_loadu_si256(p);
+            const __m256i lo = PremultiplyHalf(_mm256_unpacklo_epi8(v, zero), alphaLane, bias);
+            const __m256i hi = PremultiplyHalf(_mm256_unpackhi_epi8(v, zero), alphaLane, bias);
+            _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+        }
+        return i;
+    }
+#elif defined(CPUFEATURES_NEON)
+    size_t SwapRedBlueNeon(const uint8_t *pSource, uint8_t *pTarget, size_t unPixels)
+    {
+        size_t i = 0;
+        for (; i + 16 <= unPixels; i += 16)
+        {
+            uint8x16x4_t v = vld4q_u8(pSource + i * 4);
+            std::swap(v.val[0], v.val[2]);
+            vst4q_u8(pTarget + i * 4, v);
+        }
+        return i;
+    }
+
+    size_t RgbToRgbaNeon(const uint8_t *pSource, uint8_t *pTarget, size_t unPixels, bool bSwapRedBlue)
+    {
+        size_t i = 0;
+        for (; i + 16 <= unPixels; i += 16)
+        {
+            const uint8x16x3_t rgb = vld3q_u8(pSource + i * 3);
+            uint8x16x4_t rgba;
+            rgba.val[0] = bSwapRedBlue ? rgb.val[2] : rgb.val[0];
+            rgba.val[1] = rgb.val[1];
+            rgba.val[2] = bSwapRedBlue ? rgb.val[0] : rgb.val[2];
+            rgba.val[3] = vdupq_n_u8(255);
+            vst4q_u8(pTarget + i * 4, rgba);
+        }
+        return i;
+    }
+
+    inline uint8x8_t MultiplyByAlphaNeon(uint8x8_t color, uint8x8_t alpha)
+    {
+        // (t + ((t + 128) >> 8) + 128) >> 8, the same rounding as MultiplyByAlpha.
+        const uint16x8_t t = vmull_u8(color, alpha);
+        return vrshrn_n_u16(vrsraq_n_u16(t, t, 8), 8);
+    }
+
+    size_t PremultiplyNeon(uint8_t *pPixels, size_t unPixels)
+    {
+        size_t i = 0;
+        for (; i + 8 <= unPixels; i += 8)
+        {
+            uint8x8x4_t v = vld4_u8(pPixels + i * 4);
+            v.val[0] = MultiplyByAlphaNeon(v.val[0], v.val[3]);
+            v.val[1] = MultiplyByAlphaNeon(v.val[1], v.val[3]);
+            v.val[2] = MultiplyByAlphaNeon(v.val[2], v.val[3]);
+            vst4_u8(pPixels + i * 4, v);
+        }
+        return i;
+    }
+#endif
+
+    //=========================================================
+    struct Kernels
+    {
+        const char *pchName;
+        size_t (*pfnSwapRedBlue)(const uint8_t *, uint8_t *, size_t);
+        size_t (*pfnRgbToRgba)(const uint8_t *, uint8_t *, size_t, bool);
+        size_t (*pfnPremultiply)(uint8_t *, size_t);
+    };
+
+    size_t SwapRedBlueNone(const uint8_t *, uint8_t *, size_t) { return 0; }
+    size_t RgbToRgbaNone(const uint8_t *, uint8_t *, size_t, bool) { return 0; }
+    size_t PremultiplyNone(uint8_t *, size_t) { return 0; }
+
+    Kernels SelectKernels()
+    {
+#if defined(CPUFEATURES_X86)
+        if (CpuFeatures::HasAvx2())
+            return {"avx2", SwapRedBlueAvx2, RgbToRgbaSsse3, PremultiplyAvx2};
+        if (CpuFeatures::HasSsse3())
+            return {"ssse3", SwapRedBlueSsse3, RgbToRgbaSsse3, PremultiplySsse3};
+#elif defined(CPUFEATURES_NEON)
+        return {"neon", SwapRedBlueNeon, RgbToRgbaNeon, PremultiplyNeon};
+#endif
+        return {"scalar", SwapRedBlueNone, RgbToRgbaNone, PremultiplyNone};
+    }
+
+    const Kernels &GetKernels()
+    {
+        static const Kernels kernels = SelectKernels();
+        return kernels;
+    }
+
+    void ConvertChunk(uint32_t unConversion, const uint8_t *pSource, uint8_t *pTarget, size_t unPixels)
+    {
+        const Kernels &kernels = GetKernels();
+
+        if (unConversion & PixelConvert::Conversion_RgbToRgba)
+        {
+            const bool bSwap = (unConversion & PixelConvert::Conversion_SwapRedBlue) != 0;
+            const size_t unDone = kernels.pfnRgbToRgba(pSource, pTarget, unPixels, bSwap);
+            RgbToRgbaScalar(pSource + unDone * 3, pTarget + unDone * 4, unPixels - unDone, bSwap);
+        }
+        else if (unConversion & PixelConvert::Conversion_SwapRedBlue)
+        {
+            const size_t unDone = kernels.pfnSwapRedBlue(pSource, pTarget, unPixels);
+            SwapRedBlueScalar(pSource + unDone * 4, pTarget + unDone * 4, unPixels - unDone);
+        }
+        else if (pSource != pTarget)
+        {
+            std::memcpy(pTarget, pSource, unPixels * 4);
+        }
+
+        if (unConversion & PixelConvert::Conversion_Unpremultiply)
+            Unpremultiply(pTarget, unPixels);
+
+        if (unConversion & PixelConvert::Conversion_SrgbToLinear)
+            ApplyTransfer(pTarget, unPixels, GetTables().srgbToLinear);
+        else if (unConversion & PixelConvert::Conversion_LinearToSrgb)
+            ApplyTransfer(pTarget, unPixels, GetTables().linearToSrgb);
+
+        if (unConversion & PixelConvert::Conversion_Premultiply)
+        {
+            const size_t unDone = kernels.pfnPremultiply(pTarget, unPixels);
+            PremultiplyScalar(pTarget + unDone * 4, unPixels - unDone);
+        }
+    }
+}
+
+namespace PixelConvert
+{
+    const char *Validate(uint32_t unConversion, uint32_t unBytesPerPixel)
+    {
+        if (unConversion & ~static_cast<uint32_t>(Conversion_All))
+            return "Unknown pixel conversion flags.";
+        if ((unConversion & Conversion_Premultiply) && (unConversion & Conversion_Unpremultiply))
+            return "Premultiply and Unpremultiply cannot be combined.";
+        if ((unConversion & Conversion_SrgbToLinear) && (unConversion & Conversion_LinearToSrgb))
+            return "SrgbToLinear and LinearToSrgb cannot be combined.";
+        if (unConversion != Conversion_None && unBytesPerPixel != SourceBytesPerPixel(unConversion))
+        {
+            return (unConversion & Conversion_RgbToRgba) ? "RgbToRgba needs 3 bytes per pixel."
+                                                         : "Pixel conversions need 4 bytes per pixel.";
+        }
+        return nullptr;
+    }
+
+    uint32_t SourceBytesPerPixel(uint32_t unConversion)
+    {
+        return (unConversion & Conversion_RgbToRgba) ? 3 : 4;
+    }
+
+    uint32_t TargetBytesPerPixel(uint32_t)
+    {
+        return 4;
+    }
+
+    void Convert(uint32_t unConversion, const uint8_t *pSource, uint8_t *pTarget, size_t unPixels)
+    {
+        const uint32_t unSourceBytesPerPixel = SourceBytesPerPixel(unConversion);
+        for (size_t i = 0; i < unPixels; i += k_unChunkPixels)
+        {
+            const size_t unChunk = std::min(k_unChunkPixels, unPixels - i);
+            ConvertChunk(unConversion, pSource + i * unSourceBytesPerPixel, pTarget + i * 4, unChunk);
+        }
+    }
+
+    const char *InstructionSet()
+    {
+        return GetKernels().pchName;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef PIXELCONVERT_H_JS
+#define PIXELCONVERT_H_JS
+
+#include <cstddef>
+#include <cstdint>
+
+/// Pixel format conversions for raw overlay uploads. SetOverlayRaw wants RGBA
+/// with straight alpha (or 1 or 3 bytes per pixel), while canvases usually
+/// hand out BGRA, premultiplied alpha or packed RGB.
+///
+/// Conversions are flags and combine in a fixed order: channel layout first,
+/// then Unpremultiply, then the transfer function, then Premultiply. The
+/// stages run over small chunks so a pixel stays in cache between them.
+///
+/// Layout changes and Premultiply have SSSE3 and AVX2 versions picked at
+/// runtime on x86, and NEON versions on ARM64; everything has a scalar
+/// version. Unpremultiply and the transfer functions are table lookups.
+namespace PixelConvert
+{
+    enum EConversion : uint32_t
+    {
+        Conversion_None = 0,
+        Conversion_SwapRedBlue = 1 << 0,  // BGRA <-> RGBA, or BGR -> RGBA with RgbToRgba
+        Conversion_RgbToRgba = 1 << 1,    // 3 bytes per pixel in, opaque alpha added
+        Conversion_Premultiply = 1 << 2,
+        Conversion_Unpremultiply = 1 << 3,
+        Conversion_SrgbToLinear = 1 << 4, // color channels only
+        Conversion_LinearToSrgb = 1 << 5,
+        Conversion_All = (1 << 6) - 1,
+    };
+
+    /// Why unConversion cannot apply to pixels of unBytesPerPixel, or null when it can.
+    const char *Validate(uint32_t unConversion, uint32_t unBytesPerPixel);
+
+    uint32_t SourceBytesPerPixel(uint32_t unConversion);
+
+    uint32_t TargetBytesPerPixel(uint32_t unConversion);
+
+    /// Converts unPixels pixels. pTarget may be pSource, except with RgbToRgba.
+    void Convert(uint32_t unConversion, const uint8_t *pSource, uint8_t *pTarget, size_t unPixels);
+
+    /// "avx2", "ssse3", "neon" or "scalar".
+    const char *InstructionSet();
+}
+
+#endif
@@ -0,0 +1,533 @@
+#include "posesampler.h"
+#include "hmdmath.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <set>
+
+using namespace v8;
+
+namespace
+{
+    constexpr double k_fMinRateHz = 1.0;
+    constexpr double k_fMaxRateHz = 2000.0;
+    constexpr uint32_t k_unDefaultCapacity = 1024;
+    constexpr uint32_t k_unMaxCapacity = 1 << 16;
+    constexpr int k_nReadAttempts = 4;
+
+    // Snapshot buffer layout, mirrored by tssrc/posesnapshot.ts.
+    constexpr size_t k_unSnapshotSequenceOffset = 0;    // uint32, odd while a write is in progress, 0 until the first
+    constexpr size_t k_unSnapshotDeviceCountOffset = 4; // uint32
+    constexpr size_t k_unSnapshotTimeOffset = 8;        // float64, PoseSampler.Now() clock
+    constexpr size_t k_unSnapshotIndexOffset = 16;      // float64, sample index
+    constexpr size_t k_unSnapshotPosesOffset = 24;
+    constexpr size_t k_unSnapshotStatesOffset =
+        k_unSnapshotPosesOffset + vr::k_unMaxTrackedDeviceCount * k_unTrackedDevicePoseFloatStride * sizeof(float);
+    constexpr size_t k_unSnapshotSize =
+        k_unSnapshotStatesOffset + vr::k_unMaxTrackedDeviceCount * k_unTrackedDevicePoseStateStride;
+
+    // JS reads the sequence with Atomics.load on a Uint32Array view.
+    using SnapshotSequence = std::atomic<uint32_t>;
+    static_assert(sizeof(SnapshotSequence) == sizeof(uint32_t), "snapshot sequence must be a plain uint32");
+
+    std::mutex g_samplersMutex;
+    std::set<PoseSampler *> g_samplers;
+
+    vr::TrackedDevicePose_t Interpolate(const vr::TrackedDevicePose_t &a, const vr::TrackedDevicePose_t &b, double t)
+    {
+        vr::TrackedDevicePose_t result = t < 0.5 ? a : b;
+        result.bPoseIsValid = a.bPoseIsValid && b.bPoseIsValid;
+
+        HmdMath::SetRotation(result.mDeviceToAbsoluteTracking,
+                             HmdMath::Slerp(HmdMath::ToQuaternion(a.mDeviceToAbsoluteTracking), HmdMath::ToQuaternion(b.mDeviceToAbsoluteTracking), t));
+        for (int row = 0; row < 3; ++row)
+        {
+            result.mDeviceToAbsoluteTracking.m[row][3] =
+                HmdMath::Lerp(a.mDeviceToAbsoluteTracking.m[row][3], b.mDeviceToAbsoluteTracking.m[row][3], t);
+            result.vVelocity.v[row] = HmdMath::Lerp(a.vVelocity.v[row], b.vVelocity.v[row], t);
+            result.vAngularVelocity.v[row] = HmdMath::Lerp(a.vAngularVelocity.v[row], b.vAngularVelocity.v[row], t);
+        }
+        return result;
+    }
+}
+
+Nan::Persistent<Function> PoseSampler::constructor;
+
+void PoseSampler::Init(Local<Object> exports)
+{
+    Local<Context> context = exports->CreationContext();
+    Nan::HandleScope scope;
+
+    Local<FunctionTemplate> tpl = Nan::New<FunctionTemplate>(New);
+    tpl->SetClassName(Nan::New("PoseSampler").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    Nan::SetPrototypeMethod(tpl, "Start", Start);
+    Nan::SetPrototypeMethod(tpl, "Stop", Stop);
+    Nan::SetPrototypeMethod(tpl, "IsRunning", IsRunning);
+    Nan::SetPrototypeMethod(tpl, "Now", Now);
+    Nan::SetPrototypeMethod(tpl, "GetSampleCount", GetSampleCount);
+    Nan::SetPrototypeMethod(tpl, "GetPoseAtTime", GetPoseAtTime);
+    Nan::SetPrototypeMethod(tpl, "GetRecentSamples", GetRecentSamples);
+    Nan::SetPrototypeMethod(tpl, "GetSnapshotBuffer", GetSnapshotBuffer);
+
+    constructor.Reset(tpl->GetFunction(context).ToLocalChecked());
+    exports->Set(
+               context,
+               Nan::New("PoseSampler").ToLocalChecked(),
+               tpl->GetFunction(context).ToLocalChecked())
+        .FromJust();
+}
+
+void PoseSampler::StopAll()
+{
+    std::lock_guard<std::mutex> lock(g_samplersMutex);
+    for (PoseSampler *sampler : g_samplers)
+        sampler->Stop();
+}
+
+double PoseSampler::Now()
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+PoseSampler::PoseSampler(vr::ETrackingUniverseOrigin eOrigin, double fRateHz, uint32_t unCapacity)
+    : origin_(eOrigin), period_(1.0 / fRateHz), capacity_(unCapacity), samples_(new Sample[unCapacity])
+{
+    Nan::AdjustExternalMemory(static_cast<int>(sizeof(Sample) * capacity_));
+
+    std::lock_guard<std::mutex> lock(g_samplersMutex);
+    g_samplers.insert(this);
+}
+
+PoseSampler::~PoseSampler()
+{
+    {
+        std::lock_guard<std::mutex> lock(g_samplersMutex);
+        g_samplers.erase(this);
+    }
+
+    Stop();
+    Nan::AdjustExternalMemory(-static_cast<int>(sizeof(Sample) * capacity_));
+}
+
+void PoseSampler::Start(vr::IVRSystem *system)
+{
+    if (running_.exchange(true))
+        return;
+
+    // The interface of the current VR_Init session; a restart after
+    // VR_Shutdown and VR_Init must not sample through the old one.
+    thread_ = std::thread(&PoseSampler::Run, this, system);
+}
+
+void PoseSampler::Stop()
+{
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void PoseSampler::Run(vr::IVRSystem *system)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(period_));
+    std::array<vr::TrackedDevicePose_t, vr::k_unMaxTrackedDeviceCount> poses;
+
+    auto next = Clock::now();
+    while (running_.load(std::memory_order_relaxed))
+    {
+        const double before = Now();
+        system->GetDeviceToAbsoluteTrackingPose(origin_, 0.0f, poses.data(), static_cast<uint32_t>(poses.size()));
+        const double after = Now();
+        Write(0.5 * (before + after), poses.data());
+
+        // Skip ticks we have already missed instead of bursting to catch up.
+        next += period;
+        const auto now = Clock::now();
+        if (next < now)
+            next = now;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void PoseSampler::Write(double time, const vr::TrackedDevicePose_t *pPoses)
+{
+    const uint64_t index = written_.load(std::memory_order_relaxed);
+    Sample &slot = samples_[index % capacity_];
+
+    const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.index = index;
+    slot.time = time;
+    std::memcpy(slot.poses.data(), pPoses, sizeof(slot.poses));
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    written_.store(index + 1, std::memory_order_release);
+
+    Publish(index, time, pPoses);
+}
+
+void PoseSampler::Publish(uint64_t index, double time, const vr::TrackedDevicePose_t *pPoses)
+{
+    uint8_t *snapshot = snapshot_.load(std::memory_order_acquire);
+    if (!snapshot)
+        return;
+
+    SnapshotSequence *sequence = reinterpret_cast<SnapshotSequence *>(snapshot + k_unSnapshotSequenceOffset);
+    // Wraps after 2^32 writes, skipping 0, which means nothing was published yet.
+    const uint32_t value = sequence->load(std::memory_order_relaxed);
+    const uint32_t next = value + 2 != 0 ? value + 2 : 2;
+    sequence->store(value + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const double sampleIndex = static_cast<double>(index);
+    std::memcpy(snapshot + k_unSnapshotTimeOffset, &time, sizeof(time));
+    std::memcpy(snapshot + k_unSnapshotIndexOffset, &sampleIndex, sizeof(sampleIndex));
+
+    float *pfPoses = reinterpret_cast<float *>(snapshot + k_unSnapshotPosesOffset);
+    uint8_t *punStates = snapshot + k_unSnapshotStatesOffset;
+    for (uint32_t unDevice = 0; unDevice < vr::k_unMaxTrackedDeviceCount; ++unDevice)
+    {
+        encode(pPoses[unDevice],
+               pfPoses + unDevice * k_unTrackedDevicePoseFloatStride,
+               punStates + unDevice * k_unTrackedDevicePoseStateStride);
+    }
+
+    sequence->store(next, std::memory_order_release);
+}
+
+bool PoseSampler::Read(uint64_t index, vr::TrackedDeviceIndex_t unDeviceIndex, double *pTime, vr::TrackedDevicePose_t *pPose) const
+{
+    const Sample &slot = samples_[index % capacity_];
+    for (int attempt = 0; attempt < k_nReadAttempts; ++attempt)
+    {
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence & 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const uint64_t slotIndex = slot.index;
+        const double time = slot.time;
+        if (pPose)
+            *pPose = slot.poses[unDeviceIndex];
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+            continue;
+
+        // The slot has already been reused for a newer sample.
+        if (slotIndex != index)
+            return false;
+
+        *pTime = time;
+        return true;
+    }
+    return false;
+}
+
+bool PoseSampler::ReadTime(uint64_t index, double *pTime) const
+{
+    return Read(index, 0, pTime, nullptr);
+}
+
+bool PoseSampler::PoseAtTime(vr::TrackedDeviceIndex_t unDeviceIndex, double time, vr::TrackedDevicePose_t *pPose) const
+{
+    const uint64_t written = written_.load(std::memory_order_acquire);
+    if (written == 0)
+        return false;
+
+    // Leave out the oldest slot; it is the next one the sampler overwrites.
+    uint64_t lo = written > capacity_ ? written - capacity_ + 1 : 0;
+    uint64_t hi = written - 1;
+
+    double loTime, hiTime;
+    vr::TrackedDevicePose_t hiPose;
+    if (!Read(hi, unDeviceIndex, &hiTime, &hiPose))
+        return false;
+
+    // Later than the newest sample: hold the newest pose.
+    if (time >= hiTime)
+    {
+        *pPose = hiPose;
+        return true;
+    }
+
+    if (!ReadTime(lo, &loTime) || time < loTime)
+        return false;
+
+    // Find the pair of neighbouring samples with lo.time <= time < hi.time.
+    while (hi - lo > 1)
+    {
+        const uint64_t mid = lo + (hi - lo) / 2;
+        double midTime;
+        if (!ReadTime(mid, &midTime))
+            return false;
+
+        if (midTime <= time)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    vr::TrackedDevicePose_t loPose;
+    if (!Read(lo, unDeviceIndex, &loTime, &loPose) || !Read(hi, unDeviceIndex, &hiTime, &hiPose))
+        return false;
+
+    const double t = hiTime > loTime ? (time - loTime) / (hiTime - loTime) : 0.0;
+    *pPose = Interpolate(loPose, hiPose, t);
+    return true;
+}
+
+// new PoseSampler( eOrigin, fRateHz, unCapacity? )
+void PoseSampler::New(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+
+    if (!info.IsConstructCall())
+    {
+        Nan::ThrowError("Use the `new` keyword when creating a new instance.");
+        return;
+    }
+
+    if (!vr::VRSystem())
+    {
+        Nan::ThrowError("VR_Init must be called before creating a PoseSampler.");
+        return;
+    }
+
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a tracking universe origin.");
+        return;
+    }
+
+    if (!info[1]->IsNumber())
+    {
+        Nan::ThrowTypeError("Argument[1] must be a sampling rate in Hz.");
+        return;
+    }
+
+    vr::ETrackingUniverseOrigin eOrigin = static_cast<vr::ETrackingUniverseOrigin>(info[0]->Uint32Value(context).FromJust());
+    double fRateHz = info[1]->NumberValue(context).FromJust();
+    if (!(fRateHz >= k_fMinRateHz && fRateHz <= k_fMaxRateHz))
+    {
+        Nan::ThrowRangeError("Sampling rate must be between 1 and 2000 Hz.");
+        return;
+    }
+
+    uint32_t unCapacity = k_unDefaultCapacity;
+    if (!info[2]->IsUndefined())
+    {
+        if (!info[2]->IsUint32() || info[2]->Uint32Value(context).FromJust() < 2 || info[2]->Uint32Value(context).FromJust() > k_unMaxCapacity)
+        {
+            Nan::ThrowRangeError("Capacity must be between 2 and 65536 samples.");
+            return;
+        }
+        unCapacity = info[2]->Uint32Value(context).FromJust();
+    }
+
+    PoseSampler *obj = new PoseSampler(eOrigin, fRateHz, unCapacity);
+    obj->Wrap(info.This());
+    info.GetReturnValue().Set(info.This());
+}
+
+void PoseSampler::Start(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    PoseSampler *obj = Nan::ObjectWrap::Unwrap<PoseSampler>(info.Holder());
+
+    vr::IVRSystem *system = vr::VRSystem();
+    if (!system)
+    {
+        Nan::ThrowError("VR_Init must be called before starting a PoseSampler.");
+        return;
+    }
+
+    obj->Start(system);
+}
+
+void PoseSampler::Stop(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    PoseSampler *obj = Nan::ObjectWrap::Unwrap<PoseSampler>(info.Holder());
+    obj->Stop();
+}
+
+void PoseSampler::IsRunning(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    PoseSampler *obj = Nan::ObjectWrap::Unwrap<PoseSampler>(info.Holder());
+    info.GetReturnValue().Set(Nan::New<Boolean>(obj->running_.load()));
+}
+
+void PoseSampler::Now(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    info.GetReturnValue().Set(Nan::New<Number>(Now()));
+}
+
+void PoseSampler::GetSampleCount(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    PoseSampler *obj = Nan::ObjectWrap::Unwrap<PoseSampler>(info.Holder());
+    info.GetReturnValue().Set(Nan::New<Number>(static_cast<double>(obj->written_.load(std::memory_order_acquire))));
+}
+
+void PoseSampler::GetPoseAtTime(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+    PoseSampler *obj = Nan::ObjectWrap::Unwrap<PoseSampler>(info.Holder());
+
+    if (info.Length() < 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsUint32() || info[0]->Uint32Value(context).FromJust() >= vr::k_unMaxTrackedDeviceCount)
+    {
+        Nan::ThrowTypeError("Argument[0] must be a tracked device index.");
+        return;
+    }
+
+    if (!info[1]->IsNumber())
+    {
+        Nan::ThrowTypeError("Argument[1] must be a time from PoseSampler.Now().");
+        return;
+    }
+
+    vr::TrackedDeviceIndex_t unDeviceIndex = info[0]->Uint32Value(context).FromJust();
+    double time = info[1]->NumberValue(context).FromJust();
+
+    if (!info[2]->IsUndefined())
+    {
+        if (!info[2]->IsFloat32Array() || Nan::TypedArrayContents<float>(info[2]).length() < k_unTrackedDevicePoseFloatStride)
+        {
+            Nan::ThrowTypeError("Argument[2] must be a Float32Array that holds one pose.");
+            return;
+        }
+
+        if (!info[3]->IsUndefined() && (!info[3]->IsUint8Array() || Nan::TypedArrayContents<uint8_t>(info[3]).length() < k_unTrackedDevicePoseStateStride))
+        {
+            Nan::ThrowTypeError("Argument[3] must be a Uint8Array that holds one pose state.");
+            return;
+        }
+    }
+
+    vr::TrackedDevicePose_t pose;
+    const bool found = obj->PoseAtTime(unDeviceIndex, time, &pose);
+
+    if (info[2]->IsUndefined())
+    {
+        if (found)
+            info.GetReturnValue().Set(encode(pose));
+        return;
+    }
+
+    if (found)
+    {
+        Nan::TypedArrayContents<float> poses(info[2]);
+        if (info[3]->IsUndefined())
+            encode(pose, *poses, nullptr);
+        else
+            encode(pose, *poses, *Nan::TypedArrayContents<uint8_t>(info[3]));
+    }
+    info.GetReturnValue().Set(Nan::New<Boolean>(found));
+}
+
+void PoseSampler::GetRecentSamples(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+    PoseSampler *obj = Nan::ObjectWrap::Unwrap<PoseSampler>(info.Holder());
+
+    if (!info[0]->IsUint32() || info[0]->Uint32Value(context).FromJust() >= vr::k_unMaxTrackedDeviceCount)
+    {
+        Nan::ThrowTypeError("Argument[0] must be a tracked device index.");
+        return;
+    }
+
+    if (!info[1]->IsFloat32Array())
+    {
+        Nan::ThrowTypeError("Argument[1] must be a Float32Array.");
+        return;
+    }
+
+    if (!info[2]->IsUndefined() && !info[2]->IsFloat64Array())
+    {
+        Nan::ThrowTypeError("Argument[2] must be a Float64Array.");
+        return;
+    }
+
+    if (!info[3]->IsUndefined() && !info[3]->IsUint8Array())
+    {
+        Nan::ThrowTypeError("Argument[3] must be a Uint8Array.");
+        return;
+    }
+
+    vr::TrackedDeviceIndex_t unDeviceIndex = info[0]->Uint32Value(context).FromJust();
+    Nan::TypedArrayContents<float> poses(info[1]);
+    uint64_t unMaxCount = poses.length() / k_unTrackedDevicePoseFloatStride;
+
+    double *pTimes = nullptr;
+    if (!info[2]->IsUndefined())
+    {
+        Nan::TypedArrayContents<double> times(info[2]);
+        pTimes = *times;
+        unMaxCount = std::min<uint64_t>(unMaxCount, times.length());
+    }
+
+    uint8_t *pStates = nullptr;
+    if (!info[3]->IsUndefined())
+    {
+        Nan::TypedArrayContents<uint8_t> states(info[3]);
+        pStates = *states;
+        unMaxCount = std::min<uint64_t>(unMaxCount, states.length() / k_unTrackedDevicePoseStateStride);
+    }
+
+    // Newest first, stopping at the first sample that has aged out of the ring.
+    const uint64_t written = obj->written_.load(std::memory_order_acquire);
+    uint32_t unCount = 0;
+    while (unCount < unMaxCount && unCount < written)
+    {
+        double time;
+        vr::TrackedDevicePose_t pose;
+        if (!obj->Read(written - 1 - unCount, unDeviceIndex, &time, &pose))
+            break;
+
+        encode(pose,
+               *poses + unCount * k_unTrackedDevicePoseFloatStride,
+               pStates ? pStates + unCount * k_unTrackedDevicePoseStateStride : nullptr);
+        if (pTimes)
+            pTimes[unCount] = time;
+        ++unCount;
+    }
+
+    info.GetReturnValue().Set(unCount);
+}
+
+void PoseSampler::GetSnapshotBuffer(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Isolate *isolate = info.GetIsolate();
+    PoseSampler *obj = Nan::ObjectWrap::Unwrap<PoseSampler>(info.Holder());
+
+    if (!obj->snapshotStore_)
+    {
+        Local<SharedArrayBuffer> buffer = SharedArrayBuffer::New(isolate, k_unSnapshotSize);
+        obj->snapshotStore_ = buffer->GetBackingStore();
+
+        uint8_t *snapshot = static_cast<uint8_t *>(obj->snapshotStore_->Data());
+        std::memset(snapshot, 0, k_unSnapshotSize);
+        const uint32_t unDeviceCount = vr::k_unMaxTrackedDeviceCount;
+        std::memcpy(snapshot + k_unSnapshotDeviceCountOffset, &unDeviceCount, sizeof(unDeviceCount));
+
+        obj->snapshot_.store(snapshot, std::memory_order_release);
+        info.GetReturnValue().Set(buffer);
+        return;
+    }
+
+    info.GetReturnValue().Set(SharedArrayBuffer::New(isolate, obj->snapshotStore_));
+}
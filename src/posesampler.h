@@ -0,0 +1,94 @@
+#ifndef POSESAMPLER_H_JS
+#define POSESAMPLER_H_JS
+
+#include <nan.h>
+#include <openvr.h>
+#include <v8.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+using namespace v8;
+
+/// Samples every tracked device on a native thread at a fixed rate and keeps
+/// the most recent samples in a ring buffer that JS can query by time.
+///
+/// The sampler thread is the only writer. Readers never block it: each slot
+/// carries a sequence number, and a read that races with an overwrite of the
+/// same slot is simply retried (or reported as unavailable if the sample has
+/// aged out of the ring).
+///
+/// The sampler can also publish each sample into a SharedArrayBuffer that
+/// worker_threads read without touching the addon; see GetSnapshotBuffer.
+class PoseSampler : public Nan::ObjectWrap
+{
+public:
+    static void Init(Local<Object> exports);
+
+    /// Stops every running sampler. Called before the runtime is shut down so
+    /// no sampler thread keeps using a dead IVRSystem.
+    static void StopAll();
+
+    /// Seconds on the clock used for sample timestamps.
+    static double Now();
+
+private:
+    struct Sample
+    {
+        std::atomic<uint64_t> sequence{0};
+        uint64_t index = 0;
+        double time = 0.0;
+        std::array<vr::TrackedDevicePose_t, vr::k_unMaxTrackedDeviceCount> poses;
+    };
+
+    PoseSampler(vr::ETrackingUniverseOrigin eOrigin, double fRateHz, uint32_t unCapacity);
+    ~PoseSampler();
+
+    void Start(vr::IVRSystem *system);
+    void Stop();
+    void Run(vr::IVRSystem *system);
+
+    void Write(double time, const vr::TrackedDevicePose_t *pPoses);
+    bool Read(uint64_t index, vr::TrackedDeviceIndex_t unDeviceIndex, double *pTime, vr::TrackedDevicePose_t *pPose) const;
+    bool ReadTime(uint64_t index, double *pTime) const;
+    bool PoseAtTime(vr::TrackedDeviceIndex_t unDeviceIndex, double time, vr::TrackedDevicePose_t *pPose) const;
+    void Publish(uint64_t index, double time, const vr::TrackedDevicePose_t *pPoses);
+
+    static void New(const Nan::FunctionCallbackInfo<Value> &info);
+
+    // Start(): void
+    static void Start(const Nan::FunctionCallbackInfo<Value> &info);
+    // Stop(): void
+    static void Stop(const Nan::FunctionCallbackInfo<Value> &info);
+    // IsRunning(): boolean
+    static void IsRunning(const Nan::FunctionCallbackInfo<Value> &info);
+    // Now(): number
+    static void Now(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetSampleCount(): number
+    static void GetSampleCount(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetPoseAtTime( unDeviceIndex, time, poses?: Float32Array, states?: Uint8Array ): TrackedDevicePose_t | boolean | undefined
+    static void GetPoseAtTime(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetRecentSamples( unDeviceIndex, poses: Float32Array, times?: Float64Array, states?: Uint8Array ): number
+    static void GetRecentSamples(const Nan::FunctionCallbackInfo<Value> &info);
+    // GetSnapshotBuffer(): SharedArrayBuffer
+    static void GetSnapshotBuffer(const Nan::FunctionCallbackInfo<Value> &info);
+
+    static Nan::Persistent<v8::Function> constructor;
+
+    const vr::ETrackingUniverseOrigin origin_;
+    const double period_;
+    const uint32_t capacity_;
+    std::unique_ptr<Sample[]> samples_;
+    std::atomic<uint64_t> written_{0};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    // Created on the first GetSnapshotBuffer call and kept alive until the
+    // sampler is destroyed, so the sampler thread may write it at any time.
+    std::shared_ptr<v8::BackingStore> snapshotStore_;
+    std::atomic<uint8_t *> snapshot_{nullptr};
+};
+
+#endif
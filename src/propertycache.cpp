@@ -0,0 +1,163 @@
+#include "propertycache.h"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    struct Entry
+    {
+        vr::PropertyTypeTag_t unTag;
+        std::string data;
+    };
+
+    using DeviceEntries = std::unordered_map<uint32_t, Entry>;
+
+    std::atomic<bool> g_enabled{false};
+    std::atomic<uint64_t> g_hits{0};
+    std::atomic<uint64_t> g_misses{0};
+    std::atomic<uint64_t> g_generation{0};
+
+    std::mutex g_mutex;
+    std::array<DeviceEntries, vr::k_unMaxTrackedDeviceCount> g_devices;
+
+    void ClearLocked(vr::TrackedDeviceIndex_t unDeviceIndex)
+    {
+        g_generation.fetch_add(1, std::memory_order_relaxed);
+        if (unDeviceIndex < vr::k_unMaxTrackedDeviceCount)
+        {
+            g_devices[unDeviceIndex].clear();
+            return;
+        }
+
+        for (DeviceEntries &entries : g_devices)
+            entries.clear();
+    }
+}
+
+namespace PropertyCache
+{
+    bool Enabled()
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool bEnabled)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_enabled.store(bEnabled, std::memory_order_relaxed);
+        if (!bEnabled)
+            ClearLocked(vr::k_unTrackedDeviceIndexInvalid);
+    }
+
+    void Invalidate(vr::TrackedDeviceIndex_t unDeviceIndex)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        ClearLocked(unDeviceIndex);
+    }
+
+    void Observe(const vr::VREvent_t &event)
+    {
+        if (!Enabled())
+            return;
+
+        switch (event.eventType)
+        {
+        case vr::VREvent_PropertyChanged:
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            g_generation.fetch_add(1, std::memory_order_relaxed);
+            if (event.trackedDeviceIndex < vr::k_unMaxTrackedDeviceCount)
+            {
+                g_devices[event.trackedDeviceIndex].erase(event.data.property.prop);
+                break;
+            }
+
+            // Only the container is known, and mapping it back to a device
+            // would itself be a call into the runtime.
+            for (DeviceEntries &entries : g_devices)
+                entries.erase(event.data.property.prop);
+            break;
+        }
+        case vr::VREvent_TrackedDeviceActivated:
+        case vr::VREvent_TrackedDeviceDeactivated:
+        case vr::VREvent_TrackedDeviceUpdated:
+            Invalidate(event.trackedDeviceIndex);
+            break;
+        default:
+            break;
+        }
+    }
+
+    uint64_t Hits()
+    {
+        return g_hits.load(std::memory_order_relaxed);
+    }
+
+    uint64_t Misses()
+    {
+        return g_misses.load(std::memory_order_relaxed);
+    }
+
+    uint64_t Generation()
+    {
+        return g_generation.load(std::memory_order_relaxed);
+    }
+
+    bool Lookup(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, void *pvData, uint32_t unSize)
+    {
+        if (!Enabled() || unDeviceIndex >= vr::k_unMaxTrackedDeviceCount)
+            return false;
+
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            const DeviceEntries &entries = g_devices[unDeviceIndex];
+            auto entry = entries.find(prop);
+            if (entry != entries.end() && entry->second.unTag == unTag && entry->second.data.size() == unSize)
+            {
+                std::memcpy(pvData, entry->second.data.data(), unSize);
+                g_hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        g_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool Lookup(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, std::string *pData)
+    {
+        if (!Enabled() || unDeviceIndex >= vr::k_unMaxTrackedDeviceCount)
+            return false;
+
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            const DeviceEntries &entries = g_devices[unDeviceIndex];
+            auto entry = entries.find(prop);
+            if (entry != entries.end() && entry->second.unTag == unTag)
+            {
+                *pData = entry->second.data;
+                g_hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        g_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void Store(uint64_t unGeneration, vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, const void *pvData, uint32_t unSize)
+    {
+        if (!Enabled() || unDeviceIndex >= vr::k_unMaxTrackedDeviceCount)
+            return;
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (g_generation.load(std::memory_order_relaxed) != unGeneration)
+            return;
+        g_devices[unDeviceIndex][prop] = {unTag, std::string(static_cast<const char *>(pvData), unSize)};
+    }
+}
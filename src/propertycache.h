@@ -0,0 +1,73 @@
+#ifndef PROPERTYCACHE_H_JS
+#define PROPERTYCACHE_H_JS
+
+#include <openvr.h>
+
+#include <cstdint>
+#include <string>
+
+/// Process-wide cache of tracked device property values, so that properties
+/// read every frame cost a map lookup instead of an IPC round trip.
+///
+/// The cache is off until enabled. Entries are dropped when a polled event
+/// says they changed: VREvent_PropertyChanged drops one property, and
+/// VREvent_TrackedDeviceActivated, Deactivated and Updated drop the whole
+/// device. Events are only seen if something polls them (IVRSystem or an
+/// EventPump), so an application that never polls system events should not
+/// enable the cache, or should invalidate it itself.
+///
+/// Only successful reads are cached. All functions are thread-safe.
+namespace PropertyCache
+{
+    bool Enabled();
+
+    /// Disabling the cache also empties it.
+    void SetEnabled(bool bEnabled);
+
+    /// Drops every entry for one device, or for all devices when given
+    /// k_unTrackedDeviceIndexInvalid.
+    void Invalidate(vr::TrackedDeviceIndex_t unDeviceIndex);
+
+    /// Applies the invalidation an event implies. Call for every system
+    /// event, before any filtering.
+    void Observe(const vr::VREvent_t &event);
+
+    uint64_t Hits();
+    uint64_t Misses();
+
+    /// Bumped by every invalidation. A value read from the runtime is only
+    /// stored if no invalidation happened since the read started, so a change
+    /// racing with the read cannot leave the old value cached.
+    uint64_t Generation();
+
+    /// Copies a cached value of the given type into pvData. Returns false on a
+    /// miss, or when the cache is disabled.
+    bool Lookup(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, void *pvData, uint32_t unSize);
+    /// Variable-size form of Lookup, for string and array properties.
+    bool Lookup(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, std::string *pData);
+    void Store(uint64_t unGeneration, vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag, const void *pvData, uint32_t unSize);
+
+    /// Reads a fixed-size property through the cache, calling the runtime
+    /// getter on a miss. A hit reports TrackedProp_Success.
+    template <typename T>
+    T Read(vr::IVRSystem *system, vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t unTag,
+           T (vr::IVRSystem::*getter)(vr::TrackedDeviceIndex_t, vr::ETrackedDeviceProperty, vr::ETrackedPropertyError *),
+           vr::ETrackedPropertyError *pError = nullptr)
+    {
+        T value;
+        vr::ETrackedPropertyError error = vr::TrackedProp_Success;
+        if (!Lookup(unDeviceIndex, prop, unTag, &value, sizeof(T)))
+        {
+            const uint64_t unGeneration = Generation();
+            value = (system->*getter)(unDeviceIndex, prop, &error);
+            if (error == vr::TrackedProp_Success)
+                Store(unGeneration, unDeviceIndex, prop, unTag, &value, sizeof(T));
+        }
+
+        if (pError)
+            *pError = error;
+        return value;
+    }
+}
+
+#endif
@@ -0,0 +1,252 @@
+#ifndef PROPERTYTYPES_H_JS
+#define PROPERTYTYPES_H_JS
+
+#include <openvr.h>
+
+#include <array>
+#include <cstdint>
+
+// Type of every ETrackedDeviceProperty in openvr.h, taken from the suffix of
+// its name. X(prop, tag) pairs the property with the k_un<tag>PropertyTag it
+// is stored as. Properties without a fixed type (the _Binary ones and the
+// vendor-specific range) are left out.
+#define PROPERTY_SCALAR_TYPES(X)                                   \
+    X(Prop_TrackingSystemName_String, String)                      \
+    X(Prop_ModelNumber_String, String)                             \
+    X(Prop_SerialNumber_String, String)                            \
+    X(Prop_RenderModelName_String, String)                         \
+    X(Prop_WillDriftInYaw_Bool, Bool)                              \
+    X(Prop_ManufacturerName_String, String)                        \
+    X(Prop_TrackingFirmwareVersion_String, String)                 \
+    X(Prop_HardwareRevision_String, String)                        \
+    X(Prop_AllWirelessDongleDescriptions_String, String)           \
+    X(Prop_ConnectedWirelessDongle_String, String)                 \
+    X(Prop_DeviceIsWireless_Bool, Bool)                            \
+    X(Prop_DeviceIsCharging_Bool, Bool)                            \
+    X(Prop_DeviceBatteryPercentage_Float, Float)                   \
+    X(Prop_StatusDisplayTransform_Matrix34, HmdMatrix34)           \
+    X(Prop_Firmware_UpdateAvailable_Bool, Bool)                    \
+    X(Prop_Firmware_ManualUpdate_Bool, Bool)                       \
+    X(Prop_Firmware_ManualUpdateURL_String, String)                \
+    X(Prop_HardwareRevision_Uint64, Uint64)                        \
+    X(Prop_FirmwareVersion_Uint64, Uint64)                         \
+    X(Prop_FPGAVersion_Uint64, Uint64)                             \
+    X(Prop_VRCVersion_Uint64, Uint64)                              \
+    X(Prop_RadioVersion_Uint64, Uint64)                            \
+    X(Prop_DongleVersion_Uint64, Uint64)                           \
+    X(Prop_BlockServerShutdown_Bool, Bool)                         \
+    X(Prop_CanUnifyCoordinateSystemWithHmd_Bool, Bool)             \
+    X(Prop_ContainsProximitySensor_Bool, Bool)                     \
+    X(Prop_DeviceProvidesBatteryStatus_Bool, Bool)                 \
+    X(Prop_DeviceCanPowerOff_Bool, Bool)                           \
+    X(Prop_Firmware_ProgrammingTarget_String, String)              \
+    X(Prop_DeviceClass_Int32, Int32)                               \
+    X(Prop_HasCamera_Bool, Bool)                                   \
+    X(Prop_DriverVersion_String, String)                           \
+    X(Prop_Firmware_ForceUpdateRequired_Bool, Bool)                \
+    X(Prop_ViveSystemButtonFixRequired_Bool, Bool)                 \
+    X(Prop_ParentDriver_Uint64, Uint64)                            \
+    X(Prop_ResourceRoot_String, String)                            \
+    X(Prop_RegisteredDeviceType_String, String)                    \
+    X(Prop_InputProfilePath_String, String)                        \
+    X(Prop_NeverTracked_Bool, Bool)                                \
+    X(Prop_NumCameras_Int32, Int32)                                \
+    X(Prop_CameraFrameLayout_Int32, Int32)                         \
+    X(Prop_CameraStreamFormat_Int32, Int32)                        \
+    X(Prop_AdditionalDeviceSettingsPath_String, String)            \
+    X(Prop_Identifiable_Bool, Bool)                                \
+    X(Prop_BootloaderVersion_Uint64, Uint64)                       \
+    X(Prop_AdditionalSystemReportData_String, String)              \
+    X(Prop_CompositeFirmwareVersion_String, String)                \
+    X(Prop_Firmware_RemindUpdate_Bool, Bool)                       \
+    X(Prop_PeripheralApplicationVersion_Uint64, Uint64)            \
+    X(Prop_ManufacturerSerialNumber_String, String)                \
+    X(Prop_ComputedSerialNumber_String, String)                    \
+    X(Prop_EstimatedDeviceFirstUseTime_Int32, Int32)               \
+    X(Prop_ReportsTimeSinceVSync_Bool, Bool)                       \
+    X(Prop_SecondsFromVsyncToPhotons_Float, Float)                 \
+    X(Prop_DisplayFrequency_Float, Float)                          \
+    X(Prop_UserIpdMeters_Float, Float)                             \
+    X(Prop_CurrentUniverseId_Uint64, Uint64)                       \
+    X(Prop_PreviousUniverseId_Uint64, Uint64)                      \
+    X(Prop_DisplayFirmwareVersion_Uint64, Uint64)                  \
+    X(Prop_IsOnDesktop_Bool, Bool)                                 \
+    X(Prop_DisplayMCType_Int32, Int32)                             \
+    X(Prop_DisplayMCOffset_Float, Float)                           \
+    X(Prop_DisplayMCScale_Float, Float)                            \
+    X(Prop_EdidVendorID_Int32, Int32)                              \
+    X(Prop_DisplayMCImageLeft_String, String)                      \
+    X(Prop_DisplayMCImageRight_String, String)                     \
+    X(Prop_DisplayGCBlackClamp_Float, Float)                       \
+    X(Prop_EdidProductID_Int32, Int32)                             \
+    X(Prop_CameraToHeadTransform_Matrix34, HmdMatrix34)            \
+    X(Prop_DisplayGCType_Int32, Int32)                             \
+    X(Prop_DisplayGCOffset_Float, Float)                           \
+    X(Prop_DisplayGCScale_Float, Float)                            \
+    X(Prop_DisplayGCPrescale_Float, Float)                         \
+    X(Prop_DisplayGCImage_String, String)                          \
+    X(Prop_LensCenterLeftU_Float, Float)                           \
+    X(Prop_LensCenterLeftV_Float, Float)                           \
+    X(Prop_LensCenterRightU_Float, Float)                          \
+    X(Prop_LensCenterRightV_Float, Float)                          \
+    X(Prop_UserHeadToEyeDepthMeters_Float, Float)                  \
+    X(Prop_CameraFirmwareVersion_Uint64, Uint64)                   \
+    X(Prop_CameraFirmwareDescription_String, String)               \
+    X(Prop_DisplayFPGAVersion_Uint64, Uint64)                      \
+    X(Prop_DisplayBootloaderVersion_Uint64, Uint64)                \
+    X(Prop_DisplayHardwareVersion_Uint64, Uint64)                  \
+    X(Prop_AudioFirmwareVersion_Uint64, Uint64)                    \
+    X(Prop_CameraCompatibilityMode_Int32, Int32)                   \
+    X(Prop_ScreenshotHorizontalFieldOfViewDegrees_Float, Float)    \
+    X(Prop_ScreenshotVerticalFieldOfViewDegrees_Float, Float)      \
+    X(Prop_DisplaySuppressed_Bool, Bool)                           \
+    X(Prop_DisplayAllowNightMode_Bool, Bool)                       \
+    X(Prop_DisplayMCImageWidth_Int32, Int32)                       \
+    X(Prop_DisplayMCImageHeight_Int32, Int32)                      \
+    X(Prop_DisplayMCImageNumChannels_Int32, Int32)                 \
+    X(Prop_SecondsFromPhotonsToVblank_Float, Float)                \
+    X(Prop_DriverDirectModeSendsVsyncEvents_Bool, Bool)            \
+    X(Prop_DisplayDebugMode_Bool, Bool)                            \
+    X(Prop_GraphicsAdapterLuid_Uint64, Uint64)                     \
+    X(Prop_DriverProvidedChaperonePath_String, String)             \
+    X(Prop_ExpectedTrackingReferenceCount_Int32, Int32)            \
+    X(Prop_ExpectedControllerCount_Int32, Int32)                   \
+    X(Prop_NamedIconPathControllerLeftDeviceOff_String, String)    \
+    X(Prop_NamedIconPathControllerRightDeviceOff_String, String)   \
+    X(Prop_NamedIconPathTrackingReferenceDeviceOff_String, String) \
+    X(Prop_DoNotApplyPrediction_Bool, Bool)                        \
+    X(Prop_DistortionMeshResolution_Int32, Int32)                  \
+    X(Prop_DriverIsDrawingControllers_Bool, Bool)                  \
+    X(Prop_DriverRequestsApplicationPause_Bool, Bool)              \
+    X(Prop_DriverRequestsReducedRendering_Bool, Bool)              \
+    X(Prop_MinimumIpdStepMeters_Float, Float)                      \
+    X(Prop_AudioBridgeFirmwareVersion_Uint64, Uint64)              \
+    X(Prop_ImageBridgeFirmwareVersion_Uint64, Uint64)              \
+    X(Prop_ImuToHeadTransform_Matrix34, HmdMatrix34)               \
+    X(Prop_ImuFactoryGyroBias_Vector3, HmdVector3)                 \
+    X(Prop_ImuFactoryGyroScale_Vector3, HmdVector3)                \
+    X(Prop_ImuFactoryAccelerometerBias_Vector3, HmdVector3)        \
+    X(Prop_ImuFactoryAccelerometerScale_Vector3, HmdVector3)       \
+    X(Prop_ConfigurationIncludesLighthouse20Features_Bool, Bool)   \
+    X(Prop_AdditionalRadioFeatures_Uint64, Uint64)                 \
+    X(Prop_ExpectedControllerType_String, String)                  \
+    X(Prop_HmdTrackingStyle_Int32, Int32)                          \
+    X(Prop_DriverProvidedChaperoneVisibility_Bool, Bool)           \
+    X(Prop_HmdColumnCorrectionSettingPrefix_String, String)        \
+    X(Prop_CameraSupportsCompatibilityModes_Bool, Bool)            \
+    X(Prop_SupportsRoomViewDepthProjection_Bool, Bool)             \
+    X(Prop_DisplaySupportsMultipleFramerates_Bool, Bool)           \
+    X(Prop_DisplayColorMultLeft_Vector3, HmdVector3)               \
+    X(Prop_DisplayColorMultRight_Vector3, HmdVector3)              \
+    X(Prop_DisplaySupportsRuntimeFramerateChange_Bool, Bool)       \
+    X(Prop_DisplaySupportsAnalogGain_Bool, Bool)                   \
+    X(Prop_DisplayMinAnalogGain_Float, Float)                      \
+    X(Prop_DisplayMaxAnalogGain_Float, Float)                      \
+    X(Prop_CameraExposureTime_Float, Float)                        \
+    X(Prop_CameraGlobalGain_Float, Float)                          \
+    X(Prop_DashboardScale_Float, Float)                            \
+    X(Prop_IpdUIRangeMinMeters_Float, Float)                       \
+    X(Prop_IpdUIRangeMaxMeters_Float, Float)                       \
+    X(Prop_Hmd_SupportsHDCP14LegacyCompat_Bool, Bool)              \
+    X(Prop_Hmd_SupportsMicMonitoring_Bool, Bool)                   \
+    X(Prop_DriverRequestedMuraCorrectionMode_Int32, Int32)         \
+    X(Prop_DriverRequestedMuraFeather_InnerLeft_Int32, Int32)      \
+    X(Prop_DriverRequestedMuraFeather_InnerRight_Int32, Int32)     \
+    X(Prop_DriverRequestedMuraFeather_InnerTop_Int32, Int32)       \
+    X(Prop_DriverRequestedMuraFeather_InnerBottom_Int32, Int32)    \
+    X(Prop_DriverRequestedMuraFeather_OuterLeft_Int32, Int32)      \
+    X(Prop_DriverRequestedMuraFeather_OuterRight_Int32, Int32)     \
+    X(Prop_DriverRequestedMuraFeather_OuterTop_Int32, Int32)       \
+    X(Prop_DriverRequestedMuraFeather_OuterBottom_Int32, Int32)    \
+    X(Prop_Audio_DefaultPlaybackDeviceId_String, String)           \
+    X(Prop_Audio_DefaultRecordingDeviceId_String, String)          \
+    X(Prop_Audio_DefaultPlaybackDeviceVolume_Float, Float)         \
+    X(Prop_Audio_SupportsDualSpeakerAndJackOutput_Bool, Bool)      \
+    X(Prop_AttachedDeviceId_String, String)                        \
+    X(Prop_SupportedButtons_Uint64, Uint64)                        \
+    X(Prop_Axis0Type_Int32, Int32)                                 \
+    X(Prop_Axis1Type_Int32, Int32)                                 \
+    X(Prop_Axis2Type_Int32, Int32)                                 \
+    X(Prop_Axis3Type_Int32, Int32)                                 \
+    X(Prop_Axis4Type_Int32, Int32)                                 \
+    X(Prop_ControllerRoleHint_Int32, Int32)                        \
+    X(Prop_FieldOfViewLeftDegrees_Float, Float)                    \
+    X(Prop_FieldOfViewRightDegrees_Float, Float)                   \
+    X(Prop_FieldOfViewTopDegrees_Float, Float)                     \
+    X(Prop_FieldOfViewBottomDegrees_Float, Float)                  \
+    X(Prop_TrackingRangeMinimumMeters_Float, Float)                \
+    X(Prop_TrackingRangeMaximumMeters_Float, Float)                \
+    X(Prop_ModeLabel_String, String)                               \
+    X(Prop_CanWirelessIdentify_Bool, Bool)                         \
+    X(Prop_Nonce_Int32, Int32)                                     \
+    X(Prop_IconPathName_String, String)                            \
+    X(Prop_NamedIconPathDeviceOff_String, String)                  \
+    X(Prop_NamedIconPathDeviceSearching_String, String)            \
+    X(Prop_NamedIconPathDeviceSearchingAlert_String, String)       \
+    X(Prop_NamedIconPathDeviceReady_String, String)                \
+    X(Prop_NamedIconPathDeviceReadyAlert_String, String)           \
+    X(Prop_NamedIconPathDeviceNotReady_String, String)             \
+    X(Prop_NamedIconPathDeviceStandby_String, String)              \
+    X(Prop_NamedIconPathDeviceAlertLow_String, String)             \
+    X(Prop_NamedIconPathDeviceStandbyAlert_String, String)         \
+    X(Prop_ParentContainer, Uint64)                                \
+    X(Prop_OverrideContainer_Uint64, Uint64)                       \
+    X(Prop_UserConfigPath_String, String)                          \
+    X(Prop_InstallPath_String, String)                             \
+    X(Prop_HasDisplayComponent_Bool, Bool)                         \
+    X(Prop_HasControllerComponent_Bool, Bool)                      \
+    X(Prop_HasCameraComponent_Bool, Bool)                          \
+    X(Prop_HasDriverDirectModeComponent_Bool, Bool)                \
+    X(Prop_HasVirtualDisplayComponent_Bool, Bool)                  \
+    X(Prop_HasSpatialAnchorsSupport_Bool, Bool)                    \
+    X(Prop_ControllerType_String, String)                          \
+    X(Prop_ControllerHandSelectionPriority_Int32, Int32)
+
+// Array properties, paired with the tag of one element. The camera distortion
+// coefficients are doubles despite the name, as documented in openvr.h.
+#define PROPERTY_ARRAY_TYPES(X)                                \
+    X(Prop_CameraToHeadTransforms_Matrix34_Array, HmdMatrix34) \
+    X(Prop_CameraWhiteBalance_Vector4_Array, HmdVector4)       \
+    X(Prop_CameraDistortionFunction_Int32_Array, Int32)        \
+    X(Prop_CameraDistortionCoefficients_Float_Array, Double)   \
+    X(Prop_DisplayAvailableFrameRates_Float_Array, Float)
+
+namespace PropertyTypes
+{
+    // Every property defined by openvr.h is below the vendor-specific range.
+    constexpr uint32_t k_unTableSize = vr::Prop_VendorSpecific_Reserved_Start;
+    constexpr uint8_t k_unArrayFlag = 0x80;
+
+    constexpr std::array<uint8_t, k_unTableSize> BuildTable()
+    {
+        std::array<uint8_t, k_unTableSize> table{};
+#define PROPERTY_SCALAR_TYPE_ENTRY(prop, tag) table[vr::prop] = vr::k_un##tag##PropertyTag;
+#define PROPERTY_ARRAY_TYPE_ENTRY(prop, tag) table[vr::prop] = vr::k_un##tag##PropertyTag | k_unArrayFlag;
+        PROPERTY_SCALAR_TYPES(PROPERTY_SCALAR_TYPE_ENTRY)
+        PROPERTY_ARRAY_TYPES(PROPERTY_ARRAY_TYPE_ENTRY)
+#undef PROPERTY_ARRAY_TYPE_ENTRY
+#undef PROPERTY_SCALAR_TYPE_ENTRY
+        return table;
+    }
+
+    inline constexpr std::array<uint8_t, k_unTableSize> k_table = BuildTable();
+
+    static_assert(vr::k_unHmdVector4PropertyTag < k_unArrayFlag, "property type tags must fit below the array flag");
+
+    /// Tag the property is stored as, or of one element for array properties.
+    /// k_unInvalidPropertyTag for properties of unknown type.
+    constexpr vr::PropertyTypeTag_t Tag(uint32_t prop)
+    {
+        return prop < k_unTableSize ? k_table[prop] & ~k_unArrayFlag : vr::k_unInvalidPropertyTag;
+    }
+
+    constexpr bool IsArray(uint32_t prop)
+    {
+        return prop < k_unTableSize && (k_table[prop] & k_unArrayFlag) != 0;
+    }
+
+    static_assert(Tag(vr::Prop_DeviceBatteryPercentage_Float) == vr::k_unFloatPropertyTag, "property type table is wrong");
+    static_assert(IsArray(vr::Prop_DisplayAvailableFrameRates_Float_Array), "property type table is wrong");
+}
+
+#endif
@@ -1,5 +1,10 @@
 #include "util.h"
 
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+
 //=========================================================
 // C++ -> Node
 template <typename T>
@@ -9,6 +14,60 @@ v8::Local<v8::Value> encode(const T &value);
 template <typename T>
 T decode(const v8::Local<v8::Value>, v8::Isolate *);
 
+//=========================================================
+namespace
+{
+    v8::Local<v8::ObjectTemplate> NewShape(std::initializer_list<v8::Local<v8::String>> properties)
+    {
+        Nan::EscapableHandleScope scope;
+        auto shape = Nan::New<v8::ObjectTemplate>();
+        for (const auto &property : properties)
+            shape->Set(property, Nan::Undefined());
+        return scope.Escape(shape);
+    }
+
+    thread_local std::unique_ptr<CodecKeys> t_codecKeys;
+}
+
+const CodecKeys &CodecKeys::Get(v8::Isolate *isolate)
+{
+    // Node runs at most one isolate per thread; a new isolate on a reused
+    // thread (worker restart) just gets a fresh table.
+    if (!t_codecKeys || t_codecKeys->isolate_ != isolate)
+        t_codecKeys.reset(new CodecKeys(isolate));
+    return *t_codecKeys;
+}
+
+CodecKeys::CodecKeys(v8::Isolate *isolate)
+    : isolate_(isolate)
+{
+    Nan::HandleScope scope;
+
+#define UTIL_CODEC_KEY_INTERN(name) \
+    name##_.Set(isolate, v8::String::NewFromUtf8(isolate, #name, v8::NewStringType::kInternalized).ToLocalChecked());
+    UTIL_CODEC_KEYS(UTIL_CODEC_KEY_INTERN)
+#undef UTIL_CODEC_KEY_INTERN
+
+    poseShape_.Set(isolate, NewShape({deviceToAbsoluteTracking(), velocity(), angularVelocity(), trackingResult(), poseIsValid(), deviceIsConnected()}));
+    eventShape_.Set(isolate, NewShape({eventType(), trackedDeviceIndex(), eventAgeSeconds(), data()}));
+    boundsShape_.Set(isolate, NewShape({uMin(), uMax(), vMax(), vMin()}));
+}
+
+v8::Local<v8::Object> CodecKeys::NewPose() const
+{
+    return poseShape_.Get(isolate_)->NewInstance(isolate_->GetCurrentContext()).ToLocalChecked();
+}
+
+v8::Local<v8::Object> CodecKeys::NewEvent() const
+{
+    return eventShape_.Get(isolate_)->NewInstance(isolate_->GetCurrentContext()).ToLocalChecked();
+}
+
+v8::Local<v8::Object> CodecKeys::NewBounds() const
+{
+    return boundsShape_.Get(isolate_)->NewInstance(isolate_->GetCurrentContext()).ToLocalChecked();
+}
+
 //=========================================================
 template <>
 v8::Local<v8::Value> encode(const vr::HmdMatrix44_t &value)
@@ -128,6 +187,7 @@ template <>
 v8::Local<v8::Value> encode(const vr::DistortionCoordinates_t &value)
 {
     Nan::EscapableHandleScope scope;
+    const CodecKeys &keys = CodecKeys::Get(v8::Isolate::GetCurrent());
     auto result = Nan::New<v8::Object>();
 
     // Extract red values.
@@ -136,7 +196,7 @@ v8::Local<v8::Value> encode(const vr::DistortionCoordinates_t &value)
         Nan::Set(red, 0, Nan::New<v8::Number>(value.rfRed[0]));
         Nan::Set(red, 1, Nan::New<v8::Number>(value.rfRed[1]));
 
-        auto red_prop = Nan::New<v8::String>("red").ToLocalChecked();
+        auto red_prop = keys.red();
         Nan::Set(result, red_prop, red);
     }
 
@@ -146,7 +206,7 @@ v8::Local<v8::Value> encode(const vr::DistortionCoordinates_t &value)
         Nan::Set(green, 0, Nan::New<v8::Number>(value.rfGreen[0]));
         Nan::Set(green, 1, Nan::New<v8::Number>(value.rfGreen[1]));
 
-        auto green_prop = Nan::New<v8::String>("green").ToLocalChecked();
+        auto green_prop = keys.green();
         Nan::Set(result, green_prop, green);
     }
 
@@ -156,7 +216,7 @@ v8::Local<v8::Value> encode(const vr::DistortionCoordinates_t &value)
         Nan::Set(blue, 0, Nan::New<v8::Number>(value.rfBlue[0]));
         Nan::Set(blue, 1, Nan::New<v8::Number>(value.rfBlue[1]));
 
-        auto blue_prop = Nan::New<v8::String>("blue").ToLocalChecked();
+        auto blue_prop = keys.blue();
         Nan::Set(result, blue_prop, blue);
     }
 
@@ -175,36 +235,31 @@ template <>
 v8::Local<v8::Value> encode(const vr::TrackedDevicePose_t &value)
 {
     Nan::EscapableHandleScope scope;
-    auto result = Nan::New<v8::Object>();
+    const CodecKeys &keys = CodecKeys::Get(v8::Isolate::GetCurrent());
+    auto result = keys.NewPose();
 
-    auto deviceToAbsoluteTracking_prop =
-        Nan::New<v8::String>("deviceToAbsoluteTracking").ToLocalChecked();
+    auto deviceToAbsoluteTracking_prop = keys.deviceToAbsoluteTracking();
     Nan::Set(
         result, deviceToAbsoluteTracking_prop,
         encode(value.mDeviceToAbsoluteTracking));
 
-    auto velocity_prop =
-        Nan::New<v8::String>("velocity").ToLocalChecked();
+    auto velocity_prop = keys.velocity();
     Nan::Set(result, velocity_prop, encode(value.vVelocity));
 
-    auto angularVelocity_prop =
-        Nan::New<v8::String>("angularVelocity").ToLocalChecked();
+    auto angularVelocity_prop = keys.angularVelocity();
     Nan::Set(result, angularVelocity_prop, encode(value.vAngularVelocity));
 
-    auto trackingResult_prop =
-        Nan::New<v8::String>("trackingResult").ToLocalChecked();
+    auto trackingResult_prop = keys.trackingResult();
     Nan::Set(
         result, trackingResult_prop,
         Nan::New<v8::Number>(static_cast<uint32_t>(value.eTrackingResult)));
 
-    auto poseIsValid_prop =
-        Nan::New<v8::String>("poseIsValid").ToLocalChecked();
+    auto poseIsValid_prop = keys.poseIsValid();
     Nan::Set(
         result, poseIsValid_prop,
         Nan::New<v8::Boolean>(value.bPoseIsValid));
 
-    auto deviceIsConnected_prop =
-        Nan::New<v8::String>("deviceIsConnected").ToLocalChecked();
+    auto deviceIsConnected_prop = keys.deviceIsConnected();
     Nan::Set(
         result, deviceIsConnected_prop,
         Nan::New<v8::Boolean>(value.bDeviceIsConnected));
@@ -216,39 +271,34 @@ v8::Local<v8::Value> encode(const vr::TrackedDevicePose_t &value)
 template <>
 vr::TrackedDevicePose_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate)
 {
+    const CodecKeys &keys = CodecKeys::Get(isolate);
     vr::TrackedDevicePose_t result;
     const auto object = value->ToObject(isolate->GetCurrentContext()).ToLocalChecked();
 
-    auto deviceToAbsoluteTracking_prop =
-        Nan::New<v8::String>("deviceToAbsoluteTracking").ToLocalChecked();
+    auto deviceToAbsoluteTracking_prop = keys.deviceToAbsoluteTracking();
     result.mDeviceToAbsoluteTracking =
         decode<vr::HmdMatrix34_t>(
             Nan::Get(object, deviceToAbsoluteTracking_prop).ToLocalChecked(), isolate);
 
-    auto velocity_prop =
-        Nan::New<v8::String>("velocity").ToLocalChecked();
+    auto velocity_prop = keys.velocity();
     result.vVelocity =
         decode<vr::HmdVector3_t>(Nan::Get(object, velocity_prop).ToLocalChecked(), isolate);
 
-    auto angularVelocity_prop =
-        Nan::New<v8::String>("angularVelocity").ToLocalChecked();
+    auto angularVelocity_prop = keys.angularVelocity();
     result.vAngularVelocity =
         decode<vr::HmdVector3_t>(
             Nan::Get(object, angularVelocity_prop).ToLocalChecked(), isolate);
 
-    auto trackingResult_prop =
-        Nan::New<v8::String>("trackingResult").ToLocalChecked();
+    auto trackingResult_prop = keys.trackingResult();
     result.eTrackingResult =
         static_cast<vr::ETrackingResult>(
             Nan::Get(object, trackingResult_prop).ToLocalChecked()->Uint32Value(isolate->GetCurrentContext()).FromJust());
 
-    auto poseIsValid_prop =
-        Nan::New<v8::String>("poseIsValid").ToLocalChecked();
+    auto poseIsValid_prop = keys.poseIsValid();
     result.bPoseIsValid =
         Nan::Get(object, poseIsValid_prop).ToLocalChecked()->BooleanValue(isolate);
 
-    auto deviceIsConnected_prop =
-        Nan::New<v8::String>("deviceIsConnected").ToLocalChecked();
+    auto deviceIsConnected_prop = keys.deviceIsConnected();
     result.bDeviceIsConnected =
         Nan::Get(object, deviceIsConnected_prop).ToLocalChecked()->BooleanValue(isolate);
 
@@ -281,23 +331,49 @@ v8::Local<v8::Value> encode(const TrackedDevicePoseArray &value)
     return scope.Escape(result);
 }
 
+//=========================================================
+void encode(const vr::TrackedDevicePose_t &value, float *pfPose, uint8_t *punState)
+{
+    for (uint32_t rowIdx = 0; rowIdx < 3; ++rowIdx)
+    {
+        for (uint32_t colIdx = 0; colIdx < 4; ++colIdx)
+            *pfPose++ = value.mDeviceToAbsoluteTracking.m[rowIdx][colIdx];
+    }
+
+    for (uint32_t idx = 0; idx < 3; ++idx)
+        *pfPose++ = value.vVelocity.v[idx];
+
+    for (uint32_t idx = 0; idx < 3; ++idx)
+        *pfPose++ = value.vAngularVelocity.v[idx];
+
+    if (punState)
+    {
+        const uint32_t trackingResult = static_cast<uint32_t>(value.eTrackingResult);
+        punState[0] = value.bPoseIsValid ? 1 : 0;
+        punState[1] = value.bDeviceIsConnected ? 1 : 0;
+        punState[2] = static_cast<uint8_t>(trackingResult / 100);
+        punState[3] = static_cast<uint8_t>(trackingResult % 100);
+    }
+}
+
 //=========================================================
 template<>
 vr::VRTextureBounds_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate)
 {
+    const CodecKeys &keys = CodecKeys::Get(isolate);
     vr::VRTextureBounds_t result;
     const auto object = value->ToObject(isolate->GetCurrentContext()).ToLocalChecked();
 
-    auto uMin_prop = Nan::New<v8::String>("uMin").ToLocalChecked();
+    auto uMin_prop = keys.uMin();
     result.uMin = Nan::Get(object, uMin_prop).ToLocalChecked()->NumberValue(isolate->GetCurrentContext()).FromJust();
 
-    auto uMax_prop = Nan::New<v8::String>("uMax").ToLocalChecked();
+    auto uMax_prop = keys.uMax();
     result.uMax = Nan::Get(object, uMax_prop).ToLocalChecked()->NumberValue(isolate->GetCurrentContext()).FromJust();
 
-    auto vMax_prop = Nan::New<v8::String>("vMax").ToLocalChecked();
+    auto vMax_prop = keys.vMax();
     result.vMax = Nan::Get(object, vMax_prop).ToLocalChecked()->NumberValue(isolate->GetCurrentContext()).FromJust();
 
-    auto vMin_prop = Nan::New<v8::String>("vMin").ToLocalChecked();
+    auto vMin_prop = keys.vMin();
     result.vMin = Nan::Get(object, vMin_prop).ToLocalChecked()->NumberValue(isolate->GetCurrentContext()).FromJust();
 
     return result;
@@ -308,18 +384,19 @@ template <>
 v8::Local<v8::Value> encode(const vr::VRTextureBounds_t &textureBounds)
 {
     Nan::EscapableHandleScope scope;
-    auto result = Nan::New<v8::Object>();
+    const CodecKeys &keys = CodecKeys::Get(v8::Isolate::GetCurrent());
+    auto result = keys.NewBounds();
 
-    auto uMin_prop = Nan::New<v8::String>("uMin").ToLocalChecked();
+    auto uMin_prop = keys.uMin();
     Nan::Set(result, uMin_prop, Nan::New<v8::Number>(textureBounds.uMin));
 
-    auto uMax_prop = Nan::New<v8::String>("uMax").ToLocalChecked();
+    auto uMax_prop = keys.uMax();
     Nan::Set(result, uMax_prop, Nan::New<v8::Number>(textureBounds.uMax));
 
-    auto vMax_prop = Nan::New<v8::String>("vMax").ToLocalChecked();
+    auto vMax_prop = keys.vMax();
     Nan::Set(result, vMax_prop, Nan::New<v8::Number>(textureBounds.vMax));
 
-    auto vMin_prop = Nan::New<v8::String>("vMin").ToLocalChecked();
+    auto vMin_prop = keys.vMin();
     Nan::Set(result, vMin_prop, Nan::New<v8::Number>(textureBounds.vMin));
 
     return scope.Escape(result);
@@ -329,78 +406,353 @@ v8::Local<v8::Value> encode(const vr::VRTextureBounds_t &textureBounds)
 template<>
 vr::VROverlayProjection_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate)
 {
+    const CodecKeys &keys = CodecKeys::Get(isolate);
     vr::VROverlayProjection_t result;
     const auto object = value->ToObject(isolate->GetCurrentContext()).ToLocalChecked();
 
-    auto fBottom_prop = Nan::New<v8::String>("fBottom").ToLocalChecked();
+    auto fBottom_prop = keys.fBottom();
     result.fBottom = Nan::Get(object, fBottom_prop).ToLocalChecked()->NumberValue(isolate->GetCurrentContext()).FromJust();
 
-    auto fLeft_prop = Nan::New<v8::String>("fLeft").ToLocalChecked();
+    auto fLeft_prop = keys.fLeft();
     result.fLeft = Nan::Get(object, fLeft_prop).ToLocalChecked()->NumberValue(isolate->GetCurrentContext()).FromJust();
 
-    auto fRight_prop = Nan::New<v8::String>("fRight").ToLocalChecked();
+    auto fRight_prop = keys.fRight();
     result.fRight = Nan::Get(object, fRight_prop).ToLocalChecked()->NumberValue(isolate->GetCurrentContext()).FromJust();
 
-    auto fTop_prop = Nan::New<v8::String>("fTop").ToLocalChecked();
+    auto fTop_prop = keys.fTop();
     result.fTop = Nan::Get(object, fTop_prop).ToLocalChecked()->NumberValue(isolate->GetCurrentContext()).FromJust();
 
     return result;
 }
 
 //=========================================================
-template <typename T>
-v8::Local<v8::Value> encode(const T &eventData, vr::EVREventType eventType)
+namespace
 {
-    Nan::EscapableHandleScope scope;
-    auto result = Nan::New<v8::Object>();
+    using EventDataEncoder = v8::Local<v8::Object> (*)(const CodecKeys &keys, const vr::VREvent_Data_t &data);
 
-    switch(eventType) 
-    {
-        case vr::VREvent_None:
-        case vr::VREvent_TrackedDeviceActivated:
-        case vr::VREvent_TrackedDeviceDeactivated:
-        case vr::VREvent_TrackedDeviceUpdated:
-            return scope.Escape(Nan::New<v8::Object>());
-        case vr::VREvent_ButtonPress:
-        case vr::VREvent_ButtonUnpress:
-        case vr::VREvent_ButtonTouch:
-        case vr::VREvent_ButtonUntouch:
-        {
-            auto result = Nan::New<v8::Object>();
+    // Handles, paths and user values are opaque 64-bit ids, which a Number
+    // would round past 2^53.
+    v8::Local<v8::BigInt> Uint64BigInt(uint64_t value)
+    {
+        return v8::BigInt::NewFromUnsigned(v8::Isolate::GetCurrent(), value);
+    }
 
-            auto controller_result = Nan::New<v8::Object>();
-            auto controller_prop = Nan::New<v8::String>("controller").ToLocalChecked();
-            
-            auto button_prop = Nan::New<v8::String>("button").ToLocalChecked();
-            Nan::Set(controller_result, button_prop, Nan::New<v8::Number>(eventData.controller.button));
+    // { member: payload }, matching VREvent_Data_t on the JS side.
+    v8::Local<v8::Object> WrapEventData(v8::Local<v8::String> member, v8::Local<v8::Object> payload)
+    {
+        auto result = Nan::New<v8::Object>();
+        Nan::Set(result, member, payload);
+        return result;
+    }
 
-            Nan::Set(result, controller_prop, controller_result);
+    v8::Local<v8::Object> EncodeController(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.button(), Nan::New<v8::Number>(data.controller.button));
+        return WrapEventData(keys.controller(), payload);
+    }
 
-            return scope.Escape(result);
-        }
-        case vr::VREvent_MouseMove:
-        case vr::VREvent_MouseButtonDown:
-        case vr::VREvent_MouseButtonUp:
-        {
-            auto result = Nan::New<v8::Object>();
+    v8::Local<v8::Object> EncodeMouse(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.button(), Nan::New<v8::Number>(data.mouse.button));
+        Nan::Set(payload, keys.x(), Nan::New<v8::Number>(data.mouse.x));
+        Nan::Set(payload, keys.y(), Nan::New<v8::Number>(data.mouse.y));
+        return WrapEventData(keys.mouse(), payload);
+    }
 
-            auto mouse_result = Nan::New<v8::Object>();
-            auto mouse_prop = Nan::New<v8::String>("mouse").ToLocalChecked();
-            
-            auto button_prop = Nan::New<v8::String>("button").ToLocalChecked();
-            Nan::Set(mouse_result, button_prop, Nan::New<v8::Number>(eventData.mouse.button));
-            auto x_prop = Nan::New<v8::String>("x").ToLocalChecked();
-            Nan::Set(mouse_result, x_prop, Nan::New<v8::Number>(eventData.mouse.x));
-            auto y_prop = Nan::New<v8::String>("y").ToLocalChecked();
-            Nan::Set(mouse_result, y_prop, Nan::New<v8::Number>(eventData.mouse.y));
+    v8::Local<v8::Object> EncodeScroll(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.xdelta(), Nan::New<v8::Number>(data.scroll.xdelta));
+        Nan::Set(payload, keys.ydelta(), Nan::New<v8::Number>(data.scroll.ydelta));
+        Nan::Set(payload, keys.unused(), Nan::New<v8::Number>(data.scroll.unused));
+        Nan::Set(payload, keys.viewportscale(), Nan::New<v8::Number>(data.scroll.viewportscale));
+        return WrapEventData(keys.scroll(), payload);
+    }
 
-            Nan::Set(result, mouse_prop, mouse_result);
+    v8::Local<v8::Object> EncodeTouchPadMove(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.bFingerDown(), Nan::New<v8::Boolean>(data.touchPadMove.bFingerDown));
+        Nan::Set(payload, keys.fSecondsFingerDown(), Nan::New<v8::Number>(data.touchPadMove.flSecondsFingerDown));
+        Nan::Set(payload, keys.fValueXFirst(), Nan::New<v8::Number>(data.touchPadMove.fValueXFirst));
+        Nan::Set(payload, keys.fValueYFirst(), Nan::New<v8::Number>(data.touchPadMove.fValueYFirst));
+        Nan::Set(payload, keys.fValueXRaw(), Nan::New<v8::Number>(data.touchPadMove.fValueXRaw));
+        Nan::Set(payload, keys.fValueYRaw(), Nan::New<v8::Number>(data.touchPadMove.fValueYRaw));
+        return WrapEventData(keys.touchPadMove(), payload);
+    }
 
-            return scope.Escape(result);
-        }
-        default:
-            return scope.Escape(Nan::New<v8::Object>());
+    v8::Local<v8::Object> EncodeNotification(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.ulUserValue(), Uint64BigInt(data.notification.ulUserValue));
+        Nan::Set(payload, keys.notificationId(), Nan::New<v8::Number>(data.notification.notificationId));
+        return WrapEventData(keys.notification(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeProcess(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.pid(), Nan::New<v8::Number>(data.process.pid));
+        Nan::Set(payload, keys.oldPid(), Nan::New<v8::Number>(data.process.oldPid));
+        Nan::Set(payload, keys.bForced(), Nan::New<v8::Boolean>(data.process.bForced));
+        Nan::Set(payload, keys.bConnectionLost(), Nan::New<v8::Boolean>(data.process.bConnectionLost));
+        return WrapEventData(keys.process(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeOverlay(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.overlayHandle(), encode(static_cast<vr::VROverlayHandle_t>(data.overlay.overlayHandle)));
+        Nan::Set(payload, keys.devicePath(), Uint64BigInt(data.overlay.devicePath));
+        Nan::Set(payload, keys.memoryBlockId(), Uint64BigInt(data.overlay.memoryBlockId));
+        return WrapEventData(keys.overlay(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeStatus(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.statusState(), Nan::New<v8::Number>(data.status.statusState));
+        return WrapEventData(keys.status(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeKeyboard(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        const char *pchNewInput = data.keyboard.cNewInput;
+        const size_t unLength = std::find(pchNewInput, pchNewInput + sizeof(data.keyboard.cNewInput), '\0') - pchNewInput;
+
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.cNewInput(), Nan::New<v8::String>(pchNewInput, static_cast<int>(unLength)).ToLocalChecked());
+        Nan::Set(payload, keys.uUserValue(), Uint64BigInt(data.keyboard.uUserValue));
+        return WrapEventData(keys.keyboard(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeIpd(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.ipdMeters(), Nan::New<v8::Number>(data.ipd.ipdMeters));
+        return WrapEventData(keys.ipd(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeChaperone(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.m_nPreviousUniverse(), Uint64BigInt(data.chaperone.m_nPreviousUniverse));
+        Nan::Set(payload, keys.m_nCurrentUniverse(), Uint64BigInt(data.chaperone.m_nCurrentUniverse));
+        return WrapEventData(keys.chaperone(), payload);
+    }
+
+    v8::Local<v8::Object> EncodePerformanceTest(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.m_nFidelityLevel(), Nan::New<v8::Number>(data.performanceTest.m_nFidelityLevel));
+        return WrapEventData(keys.performanceTest(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeSeatedZeroPoseReset(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.bResetBySystemMenu(), Nan::New<v8::Boolean>(data.seatedZeroPoseReset.bResetBySystemMenu));
+        return WrapEventData(keys.seatedZeroPoseReset(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeScreenshot(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.handle(), Nan::New<v8::Number>(data.screenshot.handle));
+        Nan::Set(payload, keys.type(), Nan::New<v8::Number>(data.screenshot.type));
+        return WrapEventData(keys.screenshot(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeScreenshotProgress(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.progress(), Nan::New<v8::Number>(data.screenshotProgress.progress));
+        return WrapEventData(keys.screenshotProgress(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeCameraSurface(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.overlayHandle(), encode(static_cast<vr::VROverlayHandle_t>(data.cameraSurface.overlayHandle)));
+        Nan::Set(payload, keys.nVisualMode(), Nan::New<v8::Number>(data.cameraSurface.nVisualMode));
+        return WrapEventData(keys.cameraSurface(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeMessageOverlay(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.unVRMessageOverlayResponse(), Nan::New<v8::Number>(data.messageOverlay.unVRMessageOverlayResponse));
+        return WrapEventData(keys.messageOverlay(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeApplicationLaunch(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.pid(), Nan::New<v8::Number>(data.applicationLaunch.pid));
+        Nan::Set(payload, keys.unArgsHandle(), Nan::New<v8::Number>(data.applicationLaunch.unArgsHandle));
+        return WrapEventData(keys.applicationLaunch(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeWebConsole(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.webConsoleHandle(), Uint64BigInt(data.webConsole.webConsoleHandle));
+        return WrapEventData(keys.webConsole(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeProperty(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.container(), Uint64BigInt(data.property.container));
+        Nan::Set(payload, keys.prop(), Nan::New<v8::Number>(static_cast<uint32_t>(data.property.prop)));
+        return WrapEventData(keys.property(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeHapticVibration(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.containerHandle(), Uint64BigInt(data.hapticVibration.containerHandle));
+        Nan::Set(payload, keys.componentHandle(), Uint64BigInt(data.hapticVibration.componentHandle));
+        Nan::Set(payload, keys.fDurationSeconds(), Nan::New<v8::Number>(data.hapticVibration.fDurationSeconds));
+        Nan::Set(payload, keys.fFrequency(), Nan::New<v8::Number>(data.hapticVibration.fFrequency));
+        Nan::Set(payload, keys.fAmplitude(), Nan::New<v8::Number>(data.hapticVibration.fAmplitude));
+        return WrapEventData(keys.hapticVibration(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeInputBinding(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.ulAppContainer(), Uint64BigInt(data.inputBinding.ulAppContainer));
+        Nan::Set(payload, keys.pathMessage(), Uint64BigInt(data.inputBinding.pathMessage));
+        Nan::Set(payload, keys.pathUrl(), Uint64BigInt(data.inputBinding.pathUrl));
+        Nan::Set(payload, keys.pathControllerType(), Uint64BigInt(data.inputBinding.pathControllerType));
+        return WrapEventData(keys.inputBinding(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeActionManifest(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.pathAppKey(), Uint64BigInt(data.actionManifest.pathAppKey));
+        Nan::Set(payload, keys.pathMessage(), Uint64BigInt(data.actionManifest.pathMessage));
+        Nan::Set(payload, keys.pathMessageParam(), Uint64BigInt(data.actionManifest.pathMessageParam));
+        Nan::Set(payload, keys.pathManifestPath(), Uint64BigInt(data.actionManifest.pathManifestPath));
+        return WrapEventData(keys.actionManifest(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeSpatialAnchor(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.unHandle(), Nan::New<v8::Number>(data.spatialAnchor.unHandle));
+        return WrapEventData(keys.spatialAnchor(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeProgressUpdate(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.ulApplicationPropertyContainer(), Uint64BigInt(data.progressUpdate.ulApplicationPropertyContainer));
+        Nan::Set(payload, keys.pathDevice(), Uint64BigInt(data.progressUpdate.pathDevice));
+        Nan::Set(payload, keys.pathInputSource(), Uint64BigInt(data.progressUpdate.pathInputSource));
+        Nan::Set(payload, keys.pathProgressAction(), Uint64BigInt(data.progressUpdate.pathProgressAction));
+        Nan::Set(payload, keys.pathIcon(), Uint64BigInt(data.progressUpdate.pathIcon));
+        Nan::Set(payload, keys.fProgress(), Nan::New<v8::Number>(data.progressUpdate.fProgress));
+        return WrapEventData(keys.progressUpdate(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeShowUi(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.eType(), Nan::New<v8::Number>(static_cast<uint32_t>(data.showUi.eType)));
+        return WrapEventData(keys.showUi(), payload);
     }
+
+    v8::Local<v8::Object> EncodeShowDevTools(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.nBrowserIdentifier(), Nan::New<v8::Number>(data.showDevTools.nBrowserIdentifier));
+        return WrapEventData(keys.showDevTools(), payload);
+    }
+
+    v8::Local<v8::Object> EncodeHdcpError(const CodecKeys &keys, const vr::VREvent_Data_t &data)
+    {
+        auto payload = Nan::New<v8::Object>();
+        Nan::Set(payload, keys.eCode(), Nan::New<v8::Number>(static_cast<uint32_t>(data.hdcpError.eCode)));
+        return WrapEventData(keys.hdcpError(), payload);
+    }
+
+    // Covers every EVREventType below the vendor-specific range.
+    constexpr uint32_t k_unEventDataEncoderCount = vr::VREvent_VendorSpecific_Reserved_Start;
+
+    // Which union member each event type carries, as documented in openvr.h.
+    constexpr std::array<EventDataEncoder, k_unEventDataEncoderCount> BuildEventDataEncoders()
+    {
+        std::array<EventDataEncoder, k_unEventDataEncoderCount> table{};
+        auto assign = [&table](std::initializer_list<vr::EVREventType> eventTypes, EventDataEncoder encoder)
+        {
+            for (vr::EVREventType eventType : eventTypes)
+                table[eventType] = encoder;
+        };
+
+        assign({vr::VREvent_ButtonPress, vr::VREvent_ButtonUnpress, vr::VREvent_ButtonTouch, vr::VREvent_ButtonUntouch}, EncodeController);
+        assign({vr::VREvent_MouseMove, vr::VREvent_MouseButtonDown, vr::VREvent_MouseButtonUp}, EncodeMouse);
+        // openvr.h says "data is mouse", but the runtime fills the touchPadMove member.
+        assign({vr::VREvent_TouchPadMove}, EncodeTouchPadMove);
+        assign({vr::VREvent_ScrollDiscrete, vr::VREvent_ScrollSmooth}, EncodeScroll);
+        assign({vr::VREvent_FocusEnter, vr::VREvent_FocusLeave, vr::VREvent_OverlayFocusChanged, vr::VREvent_DashboardRequested}, EncodeOverlay);
+        assign({vr::VREvent_InputFocusCaptured, vr::VREvent_InputFocusReleased, vr::VREvent_SceneApplicationChanged,
+                vr::VREvent_SceneFocusChanged, vr::VREvent_InputFocusChanged, vr::VREvent_SceneApplicationUsingWrongGraphicsAdapter,
+                vr::VREvent_ActionBindingReloaded, vr::VREvent_Quit, vr::VREvent_ProcessQuit, vr::VREvent_QuitAcknowledged,
+                vr::VREvent_Monitor_ShowHeadsetView, vr::VREvent_Monitor_HideHeadsetView},
+               EncodeProcess);
+        assign({vr::VREvent_Notification_Shown, vr::VREvent_Notification_Hidden, vr::VREvent_Notification_BeginInteraction,
+                vr::VREvent_Notification_Destroyed},
+               EncodeNotification);
+        assign({vr::VREvent_IpdChanged}, EncodeIpd);
+        assign({vr::VREvent_PropertyChanged}, EncodeProperty);
+        assign({vr::VREvent_ChaperoneDataHasChanged, vr::VREvent_ChaperoneUniverseHasChanged, vr::VREvent_ChaperoneTempDataHasChanged,
+                vr::VREvent_ChaperoneSettingsHaveChanged},
+               EncodeChaperone);
+        assign({vr::VREvent_SeatedZeroPoseReset}, EncodeSeatedZeroPoseReset);
+        assign({vr::VREvent_StatusUpdate}, EncodeStatus);
+        assign({vr::VREvent_KeyboardClosed, vr::VREvent_KeyboardCharInput, vr::VREvent_KeyboardDone}, EncodeKeyboard);
+        assign({vr::VREvent_ScreenshotTriggered, vr::VREvent_RequestScreenshot, vr::VREvent_ScreenshotTaken, vr::VREvent_ScreenshotFailed,
+                vr::VREvent_SubmitScreenshotToDashboard},
+               EncodeScreenshot);
+        assign({vr::VREvent_ScreenshotProgressToDashboard}, EncodeScreenshotProgress);
+        assign({vr::VREvent_ShowUI}, EncodeShowUi);
+        assign({vr::VREvent_ShowDevTools}, EncodeShowDevTools);
+        assign({vr::VREvent_Compositor_HDCPError}, EncodeHdcpError);
+        assign({vr::VREvent_TrackedCamera_EditingSurface}, EncodeCameraSurface);
+        assign({vr::VREvent_PerformanceTest_FidelityLevel}, EncodePerformanceTest);
+        assign({vr::VREvent_MessageOverlay_Closed}, EncodeMessageOverlay);
+        // unArgsHandle is for IVRApplications::GetApplicationLaunchArguments.
+        assign({vr::VREvent_ApplicationMimeTypeLoad}, EncodeApplicationLaunch);
+        assign({vr::VREvent_ConsoleOpened, vr::VREvent_ConsoleClosed}, EncodeWebConsole);
+        assign({vr::VREvent_Input_HapticVibration}, EncodeHapticVibration);
+        assign({vr::VREvent_Input_BindingLoadFailed, vr::VREvent_Input_BindingLoadSuccessful}, EncodeInputBinding);
+        assign({vr::VREvent_Input_ActionManifestLoadFailed}, EncodeActionManifest);
+        assign({vr::VREvent_Input_ProgressUpdate}, EncodeProgressUpdate);
+        assign({vr::VREvent_SpatialAnchors_PoseUpdated, vr::VREvent_SpatialAnchors_DescriptorUpdated,
+                vr::VREvent_SpatialAnchors_RequestPoseUpdate, vr::VREvent_SpatialAnchors_RequestDescriptorUpdate},
+               EncodeSpatialAnchor);
+
+        return table;
+    }
+
+    constexpr std::array<EventDataEncoder, k_unEventDataEncoderCount> k_eventDataEncoders = BuildEventDataEncoders();
+}
+
+v8::Local<v8::Value> encode(const vr::VREvent_Data_t &eventData, vr::EVREventType eventType)
+{
+    Nan::EscapableHandleScope scope;
+
+    const uint32_t unIndex = static_cast<uint32_t>(eventType);
+    const EventDataEncoder encoder = unIndex < k_unEventDataEncoderCount ? k_eventDataEncoders[unIndex] : nullptr;
+    if (!encoder)
+        return scope.Escape(Nan::New<v8::Object>());
+
+    return scope.Escape(encoder(CodecKeys::Get(v8::Isolate::GetCurrent()), eventData));
 }
 
 //=========================================================
@@ -408,37 +760,74 @@ template <>
 v8::Local<v8::Value> encode(const vr::VREvent_t &value)
 {
     Nan::EscapableHandleScope scope;
-    auto result = Nan::New<v8::Object>();
+    const CodecKeys &keys = CodecKeys::Get(v8::Isolate::GetCurrent());
+    auto result = keys.NewEvent();
 
-    auto eventType_prop = Nan::New<v8::String>("eventType").ToLocalChecked();
+    auto eventType_prop = keys.eventType();
     Nan::Set(result, eventType_prop, Nan::New<v8::Number>(value.eventType));
 
-    auto trackedDeviceIndex_prop = Nan::New<v8::String>("trackedDeviceIndex").ToLocalChecked();
+    auto trackedDeviceIndex_prop = keys.trackedDeviceIndex();
     Nan::Set(result, trackedDeviceIndex_prop, Nan::New<v8::Number>(value.trackedDeviceIndex));
 
-    auto eventAgeSeconds_prop = Nan::New<v8::String>("eventAgeSeconds").ToLocalChecked();
+    auto eventAgeSeconds_prop = keys.eventAgeSeconds();
     Nan::Set(result, eventAgeSeconds_prop, Nan::New<v8::Number>(value.eventAgeSeconds));
 
-    auto data_prop = Nan::New<v8::String>("data").ToLocalChecked();
+    auto data_prop = keys.data();
     Nan::Set(result, data_prop, encode(value.data, static_cast<vr::EVREventType>(value.eventType)));
 
     return scope.Escape(result);
 }
 
+//=========================================================
+void encode(const vr::VREvent_t &value, uint8_t *pRecord)
+{
+    const uint32_t reserved = 0;
+    std::memcpy(pRecord + 0, &value.eventType, sizeof(uint32_t));
+    std::memcpy(pRecord + 4, &value.trackedDeviceIndex, sizeof(uint32_t));
+    std::memcpy(pRecord + 8, &value.eventAgeSeconds, sizeof(float));
+    std::memcpy(pRecord + 12, &reserved, sizeof(uint32_t));
+    std::memcpy(pRecord + k_unVREventRecordDataOffset, &value.data, sizeof(vr::VREvent_Data_t));
+    std::memset(pRecord + k_unVREventRecordDataOffset + sizeof(vr::VREvent_Data_t), 0,
+                k_unVREventRecordSize - k_unVREventRecordDataOffset - sizeof(vr::VREvent_Data_t));
+}
+
+//=========================================================
+bool GetBufferContents(const v8::Local<v8::Value> value, uint8_t **ppData, size_t *punSize)
+{
+    if (value->IsArrayBufferView())
+    {
+        auto view = value.As<v8::ArrayBufferView>();
+        *ppData = static_cast<uint8_t *>(view->Buffer()->GetBackingStore()->Data()) + view->ByteOffset();
+        *punSize = view->ByteLength();
+        return true;
+    }
+
+    if (value->IsArrayBuffer())
+    {
+        auto buffer = value.As<v8::ArrayBuffer>();
+        *ppData = static_cast<uint8_t *>(buffer->GetBackingStore()->Data());
+        *punSize = buffer->ByteLength();
+        return true;
+    }
+
+    return false;
+}
+
 //=========================================================
 template<>
 vr::VROverlayIntersectionParams_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate)
 {
+    const CodecKeys &keys = CodecKeys::Get(isolate);
     vr::VROverlayIntersectionParams_t result;
     const auto object = value->ToObject(isolate->GetCurrentContext()).ToLocalChecked();
 
-    auto eOrigin_prop = Nan::New<v8::String>("eOrigin").ToLocalChecked();
+    auto eOrigin_prop = keys.eOrigin();
     result.eOrigin = static_cast<vr::ETrackingUniverseOrigin>(Nan::Get(object, eOrigin_prop).ToLocalChecked()->Uint32Value(isolate->GetCurrentContext()).FromJust());
 
-    auto vDirection_prop = Nan::New<v8::String>("vDirection").ToLocalChecked();
+    auto vDirection_prop = keys.vDirection();
     result.vDirection = decode<vr::HmdVector3_t>(Nan::Get(object, vDirection_prop).ToLocalChecked(), isolate);
 
-    auto vSource_prop = Nan::New<v8::String>("vSource").ToLocalChecked();
+    auto vSource_prop = keys.vSource();
     result.vSource = decode<vr::HmdVector3_t>(Nan::Get(object, vSource_prop).ToLocalChecked(), isolate);
 
     return result;
@@ -448,19 +837,20 @@ vr::VROverlayIntersectionParams_t decode(const v8::Local<v8::Value> value, v8::I
 template<>
 vr::VROverlayIntersectionResults_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate)
 {
+    const CodecKeys &keys = CodecKeys::Get(isolate);
     vr::VROverlayIntersectionResults_t result;
     const auto object = value->ToObject(isolate->GetCurrentContext()).ToLocalChecked();
 
-    auto fDistance_prop = Nan::New<v8::String>("fDistance").ToLocalChecked();
+    auto fDistance_prop = keys.fDistance();
     result.fDistance = Nan::Get(object, fDistance_prop).ToLocalChecked()->NumberValue(isolate->GetCurrentContext()).FromJust();
 
-    auto vNormal_prop = Nan::New<v8::String>("vNormal").ToLocalChecked();
+    auto vNormal_prop = keys.vNormal();
     result.vNormal = decode<vr::HmdVector3_t>(Nan::Get(object, vNormal_prop).ToLocalChecked(), isolate);
 
-    auto vPoint_prop = Nan::New<v8::String>("vPoint").ToLocalChecked();
+    auto vPoint_prop = keys.vPoint();
     result.vPoint = decode<vr::HmdVector3_t>(Nan::Get(object, vPoint_prop).ToLocalChecked(), isolate);
 
-    auto vUVs_prop = Nan::New<v8::String>("vUVs").ToLocalChecked();
+    auto vUVs_prop = keys.vUVs();
     result.vUVs = decode<vr::HmdVector2_t>(Nan::Get(object, vUVs_prop).ToLocalChecked(), isolate);
 
     return result;
@@ -470,16 +860,17 @@ vr::VROverlayIntersectionResults_t decode(const v8::Local<v8::Value> value, v8::
 template<>
 vr::Texture_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate)
 {
+    const CodecKeys &keys = CodecKeys::Get(isolate);
     vr::Texture_t result;
     const auto object = value->ToObject(isolate->GetCurrentContext()).ToLocalChecked();
 
-    auto eType_prop = Nan::New<v8::String>("eType").ToLocalChecked();
+    auto eType_prop = keys.eType();
     result.eType = static_cast<vr::ETextureType>(Nan::Get(object, eType_prop).ToLocalChecked()->Int32Value(isolate->GetCurrentContext()).FromJust());
 
-    auto handle_prop = Nan::New<v8::String>("handle").ToLocalChecked();
+    auto handle_prop = keys.handle();
     result.handle = (void*)(uintptr_t)(Nan::Get(object, handle_prop).ToLocalChecked()->Uint32Value(isolate->GetCurrentContext()).FromJust());
 
-    auto eColorSpace_prop = Nan::New<v8::String>("eColorSpace").ToLocalChecked();
+    auto eColorSpace_prop = keys.eColorSpace();
     result.eColorSpace = static_cast<vr::EColorSpace>(Nan::Get(object, eColorSpace_prop).ToLocalChecked()->Uint32Value(isolate->GetCurrentContext()).FromJust());
 
     return result;
@@ -489,29 +880,71 @@ vr::Texture_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate)
 template<>
 vr::HmdRect2_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate)
 {
+    const CodecKeys &keys = CodecKeys::Get(isolate);
     vr::HmdRect2_t result;
     const auto object = value->ToObject(isolate->GetCurrentContext()).ToLocalChecked();
 
-    auto vBottomRight_prop = Nan::New<v8::String>("vBottomRight").ToLocalChecked();
+    auto vBottomRight_prop = keys.vBottomRight();
     result.vBottomRight = decode<vr::HmdVector2_t>(Nan::Get(object, vBottomRight_prop).ToLocalChecked(), isolate);
 
-    auto vTopLeft_prop = Nan::New<v8::String>("vTopLeft").ToLocalChecked();
+    auto vTopLeft_prop = keys.vTopLeft();
     result.vTopLeft = decode<vr::HmdVector2_t>(Nan::Get(object, vTopLeft_prop).ToLocalChecked(), isolate);
 
     return result;
 }
 
+//=========================================================
+bool IsOverlayHandle(const v8::Local<v8::Value> value)
+{
+    if (value->IsBigInt())
+    {
+        bool bLossless;
+        value.As<v8::BigInt>()->Uint64Value(&bLossless);
+        return bLossless;
+    }
+
+    // Past 2^53 a Number no longer holds every integer, so it cannot be
+    // trusted to name the handle it was meant to.
+    if (value->IsNumber())
+    {
+        const double fValue = value.As<v8::Number>()->Value();
+        return std::isfinite(fValue) && fValue >= 0.0 && fValue <= 9007199254740991.0 && std::trunc(fValue) == fValue;
+    }
+
+    return value->IsObject();
+}
+
+//=========================================================
+bool DecodeOverlayHandle(const v8::Local<v8::Value> value, v8::Isolate *isolate, vr::VROverlayHandle_t *pHandle)
+{
+    const bool bValid = IsOverlayHandle(value);
+    *pHandle = decode<vr::VROverlayHandle_t>(value, isolate);
+    return bValid;
+}
+
 //=========================================================
 template<>
 vr::VROverlayHandle_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate)
 {
-    vr::VROverlayHandle_t result;
+    if (!IsOverlayHandle(value))
+    {
+        Nan::ThrowTypeError("Overlay handles must be a BigInt, a non-negative integer no greater than Number.MAX_SAFE_INTEGER or { DownBits, UpBits }.");
+        return vr::k_ulOverlayHandleInvalid;
+    }
+
+    if (value->IsBigInt())
+        return static_cast<vr::VROverlayHandle_t>(value.As<v8::BigInt>()->Uint64Value());
+
+    if (value->IsNumber())
+        return static_cast<vr::VROverlayHandle_t>(value.As<v8::Number>()->Value());
+
+    const CodecKeys &keys = CodecKeys::Get(isolate);
     const auto object = value->ToObject(isolate->GetCurrentContext()).ToLocalChecked();
 
-    auto DownBits_prop = Nan::New("DownBits").ToLocalChecked();
+    auto DownBits_prop = keys.DownBits();
     uint32_t DownBits = Nan::Get(object, DownBits_prop).ToLocalChecked()->Uint32Value(isolate->GetCurrentContext()).FromJust();
 
-    auto UpBits_prop = Nan::New("UpBits").ToLocalChecked();
+    auto UpBits_prop = keys.UpBits();
     uint32_t UpBits = Nan::Get(object, UpBits_prop).ToLocalChecked()->Uint32Value(isolate->GetCurrentContext()).FromJust();
 
     return static_cast<vr::VROverlayHandle_t>((uint64_t) UpBits << 32 | DownBits);
@@ -520,17 +953,7 @@ vr::VROverlayHandle_t decode(const v8::Local<v8::Value> value, v8::Isolate *isol
 template<>
 v8::Local<v8::Value> encode(const vr::VROverlayHandle_t &value)
 {
-    Nan::EscapableHandleScope scope;
-    auto result = Nan::New<v8::Object>();
-    uint64_t mask = (uint64_t) 1 << 32; 
-
-    auto DownBits_prop = Nan::New<v8::String>("DownBits").ToLocalChecked();
-    Nan::Set(result, DownBits_prop, Nan::New<v8::Number>(value % mask));
-
-    auto UpBits_prop = Nan::New<v8::String>("UpBits").ToLocalChecked();
-    Nan::Set(result, UpBits_prop, Nan::New<v8::Number>(value >> 32));
-
-    return scope.Escape(result);
+    return v8::BigInt::NewFromUnsigned(v8::Isolate::GetCurrent(), value);
 }
 
 //=========================================================
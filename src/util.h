@@ -11,6 +11,86 @@
 using TrackedDevicePoseArray = std::array<vr::TrackedDevicePose_t, vr::k_unMaxTrackedDeviceCount>;
 using TrackedDeviceIndexArray = std::array<vr::TrackedDeviceIndex_t, vr::k_unMaxTrackedDeviceCount>;
 
+//=========================================================
+// Property names of the VREvent_Data_t members and their fields.
+#define UTIL_EVENT_DATA_KEYS(X)                                                                   \
+    X(scroll) X(xdelta) X(ydelta) X(unused) X(viewportscale)                                     \
+    X(touchPadMove) X(bFingerDown) X(fSecondsFingerDown)                                          \
+    X(fValueXFirst) X(fValueYFirst) X(fValueXRaw) X(fValueYRaw)                                   \
+    X(notification) X(ulUserValue) X(notificationId)                                              \
+    X(process) X(pid) X(oldPid) X(bForced) X(bConnectionLost)                                     \
+    X(overlay) X(overlayHandle) X(devicePath) X(memoryBlockId)                                    \
+    X(status) X(statusState)                                                                      \
+    X(keyboard) X(cNewInput) X(uUserValue)                                                        \
+    X(ipd) X(ipdMeters)                                                                           \
+    X(chaperone) X(m_nPreviousUniverse) X(m_nCurrentUniverse)                                     \
+    X(performanceTest) X(m_nFidelityLevel)                                                        \
+    X(seatedZeroPoseReset) X(bResetBySystemMenu)                                                  \
+    X(screenshot) X(type)                                                                         \
+    X(screenshotProgress) X(progress)                                                             \
+    X(cameraSurface) X(nVisualMode)                                                               \
+    X(messageOverlay) X(unVRMessageOverlayResponse)                                               \
+    X(applicationLaunch) X(unArgsHandle) X(webConsole) X(webConsoleHandle)                        \
+    X(property) X(container) X(prop)                                                              \
+    X(hapticVibration) X(containerHandle) X(componentHandle)                                      \
+    X(fDurationSeconds) X(fFrequency) X(fAmplitude)                                               \
+    X(inputBinding) X(ulAppContainer) X(pathMessage) X(pathUrl) X(pathControllerType)             \
+    X(actionManifest) X(pathAppKey) X(pathMessageParam) X(pathManifestPath)                       \
+    X(spatialAnchor) X(unHandle)                                                                  \
+    X(progressUpdate) X(ulApplicationPropertyContainer) X(pathDevice) X(pathInputSource)          \
+    X(pathProgressAction) X(pathIcon) X(fProgress)                                                \
+    X(showUi) X(showDevTools) X(nBrowserIdentifier)                                               \
+    X(hdcpError) X(eCode)
+
+// Property names used by the codecs below.
+#define UTIL_CODEC_KEYS(X)                                                           \
+    X(red) X(green) X(blue)                                                          \
+    X(deviceToAbsoluteTracking) X(velocity) X(angularVelocity)                       \
+    X(trackingResult) X(poseIsValid) X(deviceIsConnected)                            \
+    X(uMin) X(uMax) X(vMin) X(vMax)                                                  \
+    X(fBottom) X(fLeft) X(fRight) X(fTop)                                            \
+    X(eventType) X(trackedDeviceIndex) X(eventAgeSeconds) X(data)                    \
+    X(controller) X(mouse) X(button) X(x) X(y)                                       \
+    X(eOrigin) X(vDirection) X(vSource) X(fDistance) X(vNormal) X(vPoint) X(vUVs)    \
+    X(eType) X(handle) X(eColorSpace) X(vBottomRight) X(vTopLeft)                    \
+    X(DownBits) X(UpBits)                                                            \
+    X(alpha) X(color) X(Red) X(Green) X(Blue) X(widthInMeters) X(curvature)          \
+    X(sortOrder) X(texelAspect) X(textureBounds) X(transform) X(trackingOrigin)      \
+    X(visible) X(keyframes) X(time) X(easing) X(loop)                                \
+    X(mode) X(device) X(yawOnly) X(smoothTime) X(deadZoneDistance) X(deadZoneAngle)  \
+    UTIL_EVENT_DATA_KEYS(X)
+
+// Internalized key strings and result object templates, built once per isolate.
+// Objects created from the templates always start with the same properties in the
+// same order, so every pose/event/bounds result shares one hidden class.
+class CodecKeys
+{
+public:
+    static const CodecKeys &Get(v8::Isolate *isolate);
+
+#define UTIL_CODEC_KEY_ACCESSOR(name) \
+    v8::Local<v8::String> name() const { return name##_.Get(isolate_); }
+    UTIL_CODEC_KEYS(UTIL_CODEC_KEY_ACCESSOR)
+#undef UTIL_CODEC_KEY_ACCESSOR
+
+    v8::Local<v8::Object> NewPose() const;
+    v8::Local<v8::Object> NewEvent() const;
+    v8::Local<v8::Object> NewBounds() const;
+
+private:
+    explicit CodecKeys(v8::Isolate *isolate);
+
+    v8::Isolate *isolate_;
+
+#define UTIL_CODEC_KEY_FIELD(name) v8::Eternal<v8::String> name##_;
+    UTIL_CODEC_KEYS(UTIL_CODEC_KEY_FIELD)
+#undef UTIL_CODEC_KEY_FIELD
+
+    v8::Eternal<v8::ObjectTemplate> poseShape_;
+    v8::Eternal<v8::ObjectTemplate> eventShape_;
+    v8::Eternal<v8::ObjectTemplate> boundsShape_;
+};
+
 //=========================================================
 // C++ -> Node
 template <typename T>
@@ -72,6 +152,19 @@ v8::Local<v8::Value> encode(const TrackedDeviceIndexArray &value);
 template <>
 v8::Local<v8::Value> encode(const TrackedDevicePoseArray &value);
 
+//=========================================================
+// Flat pose layout shared by the typed-array overloads. Per device:
+//   floats [0..11]  mDeviceToAbsoluteTracking, row-major
+//   floats [12..14] vVelocity
+//   floats [15..17] vAngularVelocity
+//   states [0]      bPoseIsValid
+//   states [1]      bDeviceIsConnected
+//   states [2], [3] eTrackingResult / 100, eTrackingResult % 100
+constexpr uint32_t k_unTrackedDevicePoseFloatStride = 18;
+constexpr uint32_t k_unTrackedDevicePoseStateStride = 4;
+
+void encode(const vr::TrackedDevicePose_t &value, float *pfPose, uint8_t *punState);
+
 //=========================================================
 template<>
 vr::VRTextureBounds_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate);
@@ -85,13 +178,31 @@ template<>
 vr::VROverlayProjection_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate);
 
 //=========================================================
-template <typename T>
-v8::Local<v8::Value> encode(const T &eventData, vr::EVREventType eventType);
+// Encodes the union member that eventType carries, through a table indexed by
+// event type. Types without a payload encode as an empty object.
+v8::Local<v8::Value> encode(const vr::VREvent_Data_t &eventData, vr::EVREventType eventType);
 
 //=========================================================
 template <>
 v8::Local<v8::Value> encode(const vr::VREvent_t &value);
 
+//=========================================================
+// Fixed-size event record written by the batched PollNext*Events calls:
+//   bytes [0..3]   eventType, uint32
+//   bytes [4..7]   trackedDeviceIndex, uint32
+//   bytes [8..11]  eventAgeSeconds, float32
+//   bytes [12..15] reserved, zero
+//   bytes [16..63] data, the raw VREvent_Data_t union
+constexpr uint32_t k_unVREventRecordDataOffset = 16;
+constexpr uint32_t k_unVREventRecordSize = 64;
+static_assert(k_unVREventRecordDataOffset + sizeof(vr::VREvent_Data_t) <= k_unVREventRecordSize, "VREvent_Data_t does not fit the event record");
+
+void encode(const vr::VREvent_t &value, uint8_t *pRecord);
+
+//=========================================================
+// Bytes behind an ArrayBuffer or ArrayBufferView. Returns false for anything else.
+bool GetBufferContents(const v8::Local<v8::Value> value, uint8_t **ppData, size_t *punSize);
+
 //=========================================================
 template<>
 vr::VROverlayIntersectionParams_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate);
@@ -109,9 +220,17 @@ template<>
 vr::HmdRect2_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate);
 
 //=========================================================
+// Overlay handles travel as BigInts. Decoding also accepts a Number holding a
+// non-negative safe integer and the older { DownBits, UpBits } object; anything
+// else throws a TypeError and decodes to k_ulOverlayHandleInvalid.
 template<>
 vr::VROverlayHandle_t decode(const v8::Local<v8::Value> value, v8::Isolate *isolate);
 
+bool IsOverlayHandle(const v8::Local<v8::Value> value);
+
+// Decodes as above, returning false once the TypeError is thrown.
+bool DecodeOverlayHandle(const v8::Local<v8::Value> value, v8::Isolate *isolate, vr::VROverlayHandle_t *pHandle);
+
 //=========================================================
 template<>
 v8::Local<v8::Value> encode(const vr::VROverlayHandle_t &value);
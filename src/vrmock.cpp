@@ -0,0 +1,425 @@
+#include "vrmock.h"
+#include "overlayfingerprint.h"
+#include "util.h"
+
+#include <openvr_mock.h>
+
+#include <cstring>
+#include <string>
+
+using namespace v8;
+
+namespace
+{
+    // Copies an optional ArrayBufferView into the event's data union.
+    bool ReadEventData(Local<Value> value, vr::VREvent_Data_t *pData)
+    {
+        std::memset(pData, 0, sizeof(vr::VREvent_Data_t));
+        if (value->IsUndefined())
+            return true;
+        if (!value->IsArrayBufferView())
+            return false;
+
+        Nan::TypedArrayContents<uint8_t> bytes(value);
+        std::memcpy(pData, *bytes, std::min<size_t>(bytes.length(), sizeof(vr::VREvent_Data_t)));
+        return true;
+    }
+
+    uint64_t ReadUint64(Local<Value> value, Local<Context> context)
+    {
+        if (value->IsBigInt())
+            return value.As<BigInt>()->Uint64Value();
+        return static_cast<uint64_t>(value->NumberValue(context).FromMaybe(0));
+    }
+}
+
+void VRMock::Init(Local<Object> exports)
+{
+    Local<Context> context = exports->CreationContext();
+    Nan::HandleScope scope;
+
+    Local<Object> mock = Nan::New<Object>();
+    Nan::SetMethod(mock, "Reset", Reset);
+    Nan::SetMethod(mock, "SetCallLatency", SetCallLatency);
+    Nan::SetMethod(mock, "SetInitError", SetInitError);
+    Nan::SetMethod(mock, "SetHmdPresent", SetHmdPresent);
+    Nan::SetMethod(mock, "SetDisplayFrequency", SetDisplayFrequency);
+    Nan::SetMethod(mock, "SetDevice", SetDevice);
+    Nan::SetMethod(mock, "SetDevicePose", SetDevicePose);
+    Nan::SetMethod(mock, "SetDeviceProperty", SetDeviceProperty);
+    Nan::SetMethod(mock, "SetControllerState", SetControllerState);
+    Nan::SetMethod(mock, "QueueEvent", QueueEvent);
+    Nan::SetMethod(mock, "QueueOverlayEvent", QueueOverlayEvent);
+    Nan::SetMethod(mock, "CreateForeignOverlay", CreateForeignOverlay);
+    Nan::SetMethod(mock, "GetStats", GetStats);
+    Nan::SetMethod(mock, "HashOverlayTiles", HashOverlayTiles);
+
+    exports->Set(context, Nan::New("VRMock").ToLocalChecked(), mock).FromJust();
+}
+
+void VRMock::Reset(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    vrmock::Reset();
+}
+
+void VRMock::SetCallLatency(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a number of microseconds.");
+        return;
+    }
+
+    vrmock::SetCallLatency(info[0]->Uint32Value(info.GetIsolate()->GetCurrentContext()).FromJust());
+}
+
+void VRMock::SetInitError(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be an EVRInitError.");
+        return;
+    }
+
+    uint32_t nError = info[0]->Uint32Value(info.GetIsolate()->GetCurrentContext()).FromJust();
+    vrmock::SetInitError(static_cast<vr::EVRInitError>(nError));
+}
+
+void VRMock::SetHmdPresent(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    vrmock::SetHmdPresent(info[0]->BooleanValue(info.GetIsolate()));
+}
+
+void VRMock::SetDisplayFrequency(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (!info[0]->IsNumber())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a number.");
+        return;
+    }
+
+    vrmock::SetDisplayFrequency(static_cast<float>(info[0]->NumberValue(info.GetIsolate()->GetCurrentContext()).FromJust()));
+}
+
+void VRMock::SetDevice(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+
+    if (info.Length() != 4)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a tracked device index.");
+        return;
+    }
+
+    vr::TrackedDeviceIndex_t unDeviceIndex = info[0]->Uint32Value(context).FromJust();
+    vr::ETrackedDeviceClass eClass = static_cast<vr::ETrackedDeviceClass>(info[1]->Uint32Value(context).FromJust());
+    vr::ETrackedControllerRole eRole = static_cast<vr::ETrackedControllerRole>(info[2]->Uint32Value(context).FromJust());
+    bool bConnected = info[3]->BooleanValue(info.GetIsolate());
+    vrmock::SetDevice(unDeviceIndex, eClass, eRole, bConnected);
+}
+
+void VRMock::SetDevicePose(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (info.Length() != 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a tracked device index.");
+        return;
+    }
+
+    if (!info[1]->IsObject())
+    {
+        Nan::ThrowTypeError("Argument[1] must be a tracked device pose.");
+        return;
+    }
+
+    vr::TrackedDeviceIndex_t unDeviceIndex = info[0]->Uint32Value(info.GetIsolate()->GetCurrentContext()).FromJust();
+    vrmock::SetDevicePose(unDeviceIndex, decode<vr::TrackedDevicePose_t>(info[1], info.GetIsolate()));
+}
+
+void VRMock::SetDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+
+    if (info.Length() != 4)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a tracked device index.");
+        return;
+    }
+
+    vr::TrackedDeviceIndex_t unDeviceIndex = info[0]->Uint32Value(context).FromJust();
+    vr::ETrackedDeviceProperty prop = static_cast<vr::ETrackedDeviceProperty>(info[1]->Uint32Value(context).FromJust());
+    vr::PropertyTypeTag_t unTag = info[2]->Uint32Value(context).FromJust();
+    Local<Value> value = info[3];
+
+    if (value->IsArrayBufferView())
+    {
+        Nan::TypedArrayContents<uint8_t> bytes(value);
+        vrmock::SetDeviceProperty(unDeviceIndex, prop, unTag, *bytes, static_cast<uint32_t>(bytes.length()));
+        return;
+    }
+
+    switch (unTag)
+    {
+    case vr::k_unBoolPropertyTag:
+    {
+        bool bValue = value->BooleanValue(info.GetIsolate());
+        vrmock::SetDeviceProperty(unDeviceIndex, prop, unTag, &bValue, sizeof(bValue));
+        break;
+    }
+    case vr::k_unFloatPropertyTag:
+    {
+        float fValue = static_cast<float>(value->NumberValue(context).FromJust());
+        vrmock::SetDeviceProperty(unDeviceIndex, prop, unTag, &fValue, sizeof(fValue));
+        break;
+    }
+    case vr::k_unDoublePropertyTag:
+    {
+        double dValue = value->NumberValue(context).FromJust();
+        vrmock::SetDeviceProperty(unDeviceIndex, prop, unTag, &dValue, sizeof(dValue));
+        break;
+    }
+    case vr::k_unInt32PropertyTag:
+    {
+        int32_t nValue = value->Int32Value(context).FromJust();
+        vrmock::SetDeviceProperty(unDeviceIndex, prop, unTag, &nValue, sizeof(nValue));
+        break;
+    }
+    case vr::k_unUint64PropertyTag:
+    {
+        uint64_t ulValue = ReadUint64(value, context);
+        vrmock::SetDeviceProperty(unDeviceIndex, prop, unTag, &ulValue, sizeof(ulValue));
+        break;
+    }
+    case vr::k_unStringPropertyTag:
+    {
+        std::string sValue = *Nan::Utf8String(value);
+        vrmock::SetDeviceProperty(unDeviceIndex, prop, unTag, sValue.c_str(), static_cast<uint32_t>(sValue.size() + 1));
+        break;
+    }
+    case vr::k_unHmdMatrix34PropertyTag:
+    {
+        vr::HmdMatrix34_t matrix = decode<vr::HmdMatrix34_t>(value, info.GetIsolate());
+        vrmock::SetDeviceProperty(unDeviceIndex, prop, unTag, &matrix, sizeof(matrix));
+        break;
+    }
+    default:
+        Nan::ThrowTypeError("Argument[3] must be an ArrayBufferView for this property type.");
+        return;
+    }
+}
+
+void VRMock::SetControllerState(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+
+    if (info.Length() != 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[0] must be a tracked device index.");
+        return;
+    }
+
+    if (!info[1]->IsObject())
+    {
+        Nan::ThrowTypeError("Argument[1] must be a controller state.");
+        return;
+    }
+
+    vr::TrackedDeviceIndex_t unDeviceIndex = info[0]->Uint32Value(context).FromJust();
+    Local<Object> object = info[1]->ToObject(context).ToLocalChecked();
+    vr::VRControllerState_t state = {};
+
+    Local<String> packetNum_prop = Nan::New<String>("packetNum").ToLocalChecked();
+    state.unPacketNum = Nan::Get(object, packetNum_prop).ToLocalChecked()->Uint32Value(context).FromMaybe(0);
+
+    Local<String> buttonPressed_prop = Nan::New<String>("buttonPressed").ToLocalChecked();
+    state.ulButtonPressed = ReadUint64(Nan::Get(object, buttonPressed_prop).ToLocalChecked(), context);
+
+    Local<String> buttonTouched_prop = Nan::New<String>("buttonTouched").ToLocalChecked();
+    state.ulButtonTouched = ReadUint64(Nan::Get(object, buttonTouched_prop).ToLocalChecked(), context);
+
+    Local<String> axis_prop = Nan::New<String>("axis").ToLocalChecked();
+    Local<Value> axis = Nan::Get(object, axis_prop).ToLocalChecked();
+    if (axis->IsArray())
+    {
+        Local<Array> axes = axis.As<Array>();
+        for (uint32_t idx = 0; idx < std::min<uint32_t>(axes->Length(), vr::k_unControllerStateAxisCount); ++idx)
+        {
+            vr::HmdVector2_t vec = decode<vr::HmdVector2_t>(Nan::Get(axes, idx).ToLocalChecked(), info.GetIsolate());
+            state.rAxis[idx].x = vec.v[0];
+            state.rAxis[idx].y = vec.v[1];
+        }
+    }
+
+    vrmock::SetControllerState(unDeviceIndex, state);
+}
+
+void VRMock::QueueEvent(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+
+    if (info.Length() < 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[1]->IsUint32())
+    {
+        Nan::ThrowTypeError("Argument[1] must be a tracked device index.");
+        return;
+    }
+
+    vr::VREvent_t event = {};
+    event.eventType = info[0]->Uint32Value(context).FromJust();
+    event.trackedDeviceIndex = info[1]->Uint32Value(context).FromJust();
+    if (!ReadEventData(info[2], &event.data))
+    {
+        Nan::ThrowTypeError("Argument[2] must be an ArrayBufferView holding VREvent_Data_t.");
+        return;
+    }
+
+    vrmock::QueueEvent(event);
+}
+
+void VRMock::QueueOverlayEvent(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Local<Context> context = info.GetIsolate()->GetCurrentContext();
+
+    if (info.Length() < 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    vr::VROverlayHandle_t ulOverlayHandle;
+    if (!DecodeOverlayHandle(info[0], info.GetIsolate(), &ulOverlayHandle))
+        return;
+    vr::VREvent_t event = {};
+    event.eventType = info[1]->Uint32Value(context).FromJust();
+    event.trackedDeviceIndex = vr::k_unTrackedDeviceIndex_Hmd;
+    if (!ReadEventData(info[2], &event.data))
+    {
+        Nan::ThrowTypeError("Argument[2] must be an ArrayBufferView holding VREvent_Data_t.");
+        return;
+    }
+
+    info.GetReturnValue().Set(Nan::New<Boolean>(vrmock::QueueOverlayEvent(ulOverlayHandle, event)));
+}
+
+void VRMock::CreateForeignOverlay(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    if (info.Length() != 2)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    std::string sOverlayKey = *Nan::Utf8String(info[0]);
+    std::string sOverlayName = *Nan::Utf8String(info[1]);
+    vr::VROverlayHandle_t ulOverlayHandle = vrmock::CreateForeignOverlay(sOverlayKey.c_str(), sOverlayName.c_str());
+
+    if (ulOverlayHandle == vr::k_ulOverlayHandleInvalid)
+    {
+        Nan::ThrowError("Overlay key is invalid or already in use.");
+        return;
+    }
+
+    info.GetReturnValue().Set(encode(ulOverlayHandle));
+}
+
+void VRMock::GetStats(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    vrmock::Stats stats = vrmock::GetStats();
+
+    Local<Object> result = Nan::New<Object>();
+    {
+        Local<String> calls_prop = Nan::New<String>("calls").ToLocalChecked();
+        Nan::Set(result, calls_prop, Nan::New<Number>(static_cast<double>(stats.calls)));
+
+        Local<String> overlayUploads_prop = Nan::New<String>("overlayUploads").ToLocalChecked();
+        Nan::Set(result, overlayUploads_prop, Nan::New<Number>(static_cast<double>(stats.overlayUploads)));
+
+        Local<String> overlayUploadBytes_prop = Nan::New<String>("overlayUploadBytes").ToLocalChecked();
+        Nan::Set(result, overlayUploadBytes_prop, Nan::New<Number>(static_cast<double>(stats.overlayUploadBytes)));
+
+        Local<String> overlayFileLoads_prop = Nan::New<String>("overlayFileLoads").ToLocalChecked();
+        Nan::Set(result, overlayFileLoads_prop, Nan::New<Number>(static_cast<double>(stats.overlayFileLoads)));
+
+        Local<String> overlays_prop = Nan::New<String>("overlays").ToLocalChecked();
+        Nan::Set(result, overlays_prop, Nan::New<Number>(stats.overlays));
+    }
+
+    info.GetReturnValue().Set(result);
+}
+
+// HashOverlayTiles( data: ArrayBufferView, unWidth, unHeight, unBytesPerPixel ): { [instructionSet: string]: BigUint64Array }
+void VRMock::HashOverlayTiles(const Nan::FunctionCallbackInfo<Value> &info)
+{
+    Isolate *isolate = info.GetIsolate();
+
+    if (info.Length() != 4)
+    {
+        Nan::ThrowError("Wrong number of arguments.");
+        return;
+    }
+
+    if (!info[0]->IsArrayBufferView())
+    {
+        Nan::ThrowTypeError("Argument[0] must be an ArrayBufferView.");
+        return;
+    }
+
+    if (!info[1]->IsUint32() || !info[2]->IsUint32() || !info[3]->IsUint32())
+    {
+        Nan::ThrowTypeError("Width, height and bytes per pixel must be unsigned integers.");
+        return;
+    }
+
+    const uint32_t unWidth = info[1].As<Uint32>()->Value();
+    const uint32_t unHeight = info[2].As<Uint32>()->Value();
+    const uint32_t unBytesPerPixel = info[3].As<Uint32>()->Value();
+    Nan::TypedArrayContents<uint8_t> bytes(info[0]);
+    if (bytes.length() < static_cast<size_t>(unWidth) * unHeight * unBytesPerPixel)
+    {
+        Nan::ThrowRangeError("Argument[0] is smaller than width * height * bytes per pixel.");
+        return;
+    }
+
+    Local<Object> result = Nan::New<Object>();
+    for (const std::string &instructionSet : OverlayFingerprint::InstructionSets())
+    {
+        OverlayFingerprint::Frame frame;
+        OverlayFingerprint::Compute(instructionSet, *bytes, unWidth, unHeight, unBytesPerPixel, &frame);
+
+        const size_t unSize = frame.tiles.size() * sizeof(uint64_t);
+        Local<ArrayBuffer> buffer = ArrayBuffer::New(isolate, unSize);
+        std::memcpy(buffer->GetBackingStore()->Data(), frame.tiles.data(), unSize);
+        Nan::Set(result, Nan::New(instructionSet).ToLocalChecked(), BigUint64Array::New(buffer, 0, frame.tiles.size()));
+    }
+
+    info.GetReturnValue().Set(result);
+}
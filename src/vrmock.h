@@ -0,0 +1,46 @@
+#ifndef VRMOCK_H_JS
+#define VRMOCK_H_JS
+
+#include <nan.h>
+#include <v8.h>
+
+using namespace v8;
+
+/// Scripting hooks for the in-process mock runtime (see mock/openvr_mock.h).
+/// Only compiled into `--openvr_mock=1` builds, where they are exported as
+/// the `VRMock` object.
+namespace VRMock
+{
+    void Init(Local<Object> exports);
+
+    /// void vrmock::Reset();
+    void Reset(const Nan::FunctionCallbackInfo<Value> &info);
+    /// void vrmock::SetCallLatency( uint32_t unMicroseconds );
+    void SetCallLatency(const Nan::FunctionCallbackInfo<Value> &info);
+    /// void vrmock::SetInitError( vr::EVRInitError eError );
+    void SetInitError(const Nan::FunctionCallbackInfo<Value> &info);
+    /// void vrmock::SetHmdPresent( bool bPresent );
+    void SetHmdPresent(const Nan::FunctionCallbackInfo<Value> &info);
+    /// void vrmock::SetDisplayFrequency( float fHz );
+    void SetDisplayFrequency(const Nan::FunctionCallbackInfo<Value> &info);
+    /// void vrmock::SetDevice( TrackedDeviceIndex_t unDeviceIndex, ETrackedDeviceClass eClass, ETrackedControllerRole eRole, bool bConnected );
+    void SetDevice(const Nan::FunctionCallbackInfo<Value> &info);
+    /// void vrmock::SetDevicePose( TrackedDeviceIndex_t unDeviceIndex, const TrackedDevicePose_t &pose );
+    void SetDevicePose(const Nan::FunctionCallbackInfo<Value> &info);
+    /// void vrmock::SetDeviceProperty( TrackedDeviceIndex_t unDeviceIndex, ETrackedDeviceProperty prop, PropertyTypeTag_t unTag, const void *pvData, uint32_t unSize );
+    void SetDeviceProperty(const Nan::FunctionCallbackInfo<Value> &info);
+    /// void vrmock::SetControllerState( TrackedDeviceIndex_t unDeviceIndex, const VRControllerState_t &state );
+    void SetControllerState(const Nan::FunctionCallbackInfo<Value> &info);
+    /// void vrmock::QueueEvent( const VREvent_t &event );
+    void QueueEvent(const Nan::FunctionCallbackInfo<Value> &info);
+    /// bool vrmock::QueueOverlayEvent( VROverlayHandle_t ulOverlayHandle, const VREvent_t &event );
+    void QueueOverlayEvent(const Nan::FunctionCallbackInfo<Value> &info);
+    /// VROverlayHandle_t vrmock::CreateForeignOverlay( const char *pchOverlayKey, const char *pchOverlayName );
+    void CreateForeignOverlay(const Nan::FunctionCallbackInfo<Value> &info);
+    /// Stats vrmock::GetStats();
+    void GetStats(const Nan::FunctionCallbackInfo<Value> &info);
+    /// OverlayFingerprint::Compute( pchInstructionSet, pData, unWidth, unHeight, unBytesPerPixel ) for every instruction set this CPU has.
+    void HashOverlayTiles(const Nan::FunctionCallbackInfo<Value> &info);
+}
+
+#endif
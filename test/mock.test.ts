@@ -0,0 +1,806 @@
+import * as fs from "fs";
+import * as os from "os";
+import * as path from "path";
+import * as zlib from "zlib";
+import * as vr from "../tssrc/index";
+
+// Runs against the in-process runtime: `node-gyp rebuild --openvr_mock=1`.
+const describeMock = vr.VRMock ? describe : describe.skip;
+
+describeMock("mock runtime", () => {
+    const mock = vr.VRMock!;
+
+    beforeEach(() => mock.Reset());
+    afterEach(() => vr.VR_Shutdown());
+
+    test("reports the default scene", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+
+        expect(system.GetRecommendedRenderTargetSize()).toEqual({ width: 2016, height: 2240 });
+        expect(system.IsTrackedDeviceConnected(vr.k_unTrackedDeviceIndex_Hmd)).toBe(true);
+        expect(system.GetTrackedDeviceClass(1)).toBe(vr.ETrackedDeviceClass.TrackedDeviceClass_Controller);
+
+        const poses = system.GetDeviceToAbsoluteTrackingPose(vr.ETrackingUniverseOrigin.TrackingUniverseStanding, 0);
+        expect(poses[0].poseIsValid).toBe(true);
+        expect(poses[0].deviceToAbsoluteTracking[1][3]).toBeCloseTo(1.7);
+    });
+
+    test("writes poses into caller-supplied typed arrays", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const poses = new Float32Array(vr.k_unMaxTrackedDeviceCount * vr.k_unTrackedDevicePoseFloatStride);
+        const states = new Uint8Array(vr.k_unMaxTrackedDeviceCount * vr.k_unTrackedDevicePoseStateStride);
+
+        mock.SetDevicePose(1, {
+            deviceToAbsoluteTracking: [[1, 0, 0, 0.5], [0, 1, 0, 1.0], [0, 0, 1, -0.25]],
+            velocity: [0, 0, 0],
+            angularVelocity: [0, 0, 0],
+            trackingResult: vr.ETrackingResult.TrackingResult_Running_OK,
+            poseIsValid: true,
+            deviceIsConnected: true,
+        });
+
+        const count = system.GetDeviceToAbsoluteTrackingPose(vr.ETrackingUniverseOrigin.TrackingUniverseStanding, 0, poses, states);
+        expect(count).toBe(vr.k_unMaxTrackedDeviceCount);
+
+        const base = 1 * vr.k_unTrackedDevicePoseFloatStride;
+        expect(Array.from(poses.subarray(base, base + 12))).toEqual([1, 0, 0, 0.5, 0, 1, 0, 1, 0, 0, 1, -0.25]);
+
+        const state = 1 * vr.k_unTrackedDevicePoseStateStride;
+        expect(states[state]).toBe(1);
+        expect(states[state + 2] * 100 + states[state + 3]).toBe(vr.ETrackingResult.TrackingResult_Running_OK);
+        expect(states[3 * vr.k_unTrackedDevicePoseStateStride + 1]).toBe(0);
+    });
+
+    test("fails VR_Init with the scripted error", () => {
+        mock.SetInitError(vr.EVRInitError.VRInitError_Init_HmdNotFound);
+        expect(() => vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay)).toThrow();
+    });
+
+    test("counts overlay uploads", () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+
+        const handle = overlay.CreateOverlay("mock.test", "mock test");
+        overlay.SetOverlayRaw(handle, Buffer.alloc(4 * 4 * 4), 4, 4, 4);
+
+        const stats = mock.GetStats();
+        expect(stats.overlays).toBe(1);
+        expect(stats.overlayUploads).toBe(1);
+        expect(stats.overlayUploadBytes).toBe(64);
+    });
+
+    test("samples poses in the background and answers by time", async () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const sampler = new vr.PoseSampler(vr.ETrackingUniverseOrigin.TrackingUniverseStanding, 250);
+        const start = sampler.Now();
+
+        mock.SetDevicePose(1, {
+            deviceToAbsoluteTracking: [[1, 0, 0, 0], [0, 1, 0, 0], [0, 0, 1, 0]],
+            velocity: [1, 0, 0],
+            angularVelocity: [0, 0, 0],
+            trackingResult: vr.ETrackingResult.TrackingResult_Running_OK,
+            poseIsValid: true,
+            deviceIsConnected: true,
+        });
+        sampler.Start();
+        await new Promise((resolve) => setTimeout(resolve, 100));
+
+        const pose = sampler.GetPoseAtTime(1, start + 0.05);
+        expect(pose).toBeDefined();
+        expect(pose!.deviceToAbsoluteTracking[0][3]).toBeCloseTo(0.05, 1);
+        expect(sampler.GetPoseAtTime(1, start - 10)).toBeUndefined();
+
+        const times = new Float64Array(8);
+        const count = sampler.GetRecentSamples(1, new Float32Array(8 * vr.k_unTrackedDevicePoseFloatStride), times);
+        expect(count).toBeGreaterThan(1);
+        expect(times[0]).toBeGreaterThan(times[1]);
+
+        vr.VR_Shutdown();
+        expect(sampler.IsRunning()).toBe(false);
+    });
+
+    test("publishes the latest sample into a shared snapshot", async () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const sampler = new vr.PoseSampler(vr.ETrackingUniverseOrigin.TrackingUniverseStanding, 250);
+        const reader = new vr.PoseSnapshotReader(sampler.GetSnapshotBuffer());
+        const poses = new Float32Array(vr.k_unPoseSnapshotDeviceCount * vr.k_unTrackedDevicePoseFloatStride);
+        const states = new Uint8Array(vr.k_unPoseSnapshotDeviceCount * vr.k_unTrackedDevicePoseStateStride);
+
+        expect(reader.Read(poses, states)).toBeUndefined();
+
+        sampler.Start();
+        await new Promise((resolve) => setTimeout(resolve, 50));
+
+        const info = reader.Read(poses, states);
+        expect(info).toBeDefined();
+        expect(info!.sampleIndex).toBeLessThan(sampler.GetSampleCount());
+        expect(poses[7]).toBeCloseTo(1.7);
+        expect(states[0]).toBe(1);
+    });
+
+    test("keeps the snapshot sequence readable when it wraps", async () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const sampler = new vr.PoseSampler(vr.ETrackingUniverseOrigin.TrackingUniverseStanding, 250);
+        const buffer = sampler.GetSnapshotBuffer();
+        const reader = new vr.PoseSnapshotReader(buffer);
+        const poses = new Float32Array(vr.k_unPoseSnapshotDeviceCount * vr.k_unTrackedDevicePoseFloatStride);
+
+        // The last even value before 2^32; the next publish wraps past 0.
+        const header = new Uint32Array(buffer, vr.k_unPoseSnapshotSequenceOffset, 1);
+        Atomics.store(header, 0, 0xfffffffe);
+        sampler.Start();
+        await new Promise((resolve) => setTimeout(resolve, 50));
+        sampler.Stop();
+
+        const sequence = Atomics.load(header, 0);
+        expect(sequence).toBeGreaterThan(0);
+        expect(sequence).toBeLessThan(0xfffffffe);
+        expect(sequence & 1).toBe(0);
+        expect(reader.Read(poses)).toBeDefined();
+    });
+
+    test("hands out BigInt overlay handles and accepts the older forms", () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+
+        const handle = overlay.CreateOverlay("mock.handle", "mock handle");
+        expect(typeof handle).toBe("bigint");
+        expect(overlay.FindOverlay("mock.handle")).toBe(handle);
+
+        const parts = { DownBits: Number(handle & BigInt(0xffffffff)), UpBits: Number(handle >> BigInt(32)) };
+        overlay.SetOverlayAlpha(parts as any, 0.5);
+        overlay.SetOverlayAlpha(Number(handle) as any, 0.25);
+        expect(overlay.GetOverlayAlpha(handle)).toBeCloseTo(0.25);
+
+        // Numbers that cannot name a handle exactly throw before reaching the runtime.
+        for (const bad of [-1, 1.5, NaN, Infinity, Math.pow(2, 53), undefined, "1"]) {
+            expect(() => overlay.SetOverlayAlpha(bad as any, 1)).toThrow(TypeError);
+            expect(() => overlay.DestroyOverlay(bad as any)).toThrow(TypeError);
+        }
+        expect(overlay.GetOverlayAlpha(handle)).toBeCloseTo(0.25);
+        expect(overlay.FindOverlay("mock.handle")).toBe(handle);
+    });
+
+    test("takes BigInt handles for the second overlay of a call", () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const parent = overlay.CreateOverlay("mock.parent", "mock parent");
+        const child = overlay.CreateOverlay("mock.child", "mock child");
+
+        const transform = [[1, 0, 0, 0], [0, 1, 0, 0.5], [0, 0, 1, -0.25]];
+        overlay.SetOverlayTransformOverlayRelative(child, parent, transform);
+        const relative = overlay.GetOverlayTransformOverlayRelative(child);
+        expect(relative.OverlayHandleParent).toBe(parent);
+        expect(relative.ParentOverlayToOverlayTransform).toEqual(transform);
+
+        overlay.SetOverlayCursor(child, parent);
+        expect(() => overlay.SetOverlayCursor(child, -1 as any)).toThrow(TypeError);
+        expect(() => overlay.SetOverlayTransformOverlayRelative(child, 1.5 as any, transform)).toThrow(TypeError);
+    });
+
+    test("drains queued events into packed records", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        while (system.PollNextEvent());
+
+        const mouse = new Float32Array([0.25, 0.75, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0]);
+        for (let i = 0; i < 5; ++i)
+            mock.QueueEvent(vr.EVREventType.VREvent_MouseMove, 1, mouse);
+
+        const buffer = new ArrayBuffer(3 * vr.k_unVREventRecordSize);
+        expect(system.PollNextEvents(buffer)).toBe(3);
+
+        const view = new DataView(buffer);
+        expect(view.getUint32(0, true)).toBe(vr.EVREventType.VREvent_MouseMove);
+        expect(view.getUint32(4, true)).toBe(1);
+        expect(view.getFloat32(vr.k_unVREventRecordDataOffset + 4, true)).toBeCloseTo(0.75);
+
+        expect(system.PollNextEvents(buffer)).toBe(2);
+        expect(system.PollNextEvents(buffer)).toBe(0);
+        expect(system.PollNextEvent()).toBeUndefined();
+    });
+
+    test("pumps events to the main loop without polling from JS", async () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handle = overlay.CreateOverlay("mock.pump", "mock pump");
+
+        const emitter = new vr.VREventEmitter();
+        const systemEvents: vr.VREvent_t[] = [];
+        const overlayEvents: [vr.VROverlayHandle_t, vr.VREvent_t][] = [];
+        emitter.on("event", (event) => systemEvents.push(event));
+        emitter.on("overlayEvent", (overlayHandle, event) => overlayEvents.push([overlayHandle, event]));
+        emitter.WatchOverlay(handle);
+        emitter.Start();
+
+        mock.QueueEvent(vr.EVREventType.VREvent_ButtonPress, 1);
+        mock.QueueOverlayEvent(handle, vr.EVREventType.VREvent_MouseMove);
+        await new Promise((resolve) => setTimeout(resolve, 50));
+
+        expect(systemEvents.map((event) => event.eventType)).toContain(vr.EVREventType.VREvent_ButtonPress);
+        expect(overlayEvents).toHaveLength(1);
+        expect(overlayEvents[0][0]).toBe(handle);
+
+        vr.VR_Shutdown();
+        expect(emitter.IsRunning()).toBe(false);
+    });
+
+    test("decodes the payload that each event type carries", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        while (system.PollNextEvent());
+
+        mock.SetDeviceProperty(1, vr.ETrackedDeviceProperty.Prop_DeviceBatteryPercentage_Float, vr.k_unFloatPropertyTag, 0.5);
+        mock.QueueEvent(vr.EVREventType.VREvent_ScrollDiscrete, 0, new Float32Array([1.5, -2, 0, 0.5]));
+        const keyboard = new Uint8Array(48);
+        keyboard.set([0x68, 0x69]);
+        mock.QueueEvent(vr.EVREventType.VREvent_KeyboardCharInput, 0, keyboard);
+        mock.QueueEvent(vr.EVREventType.VREvent_TrackedDeviceUpdated, 1);
+
+        const property = system.PollNextEvent()!;
+        expect(property.eventType).toBe(vr.EVREventType.VREvent_PropertyChanged);
+        expect(property.data.property.prop).toBe(vr.ETrackedDeviceProperty.Prop_DeviceBatteryPercentage_Float);
+
+        expect(system.PollNextEvent()!.data.scroll).toEqual({ xdelta: 1.5, ydelta: -2, unused: 0, viewportscale: 0.5 });
+        expect(system.PollNextEvent()!.data.keyboard.cNewInput).toBe("hi");
+        expect(system.PollNextEvent()!.data).toEqual({});
+    });
+
+    test("decodes touchpad moves into the touchPadMove member", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        while (system.PollNextEvent());
+
+        const touchPadMove = new ArrayBuffer(24);
+        new Uint8Array(touchPadMove)[0] = 1;
+        new Float32Array(touchPadMove, 4).set([0.5, -0.25, 0.75, 0.125, -1]);
+        mock.QueueEvent(vr.EVREventType.VREvent_TouchPadMove, 1, new Uint8Array(touchPadMove));
+
+        const event = system.PollNextEvent()!;
+        expect(event.eventType).toBe(vr.EVREventType.VREvent_TouchPadMove);
+        expect(event.data.touchPadMove).toEqual({
+            bFingerDown: true,
+            fSecondsFingerDown: 0.5,
+            fValueXFirst: -0.25,
+            fValueYFirst: 0.75,
+            fValueXRaw: 0.125,
+            fValueYRaw: -1,
+        });
+    });
+
+    test("decodes 64-bit payload ids as BigInts", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        while (system.PollNextEvent());
+
+        const previous = BigInt("0x123456789abcdef1");
+        const current = BigInt("0xfedcba9876543211");
+        mock.QueueEvent(vr.EVREventType.VREvent_ChaperoneUniverseHasChanged, 0, new BigUint64Array([previous, current]));
+
+        const event = system.PollNextEvent()!;
+        expect(event.data.chaperone).toEqual({ m_nPreviousUniverse: previous, m_nCurrentUniverse: current });
+    });
+
+    test("decodes application launch and web console payloads", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        while (system.PollNextEvent());
+
+        mock.QueueEvent(vr.EVREventType.VREvent_ApplicationMimeTypeLoad, 0, new Uint32Array([4242, 7]));
+        mock.QueueEvent(vr.EVREventType.VREvent_ConsoleOpened, 0, new BigUint64Array([BigInt("0x8000000000000001")]));
+
+        expect(system.PollNextEvent()!.data.applicationLaunch).toEqual({ pid: 4242, unArgsHandle: 7 });
+        expect(system.PollNextEvent()!.data.webConsole).toEqual({ webConsoleHandle: BigInt("0x8000000000000001") });
+    });
+
+    test("drops unsubscribed event types before they reach JS", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        while (system.PollNextEvent());
+
+        system.SetEventFilter([vr.EVREventType.VREvent_ButtonPress]);
+        expect(system.GetEventFilter()).toEqual([vr.EVREventType.VREvent_ButtonPress]);
+
+        mock.QueueEvent(vr.EVREventType.VREvent_MouseMove, 0);
+        mock.QueueEvent(vr.EVREventType.VREvent_ButtonPress, 1);
+        mock.QueueEvent(vr.EVREventType.VREvent_MouseMove, 0);
+
+        expect(system.PollNextEvent()!.eventType).toBe(vr.EVREventType.VREvent_ButtonPress);
+        expect(system.PollNextEvent()).toBeUndefined();
+
+        system.SetEventFilter();
+        mock.QueueEvent(vr.EVREventType.VREvent_MouseMove, 0);
+        expect(system.PollNextEvent()!.eventType).toBe(vr.EVREventType.VREvent_MouseMove);
+    });
+
+    test("coalesces runs of overlay mouse-move and scroll events", () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handle = overlay.CreateOverlay("mock.coalesce", "mock coalesce");
+        overlay.SetEventCoalescing(true);
+
+        const move = (x: number) => new Float32Array([x, 0, 0]);
+        const scroll = (dy: number) => new Float32Array([0, dy, 0, 1]);
+        mock.QueueOverlayEvent(handle, vr.EVREventType.VREvent_MouseMove, move(1));
+        mock.QueueOverlayEvent(handle, vr.EVREventType.VREvent_MouseMove, move(2));
+        mock.QueueOverlayEvent(handle, vr.EVREventType.VREvent_MouseButtonDown, move(2));
+        mock.QueueOverlayEvent(handle, vr.EVREventType.VREvent_MouseMove, move(3));
+        mock.QueueOverlayEvent(handle, vr.EVREventType.VREvent_ScrollSmooth, scroll(1));
+        mock.QueueOverlayEvent(handle, vr.EVREventType.VREvent_ScrollSmooth, scroll(2));
+
+        const events: vr.VREvent_t[] = [];
+        let event: vr.VREvent_t | undefined;
+        while ((event = overlay.PollNextOverlayEvent(handle)))
+            events.push(event);
+
+        expect(events.map((e) => e.eventType)).toEqual([
+            vr.EVREventType.VREvent_MouseMove,
+            vr.EVREventType.VREvent_MouseButtonDown,
+            vr.EVREventType.VREvent_MouseMove,
+            vr.EVREventType.VREvent_ScrollSmooth,
+        ]);
+        expect(events[0].data.mouse.x).toBe(2);
+        expect(events[3].data.scroll.ydelta).toBe(3);
+
+        // The event that ended a run is held back, and must still obey a filter set after it was read.
+        mock.QueueOverlayEvent(handle, vr.EVREventType.VREvent_MouseMove, move(4));
+        mock.QueueOverlayEvent(handle, vr.EVREventType.VREvent_MouseButtonDown, move(4));
+        mock.QueueOverlayEvent(handle, vr.EVREventType.VREvent_MouseButtonUp, move(4));
+        expect(overlay.PollNextOverlayEvent(handle)!.eventType).toBe(vr.EVREventType.VREvent_MouseMove);
+        overlay.SetEventFilter([vr.EVREventType.VREvent_MouseMove, vr.EVREventType.VREvent_MouseButtonUp]);
+        expect(overlay.PollNextOverlayEvent(handle)!.eventType).toBe(vr.EVREventType.VREvent_MouseButtonUp);
+        expect(overlay.PollNextOverlayEvent(handle)).toBeUndefined();
+        overlay.SetEventFilter();
+    });
+
+    test("caches device properties until a change event is polled", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        system.SetPropertyCacheEnabled(true);
+
+        const prop = vr.ETrackedDeviceProperty.Prop_DeviceBatteryPercentage_Float;
+        mock.SetDeviceProperty(1, prop, vr.k_unFloatPropertyTag, 0.5);
+        while (system.PollNextEvent());
+
+        expect(system.GetFloatTrackedDeviceProperty(1, prop)).toBeCloseTo(0.5);
+        const calls = mock.GetStats().calls;
+        expect(system.GetFloatTrackedDeviceProperty(1, prop)).toBeCloseTo(0.5);
+        expect(mock.GetStats().calls).toBe(calls);
+
+        mock.SetDeviceProperty(1, prop, vr.k_unFloatPropertyTag, 0.25);
+        expect(system.GetFloatTrackedDeviceProperty(1, prop)).toBeCloseTo(0.5);
+        while (system.PollNextEvent());
+        expect(system.GetFloatTrackedDeviceProperty(1, prop)).toBeCloseTo(0.25);
+
+        const stats = system.GetPropertyCacheStats();
+        expect(stats.hits).toBeGreaterThanOrEqual(2);
+        expect(stats.misses).toBeGreaterThanOrEqual(2);
+        system.SetPropertyCacheEnabled(false);
+    });
+
+    test("fetches a matrix of device properties in one call", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        mock.SetDeviceProperty(1, vr.ETrackedDeviceProperty.Prop_DeviceBatteryPercentage_Float, vr.k_unFloatPropertyTag, 0.5);
+        mock.SetDeviceProperty(2, vr.ETrackedDeviceProperty.Prop_DeviceIsCharging_Bool, vr.k_unBoolPropertyTag, true);
+
+        const props = [vr.ETrackedDeviceProperty.Prop_DeviceBatteryPercentage_Float, vr.ETrackedDeviceProperty.Prop_DeviceIsCharging_Bool];
+        const tags = [vr.k_unFloatPropertyTag, vr.k_unBoolPropertyTag];
+        const result = system.GetDeviceProperties([1, 2, 10], props, tags);
+
+        expect(result.values.length).toBe(6);
+        expect(Array.from(result.values.subarray(0, 4))).toEqual([0.5, 0, 0.75, 1]);
+        expect(Array.from(result.errors.subarray(0, 4))).toEqual(new Array(4).fill(vr.ETrackedPropertyError.TrackedProp_Success));
+        expect(result.errors[4]).not.toBe(vr.ETrackedPropertyError.TrackedProp_Success);
+        expect(result.errors[5]).not.toBe(vr.ETrackedPropertyError.TrackedProp_Success);
+        expect(result.uint64Values).toBeUndefined();
+
+        const parentDriver = BigInt("0x8000000000000003");
+        mock.SetDeviceProperty(1, vr.ETrackedDeviceProperty.Prop_ParentDriver_Uint64, vr.k_unUint64PropertyTag, parentDriver);
+        const mixed = system.GetDeviceProperties([1], [vr.ETrackedDeviceProperty.Prop_DeviceBatteryPercentage_Float, vr.ETrackedDeviceProperty.Prop_ParentDriver_Uint64]);
+        expect(mixed.values[0]).toBe(0.5);
+        expect(mixed.values[1]).toBeNaN();
+        expect(mixed.uint64Values![1]).toBe(parentDriver);
+    });
+
+    test("reads any property through the generic getter", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const frameRates = new Float32Array([90, 120, 144]);
+        mock.SetDeviceProperty(0, vr.ETrackedDeviceProperty.Prop_DisplayAvailableFrameRates_Float_Array, vr.k_unFloatPropertyTag, frameRates);
+        mock.SetDeviceProperty(0, vr.ETrackedDeviceProperty.Prop_ModelNumber_String, vr.k_unStringPropertyTag, "Mock HMD".repeat(64));
+
+        expect(system.GetTrackedDeviceProperty(1, vr.ETrackedDeviceProperty.Prop_DeviceBatteryPercentage_Float)).toBeCloseTo(0.75);
+        expect(system.GetTrackedDeviceProperty(1, vr.ETrackedDeviceProperty.Prop_DeviceIsCharging_Bool)).toBe(false);
+        expect(system.GetTrackedDeviceProperty(0, vr.ETrackedDeviceProperty.Prop_ModelNumber_String)).toBe("Mock HMD".repeat(64));
+        expect(system.GetTrackedDeviceProperty(0, vr.ETrackedDeviceProperty.Prop_DisplayAvailableFrameRates_Float_Array)).toEqual(frameRates);
+        expect(system.GetTrackedDeviceProperty(1, vr.ETrackedDeviceProperty.Prop_DisplayFrequency_Float)).toBeUndefined();
+
+        const parentDriver = BigInt("0x8000000000000005");
+        mock.SetDeviceProperty(1, vr.ETrackedDeviceProperty.Prop_ParentDriver_Uint64, vr.k_unUint64PropertyTag, parentDriver);
+        expect(system.GetTrackedDeviceProperty(1, vr.ETrackedDeviceProperty.Prop_ParentDriver_Uint64)).toBe(parentDriver);
+
+        const matrix = system.GetDeviceProperties([1], [vr.ETrackedDeviceProperty.Prop_DeviceBatteryPercentage_Float]);
+        expect(matrix.values[0]).toBeCloseTo(0.75);
+    });
+
+    test("reads array properties into typed arrays", () => {
+        const system = vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const transforms = new Float32Array(24).map((_, i) => i);
+        mock.SetDeviceProperty(0, vr.ETrackedDeviceProperty.Prop_CameraToHeadTransforms_Matrix34_Array, vr.k_unHmdMatrix34PropertyTag, transforms);
+
+        const result = system.GetArrayTrackedDeviceProperty(0, vr.ETrackedDeviceProperty.Prop_CameraToHeadTransforms_Matrix34_Array);
+        expect(result).toBeInstanceOf(Float32Array);
+        expect(result).toEqual(transforms);
+
+        const small = new Float32Array(12);
+        expect(system.GetArrayTrackedDeviceProperty(0, vr.ETrackedDeviceProperty.Prop_CameraToHeadTransforms_Matrix34_Array, undefined, small)).toBe(96);
+        expect(small).toEqual(new Float32Array(12));
+
+        const large = new Float32Array(32);
+        expect(system.GetArrayTrackedDeviceProperty(0, vr.ETrackedDeviceProperty.Prop_CameraToHeadTransforms_Matrix34_Array, undefined, large)).toBe(96);
+        expect(large.subarray(0, 24)).toEqual(transforms);
+
+        expect(system.GetArrayTrackedDeviceProperty(1, vr.ETrackedDeviceProperty.Prop_CameraToHeadTransforms_Matrix34_Array)).toBeUndefined();
+    });
+
+    test("uploads raw overlay pixels off the JS thread", async () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handle = overlay.CreateOverlay("mock.async", "mock async");
+        const pixels = Buffer.alloc(32 * 32 * 4);
+
+        const result = await overlay.SetOverlayRawAsync(handle, pixels, 32, 32, 4);
+        expect(result.skipped).toBe(false);
+        expect(result.uploadMs).toBeGreaterThanOrEqual(0);
+        expect(mock.GetStats().overlayUploads).toBe(1);
+
+        await expect(overlay.SetOverlayRawAsync(vr.k_ulOverlayHandleInvalid, pixels, 32, 32, 4))
+            .rejects.toMatchObject({ overlayError: vr.EVROverlayError.VROverlayError_UnknownOverlay });
+        expect(() => overlay.SetOverlayRawAsync(handle, pixels, 64, 32, 4)).toThrow(RangeError);
+
+        // The upload fails on the worker, and its error is only reported after shutdown.
+        const failed = overlay.SetOverlayRawAsync(vr.k_ulOverlayHandleInvalid, pixels, 32, 32, 4);
+        const until = Date.now() + 50;
+        while (Date.now() < until);
+        vr.VR_Shutdown();
+        await expect(failed).rejects.toMatchObject({ message: "VROverlayError_UnknownOverlay" });
+    });
+
+    test("skips raw uploads of unchanged frames", () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handle = overlay.CreateOverlay("mock.dedup", "mock dedup");
+        overlay.SetSkipUnchangedUploads(true);
+        const before = overlay.GetOverlayUploadStats();
+
+        const pixels = Buffer.alloc(200 * 100 * 4);
+        overlay.SetOverlayRaw(handle, pixels, 200, 100, 4);
+        overlay.SetOverlayRaw(handle, pixels, 200, 100, 4);
+        pixels[4 * (200 * 70 + 150)] = 255;
+        overlay.SetOverlayRaw(handle, pixels, 200, 100, 4);
+        overlay.ClearOverlayTexture(handle);
+        overlay.SetOverlayRaw(handle, pixels, 200, 100, 4);
+
+        const stats = overlay.GetOverlayUploadStats();
+        overlay.SetSkipUnchangedUploads(false);
+        expect(mock.GetStats().overlayUploads).toBe(3);
+        expect(stats.skippedFrames - before.skippedFrames).toBe(1);
+        expect(stats.skippedBytes - before.skippedBytes).toBe(pixels.length);
+        expect(stats.dirtyTiles - before.dirtyTiles).toBe(8 + 1 + 8);
+    });
+
+    test("converts pixels natively before upload", () => {
+        // An odd pixel count so the SIMD kernels leave a scalar tail.
+        const source = Buffer.alloc(37 * 4);
+        for (let i = 0; i < source.length; i++) source[i] = (i * 97 + 13) & 255;
+
+        const converted = vr.ConvertPixels(vr.EPixelConversion.SwapRedBlue | vr.EPixelConversion.Premultiply, source);
+        const premultiply = (c: number, a: number) => Math.round(c * a / 255);
+        for (let p = 0; p < 37; p++) {
+            const a = source[p * 4 + 3];
+            const expected = [premultiply(source[p * 4 + 2], a), premultiply(source[p * 4 + 1], a), premultiply(source[p * 4], a), a];
+            expect(Array.from(converted.subarray(p * 4, p * 4 + 4))).toEqual(expected);
+        }
+        // RgbToRgba grows the pixels, so it cannot run in place even with room to spare.
+        const rgb = Buffer.alloc(48 * 4);
+        expect(() => vr.ConvertPixels(vr.EPixelConversion.RgbToRgba, rgb.subarray(0, 48 * 3), rgb))
+            .toThrow("Argument[2] must either be Argument[1] itself or not overlap it.");
+
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handle = overlay.CreateOverlay("mock.convert", "mock convert");
+        overlay.SetOverlayRaw(handle, Buffer.alloc(8 * 8 * 3), 8, 8, 3, vr.EPixelConversion.RgbToRgba);
+        expect(mock.GetStats().overlayUploadBytes).toBe(8 * 8 * 4);
+        expect(() => overlay.SetOverlayRaw(handle, Buffer.alloc(8 * 8 * 4), 8, 8, 4, vr.EPixelConversion.RgbToRgba)).toThrow(RangeError);
+    });
+
+    test("decodes overlay image files once and uploads them raw", async () => {
+        const crc32 = (bytes: Buffer) => {
+            let crc = ~0;
+            for (let i = 0; i < bytes.length; i++) {
+                crc ^= bytes[i];
+                for (let k = 0; k < 8; k++) crc = (crc >>> 1) ^ (0xEDB88320 & -(crc & 1));
+            }
+            return ~crc >>> 0;
+        };
+        const chunk = (type: string, data: Buffer) => {
+            const body = Buffer.concat([Buffer.from(type, "ascii"), data]);
+            const framed = Buffer.alloc(body.length + 8);
+            framed.writeUInt32BE(data.length, 0);
+            body.copy(framed, 4);
+            framed.writeUInt32BE(crc32(body), body.length + 4);
+            return framed;
+        };
+        const header = Buffer.alloc(13);
+        header.writeUInt32BE(2, 0);
+        header.writeUInt32BE(2, 4);
+        header[8] = 8; // bit depth
+        header[9] = 6; // RGBA
+        const rows = Buffer.from([0, 255, 0, 0, 255, 0, 255, 0, 255, 0, 0, 0, 255, 255, 1, 2, 3, 4]);
+
+        const dir = fs.mkdtempSync(path.join(os.tmpdir(), "openvr-"));
+        const png = path.join(dir, "icon.png");
+        const other = path.join(dir, "icon.jpg");
+        fs.writeFileSync(png, Buffer.concat([
+            Buffer.from([137, 80, 78, 71, 13, 10, 26, 10]),
+            chunk("IHDR", header), chunk("IDAT", zlib.deflateSync(rows)), chunk("IEND", Buffer.alloc(0)),
+        ]));
+        fs.writeFileSync(other, "not a png");
+
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handle = overlay.CreateOverlay("mock.icon", "mock icon");
+        overlay.ClearOverlayImageCache();
+
+        expect((await overlay.SetOverlayFromFileAsync(handle, png)).cached).toBe(false);
+        expect((await overlay.SetOverlayFromFileAsync(handle, png)).cached).toBe(true);
+        expect(mock.GetStats()).toMatchObject({ overlayUploads: 2, overlayUploadBytes: 2 * 2 * 4 * 2, overlayFileLoads: 0 });
+        expect(overlay.GetOverlayImageCacheStats()).toMatchObject({ entries: 1, bytes: 16 });
+
+        const budget = overlay.GetOverlayImageCacheStats().budget;
+        for (const bad of [NaN, Infinity, -1, 1e30])
+            expect(() => overlay.SetOverlayImageCacheBudget(bad)).toThrow(TypeError);
+        expect(overlay.GetOverlayImageCacheStats().budget).toBe(budget);
+
+        // Formats the cache cannot decode go to the runtime's own loader.
+        await overlay.SetOverlayFromFileAsync(handle, other);
+        expect(mock.GetStats().overlayFileLoads).toBe(1);
+
+        fs.rmSync(dir, { recursive: true });
+    });
+
+    test("applies overlay properties in one call", () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const first = overlay.CreateOverlay("mock.props.first", "first");
+        const second = overlay.CreateOverlay("mock.props.second", "second");
+
+        overlay.SetOverlayProperties(first, {
+            alpha: 0.5,
+            color: { Red: 1, Green: 0.5, Blue: 0 },
+            widthInMeters: 2,
+            sortOrder: 3,
+            transform: [[1, 0, 0, 1], [0, 1, 0, 2], [0, 0, 1, 3]],
+            visible: true,
+        });
+        expect(overlay.GetOverlayAlpha(first)).toBe(0.5);
+        expect(overlay.GetOverlayColor(first)).toEqual({ Red: 1, Green: 0.5, Blue: 0 });
+        expect(overlay.GetOverlayWidthInMeters(first)).toBe(2);
+        expect(overlay.GetOverlaySortOrder(first)).toBe(3);
+        expect(overlay.GetOverlayTransformAbsolute(first).TrackingOriginToOverlayTransform[1][3]).toBe(2);
+        expect(overlay.IsOverlayVisible(first)).toBe(true);
+        expect(() => overlay.SetOverlayProperties(first, { alpha: "opaque" } as any)).toThrow(TypeError);
+
+        const errors = overlay.SetOverlayPropertiesBatch([first, second, BigInt(0xDEAD)], [{ sortOrder: 1 }, { sortOrder: 2 }, { sortOrder: 3 }]);
+        expect(Array.from(errors)).toEqual([vr.EVROverlayError.VROverlayError_None, vr.EVROverlayError.VROverlayError_None, vr.EVROverlayError.VROverlayError_UnknownOverlay]);
+        expect(overlay.GetOverlaySortOrder(second)).toBe(2);
+    });
+
+    test("answers overlay getters from the state mirror", () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handle = overlay.CreateOverlay("mock.mirror", "mirror");
+
+        overlay.SetOverlayStateMirrorEnabled(true);
+        overlay.SetOverlayAlpha(handle, 0.25);
+        overlay.SetOverlayProperties(handle, { widthInMeters: 1.5, visible: true });
+
+        const calls = mock.GetStats().calls;
+        expect(overlay.GetOverlayAlpha(handle)).toBe(0.25);
+        expect(overlay.GetOverlayWidthInMeters(handle)).toBe(1.5);
+        expect(overlay.IsOverlayVisible(handle)).toBe(true);
+        expect(mock.GetStats().calls).toBe(calls);
+
+        // Unknown fields are read once, then served from the mirror.
+        overlay.GetOverlayColor(handle);
+        overlay.GetOverlayColor(handle);
+        expect(mock.GetStats().calls).toBe(calls + 1);
+        expect(overlay.GetOverlayStateMirrorStats()).toMatchObject({ enabled: true, overlays: 1, hits: 4, misses: 1 });
+
+        overlay.SetOverlayStateMirrorEnabled(false);
+        overlay.GetOverlayAlpha(handle);
+        expect(mock.GetStats().calls).toBe(calls + 2);
+    });
+
+    test("destroys overlays still registered at shutdown", () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const kept = overlay.CreateOverlay("mock.registry.kept", "kept");
+        const destroyed = overlay.CreateOverlay("mock.registry.destroyed", "destroyed");
+        overlay.DestroyOverlay(destroyed);
+
+        const calls = mock.GetStats().calls;
+        expect(overlay.FindOverlay("mock.registry.kept")).toBe(kept);
+        expect(mock.GetStats().calls).toBe(calls);
+
+        const before = overlay.GetOverlayRegistryStats();
+        expect(before.live).toBe(1);
+        expect(before.sites[0].location).toContain("mock.test");
+
+        vr.VR_Shutdown();
+        expect(mock.GetStats().overlays).toBe(0);
+        const after = overlay.GetOverlayRegistryStats();
+        expect(after.live).toBe(0);
+        expect(after.reclaimed - before.reclaimed).toBe(1);
+    });
+
+    test("sets many overlay transforms from one Float32Array", () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handles = [overlay.CreateOverlay("mock.transforms.a", "a"), overlay.CreateOverlay("mock.transforms.b", "b")];
+        const transforms = new Float32Array(24);
+        for (let i = 0; i < 2; ++i) {
+            transforms.set([1, 0, 0, i, 0, 1, 0, 0, 0, 0, 1, -1], i * 12);
+        }
+
+        overlay.SetOverlayStateMirrorEnabled(true);
+        const origin = vr.ETrackingUniverseOrigin.TrackingUniverseStanding;
+        expect(Array.from(overlay.SetOverlayTransformsAbsolute(handles, origin, transforms))).toEqual([0, 0]);
+        expect(overlay.GetOverlayTransformAbsolute(handles[1]).TrackingOriginToOverlayTransform[0][3]).toBe(1);
+
+        // Only the transform that changed reaches the runtime.
+        transforms[12 + 7] = 2;
+        const calls = mock.GetStats().calls;
+        overlay.SetOverlayTransformsAbsolute(handles, origin, transforms);
+        expect(mock.GetStats().calls).toBe(calls + 1);
+        expect(() => overlay.SetOverlayTransformsAbsolute(handles, origin, transforms.subarray(12))).toThrow(RangeError);
+        overlay.SetOverlayStateMirrorEnabled(false);
+    });
+
+    test("skips unchanged bulk transforms without the state mirror", () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handles = [overlay.CreateOverlay("mock.sent.a", "a"), overlay.CreateOverlay("mock.sent.b", "b")];
+        const transforms = new Float32Array(24);
+        for (let i = 0; i < 2; ++i) {
+            transforms.set([1, 0, 0, i, 0, 1, 0, 0, 0, 0, 1, -1], i * 12);
+        }
+
+        const origin = vr.ETrackingUniverseOrigin.TrackingUniverseStanding;
+        overlay.SetOverlayTransformsAbsolute(handles, origin, transforms);
+        let calls = mock.GetStats().calls;
+        overlay.SetOverlayTransformsAbsolute(handles, origin, transforms);
+        expect(mock.GetStats().calls).toBe(calls);
+
+        // Placing an overlay any other way makes the next bulk call send it again.
+        overlay.SetOverlayTransformTrackedDeviceRelative(handles[0], vr.k_unTrackedDeviceIndex_Hmd, [[1, 0, 0, 0], [0, 1, 0, 0], [0, 0, 1, -1]]);
+        calls = mock.GetStats().calls;
+        overlay.SetOverlayTransformsAbsolute(handles, origin, transforms);
+        expect(mock.GetStats().calls).toBe(calls + 1);
+
+        expect(() => overlay.SetOverlayTransformsAbsolute(handles, -1 as vr.ETrackingUniverseOrigin, transforms)).toThrow(TypeError);
+        expect(() => overlay.SetOverlayTransformsAbsolute(handles, 7.5 as vr.ETrackingUniverseOrigin, transforms)).toThrow(TypeError);
+    });
+
+    test("runs overlay tweens on the animator thread", async () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handle = overlay.CreateOverlay("mock.animator", "animator");
+
+        let animator: vr.OverlayAnimator | undefined;
+        const finished = new Promise<number[]>((resolve) => {
+            animator = new vr.OverlayAnimator((id, error) => resolve([id, error]));
+        });
+        const id = animator!.Animate(handle, {
+            keyframes: [
+                { time: 0, alpha: 0, widthInMeters: 1, easing: vr.EOverlayEasing.QuadOut },
+                { time: 0.05, alpha: 1, widthInMeters: 3 },
+            ],
+        });
+        expect(() => animator!.Animate(handle, { keyframes: [{ time: 0, visible: true } as any] })).toThrow(TypeError);
+        animator!.Start();
+
+        expect(await finished).toEqual([id, vr.EVROverlayError.VROverlayError_None]);
+        expect(overlay.GetOverlayAlpha(handle)).toBe(1);
+        expect(overlay.GetOverlayWidthInMeters(handle)).toBe(3);
+        expect(animator!.GetActiveCount()).toBe(0);
+        expect(animator!.GetFrameCount()).toBeGreaterThan(1);
+        animator!.Stop();
+    });
+
+    test("keeps an overlay following the HMD from the animator thread", async () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handle = overlay.CreateOverlay("mock.follow", "follow");
+
+        mock.SetDevicePose(vr.k_unTrackedDeviceIndex_Hmd, {
+            deviceToAbsoluteTracking: [[1, 0, 0, 0.5], [0, 1, 0, 1.5], [0, 0, 1, 0]],
+            velocity: [0, 0, 0],
+            angularVelocity: [0, 0, 0],
+            trackingResult: vr.ETrackingResult.TrackingResult_Running_OK,
+            poseIsValid: true,
+            deviceIsConnected: true,
+        });
+
+        const animator = new vr.OverlayAnimator();
+        const id = animator.Follow(handle, {
+            mode: vr.EOverlayFollowMode.Spring,
+            transform: [[1, 0, 0, 0], [0, 1, 0, 0], [0, 0, 1, -2]],
+            smoothTime: 0,
+        });
+        expect(() => animator.Follow(handle, { mode: 7 as vr.EOverlayFollowMode, transform: [[1, 0, 0, 0], [0, 1, 0, 0], [0, 0, 1, 0]] })).toThrow(TypeError);
+        expect(() => animator.Follow(handle, { mode: vr.EOverlayFollowMode.Spring, transform: [[1, 0, 0, 0], [0, 1, 0, 0], [0, 0, 1, 0]], smoothTime: -1 })).toThrow(RangeError);
+        animator.Start();
+
+        await new Promise((resolve) => setTimeout(resolve, 100));
+        const transform = overlay.GetOverlayTransformAbsolute(handle).TrackingOriginToOverlayTransform;
+        expect(transform[0][3]).toBeCloseTo(0.5);
+        expect(transform[1][3]).toBeCloseTo(1.5);
+        expect(transform[2][3]).toBeCloseTo(-2);
+        expect(animator.GetActiveCount()).toBe(1);
+        expect(animator.Cancel(id)).toBe(true);
+        animator.Stop();
+    });
+
+    test("hashes overlay tiles the same with every instruction set", () => {
+        for (const [width, height, bytesPerPixel] of [[130, 70, 4], [100, 65, 3], [7, 3, 1]]) {
+            const pixels = new Uint8Array(width * height * bytesPerPixel);
+            for (let i = 0; i < pixels.length; i++) pixels[i] = (i * 2654435761 >>> 13) & 255;
+
+            const hashes = mock.HashOverlayTiles(pixels, width, height, bytesPerPixel);
+            expect(Object.keys(hashes)).toContain("scalar");
+            const scalar = Array.from(hashes.scalar);
+            expect(scalar.length).toBe(Math.ceil(width / 64) * Math.ceil(height / 64));
+            for (const instructionSet of Object.keys(hashes))
+                expect(Array.from(hashes[instructionSet])).toEqual(scalar);
+
+            // Swapping the first two rows changes the first tile.
+            const swapped = pixels.slice();
+            swapped.set(pixels.subarray(width * bytesPerPixel, 2 * width * bytesPerPixel), 0);
+            swapped.set(pixels.subarray(0, width * bytesPerPixel), width * bytesPerPixel);
+            for (const instructionSet of Object.keys(hashes))
+                expect(mock.HashOverlayTiles(swapped, width, height, bytesPerPixel)[instructionSet][0]).not.toBe(scalar[0]);
+        }
+    });
+
+    test("delivers events left in the pump's ring after a restart", async () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+
+        const emitter = new vr.VREventEmitter();
+        const eventTypes: vr.EVREventType[] = [];
+        emitter.on("event", (event) => eventTypes.push(event.eventType));
+        emitter.SetEventFilter([vr.EVREventType.VREvent_ButtonPress]);
+        emitter.Start();
+
+        // Let the poll thread queue the event, then stop before the main loop sees it.
+        mock.QueueEvent(vr.EVREventType.VREvent_ButtonPress, 1);
+        const until = Date.now() + 50;
+        while (Date.now() < until);
+        emitter.Stop();
+        expect(eventTypes).toEqual([]);
+
+        emitter.Start();
+        await new Promise((resolve) => setTimeout(resolve, 20));
+        expect(eventTypes).toEqual([vr.EVREventType.VREvent_ButtonPress]);
+        emitter.Stop();
+    });
+
+    test("reports tweens that finished just before the animator stopped", () => {
+        vr.VR_Init(vr.EVRApplicationType.VRApplication_Overlay);
+        const overlay = vr.IVROverlay_Init();
+        const handle = overlay.CreateOverlay("mock.animator.stop", "animator stop");
+
+        const finished: number[][] = [];
+        const animator = new vr.OverlayAnimator((id, error) => finished.push([id, error]));
+        const id = animator.Animate(handle, { keyframes: [{ time: 0, alpha: 0.5 }] });
+        animator.Start();
+
+        // Let the thread finish the tween, then stop before the main loop hears of it.
+        const until = Date.now() + 50;
+        while (Date.now() < until);
+        animator.Stop();
+        expect(finished).toEqual([[id, vr.EVROverlayError.VROverlayError_None]]);
+    });
+});
@@ -1,3 +1,7 @@
+/// <reference lib="es2020.bigint" />
+
+import { EventEmitter } from "events";
+
 const openvr = require('bindings')('openvr')
 
 // version.h
@@ -101,6 +105,11 @@ export type TrackedDevicePose_t = {
     poseIsValid: boolean;
     deviceIsConnected: boolean;
 }
+// Layout written by IVRSystem.GetDeviceToAbsoluteTrackingPose(eOrigin, fPredicted, poses, states).
+// poses: [0..11] deviceToAbsoluteTracking (row-major), [12..14] velocity, [15..17] angularVelocity
+// states: [0] poseIsValid, [1] deviceIsConnected, [2] * 100 + [3] trackingResult
+export const k_unTrackedDevicePoseFloatStride: number = 18;
+export const k_unTrackedDevicePoseStateStride: number = 4;
 export enum ETrackingUniverseOrigin {
     TrackingUniverseSeated = 0,
     TrackingUniverseStanding = 1,
@@ -112,13 +121,13 @@ export enum EAdditionalRadioFeatures {
     AdditionalRadioFeatures_InternalDongle = 0x00000002,
     AdditionalRadioFeatures_ExternalDongle = 0x00000004,
 }
-export type WebConsoleHandle_t = number;
-export type PropertyContainerHandle_t = number;
+export type WebConsoleHandle_t = bigint;
+export type PropertyContainerHandle_t = bigint;
 export type PropertyTypeTag_t = number;
-export const k_unInvalidPropertyContainer: PropertyContainerHandle_t = 0;
+export const k_unInvalidPropertyContainer: PropertyContainerHandle_t = BigInt(0);
 export const k_unInvalidPropertyTag: PropertyTypeTag_t = 0;
 export type DriverHandle_t = PropertyContainerHandle_t;
-export const k_unInvalidDriverHandle: PropertyContainerHandle_t = 0;
+export const k_unInvalidDriverHandle: PropertyContainerHandle_t = BigInt(0);
 
 export const k_unFloatPropertyTag: PropertyTypeTag_t = 1;
 export const k_unInt32PropertyTag: PropertyTypeTag_t = 2;
@@ -507,7 +516,7 @@ export enum EVREventType {
     VREvent_FocusEnter = 303, // data is overlay
     VREvent_FocusLeave = 304, // data is overlay
     VREvent_ScrollDiscrete = 305, // data is scroll
-    VREvent_TouchPadMove = 306, // data is mouse
+    VREvent_TouchPadMove = 306, // data is touchPadMove
     VREvent_OverlayFocusChanged = 307, // data is overlay, global event
     VREvent_ReloadOverlays = 308,
     VREvent_ScrollSmooth = 309, // data is scroll
@@ -530,8 +539,8 @@ export enum EVREventType {
 
     VREvent_SceneApplicationStateChanged = 412, // No data; but query VRApplications()->GetSceneApplicationState();
 
-    VREvent_ConsoleOpened = 420,
-    VREvent_ConsoleClosed = 421,
+    VREvent_ConsoleOpened = 420, // data is webConsole
+    VREvent_ConsoleClosed = 421, // data is webConsole
 
     VREvent_OverlayShown = 500,
     VREvent_OverlayHidden = 501,
@@ -633,7 +642,7 @@ export enum EVREventType {
     //VREvent_ApplicationTransitionAborted		= 1301,
     //VREvent_ApplicationTransitionNewAppStarted	= 1302,
     VREvent_ApplicationListUpdated = 1303,
-    VREvent_ApplicationMimeTypeLoad = 1304,
+    VREvent_ApplicationMimeTypeLoad = 1304, // data is applicationLaunch
     // VREvent_ApplicationTransitionNewAppLaunchComplete = 1305,
     VREvent_ProcessConnected = 1306,
     VREvent_ProcessDisconnected = 1307,
@@ -753,13 +762,13 @@ export type VREvent_TouchPadMove_t = {
     fValueXRaw: number;
     fValueYRaw: number;
 };
-export type VREvent_Notification_t = { ulUserValue: number; notificationId: number; };
+export type VREvent_Notification_t = { ulUserValue: bigint; notificationId: number; };
 export type VREvent_Process_t = { pid: number; oldPid: number; bForced: boolean; bConnectionLost: boolean; };
-export type VREvent_Overlay_t = { overlayHandle: number; devicePath: number; memoryBlockId: number; };
+export type VREvent_Overlay_t = { overlayHandle: VROverlayHandle_t; devicePath: bigint; memoryBlockId: bigint; };
 export type VREvent_Status_t = { statusState: number; };
-export type VREvent_Keyboard_t = { cNewInput: string; uUserValue: number; };
+export type VREvent_Keyboard_t = { cNewInput: string; uUserValue: bigint; };
 export type VREvent_Ipd_t = { ipdMeters: number; };
-export type VREvent_Chaperone_t = { m_nPreviousUniverse: number; m_nCurrentUniverse: number; };
+export type VREvent_Chaperone_t = { m_nPreviousUniverse: bigint; m_nCurrentUniverse: bigint; };
 export type VREvent_Reserved_t = {
     reserved0: number;
     reserved1: number;
@@ -768,17 +777,17 @@ export type VREvent_Reserved_t = {
     reserved4: number;
     reserved5: number;
 };
-export type VREvent_PerformanceTest_t = { m_bFidelityLevel: number; };
-export type VREvent_SeatedZeroPoseReset_t = { bResetBySystemMenu: number; };
+export type VREvent_PerformanceTest_t = { m_nFidelityLevel: number; };
+export type VREvent_SeatedZeroPoseReset_t = { bResetBySystemMenu: boolean; };
 export type VREvent_Screenshot_t = { handle: number; type: number; };
 export type VREvent_ScreenshotProgress_t = { progress: number; };
 export type VREvent_ApplicationLaunch_t = { pid: number; unArgsHandle: number; };
-export type VREvent_EditingCameraSurface_t = { overlayHandle: number; nVisualMode: number; };
+export type VREvent_EditingCameraSurface_t = { overlayHandle: VROverlayHandle_t; nVisualMode: number; };
 export type VREvent_MessageOverlay_t = { unVRMessageOverlayResponse: number; };
 export type VREvent_Property_t = { container: PropertyContainerHandle_t; prop: ETrackedDeviceProperty; };
 export type VREvent_HapticVibration_t = {
-    containerHandle: number; // property container handle of the device with the haptic component
-    componentHandle: number;
+    containerHandle: PropertyContainerHandle_t; // property container handle of the device with the haptic component
+    componentHandle: bigint;
     fDurationSeconds: number;
     fFrequency: number;
     fAmplitude: number;
@@ -786,18 +795,18 @@ export type VREvent_HapticVibration_t = {
 export type VREvent_WebConsole_t = { webConsoleHandle: WebConsoleHandle_t; };
 export type VREvent_InputBindingLoad_t = {
     ulAppContainer: PropertyContainerHandle_t;
-    pathMessage: number;
-    pathUrl: number;
-    pathControllerType: number;
+    pathMessage: bigint;
+    pathUrl: bigint;
+    pathControllerType: bigint;
 };
-export type VREvent_InputActionManifestLoad_t = { pathAppKey: number; pathMessage: number; pathMessageParam: number; pathManifestPath: number; };
+export type VREvent_InputActionManifestLoad_t = { pathAppKey: bigint; pathMessage: bigint; pathMessageParam: bigint; pathManifestPath: bigint; };
 export type VREvent_SpatialAnchor_t = { unHandle: SpatialAnchorHandle_t };
 export type VREvent_ProgressUpdate_t = {
-    ulApplicationPropertyContainer: number;
-    pathDevice: number;
-    pathInputSource: number;
-    pathProgressAction: number;
-    pathIcon: number;
+    ulApplicationPropertyContainer: PropertyContainerHandle_t;
+    pathDevice: bigint;
+    pathInputSource: bigint;
+    pathProgressAction: bigint;
+    pathIcon: bigint;
     fProgress: number;
 };
 export enum EShowUIType {
@@ -857,6 +866,11 @@ export type VREvent_t = {
     eventAgeSeconds: number;
     data: VREvent_Data_t;
 }
+// Record layout used by PollNextEvents / PollNextOverlayEvents, one per event:
+//   bytes [0..3] eventType (Uint32), [4..7] trackedDeviceIndex (Uint32),
+//   [8..11] eventAgeSeconds (Float32), [12..15] reserved, [16..63] raw VREvent_Data_t
+export const k_unVREventRecordSize: number = 64;
+export const k_unVREventRecordDataOffset: number = 16;
 export type VRComponentProperties = number;
 export enum EVRComponentProperty {
     VRComponentProperty_IsStatic = (1 << 0),
@@ -950,11 +964,10 @@ export enum ECollisionBoundsStyle {
 
     COLLISION_BOUNDS_STYLE_COUNT
 };
-export type VROverlayHandle_t = {
-    DownBits: number,
-    UpBits: number
-};
-export const k_ulOverlayHandleInvalid: VROverlayHandle_t = { DownBits: 0, UpBits: 0 };
+// Overlay handles are BigInts. Methods also accept a Number or the older { DownBits, UpBits } object.
+export type VROverlayHandle_t = bigint;
+export type VROverlayHandleParts_t = { DownBits: number, UpBits: number };
+export const k_ulOverlayHandleInvalid: VROverlayHandle_t = BigInt(0);
 export enum EVROverlayError {
     VROverlayError_None = 0,
 
@@ -1406,6 +1419,149 @@ export const VR_GetInitToken = function (): number { return openvr.VR_GetInitTok
 export const IVROverlay_Init = function (): IVROverlay { return openvr.IVROverlay_Init(); }
 export const IVRApplications_Init = function (): IVRApplications { return openvr.IVRApplications_Init(); }
 
+// Pixel conversions for raw overlay uploads. Flags combine and apply in order:
+// layout, Unpremultiply, transfer function, Premultiply.
+export enum EPixelConversion {
+    None = 0,
+    SwapRedBlue = 1 << 0, // BGRA <-> RGBA, or BGR -> RGBA together with RgbToRgba
+    RgbToRgba = 1 << 1, // 3 bytes per pixel in, opaque alpha added
+    Premultiply = 1 << 2,
+    Unpremultiply = 1 << 3,
+    SrgbToLinear = 1 << 4,
+    LinearToSrgb = 1 << 5,
+};
+// Converts a whole buffer of pixels, into target (which may be source itself, except with RgbToRgba) or a new Buffer.
+export const ConvertPixels = function <T extends Buffer | ArrayBuffer | ArrayBufferView = Buffer>(eConversion: EPixelConversion, source: Buffer | ArrayBuffer | ArrayBufferView, target?: T): T { return openvr.ConvertPixels(eConversion, source, target); }
+// "avx2", "ssse3", "neon" or "scalar".
+export const GetPixelConversionInstructionSet = function (): string { return openvr.GetPixelConversionInstructionSet(); }
+
+// Background pose sampler. Times are seconds on the sampler clock, see Now().
+export interface PoseSampler {
+    Start(): void;
+    Stop(): void;
+    IsRunning(): boolean;
+    Now(): number;
+    GetSampleCount(): number;
+    GetPoseAtTime(unDeviceIndex: TrackedDeviceIndex_t, time: number): TrackedDevicePose_t | undefined;
+    GetPoseAtTime(unDeviceIndex: TrackedDeviceIndex_t, time: number, poses: Float32Array, states?: Uint8Array): boolean;
+    GetRecentSamples(unDeviceIndex: TrackedDeviceIndex_t, poses: Float32Array, times?: Float64Array, states?: Uint8Array): number;
+    GetSnapshotBuffer(): SharedArrayBuffer;
+}
+export const PoseSampler: { new(eOrigin: ETrackingUniverseOrigin, fRateHz: number, unCapacity?: number): PoseSampler } = openvr.PoseSampler;
+export * from "./posesnapshot";
+
+// Native event pump. The callback runs on the main loop with one batch per event source;
+// overlayHandle is undefined for IVRSystem events.
+export interface EventPump {
+    Start(): void;
+    Stop(): void;
+    IsRunning(): boolean;
+    WatchOverlay(ulOverlayHandle: VROverlayHandle_t): void;
+    UnwatchOverlay(ulOverlayHandle: VROverlayHandle_t): void;
+    // Only these event types are queued; undefined delivers everything.
+    SetEventFilter(eventTypes?: EVREventType[]): void;
+    GetEventFilter(): EVREventType[] | undefined;
+    // Merges runs of overlay mouse-move and scroll events before they are queued.
+    SetEventCoalescing(bEnabled: boolean): void;
+}
+export const EventPump: { new(callback: (overlayHandle: VROverlayHandle_t | undefined, events: VREvent_t[]) => void, unPollIntervalUs?: number): EventPump } = openvr.EventPump;
+
+// Emits "event" (event) for IVRSystem events and "overlayEvent" (overlayHandle, event)
+// for watched overlays, fed by an EventPump.
+export class VREventEmitter extends EventEmitter {
+    private readonly pump: EventPump;
+
+    constructor(unPollIntervalUs?: number) {
+        super();
+        this.pump = new EventPump((overlayHandle, events) => {
+            for (const event of events) {
+                if (overlayHandle === undefined)
+                    this.emit("event", event);
+                else
+                    this.emit("overlayEvent", overlayHandle, event);
+            }
+        }, unPollIntervalUs);
+    }
+
+    Start(): void { this.pump.Start(); }
+    Stop(): void { this.pump.Stop(); }
+    IsRunning(): boolean { return this.pump.IsRunning(); }
+    WatchOverlay(ulOverlayHandle: VROverlayHandle_t): void { this.pump.WatchOverlay(ulOverlayHandle); }
+    UnwatchOverlay(ulOverlayHandle: VROverlayHandle_t): void { this.pump.UnwatchOverlay(ulOverlayHandle); }
+    SetEventFilter(eventTypes?: EVREventType[]): void { this.pump.SetEventFilter(eventTypes); }
+    GetEventFilter(): EVREventType[] | undefined { return this.pump.GetEventFilter(); }
+    SetEventCoalescing(bEnabled: boolean): void { this.pump.SetEventCoalescing(bEnabled); }
+}
+
+// Easing of the segment that starts at a keyframe.
+export enum EOverlayEasing {
+    Linear = 0,
+    QuadIn = 1,
+    QuadOut = 2,
+    QuadInOut = 3,
+    CubicIn = 4,
+    CubicOut = 5,
+    CubicInOut = 6,
+    Step = 7, // holds the keyframe's value until the next one
+};
+// Any subset of an overlay's properties, for SetOverlayProperties. transform is absolute, relative to trackingOrigin (standing by default).
+export type OverlayProperties = {
+    alpha?: number,
+    color?: { Red: number, Green: number, Blue: number },
+    widthInMeters?: number,
+    curvature?: number,
+    sortOrder?: number,
+    texelAspect?: number,
+    textureBounds?: VRTextureBounds_t,
+    transform?: HmdMatrix34_t,
+    trackingOrigin?: ETrackingUniverseOrigin,
+    visible?: boolean,
+};
+// Every keyframe of a tween sets the same properties, out of alpha, color, widthInMeters, curvature and transform.
+export type OverlayKeyframe = Pick<OverlayProperties, "alpha" | "color" | "widthInMeters" | "curvature" | "transform" | "trackingOrigin"> & { time: number, easing?: EOverlayEasing };
+export type OverlayTween = { keyframes: OverlayKeyframe[], loop?: boolean };
+
+export enum EOverlayFollowMode {
+    Spring = 0, // trails the device, transform being the offset from it
+    DeadZone = 1, // like Spring, but recenters only once the device moves or turns past the dead zone
+    Billboard = 2, // stays at transform and turns about +Y to face the device
+};
+// smoothTime is roughly how long the overlay takes to catch up, 0 being rigid (default 0.15).
+// yawOnly keeps the overlay level by following only the device's heading.
+export type OverlayFollow = {
+    mode: EOverlayFollowMode,
+    transform: HmdMatrix34_t,
+    trackingOrigin?: ETrackingUniverseOrigin,
+    device?: TrackedDeviceIndex_t, // default k_unTrackedDeviceIndex_Hmd
+    yawOnly?: boolean,
+    smoothTime?: number,
+    deadZoneDistance?: number, // meters, default 0.3
+    deadZoneAngle?: number, // degrees, default 25
+};
+
+// Native overlay animator. Tweens advance once per display frame on a native thread, timed from vsync.
+// onFinished runs on the main loop when a tween ends on its own or the runtime rejects a value.
+// Followers run at the same rate, from poses predicted for when the frame is shown, until cancelled.
+export interface OverlayAnimator {
+    Start(): void;
+    Stop(): void;
+    IsRunning(): boolean;
+    // Returns an id for Cancel. Keyframe times are seconds from the first frame the tween runs.
+    Animate(ulOverlayHandle: VROverlayHandle_t, tween: OverlayTween): number;
+    // Returns an id for Cancel.
+    Follow(ulOverlayHandle: VROverlayHandle_t, follow: OverlayFollow): number;
+    Cancel(unId: number): boolean;
+    CancelOverlay(ulOverlayHandle: VROverlayHandle_t): number;
+    GetActiveCount(): number;
+    GetFrameCount(): number;
+}
+export const OverlayAnimator: { new(onFinished?: (unId: number, error: EVROverlayError) => void): OverlayAnimator } = openvr.OverlayAnimator;
+
+export type TrackedDevicePropertyArray = Float32Array | Float64Array | Int32Array | BigUint64Array | Uint8Array;
+export type TrackedDevicePropertyValue = boolean | number | bigint | string | HmdMatrix34_t | HmdVector3_t | TrackedDevicePropertyArray;
+// uint64 cells are NaN in values and exact in uint64Values, which is only present when some property is a uint64.
+export type DevicePropertyMatrix = { values: Float64Array, errors: Int32Array, uint64Values?: BigUint64Array };
+export type PropertyCacheStats = { enabled: boolean, hits: number, misses: number };
 
 export class IVRSystem {
 
@@ -1434,7 +1590,9 @@ export class IVRSystem {
     // Tracking Methods
     // ------------------------------------
 
-    GetDeviceToAbsoluteTrackingPose(eOrigin: ETrackingUniverseOrigin, fPredictedSecondsToPhotonsFromNow: number): TrackedDevicePose_t[] { return openvr.IVRSystem.GetDeviceToAbsoluteTrackingPose(eOrigin, fPredictedSecondsToPhotonsFromNow); }
+    GetDeviceToAbsoluteTrackingPose(eOrigin: ETrackingUniverseOrigin, fPredictedSecondsToPhotonsFromNow: number): TrackedDevicePose_t[];
+    GetDeviceToAbsoluteTrackingPose(eOrigin: ETrackingUniverseOrigin, fPredictedSecondsToPhotonsFromNow: number, poses: Float32Array, states?: Uint8Array): number;
+    GetDeviceToAbsoluteTrackingPose(eOrigin: ETrackingUniverseOrigin, fPredictedSecondsToPhotonsFromNow: number, poses?: Float32Array, states?: Uint8Array): TrackedDevicePose_t[] | number { return openvr.IVRSystem.GetDeviceToAbsoluteTrackingPose(eOrigin, fPredictedSecondsToPhotonsFromNow, poses, states); }
     GetSeatedZeroPoseToStandingAbsoluteTrackingPose(): HmdMatrix34_t { return openvr.IVRSystem.GetSeatedZeroPoseToStandingAbsoluteTrackingPose(); }
     GetRawZeroPoseToStandingAbsoluteTrackingPose(): HmdMatrix34_t { return openvr.IVRSystem.GetRawZeroPoseToStandingAbsoluteTrackingPose(); }
     GetSortedTrackedDeviceIndicesOfClass(eTrackedDeviceClass: ETrackedDeviceClass, unRelativeToTrackedDeviceIndex?: ETrackedDeviceClass): TrackedDeviceIndex_t[] {
@@ -1456,6 +1614,31 @@ export class IVRSystem {
     GetInt32TrackedDeviceProperty(nDeviceIndex: TrackedDeviceIndex_t, nDeviceProp: ETrackedDeviceProperty): number { return openvr.IVRSystem.GetInt32TrackedDeviceProperty(nDeviceIndex, nDeviceProp); }
     GetUint64TrackedDeviceProperty(nDeviceIndex: TrackedDeviceIndex_t, nDeviceProp: ETrackedDeviceProperty): number { return openvr.IVRSystem.GetUint64TrackedDeviceProperty(nDeviceIndex, nDeviceProp); }
     GetMatrix34TrackedDeviceProperty(nDeviceIndex: TrackedDeviceIndex_t, nDeviceProp: ETrackedDeviceProperty): HmdMatrix34_t { return openvr.IVRSystem.GetMatrix34TrackedDeviceProperty(nDeviceIndex, nDeviceProp); }
+    // Returns a view over natively filled memory: Float32Array for float, vector and matrix elements, Int32Array for
+    // int32 and Float64Array for double. With a buffer, fills it in place and returns the bytes the value needs.
+    GetArrayTrackedDeviceProperty(nDeviceIndex: TrackedDeviceIndex_t, nDeviceProp: ETrackedDeviceProperty, propType?: PropertyTypeTag_t): TrackedDevicePropertyArray | undefined;
+    GetArrayTrackedDeviceProperty(nDeviceIndex: TrackedDeviceIndex_t, nDeviceProp: ETrackedDeviceProperty, propType: PropertyTypeTag_t | undefined, buffer: ArrayBuffer | ArrayBufferView): number;
+    GetArrayTrackedDeviceProperty(nDeviceIndex: TrackedDeviceIndex_t, nDeviceProp: ETrackedDeviceProperty, propType?: PropertyTypeTag_t, buffer?: ArrayBuffer | ArrayBufferView): TrackedDevicePropertyArray | number | undefined { return openvr.IVRSystem.GetArrayTrackedDeviceProperty(nDeviceIndex, nDeviceProp, propType, buffer); }
+    GetStringTrackedDeviceProperty(nDeviceIndex: TrackedDeviceIndex_t, nDeviceProp: ETrackedDeviceProperty): string { return openvr.IVRSystem.GetStringTrackedDeviceProperty(nDeviceIndex, nDeviceProp); }
+    // Reads any property whose type is known from its name, or returns undefined if the read fails.
+    GetTrackedDeviceProperty(nDeviceIndex: TrackedDeviceIndex_t, nDeviceProp: ETrackedDeviceProperty): TrackedDevicePropertyValue | undefined { return openvr.IVRSystem.GetTrackedDeviceProperty(nDeviceIndex, nDeviceProp); }
+    // Reads every property for every device in one call. Cell [i * props.length + j] holds property j of device i.
+    // Without tags, each type comes from the property's name.
+    GetDeviceProperties(nDeviceIndices: TrackedDeviceIndex_t[] | Uint32Array, props: ETrackedDeviceProperty[] | Uint32Array, tags?: PropertyTypeTag_t[] | Uint32Array): DevicePropertyMatrix { return openvr.IVRSystem.GetDeviceProperties(nDeviceIndices, props, tags); }
+    // Serves repeated property reads from memory. Entries are dropped when polled events report a change,
+    // so only enable this if system events are polled, or invalidate the cache yourself.
+    SetPropertyCacheEnabled(bEnabled: boolean): void { openvr.IVRSystem.SetPropertyCacheEnabled(bEnabled); }
+    GetPropertyCacheStats(): PropertyCacheStats { return openvr.IVRSystem.GetPropertyCacheStats(); }
+    InvalidatePropertyCache(nDeviceIndex?: TrackedDeviceIndex_t): void { openvr.IVRSystem.InvalidatePropertyCache(nDeviceIndex); }
+
+    // ------------------------------------
+    // Event methods
+    // ------------------------------------
+
+    PollNextEvent(): VREvent_t | undefined { return openvr.IVRSystem.PollNextEvent(); }
+    PollNextEvents(buffer: ArrayBuffer | ArrayBufferView): number { return openvr.IVRSystem.PollNextEvents(buffer); }
+    SetEventFilter(eventTypes?: EVREventType[]): void { openvr.IVRSystem.SetEventFilter(eventTypes); }
+    GetEventFilter(): EVREventType[] | undefined { return openvr.IVRSystem.GetEventFilter(); }
 
     // ------------------------------------
     // Controller methods
@@ -1628,6 +1811,23 @@ export type VROverlayProjection_t = {
     fBottom: number
 }
 
+// skipped is true when a newer upload to the same overlay finished first, or the frame was unchanged.
+export type OverlayUploadResult = { uploadMs: number, skipped: boolean };
+// cached is false when the file was decoded for this call, or handed to the runtime because it is not a PNG.
+export type OverlayFileUploadResult = OverlayUploadResult & { cached: boolean };
+export type OverlayImageCacheStats = { entries: number, bytes: number, budget: number, hits: number, misses: number, evictions: number };
+// Overlays are counted per JS creation site; reclaimed ones were still alive when their IVROverlay was collected or VR_Shutdown ran.
+export type OverlayRegistryStats = {
+    live: number,
+    created: number,
+    destroyed: number,
+    reclaimed: number,
+    findHits: number,
+    sites: { location: string, created: number, live: number }[],
+};
+export type OverlayStateMirrorStats = { enabled: boolean, overlays: number, hits: number, misses: number };
+export type OverlayUploadStats = { enabled: boolean, uploadedFrames: number, uploadedBytes: number, skippedFrames: number, skippedBytes: number, dirtyTiles: number, totalTiles: number };
+
 export class IVROverlay {
 
     // ---------------------------------------------
@@ -1637,6 +1837,8 @@ export class IVROverlay {
     FindOverlay(OverlayKey: string): VROverlayHandle_t { return openvr.IVROverlay.FindOverlay(OverlayKey); }
     CreateOverlay(OverlayKey: string, OverlayName: string): VROverlayHandle_t { return openvr.IVROverlay.CreateOverlay(OverlayKey, OverlayName); }
     DestroyOverlay(OverlayHandle: VROverlayHandle_t): EVROverlayError { return openvr.IVROverlay.DestroyOverlay(OverlayHandle); }
+    // Overlays belong to the IVROverlay that created them, and are destroyed when it is garbage collected.
+    GetOverlayRegistryStats(): OverlayRegistryStats { return openvr.IVROverlay.GetOverlayRegistryStats(); }
     GetOverlayKey(OverlayHandle: VROverlayHandle_t): string { return openvr.IVROverlay.GetOverlayKey(OverlayHandle); }
     GetOverlayName(OverlayHandle: VROverlayHandle_t): string { return openvr.IVROverlay.GetOverlayName(OverlayHandle); }
     SetOverlayName(OverlayHandle: VROverlayHandle_t, Name: string) { openvr.IVROverlay.SetOverlayName(OverlayHandle, Name); }
@@ -1682,13 +1884,29 @@ export class IVROverlay {
     ShowOverlay(OverlayHandle: VROverlayHandle_t) { openvr.IVROverlay.ShowOverlay(OverlayHandle); }
     HideOverlay(OverlayHandle: VROverlayHandle_t) { openvr.IVROverlay.HideOverlay(OverlayHandle); }
     IsOverlayVisible(OverlayHandle: VROverlayHandle_t): boolean { return openvr.IVROverlay.IsOverlayVisible(OverlayHandle); }
+    // Applies every property given in one native call, visibility last.
+    SetOverlayProperties(OverlayHandle: VROverlayHandle_t, Properties: OverlayProperties): void { openvr.IVROverlay.SetOverlayProperties(OverlayHandle, Properties); }
+    // One descriptor for every overlay, or one per overlay. Returns each overlay's EVROverlayError rather than throwing.
+    SetOverlayPropertiesBatch(OverlayHandles: VROverlayHandle_t[] | BigUint64Array, Properties: OverlayProperties | OverlayProperties[]): Int32Array { return openvr.IVROverlay.SetOverlayPropertiesBatch(OverlayHandles, Properties); }
+    // Transforms holds 12 floats (a row-major HmdMatrix34_t) per handle. Transforms equal to the last one this process sent an overlay are not sent.
+    SetOverlayTransformsAbsolute(OverlayHandles: VROverlayHandle_t[] | BigUint64Array, TrackingOrigin: ETrackingUniverseOrigin, Transforms: Float32Array): Int32Array { return openvr.IVROverlay.SetOverlayTransformsAbsolute(OverlayHandles, TrackingOrigin, Transforms); }
+    // Answers GetOverlayAlpha, GetOverlayWidthInMeters, GetOverlayColor, GetOverlayTransformAbsolute and IsOverlayVisible
+    // from values this process set, for overlays it created. Other overlays still ask the runtime.
+    SetOverlayStateMirrorEnabled(bEnabled: boolean): void { openvr.IVROverlay.SetOverlayStateMirrorEnabled(bEnabled); }
+    GetOverlayStateMirrorStats(): OverlayStateMirrorStats { return openvr.IVROverlay.GetOverlayStateMirrorStats(); }
     GetTransformForOverlayCoordinates(OverlayHandle: VROverlayHandle_t, TrackingOrigin: ETrackingUniverseOrigin, CoordinatesInOverlay: HmdVector2_t): HmdMatrix34_t { return openvr.IVROverlay.GetTransformForOverlayCoordinates(OverlayHandle, TrackingOrigin, CoordinatesInOverlay); }
 
     // ---------------------------------------------
     // Overlay input methods
     // ---------------------------------------------
 
-    PollNextOverlayEvent(OverlayHandle: VROverlayHandle_t): VREvent_t { return openvr.IVROverlay.PollNextOverlayEvent(OverlayHandle); }
+    PollNextOverlayEvent(OverlayHandle: VROverlayHandle_t): VREvent_t | undefined { return openvr.IVROverlay.PollNextOverlayEvent(OverlayHandle); }
+    PollNextOverlayEvents(OverlayHandle: VROverlayHandle_t, buffer: ArrayBuffer | ArrayBufferView): number { return openvr.IVROverlay.PollNextOverlayEvents(OverlayHandle, buffer); }
+    SetEventFilter(eventTypes?: EVREventType[]): void { openvr.IVROverlay.SetEventFilter(eventTypes); }
+    GetEventFilter(): EVREventType[] | undefined { return openvr.IVROverlay.GetEventFilter(); }
+    // Merges runs of mouse-move (latest position wins) and scroll (deltas summed) events per overlay.
+    SetEventCoalescing(bEnabled: boolean): void { openvr.IVROverlay.SetEventCoalescing(bEnabled); }
+    GetEventCoalescing(): boolean { return openvr.IVROverlay.GetEventCoalescing(); }
     GetOverlayInputMethod(OverlayHandle: VROverlayHandle_t): VROverlayInputMethod { return openvr.IVROverlay.GetOverlayInputMethod(OverlayHandle); }
     SetOverlayInputMethod(OverlayHandle: VROverlayHandle_t, InputMethod: VROverlayInputMethod) { openvr.IVROverlay.SetOverlayInputMethod(OverlayHandle, InputMethod); }
     GetOverlayMouseScale(OverlayHandle: VROverlayHandle_t): HmdVector2_t { return openvr.IVROverlay.GetOverlayMouseScale(OverlayHandle); }
@@ -1706,8 +1924,20 @@ export class IVROverlay {
 
     SetOverlayTexture(OverlayHandle: VROverlayHandle_t, Texture: Texture_t) { openvr.IVROverlay.SetOverlayTexture(OverlayHandle, Texture); }
     ClearOverlayTexture(OverlayHandle: VROverlayHandle_t) { openvr.IVROverlay.ClearOverlayTexture(OverlayHandle); }
-    SetOverlayRaw(OverlayHandle: VROverlayHandle_t, Buffer: Buffer, Width: number, Height: number, BytesPerPixel: number) { openvr.IVROverlay.SetOverlayRaw(OverlayHandle, Buffer, Width, Height, BytesPerPixel); }
+    // BytesPerPixel describes Buffer before Conversion.
+    SetOverlayRaw(OverlayHandle: VROverlayHandle_t, Buffer: Buffer, Width: number, Height: number, BytesPerPixel: number, Conversion?: EPixelConversion) { openvr.IVROverlay.SetOverlayRaw(OverlayHandle, Buffer, Width, Height, BytesPerPixel, Conversion); }
+    // Skips raw uploads whose pixels match the overlay's last upload, compared by 64x64 tile hashes.
+    SetSkipUnchangedUploads(bEnabled: boolean): void { openvr.IVROverlay.SetSkipUnchangedUploads(bEnabled); }
+    GetOverlayUploadStats(): OverlayUploadStats { return openvr.IVROverlay.GetOverlayUploadStats(); }
+    // Uploads on a libuv worker. Rejects with an Error carrying `overlayError` if the runtime refuses the upload.
+    SetOverlayRawAsync(OverlayHandle: VROverlayHandle_t, Buffer: Buffer | ArrayBuffer | ArrayBufferView, Width: number, Height: number, BytesPerPixel: number, Conversion?: EPixelConversion): Promise<OverlayUploadResult> { return openvr.IVROverlay.SetOverlayRawAsync(OverlayHandle, Buffer, Width, Height, BytesPerPixel, Conversion); }
     SetOverlayFromFile(OverlayHandle: VROverlayHandle_t, FilePath: String) { openvr.IVROverlay.SetOverlayFromFile(OverlayHandle, FilePath); }
+    // Decodes PNGs natively on a libuv worker, through a cache keyed by path and modification time, and uploads them raw.
+    SetOverlayFromFileAsync(OverlayHandle: VROverlayHandle_t, FilePath: string): Promise<OverlayFileUploadResult> { return openvr.IVROverlay.SetOverlayFromFileAsync(OverlayHandle, FilePath); }
+    // Decoded bytes the image cache may hold, 64 MiB by default; 0 turns it off.
+    SetOverlayImageCacheBudget(Bytes: number): void { openvr.IVROverlay.SetOverlayImageCacheBudget(Bytes); }
+    ClearOverlayImageCache(): void { openvr.IVROverlay.ClearOverlayImageCache(); }
+    GetOverlayImageCacheStats(): OverlayImageCacheStats { return openvr.IVROverlay.GetOverlayImageCacheStats(); }
     ReleaseNativeOverlayHandle(OverlayHandle: VROverlayHandle_t, NativeTextureHandle: number) { openvr.IVROverlay.ReleaseNativeOverlayHandle(OverlayHandle, NativeTextureHandle); }
     GetOverlayTextureSize(OverlayHandle: VROverlayHandle_t): { Width: number, Height: number } { return openvr.IVROverlay.GetOverlayTextureSize(OverlayHandle); }
 
@@ -1765,3 +1995,25 @@ export class IVRApplications {
         return openvr.IVRApplications.IsApplicationInstalled(appKey);
     }
 }
+
+// Mock runtime, only present in builds made with `--openvr_mock=1`
+export type VRMockStats = { calls: number, overlayUploads: number, overlayUploadBytes: number, overlayFileLoads: number, overlays: number };
+export type VRMockControllerState = { packetNum: number, buttonPressed: number | bigint, buttonTouched: number | bigint, axis: HmdVector2_t[] };
+export interface VRMock {
+    Reset(): void;
+    SetCallLatency(microseconds: number): void;
+    SetInitError(error: EVRInitError): void;
+    SetHmdPresent(present: boolean): void;
+    SetDisplayFrequency(hz: number): void;
+    SetDevice(deviceIndex: TrackedDeviceIndex_t, deviceClass: ETrackedDeviceClass, role: ETrackedControllerRole, connected: boolean): void;
+    SetDevicePose(deviceIndex: TrackedDeviceIndex_t, pose: TrackedDevicePose_t): void;
+    SetDeviceProperty(deviceIndex: TrackedDeviceIndex_t, prop: ETrackedDeviceProperty, tag: PropertyTypeTag_t, value: boolean | number | bigint | string | HmdMatrix34_t | ArrayBufferView): void;
+    SetControllerState(deviceIndex: TrackedDeviceIndex_t, state: VRMockControllerState): void;
+    QueueEvent(eventType: EVREventType, deviceIndex: TrackedDeviceIndex_t, data?: ArrayBufferView): void;
+    QueueOverlayEvent(overlayHandle: VROverlayHandle_t, eventType: EVREventType, data?: ArrayBufferView): boolean;
+    CreateForeignOverlay(overlayKey: string, overlayName: string): VROverlayHandle_t;
+    GetStats(): VRMockStats;
+    // Overlay fingerprint tile hashes from every instruction set this CPU has, which must all agree.
+    HashOverlayTiles(data: ArrayBufferView, width: number, height: number, bytesPerPixel: number): { [instructionSet: string]: BigUint64Array };
+}
+export const VRMock: VRMock | undefined = openvr.VRMock;
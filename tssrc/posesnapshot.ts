@@ -0,0 +1,55 @@
+/// <reference lib="es2017.sharedmemory" />
+
+// Reader for the buffer returned by PoseSampler.GetSnapshotBuffer().
+// This module does not load the native addon, so worker_threads can import it
+// directly and read poses without a round trip through the main thread.
+
+// Layout, mirrored by src/posesampler.cpp.
+export const k_unPoseSnapshotSequenceOffset: number = 0;     // Uint32, odd while a write is in progress, 0 until the first; wraps skipping 0
+export const k_unPoseSnapshotDeviceCountOffset: number = 4;  // Uint32
+export const k_unPoseSnapshotTimeOffset: number = 8;         // Float64, PoseSampler.Now() clock
+export const k_unPoseSnapshotIndexOffset: number = 16;       // Float64, sample index
+export const k_unPoseSnapshotPosesOffset: number = 24;       // Float32 x 18 per device, as GetDeviceToAbsoluteTrackingPose
+export const k_unPoseSnapshotDeviceCount: number = 64;
+export const k_unPoseSnapshotStatesOffset: number = k_unPoseSnapshotPosesOffset + k_unPoseSnapshotDeviceCount * 18 * 4; // Uint8 x 4 per device
+export const k_unPoseSnapshotSize: number = k_unPoseSnapshotStatesOffset + k_unPoseSnapshotDeviceCount * 4;
+
+export type PoseSnapshotInfo = { time: number, sampleIndex: number };
+
+export class PoseSnapshotReader {
+    private readonly header: Uint32Array;
+    private readonly stamps: Float64Array;
+    private readonly poses: Float32Array;
+    private readonly states: Uint8Array;
+
+    constructor(buffer: SharedArrayBuffer) {
+        if (buffer.byteLength < k_unPoseSnapshotSize)
+            throw new RangeError("Buffer is too small to hold a pose snapshot.");
+
+        this.header = new Uint32Array(buffer, 0, 2);
+        this.stamps = new Float64Array(buffer, k_unPoseSnapshotTimeOffset, 2);
+        this.poses = new Float32Array(buffer, k_unPoseSnapshotPosesOffset, k_unPoseSnapshotDeviceCount * 18);
+        this.states = new Uint8Array(buffer, k_unPoseSnapshotStatesOffset, k_unPoseSnapshotDeviceCount * 4);
+    }
+
+    // Copies the latest published sample into `poses` (and `states`), which must hold all 64 devices.
+    // Returns undefined if nothing has been published yet or the writer kept the snapshot busy.
+    Read(poses: Float32Array, states?: Uint8Array, maxAttempts: number = 16): PoseSnapshotInfo | undefined {
+        for (let attempt = 0; attempt < maxAttempts; ++attempt) {
+            const before = Atomics.load(this.header, 0);
+            if (before === 0)
+                return undefined;
+            if (before & 1)
+                continue;
+
+            poses.set(this.poses);
+            if (states)
+                states.set(this.states);
+            const info = { time: this.stamps[0], sampleIndex: this.stamps[1] };
+
+            if (Atomics.load(this.header, 0) === before)
+                return info;
+        }
+        return undefined;
+    }
+}